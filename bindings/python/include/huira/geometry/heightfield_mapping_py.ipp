@@ -0,0 +1,55 @@
+#pragma once
+
+#include "huira/geometry/heightfield.hpp"
+#include "huira/units/units_py.ipp"
+#include "pybind11/pybind11.h"
+
+namespace py = pybind11;
+
+namespace huira {
+
+inline void bind_heightfield_mapping(py::module_& m)
+{
+    py::class_<HeightfieldMapping> mapping(m, "HeightfieldMapping");
+
+    py::enum_<HeightfieldMapping::Projection>(mapping, "Projection")
+        .value("PLANAR", HeightfieldMapping::Projection::Planar)
+        .value("EQUIRECTANGULAR", HeightfieldMapping::Projection::Equirectangular);
+
+    mapping
+        .def_static(
+            "planar",
+            [](const py::object& sample_spacing) {
+                return HeightfieldMapping::planar(
+                    detail::unit_from_py<units::Meter>(sample_spacing));
+            },
+            py::arg("sample_spacing"),
+            "Samples on the local xy plane, centred on the origin, with elevation along +z")
+        .def_static(
+            "equirectangular",
+            [](const py::object& body_radius,
+               const py::object& lon_min,
+               const py::object& lon_max,
+               const py::object& lat_min,
+               const py::object& lat_max) {
+                return HeightfieldMapping::equirectangular(
+                    detail::unit_from_py<units::Meter>(body_radius),
+                    detail::unit_from_py<units::Degree>(lon_min),
+                    detail::unit_from_py<units::Degree>(lon_max),
+                    detail::unit_from_py<units::Degree>(lat_min),
+                    detail::unit_from_py<units::Degree>(lat_max));
+            },
+            py::arg("body_radius"),
+            py::arg("lon_min"),
+            py::arg("lon_max"),
+            py::arg("lat_min"),
+            py::arg("lat_max"),
+            "Samples over a longitude/latitude box on a sphere, row 0 at the northern edge")
+        .def_readonly("projection", &HeightfieldMapping::projection)
+        .def("__repr__", [](const HeightfieldMapping& mapping) {
+            return mapping.projection == HeightfieldMapping::Projection::Planar
+                       ? std::string("<HeightfieldMapping planar>")
+                       : std::string("<HeightfieldMapping equirectangular>");
+        });
+}
+} // namespace huira
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "huira/geometry/particle_cloud.hpp"
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+
+namespace py = pybind11;
+
+namespace huira {
+namespace detail {
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+// Particle positions from an (N, 3) array:
+inline std::vector<Vec3<float>> particle_positions_from_py(const FloatArray& arr)
+{
+    auto buf = arr.request();
+    if (buf.ndim != 2 || buf.shape[1] != 3) {
+        throw std::runtime_error("Expected an array of shape (N, 3) for particle positions");
+    }
+    const auto* data = static_cast<const float*>(buf.ptr);
+    std::vector<Vec3<float>> positions(static_cast<std::size_t>(buf.shape[0]));
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = Vec3<float>{data[3 * i], data[3 * i + 1], data[3 * i + 2]};
+    }
+    return positions;
+}
+
+// Particle albedos from an (N, bins) array, or none:
+template <typename TSpectral>
+std::vector<TSpectral> particle_albedos_from_py(const py::object& obj)
+{
+    std::vector<TSpectral> albedos;
+    if (obj.is_none()) {
+        return albedos;
+    }
+    auto arr = obj.cast<FloatArray>();
+    auto buf = arr.request();
+    const auto bins = static_cast<py::ssize_t>(TSpectral::size());
+    if (buf.ndim != 2 || buf.shape[1] != bins) {
+        throw std::runtime_error("Expected an array of shape (N, " + std::to_string(bins) +
+                                 ") for particle albedos");
+    }
+    const auto* data = static_cast<const float*>(buf.ptr);
+    albedos.resize(static_cast<std::size_t>(buf.shape[0]));
+    for (std::size_t i = 0; i < albedos.size(); ++i) {
+        for (std::size_t b = 0; b < TSpectral::size(); ++b) {
+            albedos[i][b] = data[i * TSpectral::size() + b];
+        }
+    }
+    return albedos;
+}
+} // namespace detail
+
+inline void bind_particle_shape(py::module_& m)
+{
+    py::enum_<ParticleShape>(m, "ParticleShape")
+        .value("SPHERE", ParticleShape::Sphere)
+        .value("DISC", ParticleShape::Disc);
+}
+} // namespace huira
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "huira/handles/geometry/heightfield_handle.hpp"
+#include "huira/handles/handle_py.ipp"
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+namespace py = pybind11;
+
+namespace huira {
+/**
+ * @brief Registers HeightfieldHandle<TSpectral> as a Python class.
+ */
+template <typename TSpectral>
+inline void bind_heightfield_handle(py::module_& m)
+{
+    using HandleType = HeightfieldHandle<TSpectral>;
+
+    auto cls = py::class_<HandleType, GeometryHandle<TSpectral>>(m, "HeightfieldHandle")
+                   // --- Handle basics ---
+                   .def("__bool__", &HandleType::valid)
+                   .def("__repr__", [](const HandleType&) { return "<HeightfieldHandle>"; })
+
+                   // --- Raster ---
+                   .def_property_readonly("width", &HandleType::width)
+                   .def_property_readonly("height", &HandleType::height)
+                   .def_property_readonly("tile_count", &HandleType::tile_count)
+
+                   // --- Level of detail ---
+                   .def("set_lod_pixels",
+                        &HandleType::set_lod_pixels,
+                        py::arg("lod_pixels"),
+                        "Largest on-screen size of a rendered cell, in pixels (0 for full detail)")
+                   .def_property_readonly("lod_pixels", &HandleType::lod_pixels);
+
+    bind_handle_methods<Heightfield<TSpectral>>(cls);
+}
+} // namespace huira
@@ -21,6 +21,27 @@ inline void bind_mesh_handle(py::module_& m)
                         &HandleType::get_vertex_count,
                         "Return the number of vertices in the mesh")
 
+                   // --- Level of detail ---
+                   .def("generate_lods",
+                        &HandleType::generate_lods,
+                        py::arg("max_levels") = 6,
+                        py::arg("reduction") = 0.25f,
+                        "Build a chain of simplified levels of detail")
+                   .def_property_readonly("lod_count", &HandleType::lod_count)
+                   .def_property_readonly("lod_level", &HandleType::lod_level)
+                   .def("lod_error", &HandleType::lod_error, py::arg("level"))
+                   .def("lod_triangle_count", &HandleType::lod_triangle_count, py::arg("level"))
+                   .def("set_lod_pixel_error",
+                        &HandleType::set_lod_pixel_error,
+                        py::arg("pixels"),
+                        "Largest on-screen error of the traced level in pixels (0: full detail)")
+                   .def_property_readonly("lod_pixel_error", &HandleType::lod_pixel_error)
+                   .def("set_lod_hysteresis",
+                        &HandleType::set_lod_hysteresis,
+                        py::arg("hysteresis"),
+                        "Margin a coarser level must fit the pixel error by before it is used")
+                   .def_property_readonly("lod_hysteresis", &HandleType::lod_hysteresis)
+
                    // --- Handle basics ---
                    .def("__bool__", &HandleType::valid)
                    .def("__repr__", [](const HandleType&) { return "<MeshHandle>"; });
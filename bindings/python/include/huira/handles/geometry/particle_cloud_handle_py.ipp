@@ -0,0 +1,45 @@
+#pragma once
+
+#include "huira/geometry/particle_cloud_py.ipp"
+#include "huira/handles/geometry/particle_cloud_handle.hpp"
+#include "huira/handles/handle_py.ipp"
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+namespace py = pybind11;
+
+namespace huira {
+/**
+ * @brief Registers ParticleCloudHandle<TSpectral> as a Python class.
+ */
+template <typename TSpectral>
+inline void bind_particle_cloud_handle(py::module_& m)
+{
+    using HandleType = ParticleCloudHandle<TSpectral>;
+
+    auto cls = py::class_<HandleType, GeometryHandle<TSpectral>>(m, "ParticleCloudHandle")
+                   // --- Handle basics ---
+                   .def("__bool__", &HandleType::valid)
+                   .def("__repr__", [](const HandleType&) { return "<ParticleCloudHandle>"; })
+
+                   // --- Particles ---
+                   .def_property_readonly("size", &HandleType::size)
+                   .def_property_readonly("shape", &HandleType::shape)
+
+                   // --- Motion blur ---
+                   .def_property_readonly("time_step_count", &HandleType::time_step_count)
+                   .def(
+                       "add_time_step",
+                       [](const HandleType& self, const detail::FloatArray& positions) {
+                           self.add_time_step(detail::particle_positions_from_py(positions));
+                       },
+                       py::arg("positions"),
+                       "Add (N, 3) positions in metres at a further time, evenly spaced across "
+                       "the exposure")
+                   .def("clear_motion",
+                        &HandleType::clear_motion,
+                        "Remove every time step after the first");
+
+    bind_handle_methods<ParticleCloud<TSpectral>>(cls);
+}
+} // namespace huira
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "huira/handles/handle_py.ipp"
+#include "huira/handles/volumes/atmosphere_handle.hpp"
+#include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
+
+namespace py = pybind11;
+
+namespace huira {
+/**
+ * @brief Registers AtmosphereHandle<TSpectral> as a Python class.
+ */
+template <IsSpectral TSpectral>
+inline void bind_atmosphere_handle(py::module_& m)
+{
+    using HandleType = AtmosphereHandle<TSpectral>;
+
+    auto cls = py::class_<HandleType>(m, "AtmosphereHandle")
+                   .def("__bool__", &HandleType::valid)
+                   .def("__repr__", [](const HandleType&) { return "<AtmosphereHandle>"; });
+
+    bind_handle_methods<Atmosphere<TSpectral>>(cls);
+}
+} // namespace huira
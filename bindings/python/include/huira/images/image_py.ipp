@@ -6,6 +6,7 @@
 #include <string>
 
 #include "huira/images/color_map.hpp"
+#include "huira/images/compact_texture.hpp"
 #include "huira/images/image.hpp"
 #include "huira/images/io/color_space.hpp"
 #include "huira/images/io/jpeg_io.hpp"
@@ -32,6 +33,36 @@ void bind_image(py::module_& m, const char* class_name)
     using Scalar = typename Traits::Scalar;
     constexpr auto C = Traits::channels;
 
+    // Copies the pixels into a new row-major numpy array, whatever the image's layout:
+    const auto to_numpy = [](const Img& source) -> py::array_t<Scalar> {
+        Img row_major;
+        if (source.layout() != ImageLayout::RowMajor) {
+            row_major = source;
+            row_major.set_layout(ImageLayout::RowMajor);
+        }
+        const Img& img = row_major.empty() ? source : row_major;
+        if constexpr (C == 1) {
+            py::array_t<Scalar> arr(
+                std::vector<py::ssize_t>{static_cast<py::ssize_t>(img.height()),
+                                         static_cast<py::ssize_t>(img.width())});
+            std::memcpy(arr.mutable_data(),
+                        img.data(),
+                        static_cast<std::size_t>(img.width()) *
+                            static_cast<std::size_t>(img.height()) * sizeof(Scalar));
+            return arr;
+        } else {
+            py::array_t<Scalar> arr(
+                std::vector<py::ssize_t>{static_cast<py::ssize_t>(img.height()),
+                                         static_cast<py::ssize_t>(img.width()),
+                                         static_cast<py::ssize_t>(C)});
+            std::memcpy(arr.mutable_data(),
+                        img.data(),
+                        static_cast<std::size_t>(img.width()) *
+                            static_cast<std::size_t>(img.height()) * C * sizeof(Scalar));
+            return arr;
+        }
+    };
+
     py::class_<Img>(m, class_name, py::buffer_protocol())
 
         // -----------------------------------------------------------------
@@ -104,7 +135,12 @@ void bind_image(py::module_& m, const char* class_name)
         // -----------------------------------------------------------------
         // Buffer protocol  --  np.asarray(img) gives a zero-copy view
         // -----------------------------------------------------------------
-        .def_buffer([](Img& img) -> py::buffer_info {
+        // A tiled image cannot be described by strides, so it is viewed through a row-major copy
+        // that the view keeps alive; writes to that view do not reach the image.
+        .def_buffer([to_numpy](Img& img) -> py::buffer_info {
+            if (img.layout() != ImageLayout::RowMajor) {
+                return to_numpy(img).request(true);
+            }
             if constexpr (C == 1) {
                 return py::buffer_info(
                     static_cast<void*>(img.data()),
@@ -139,28 +175,7 @@ void bind_image(py::module_& m, const char* class_name)
         // -----------------------------------------------------------------
         .def(
             "to_numpy",
-            [](const Img& img) {
-                if constexpr (C == 1) {
-                    py::array_t<Scalar> arr(
-                        std::vector<py::ssize_t>{static_cast<py::ssize_t>(img.height()),
-                                                 static_cast<py::ssize_t>(img.width())});
-                    std::memcpy(arr.mutable_data(),
-                                img.data(),
-                                static_cast<std::size_t>(img.width()) *
-                                    static_cast<std::size_t>(img.height()) * sizeof(Scalar));
-                    return arr;
-                } else {
-                    py::array_t<Scalar> arr(
-                        std::vector<py::ssize_t>{static_cast<py::ssize_t>(img.height()),
-                                                 static_cast<py::ssize_t>(img.width()),
-                                                 static_cast<py::ssize_t>(C)});
-                    std::memcpy(arr.mutable_data(),
-                                img.data(),
-                                static_cast<std::size_t>(img.width()) *
-                                    static_cast<std::size_t>(img.height()) * C * sizeof(Scalar));
-                    return arr;
-                }
-            },
+            to_numpy,
             "Return image data as a numpy array (always copies).")
 
         // -----------------------------------------------------------------
@@ -464,6 +479,12 @@ inline void bind_common_images(py::module_& m)
         .value("Unknown", ColorSpaceHint::Unknown)
         .export_values();
 
+    py::enum_<CompactTexelFormat>(m, "CompactTexelFormat")
+        .value("RGB8", CompactTexelFormat::RGB8)
+        .value("RGB16", CompactTexelFormat::RGB16)
+        .value("Half", CompactTexelFormat::Half)
+        .export_values();
+
     // Scalar images
     bind_image<float>(m, "Image_f32");
     bind_image<double>(m, "Image_f64");
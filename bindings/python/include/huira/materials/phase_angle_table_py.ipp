@@ -0,0 +1,18 @@
+#pragma once
+
+#include "huira/materials/bsdfs/phase_angle_table.hpp"
+#include "pybind11/pybind11.h"
+
+namespace py = pybind11;
+
+namespace huira {
+
+inline void bind_photometric_evaluation(py::module_& m)
+{
+    py::enum_<PhotometricEvaluation>(
+        m, "PhotometricEvaluation", "How photometric BSDFs evaluate their phase-angle terms")
+        .value("Exact", PhotometricEvaluation::Exact)
+        .value("Tabulated", PhotometricEvaluation::Tabulated);
+}
+
+} // namespace huira
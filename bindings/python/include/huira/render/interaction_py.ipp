@@ -22,6 +22,10 @@ void bind_interaction(py::module_& m)
         .def_readwrite("tangent", &InteractionT::tangent, "Tangent vector")
         .def_readwrite("bitangent", &InteractionT::bitangent, "Bitangent vector")
         .def_readwrite("uv", &InteractionT::uv, "Texture coordinates (u, v)")
+        .def_readwrite("dpdu", &InteractionT::dpdu, "Partial derivative of position along u")
+        .def_readwrite("dpdv", &InteractionT::dpdv, "Partial derivative of position along v")
+        .def_readwrite("duvdx", &InteractionT::duvdx, "Change in uv across one pixel in x")
+        .def_readwrite("duvdy", &InteractionT::duvdy, "Change in uv across one pixel in y")
         .def_readwrite("wo", &InteractionT::wo, "Outgoing direction (towards camera)")
         .def_readwrite("vertex_albedo", &InteractionT::vertex_albedo, "Interpolated vertex color")
 
@@ -29,6 +29,12 @@ void bind_renderer(py::module_& m)
         .def("set_variance_threshold", &Renderer::set_variance_threshold, py::arg("threshold"))
 
         .def("set_indirect_clamp", &Renderer::set_indirect_clamp, py::arg("indirect_clamp"))
+        .def("set_irradiance_cache",
+             &Renderer::set_irradiance_cache,
+             py::arg("irradiance_cache").none(true))
+        .def_property_readonly("irradiance_cache", &Renderer::irradiance_cache)
+        .def("set_shadow_cache", &Renderer::set_shadow_cache, py::arg("shadow_cache").none(true))
+        .def_property_readonly("shadow_cache", &Renderer::shadow_cache)
         .def("__repr__", [](const Renderer&) { return "Renderer()"; });
 }
 
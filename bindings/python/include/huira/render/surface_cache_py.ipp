@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "huira/render/surface_cache.hpp"
+#include "huira/units/units_py.ipp"
+#include "pybind11/pybind11.h"
+
+namespace py = pybind11;
+
+namespace huira {
+
+template <typename Cache>
+void bind_surface_cache(py::module_& m, const std::string& name, int default_min_samples)
+{
+    py::class_<Cache, std::shared_ptr<Cache>>(m, name.c_str())
+        .def(py::init([](const py::object& cell_size,
+                         const py::object& sun_tolerance,
+                         int min_samples) {
+                 return std::make_shared<Cache>(
+                     detail::unit_from_py<units::Meter>(cell_size),
+                     detail::unit_from_py<units::Radian>(sun_tolerance),
+                     min_samples);
+             }),
+             py::arg("cell_size"),
+             py::arg("sun_tolerance"),
+             py::arg("min_samples") = default_min_samples,
+             "Create a surface cache (accepts any distance and angle units)")
+        .def(
+            "set_cell_size",
+            [](Cache& self, const py::object& cell_size) {
+                self.set_cell_size(detail::unit_from_py<units::Meter>(cell_size));
+            },
+            py::arg("cell_size"))
+        .def(
+            "set_sun_tolerance",
+            [](Cache& self, const py::object& sun_tolerance) {
+                self.set_sun_tolerance(detail::unit_from_py<units::Radian>(sun_tolerance));
+            },
+            py::arg("sun_tolerance"))
+        .def("set_min_samples", &Cache::set_min_samples, py::arg("min_samples"))
+        .def("set_max_samples", &Cache::set_max_samples, py::arg("max_samples"))
+        .def("clear", &Cache::clear)
+        .def("__len__", &Cache::size)
+        .def("__repr__", [name](const Cache& self) {
+            return name + "(cells=" + std::to_string(self.size()) + ")";
+        });
+}
+
+template <IsSpectral TSpectral>
+void bind_surface_caches(py::module_& m)
+{
+    bind_surface_cache<IrradianceCache<TSpectral>>(m, "IrradianceCache", 16);
+    bind_surface_cache<ShadowCache<TSpectral>>(m, "ShadowCache", 8);
+}
+
+} // namespace huira
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "huira/geometry/particle_cloud_py.ipp"
 #include "huira/handles/camera_handle.hpp"
 #include "huira/scene/scene.hpp"
 #include "pybind11/pybind11.h"
@@ -48,6 +53,13 @@ inline void bind_scene(py::module_& m)
              py::arg("tangent_buffer"),
              py::arg("name") = "",
              "Add a mesh from index, vertex, and tangent buffers")
+        .def("load_mesh",
+             &SceneType::load_mesh,
+             py::arg("file"),
+             py::arg("name") = "",
+             py::arg("lod_levels") = 0,
+             py::arg("use_cache") = true,
+             "Load a shape model as a single mesh, through a memory-mapped cache beside the file")
 
         // add_ellipsoid
         .def(
@@ -67,6 +79,71 @@ inline void bind_scene(py::module_& m)
             py::arg("z"),
             py::arg("name") = "",
             "Add an ellipsoid geometry (accepts any distance unit)")
+        .def(
+            "add_heightfield",
+            [](SceneType& self,
+               std::size_t width,
+               std::size_t height,
+               std::vector<float> elevations,
+               const HeightfieldMapping& mapping,
+               std::string name) {
+                return self.add_heightfield(
+                    width, height, std::move(elevations), mapping, std::move(name));
+            },
+            py::arg("width"),
+            py::arg("height"),
+            py::arg("elevations"),
+            py::arg("mapping"),
+            py::arg("name") = "",
+            "Add a heightfield from row-major elevations in metres")
+        .def("load_heightfield",
+             &SceneType::load_heightfield,
+             py::arg("path"),
+             py::arg("mapping"),
+             py::arg("height_scale") = 1.f,
+             py::arg("height_offset") = 0.f,
+             py::arg("name") = "",
+             "Load a heightfield from a TIFF, GeoTIFF or FITS elevation raster")
+        .def("load_raw_heightfield",
+             &SceneType::load_raw_heightfield,
+             py::arg("path"),
+             py::arg("width"),
+             py::arg("height"),
+             py::arg("mapping"),
+             py::arg("height_scale") = 1.f,
+             py::arg("height_offset") = 0.f,
+             py::arg("name") = "",
+             "Load a heightfield from a headerless raster of 32-bit floats")
+        .def(
+            "add_particles",
+            [](SceneType& self,
+               const detail::FloatArray& positions,
+               const detail::FloatArray& radii,
+               const py::object& albedos,
+               ParticleShape shape,
+               std::string name) {
+                auto radii_buf = radii.request();
+                const auto* radii_data = static_cast<const float*>(radii_buf.ptr);
+                std::vector<float> radii_vec(radii_data, radii_data + radii_buf.size);
+                return self.add_particles(detail::particle_positions_from_py(positions),
+                                          radii_vec,
+                                          detail::particle_albedos_from_py<TSpectral>(albedos),
+                                          shape,
+                                          std::move(name));
+            },
+            py::arg("positions"),
+            py::arg("radii"),
+            py::arg("albedos") = py::none(),
+            py::arg("shape") = ParticleShape::Sphere,
+            py::arg("name") = "",
+            "Add particles from (N, 3) positions and N radii (or one) in metres, and optional "
+            "(N, bins) albedos")
+        .def("load_raw_particles",
+             &SceneType::load_raw_particles,
+             py::arg("path"),
+             py::arg("shape") = ParticleShape::Sphere,
+             py::arg("name") = "",
+             "Load particles from a headerless file of float32 (x, y, z, radius) records")
 
         .def("add_geometry",
              &SceneType::add_geometry,
@@ -148,6 +225,11 @@ inline void bind_scene(py::module_& m)
             py::arg("primitive_handle"),
             py::arg("name"),
             "Set the name of a primitive")
+        .def("set_atmosphere",
+             &SceneType::set_atmosphere,
+             py::arg("primitive_handle"),
+             py::arg("atmosphere_handle"),
+             "Surround every instance of a primitive with an atmosphere")
 
         // =============================================================
         // Lights
@@ -391,6 +473,7 @@ inline void bind_scene(py::module_& m)
              py::arg("b"),
              py::arg("c"),
              py::arg("name") = "",
+             py::arg("evaluation") = PhotometricEvaluation::Exact,
              "Create a Hapke BSDF")
         .def("new_bsdf_lambertian",
              &SceneType::new_bsdf_lambertian,
@@ -403,6 +486,7 @@ inline void bind_scene(py::module_& m)
         .def("new_bsdf_mcewen",
              &SceneType::new_bsdf_mcewen,
              py::arg("name") = "",
+             py::arg("evaluation") = PhotometricEvaluation::Exact,
              "Create a McEwen BSDF")
         .def("new_bsdf_null",
              &SceneType::new_bsdf_null,
@@ -442,6 +526,103 @@ inline void bind_scene(py::module_& m)
             py::arg("scattering"),
             py::arg("name") = "",
             "Create a constant density field with the given absorption and scattering coefficients")
+        .def(
+            "new_exponential_density_field",
+            [](SceneType& self,
+               const py::object& planet_radius,
+               const py::object& scale_height,
+               TSpectral absorption,
+               TSpectral scattering,
+               std::string name) {
+                return self.new_exponential_density_field(
+                    detail::unit_from_py<units::Meter>(planet_radius),
+                    detail::unit_from_py<units::Meter>(scale_height),
+                    absorption,
+                    scattering,
+                    std::move(name));
+            },
+            py::arg("planet_radius"),
+            py::arg("scale_height"),
+            py::arg("absorption"),
+            py::arg("scattering"),
+            py::arg("name") = "",
+            "Create a spherical atmosphere whose density falls off exponentially with altitude")
+        .def(
+            "new_tabulated_density_field",
+            [](SceneType& self,
+               const py::object& planet_radius,
+               const std::vector<float>& altitudes,
+               const std::vector<float>& densities,
+               TSpectral absorption,
+               TSpectral scattering,
+               std::string name) {
+                return self.new_tabulated_density_field(
+                    detail::unit_from_py<units::Meter>(planet_radius),
+                    altitudes,
+                    densities,
+                    absorption,
+                    scattering,
+                    std::move(name));
+            },
+            py::arg("planet_radius"),
+            py::arg("altitudes"),
+            py::arg("densities"),
+            py::arg("absorption"),
+            py::arg("scattering"),
+            py::arg("name") = "",
+            "Create a spherical atmosphere from altitudes in metres and relative densities")
+        .def(
+            "new_grid_density_field",
+            [](SceneType& self,
+               const std::array<std::size_t, 3>& resolution,
+               const std::vector<float>& densities,
+               const Vec3<double>& bounds_min,
+               const Vec3<double>& bounds_max,
+               TSpectral absorption,
+               TSpectral scattering,
+               std::string name) {
+                return self.new_grid_density_field(resolution,
+                                                   densities,
+                                                   Vec3<float>(bounds_min),
+                                                   Vec3<float>(bounds_max),
+                                                   absorption,
+                                                   scattering,
+                                                   std::move(name));
+            },
+            py::arg("resolution"),
+            py::arg("densities"),
+            py::arg("bounds_min"),
+            py::arg("bounds_max"),
+            py::arg("absorption"),
+            py::arg("scattering"),
+            py::arg("name") = "",
+            "Create a sparse voxel medium from densities with x varying fastest")
+        .def(
+            "load_grid_density_field",
+            [](SceneType& self,
+               const fs::path& path,
+               const std::array<std::size_t, 3>& resolution,
+               const Vec3<double>& bounds_min,
+               const Vec3<double>& bounds_max,
+               TSpectral absorption,
+               TSpectral scattering,
+               std::string name) {
+                return self.load_grid_density_field(path,
+                                                    resolution,
+                                                    Vec3<float>(bounds_min),
+                                                    Vec3<float>(bounds_max),
+                                                    absorption,
+                                                    scattering,
+                                                    std::move(name));
+            },
+            py::arg("path"),
+            py::arg("resolution"),
+            py::arg("bounds_min"),
+            py::arg("bounds_max"),
+            py::arg("absorption"),
+            py::arg("scattering"),
+            py::arg("name") = "",
+            "Create a sparse voxel medium from a raw binary grid of 32-bit floats")
         .def("add_density_field",
              &SceneType::add_density_field,
              py::arg("density_field"),
@@ -452,6 +633,15 @@ inline void bind_scene(py::module_& m)
              &SceneType::new_isotropic_phase_function,
              py::arg("name") = "",
              "Create an isotropic phase function")
+        .def("new_rayleigh_phase_function",
+             &SceneType::new_rayleigh_phase_function,
+             py::arg("name") = "",
+             "Create a Rayleigh phase function for molecular scattering")
+        .def("new_henyey_greenstein_phase_function",
+             &SceneType::new_henyey_greenstein_phase_function,
+             py::arg("g"),
+             py::arg("name") = "",
+             "Create a Henyey-Greenstein phase function with asymmetry g in (-1, 1)")
         .def("add_phase_function",
              &SceneType::add_phase_function,
              py::arg("phase_function"),
@@ -470,6 +660,18 @@ inline void bind_scene(py::module_& m)
              py::arg("name") = "",
              "Add a medium from a shared pointer")
 
+        .def("new_atmosphere",
+             &SceneType::new_atmosphere,
+             py::arg("layers"),
+             py::arg("ground_albedo") = TSpectral{0.f},
+             py::arg("name") = "",
+             "Create a planetary atmosphere with precomputed scattering from a list of media")
+        .def("add_atmosphere",
+             &SceneType::add_atmosphere,
+             py::arg("atmosphere"),
+             py::arg("name") = "",
+             "Add an atmosphere from a shared pointer")
+
         // =============================================================
         // Background
         // =============================================================
@@ -541,6 +743,18 @@ inline void bind_scene(py::module_& m)
             py::arg("image"),
             py::arg("name") = "",
             "Add a normal map texture from an RGB image")
+        .def(
+            "add_compact_texture",
+            [](SceneType& self,
+               const Image<RGB>& image,
+               CompactTexelFormat format,
+               std::string name) {
+                return self.add_compact_texture(image, format, std::move(name));
+            },
+            py::arg("image"),
+            py::arg("format") = CompactTexelFormat::RGB8,
+            py::arg("name") = "",
+            "Add a spectral texture stored as compact RGB texels, from a linear RGB image")
 
         // =============================================================
         // Models
@@ -548,12 +762,16 @@ inline void bind_scene(py::module_& m)
 
         .def(
             "load_model",
-            [](SceneType& self,
-               const fs::path& file,
-               std::string name) { return self.load_model(file, std::move(name)); },
+            [](SceneType& self, const fs::path& file, std::string name, std::size_t lod_levels) {
+                return self.load_model(file,
+                                       std::move(name),
+                                       ModelLoader<TSpectral>::DEFAULT_POST_PROCESS_FLAGS,
+                                       lod_levels);
+            },
             py::arg("file"),
             py::arg("name") = "",
-            "Load a model from a file")
+            py::arg("lod_levels") = 0,
+            "Load a model from a file, optionally generating levels of detail for its meshes")
         .def("get_model", &SceneType::get_model, py::arg("name"), "Get a model handle by name")
         .def("delete_model", &SceneType::delete_model, py::arg("model_handle"))
         .def("set_model_name",
@@ -10,6 +10,8 @@
 #include "huira/core/spice_py.ipp"
 #include "huira/core/time_py.ipp"
 #include "huira/core/types_py.ipp"
+#include "huira/geometry/heightfield_mapping_py.ipp"
+#include "huira/geometry/particle_cloud_py.ipp"
 #include "huira/handles/assets/light_handle_py.ipp"
 #include "huira/handles/assets/model_handle_py.ipp"
 #include "huira/handles/assets/primitive_handle_py.ipp"
@@ -17,7 +19,9 @@
 #include "huira/handles/camera_handle_py.ipp"
 #include "huira/handles/geometry/ellipsoid_handle_py.ipp"
 #include "huira/handles/geometry/geometry_handle_py.ipp"
+#include "huira/handles/geometry/heightfield_handle_py.ipp"
 #include "huira/handles/geometry/mesh_handle_py.ipp"
+#include "huira/handles/geometry/particle_cloud_handle_py.ipp"
 #include "huira/handles/handle_py.ipp"
 #include "huira/handles/materials/bsdf_handle_py.ipp"
 #include "huira/handles/materials/material_handle_py.ipp"
@@ -26,15 +30,18 @@
 #include "huira/handles/scene/instance_handle_py.ipp"
 #include "huira/handles/scene/node_handle_py.ipp"
 #include "huira/handles/scene/root_frame_handle_py.ipp"
+#include "huira/handles/volumes/atmosphere_handle_py.ipp"
 #include "huira/handles/volumes/density_field_handle_py.ipp"
 #include "huira/handles/volumes/medium_handle_py.ipp"
 #include "huira/handles/volumes/phase_function_handle_py.ipp"
 #include "huira/images/fits_metadata_py.ipp"
 #include "huira/images/image_py.ipp"
+#include "huira/materials/phase_angle_table_py.ipp"
 #include "huira/render/frame_buffer_py.ipp"
 #include "huira/render/interaction_py.ipp"
 #include "huira/render/ray_py.ipp"
 #include "huira/render/renderer_py.ipp"
+#include "huira/render/surface_cache_py.ipp"
 #include "huira/scene/scene_py.ipp"
 #include "huira/scene/scene_view_py.ipp"
 #include "huira/units/units_py.ipp"
@@ -55,6 +62,8 @@ inline void bind_spectral(py::module_& m)
     huira::bind_geometry_handle<TSpectral>(m);
     huira::bind_mesh_handle<TSpectral>(m);
     huira::bind_ellipsoid_handle<TSpectral>(m);
+    huira::bind_heightfield_handle<TSpectral>(m);
+    huira::bind_particle_cloud_handle<TSpectral>(m);
 
     // --- Asset handles ---
     huira::bind_primitive_handle<TSpectral>(m);
@@ -76,6 +85,7 @@ inline void bind_spectral(py::module_& m)
     huira::bind_density_field_handle<TSpectral>(m);
     huira::bind_phase_function_handle<TSpectral>(m);
     huira::bind_medium_handle<TSpectral>(m);
+    huira::bind_atmosphere_handle<TSpectral>(m);
 
     // --- Images ---
     std::string img_name = "Image_" + m.attr("__name__").cast<std::string>();
@@ -92,6 +102,7 @@ inline void bind_spectral(py::module_& m)
     huira::bind_ray<TSpectral>(m);
     huira::bind_interaction<TSpectral>(m);
     huira::bind_scene_view<TSpectral>(m);
+    huira::bind_surface_caches<TSpectral>(m);
     huira::bind_renderer<TSpectral>(m);
 }
 
@@ -117,9 +128,14 @@ PYBIND11_MODULE(_huira, m)
 
     huira::bind_distortion_coefficients(m);
 
+    huira::bind_heightfield_mapping(m);
+    huira::bind_particle_shape(m);
+
     huira::bind_fits_metadata(m);
     huira::bind_common_images(m);
 
+    huira::bind_photometric_evaluation(m);
+
     huira::bind_texture_handle<float>(m, "TextureHandle_float");
     huira::bind_texture_handle<huira::Vec3<float>>(m, "TextureHandle_vec3");
 
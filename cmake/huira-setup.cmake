@@ -11,6 +11,16 @@ target_include_directories(huira
 
 target_compile_features(huira INTERFACE cxx_std_20)
 
+# SpectralBins arithmetic picks its SIMD width from the target flags, so opt in to host ISA. Only
+# for in-tree builds: an installed package must not pass the packager's host ISA to its consumers.
+if(HUIRA_NATIVE_ARCH)
+    if(MSVC)
+        target_compile_options(huira INTERFACE $<BUILD_INTERFACE:/arch:AVX2>)
+    else()
+        target_compile_options(huira INTERFACE $<BUILD_INTERFACE:-march=native>)
+    endif()
+endif()
+
 
 set(HUIRA_DATA_DIR_BUILD "${CMAKE_CURRENT_SOURCE_DIR}/data")
 set(HUIRA_DATA_DIR_INSTALL "${CMAKE_INSTALL_FULL_DATADIR}/huira/data")
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -18,8 +22,10 @@
 #include "huira/geometry/mesh.hpp"
 #include "huira/handles/assets/primitive_handle.hpp"
 #include "huira/handles/materials/material_handle.hpp"
+#include "huira/images/compact_texture.hpp"
 #include "huira/scene/frame_node.hpp"
 #include "huira/scene/instance.hpp"
+#include "huira/util/content_hash.hpp"
 
 namespace fs = std::filesystem;
 
@@ -44,9 +50,49 @@ class ModelLoader {
          const fs::path& file_path,
          std::string name,
          unsigned int post_process_flags = DEFAULT_POST_PROCESS_FLAGS,
+         std::size_t lod_levels = 0,
          std::function<TSpectral(RGB)> spectral_conversion = convert_rgb_to_spectral<TSpectral>);
 
+    static std::shared_ptr<Mesh<TSpectral>> load_mesh(
+        const fs::path& file_path,
+        unsigned int post_process_flags = DEFAULT_POST_PROCESS_FLAGS,
+        std::function<TSpectral(RGB)> spectral_conversion = convert_rgb_to_spectral<TSpectral>);
+
   private:
+    // A texture decoded ahead of registration with the scene
+    template <typename TPixel>
+    struct DecodedTexture {
+        Image<TPixel> image;
+        Image<float> alpha;
+
+        // Colour data kept as RGB, to be stored as a CompactTexture
+        std::optional<Image<RGB>> compact_rgb;
+        int compact_bit_depth = 8;
+
+        // ContentHasher digests of the texture and its alpha, for sharing identical textures
+        std::uint64_t content_hash = 0;
+        std::uint64_t alpha_hash = 0;
+    };
+
+    // A mesh converted ahead of registration with the scene
+    struct ConvertedMesh {
+        IndexBuffer indices;
+        VertexBuffer<TSpectral> vertices;
+        TangentBuffer tangent_buffer;
+
+        // ContentHasher digest of the buffers and level of detail count, for sharing identical
+        // meshes
+        std::uint64_t content_hash = 0;
+
+        // Built from the buffers by build_mesh_, unless an identical mesh is already in the scene.
+        // The buffers are kept until then, to be compared with that mesh.
+        std::shared_ptr<Mesh<TSpectral>> mesh;
+    };
+
+    template <typename TPixel>
+    using DecodedTextureMap =
+        std::unordered_map<std::string, std::optional<DecodedTexture<TPixel>>>;
+
     struct LoadContext {
         const aiScene* ai_scene;
         Model<TSpectral>* model;
@@ -57,6 +103,12 @@ class ModelLoader {
 
         std::function<TSpectral(RGB)> spectral_conversion;
 
+        // Levels of detail to generate for each new mesh
+        std::size_t lod_levels = 0;
+
+        // Set when spectral_conversion is linear, so colour textures can be stored compactly
+        std::optional<RGBSpectralBasis<TSpectral>> spectral_basis;
+
         // Maps ASSIMP mesh index to our Primitive pointer
         std::unordered_map<unsigned int, PrimitiveHandle<TSpectral>> primitive_map;
 
@@ -67,11 +119,28 @@ class ModelLoader {
         std::unordered_map<std::string, TextureHandle<TSpectral>> spectral_texture_cache;
         std::unordered_map<std::string, TextureHandle<float>> mono_texture_cache;
         std::unordered_map<std::string, TextureHandle<Vec3<float>>> vec3_texture_cache;
+
+        // Textures decoded up front by decode_textures_ (keyed by texture path), consumed as
+        // load_material_texture_ registers them
+        DecodedTextureMap<TSpectral> spectral_decoded;
+        DecodedTextureMap<float> mono_decoded;
+        DecodedTextureMap<Vec3<float>> vec3_decoded;
     };
 
     static void process_meshes_(LoadContext& ctx);
 
-    static PrimitiveHandle<TSpectral> convert_mesh_(const aiMesh* ai_mesh, LoadContext& ctx);
+    static ConvertedMesh convert_mesh_(const aiMesh* ai_mesh, const LoadContext& ctx);
+
+    static void build_mesh_(ConvertedMesh& converted, const LoadContext& ctx);
+
+    static PrimitiveHandle<TSpectral>
+    add_mesh_(const aiMesh* ai_mesh, ConvertedMesh& converted, LoadContext& ctx);
+
+    static void append_mesh_(const aiMesh* ai_mesh,
+                             const std::function<TSpectral(RGB)>& spectral_conversion,
+                             IndexBuffer& indices,
+                             VertexBuffer<TSpectral>& vertices,
+                             TangentBuffer& tangent_buffer);
 
     static void
     process_node_(const aiNode* ai_node, FrameNode<TSpectral>* parent_frame, LoadContext& ctx);
@@ -82,6 +151,14 @@ class ModelLoader {
 
     static void process_materials_(LoadContext& ctx);
 
+    static void decode_textures_(LoadContext& ctx);
+
+    template <typename TPixel>
+    static std::optional<DecodedTexture<TPixel>> decode_texture_(const std::string& tex_path_str,
+                                                                 const LoadContext& ctx,
+                                                                 bool read_alpha,
+                                                                 bool is_color_data);
+
     template <typename TPixel>
     static std::pair<std::optional<TextureHandle<TPixel>>, std::optional<TextureHandle<float>>>
     load_material_texture_(const aiMaterial* ai_mat,
@@ -92,6 +169,25 @@ class ModelLoader {
 
     template <typename TPixel>
     static auto& get_texture_cache_(LoadContext& ctx);
+
+    template <typename TPixel>
+    static auto& get_decoded_cache_(LoadContext& ctx);
+
+    template <typename TPixel>
+    static auto& get_texture_content_(LoadContext& ctx);
+
+    template <typename TAsset, typename TSame>
+    static std::shared_ptr<TAsset>
+    find_content_(const std::unordered_map<std::uint64_t, ContentEntry<TAsset>>& content_cache,
+                  std::uint64_t content_hash,
+                  TSame&& same);
+
+    template <typename TAsset, typename TSame, typename TMake>
+    static std::invoke_result_t<TMake>
+    share_content_(std::unordered_map<std::uint64_t, ContentEntry<TAsset>>& content_cache,
+                   std::uint64_t content_hash,
+                   TSame&& same,
+                   TMake&& make);
 };
 
 } // namespace huira
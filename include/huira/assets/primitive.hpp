@@ -7,6 +7,7 @@
 #include "huira/geometry/geometry.hpp"
 #include "huira/materials/material.hpp"
 #include "huira/scene/scene_object.hpp"
+#include "huira/volumes/atmosphere.hpp"
 #include "huira/volumes/medium.hpp"
 
 namespace huira {
@@ -25,6 +26,7 @@ class Primitive : public SceneObject<Primitive<TSpectral>> {
     std::shared_ptr<Geometry<TSpectral>> geometry;
     std::shared_ptr<Material<TSpectral>> material;
     std::shared_ptr<Medium<TSpectral>> medium;
+    std::shared_ptr<Atmosphere<TSpectral>> atmosphere; ///< Optional, centred on each instance
 
     std::string type() const override { return "Primitive"; }
 };
@@ -190,6 +190,7 @@ class CameraModel : public SceneObject<CameraModel<TSpectral>> {
 
     template <IsFloatingPoint TFloat>
     Vec3<TFloat> pixel_to_direction_(const Pixel& pixel) const;
+    Vec3<float> ray_direction_(const Pixel& pixel) const;
 
     Image<Vec3<float>> distortion_field_;
     void compute_distortion_field_();
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace huira {
+/**
+ * @brief An immutable array that keeps the memory it views alive.
+ *
+ * The memory is either a vector the SharedSpan took over or a range inside some other object,
+ * such as a MappedFile, that the SharedSpan holds a reference to. Copies share the same memory,
+ * and the data pointer never changes, so it can be handed to Embree as a shared buffer.
+ *
+ * @tparam T The element type
+ */
+template <typename T>
+class SharedSpan {
+  public:
+    SharedSpan() = default;
+
+    SharedSpan(std::vector<T> values)
+    {
+        auto owned = std::make_shared<const std::vector<T>>(std::move(values));
+        values_ = std::span<const T>(owned->data(), owned->size());
+        owner_ = std::move(owned);
+    }
+
+    SharedSpan(std::shared_ptr<const void> owner, std::span<const T> values)
+        : owner_{std::move(owner)}, values_{values}
+    {
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return values_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return values_.empty(); }
+    [[nodiscard]] const T* data() const noexcept { return values_.data(); }
+    [[nodiscard]] const T& operator[](std::size_t i) const { return values_[i]; }
+
+    [[nodiscard]] auto begin() const noexcept { return values_.begin(); }
+    [[nodiscard]] auto end() const noexcept { return values_.end(); }
+
+    [[nodiscard]] std::span<const T> span() const noexcept { return values_; }
+    operator std::span<const T>() const noexcept { return values_; }
+
+  private:
+    std::shared_ptr<const void> owner_;
+    std::span<const T> values_;
+};
+} // namespace huira
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+
+// Instruction set selection follows the compiler's target flags (e.g. -march=native, /arch:AVX2).
+// See the HUIRA_NATIVE_ARCH CMake option.
+#if defined(__AVX512F__)
+#define HUIRA_SIMD_AVX512 1
+#endif
+#if defined(__AVX__)
+#define HUIRA_SIMD_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HUIRA_SIMD_SSE 1
+#endif
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define HUIRA_SIMD_FMA 1
+#endif
+
+#if defined(HUIRA_SIMD_AVX512) || defined(HUIRA_SIMD_AVX) || defined(HUIRA_SIMD_SSE)
+#include <immintrin.h>
+#endif
+
+namespace huira::detail {
+/**
+ * @brief Element-wise operations supported by the SIMD kernels.
+ */
+enum class SimdOp { Add, Sub, Mul, Div, Min, Max };
+
+/**
+ * @brief Fixed-size float kernels used by SpectralBins.
+ *
+ * Each kernel processes N floats by walking down the widest available register (AVX-512, AVX,
+ * then SSE) and finishing with a scalar tail, so e.g. an 8-bin spectrum on an AVX-512 machine is
+ * still handled by a single AVX instruction. All loads and stores are unaligned. These must not
+ * be called during constant evaluation; SpectralBins falls back to scalar loops there.
+ */
+template <SimdOp Op, std::size_t N>
+void simd_binary(float* out, const float* a, const float* b) noexcept;
+
+template <SimdOp Op, std::size_t N>
+void simd_binary_scalar(float* out, const float* a, float s) noexcept;
+
+template <std::size_t N>
+void simd_fma(float* out, const float* a, const float* b, const float* c) noexcept;
+
+template <std::size_t N>
+void simd_fma_scalar(float* out, const float* a, float s, const float* c) noexcept;
+
+template <std::size_t N>
+float simd_sum(const float* a) noexcept;
+
+template <std::size_t N>
+float simd_dot(const float* a, const float* b) noexcept;
+
+template <std::size_t N>
+float simd_max(const float* a) noexcept;
+
+template <std::size_t N>
+float simd_min(const float* a) noexcept;
+} // namespace huira::detail
+
+#include "huira_impl/core/simd.ipp"
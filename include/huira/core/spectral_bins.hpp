@@ -125,6 +125,7 @@ class SpectralBins {
                               ///< not NaN, not infinite).
 
     SpectralBins sqrt() const;
+    SpectralBins exp() const;
 
     // Array-Array Arithmetic Operations
     constexpr SpectralBins& operator+=(const SpectralBins& other);
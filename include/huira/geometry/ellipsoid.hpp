@@ -32,6 +32,13 @@ class Ellipsoid : public Geometry<TSpectral> {
 
     [[nodiscard]] Vec3<float> radii() const { return radii_; }
 
+    static bool intersect_local(const Vec3<double>& radii,
+                                const Vec3<double>& origin,
+                                const Vec3<double>& direction,
+                                float t_min,
+                                float t_max,
+                                HitRecord& hit) noexcept;
+
   private:
     Vec3<float> radii_;
 
@@ -39,6 +46,30 @@ class Ellipsoid : public Geometry<TSpectral> {
 
     static void bounds_callback(const RTCBoundsFunctionArguments* args) noexcept;
     static void intersect_callback(const RTCIntersectFunctionNArguments* args) noexcept;
+    static void occluded_callback(const RTCOccludedFunctionNArguments* args) noexcept;
+
+    static bool solve_(const Vec3<double>& origin,
+                       const Vec3<double>& direction,
+                       const Vec3<double>& radii,
+                       double& t0,
+                       double& t1) noexcept;
+    static RTCHit make_hit_(const Vec3<double>& origin,
+                            const Vec3<double>& direction,
+                            const Vec3<double>& radii,
+                            double t,
+                            unsigned int geom_id,
+                            unsigned int prim_id,
+                            unsigned int inst_id) noexcept;
+
+    template <typename Accept>
+    static void for_each_crossing_(const Ellipsoid<TSpectral>* ellipsoid,
+                                   const int* valid,
+                                   RTCRayN* ray,
+                                   unsigned int N,
+                                   unsigned int geom_id,
+                                   unsigned int prim_id,
+                                   unsigned int inst_id,
+                                   Accept&& accept) noexcept;
 };
 
 } // namespace huira
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
 #include "huira/geometry/ray.hpp"
 #include "huira/render/interaction.hpp"
 #include "huira/scene/embree_device.hpp"
@@ -15,6 +17,18 @@ class Scene;
 template <IsSpectral TSpectral>
 class SceneView;
 
+/**
+ * @brief A geometry's BLAS as handed to one SceneView, with everything the BLAS reads.
+ *
+ * Each SceneView holds the builds it traces for as long as it lives, so a geometry may be edited,
+ * or build differently for a later view, without touching what an earlier view traces.
+ */
+struct GeometryBuild {
+    virtual ~GeometryBuild() = default;
+
+    UniqueRTCScene blas = nullptr;
+};
+
 template <IsSpectral TSpectral>
 class Geometry : public SceneObject<Geometry<TSpectral>> {
   public:
@@ -38,6 +52,32 @@ class Geometry : public SceneObject<Geometry<TSpectral>> {
     mutable UniqueRTCScene blas_ = nullptr;
     virtual void build_blas_() const = 0;
 
+    // The build a SceneView about to be built traces, by default sharing the cached BLAS. Gets
+    // the camera position in the geometry's frame for each instance, and the angle one pixel
+    // subtends, for geometry with levels of detail to choose them for the view:
+    [[nodiscard]] virtual std::shared_ptr<const GeometryBuild>
+    build_for_view_(const std::vector<Vec3<float>>& /*eyes*/, float /*pixel_angle*/) const
+    {
+        RTCScene scene = blas();
+        rtcRetainScene(scene);
+        auto build = std::make_shared<GeometryBuild>();
+        build->blas.reset(scene);
+        return build;
+    }
+
+    // Resolve hits on a build made by build_for_view_, by default as if on the geometry itself:
+    virtual void compute_surface_interaction_(const GeometryBuild& /*build*/,
+                                              const HitRecord& hit,
+                                              Interaction<TSpectral>& isect) const
+    {
+        compute_surface_interaction(hit, isect);
+    }
+    [[nodiscard]] virtual Vec2<float> compute_uv_(const GeometryBuild& /*build*/,
+                                                  const HitRecord& hit) const
+    {
+        return compute_uv(hit);
+    }
+
     void set_device(std::shared_ptr<EmbreeDevice> device) noexcept { device_ = device; }
 
     [[nodiscard]] virtual RTCScene blas() const
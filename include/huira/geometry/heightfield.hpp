@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "embree4/rtcore.h"
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/geometry/geometry.hpp"
+#include "huira/units/units.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief How the samples of an elevation raster are placed in space.
+ *
+ * Planar rasters lie on the local xy plane, centred on the origin with columns along +x, rows
+ * along -y and elevation along +z. Equirectangular rasters cover a longitude/latitude box on a
+ * sphere of the given radius, in the body-fixed frame, with row 0 at the northern edge.
+ */
+struct HeightfieldMapping {
+    enum class Projection { Planar, Equirectangular };
+
+    Projection projection = Projection::Planar;
+    double sample_spacing = 1.0; // Metres between samples, planar only
+    double body_radius = 0.0;    // Metres, equirectangular only
+    double lon_min = 0.0;        // Radians, equirectangular only
+    double lon_max = 0.0;
+    double lat_min = 0.0;
+    double lat_max = 0.0;
+
+    static HeightfieldMapping planar(const units::Meter& sample_spacing);
+    static HeightfieldMapping equirectangular(const units::Meter& body_radius,
+                                              const units::Degree& lon_min,
+                                              const units::Degree& lon_max,
+                                              const units::Degree& lat_min,
+                                              const units::Degree& lat_max);
+};
+
+/**
+ * @brief Terrain given as a raster of elevations, such as a DEM for landing or terrain relative
+ * navigation.
+ *
+ * The raster is kept as one float per sample and never expanded into mesh vertices. Instead it
+ * is split into square tiles of TILE_CELLS cells, each handed to Embree as a grid primitive, which
+ * Embree triangulates on the fly from a bare vertex lattice. Every tile also gets a skirt hanging
+ * below its edges, which hides the cracks between neighbouring tiles of different detail.
+ *
+ * Each tile is built at the coarsest level of detail whose cells still project to at most
+ * lod_pixels() pixels, judged from the camera of the SceneView being built. Level L keeps every
+ * 2^L-th sample. Every view traces its own build, with the levels it was built at, so the
+ * heightfield itself never changes; a view choosing the same levels as the last one reuses its
+ * build. Shading normals always come from the full resolution raster, so coarse tiles keep their
+ * shading detail.
+ *
+ * @tparam TSpectral The spectral type of the scene
+ */
+template <IsSpectral TSpectral>
+class Heightfield : public Geometry<TSpectral> {
+  public:
+    static constexpr std::size_t TILE_CELLS = 128;
+
+    Heightfield(std::size_t width,
+                std::size_t height,
+                std::vector<float> elevations,
+                const HeightfieldMapping& mapping);
+    ~Heightfield() override = default;
+
+    Heightfield(const Heightfield&) = delete;
+    Heightfield& operator=(const Heightfield&) = delete;
+
+    Heightfield(Heightfield&&) noexcept = default;
+    Heightfield& operator=(Heightfield&&) noexcept = default;
+
+    // Geometry overrides
+    void compute_surface_interaction(const HitRecord& hit,
+                                     Interaction<TSpectral>& isect) const override;
+    Vec2<float> compute_uv(const HitRecord& hit) const override;
+
+    std::string type() const override { return "Heightfield"; }
+
+    [[nodiscard]] std::size_t width() const noexcept { return width_; }
+    [[nodiscard]] std::size_t height() const noexcept { return height_; }
+    [[nodiscard]] const HeightfieldMapping& mapping() const noexcept { return mapping_; }
+    [[nodiscard]] float elevation(std::size_t col, std::size_t row) const
+    {
+        return elevations_[row * width_ + col];
+    }
+    [[nodiscard]] std::size_t tile_count() const noexcept { return tiles_.size(); }
+    [[nodiscard]] std::vector<std::uint8_t> select_tile_levels(const std::vector<Vec3<float>>& eyes,
+                                                               float pixel_angle) const;
+
+    void set_lod_pixels(float lod_pixels);
+    [[nodiscard]] float lod_pixels() const noexcept { return lod_pixels_; }
+
+    [[nodiscard]] Vec3<float> position(double col, double row) const;
+
+    static std::vector<float> read_raster(const fs::path& path,
+                                          std::size_t& width,
+                                          std::size_t& height,
+                                          float height_scale = 1.f,
+                                          float height_offset = 0.f);
+    static std::vector<float> read_raw(const fs::path& path,
+                                       std::size_t width,
+                                       std::size_t height,
+                                       float height_scale = 1.f,
+                                       float height_offset = 0.f);
+
+  private:
+    struct Tile {
+        std::size_t col0;
+        std::size_t row0;
+        std::size_t cols; // Cells, not samples
+        std::size_t rows;
+        Vec3<float> center;
+        float radius;
+        float cell_size;
+        float skirt_depth;
+    };
+
+    // A tile as handed to Embree, indexed by the grid's primitive ID:
+    struct BuiltTile {
+        std::size_t step;
+        std::size_t samples_x;
+        std::size_t samples_y;
+    };
+
+    // A BLAS built for SceneViews, with the level each tile was built at and the tiles as built:
+    struct Build : GeometryBuild {
+        std::vector<std::uint8_t> levels;
+        std::vector<BuiltTile> tiles;
+    };
+
+    // The cell of a built level containing a hit, and the hit's position within it:
+    struct LevelPatch {
+        std::size_t c0;
+        std::size_t c1;
+        std::size_t r0;
+        std::size_t r1;
+        double fx;
+        double fy;
+
+        [[nodiscard]] double col() const
+        {
+            return static_cast<double>(c0) + fx * static_cast<double>(c1 - c0);
+        }
+        [[nodiscard]] double row() const
+        {
+            return static_cast<double>(r0) + fy * static_cast<double>(r1 - r0);
+        }
+    };
+
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<float> elevations_;
+    HeightfieldMapping mapping_;
+    float lod_pixels_ = 1.f;
+
+    std::vector<Tile> tiles_;
+    Build full_resolution_; // Every tile at level 0, with no BLAS of its own
+
+    // The last build handed to a SceneView, reused while views keep choosing its levels:
+    mutable std::shared_ptr<const Build> last_build_;
+
+    void build_blas_() const override;
+    [[nodiscard]] std::shared_ptr<const GeometryBuild>
+    build_for_view_(const std::vector<Vec3<float>>& eyes, float pixel_angle) const override;
+    void compute_surface_interaction_(const GeometryBuild& build,
+                                      const HitRecord& hit,
+                                      Interaction<TSpectral>& isect) const override;
+    [[nodiscard]] Vec2<float> compute_uv_(const GeometryBuild& build,
+                                          const HitRecord& hit) const override;
+
+    [[nodiscard]] std::vector<BuiltTile>
+    built_tiles_(const std::vector<std::uint8_t>& levels) const;
+    [[nodiscard]] UniqueRTCScene build_scene_(const std::vector<BuiltTile>& built_tiles) const;
+
+    [[nodiscard]] Vec3<double> place_(double col, double row, double elevation) const;
+    [[nodiscard]] double elevation_at_(double col, double row) const;
+    [[nodiscard]] LevelPatch patch_(const std::vector<BuiltTile>& built_tiles,
+                                    const HitRecord& hit) const;
+    [[nodiscard]] std::uint8_t max_level_(const Tile& tile) const;
+
+    static std::size_t
+    sample_(std::size_t start, std::size_t cells, std::size_t step, std::size_t k) noexcept;
+};
+} // namespace huira
+
+#include "huira_impl/geometry/heightfield.ipp"
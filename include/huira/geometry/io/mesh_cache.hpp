@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/geometry/mesh.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Fixed header at the start of a mesh cache file.
+ */
+struct MeshCacheHeader {
+    char magic[8];             ///< "HUIRAMSH"
+    std::uint32_t version;     ///< File format version
+    std::uint32_t albedo_bins; ///< Floats per albedo value
+    std::uint32_t vec3_bytes;  ///< sizeof(Vec3<float>) of the writer
+    std::uint32_t level_count; ///< Levels stored, the full resolution mesh first
+    std::uint64_t source_key;  ///< Identifies what the cache was made from, see mesh_cache_key()
+};
+
+/**
+ * @brief Where one level of detail lies in a mesh cache file.
+ *
+ * Offsets are in bytes from the start of the file, and each is a multiple of
+ * MeshCacheLayout::ALIGNMENT. Positions are followed by one element of padding, albedo_count is
+ * zero when the single albedo at uniform_albedo_offset applies to every vertex, and
+ * tangent_count is either zero or vertex_count.
+ */
+struct MeshCacheLevel {
+    std::uint64_t index_count;
+    std::uint64_t vertex_count;
+    std::uint64_t albedo_count;
+    std::uint64_t tangent_count;
+    std::uint64_t index_offset;
+    std::uint64_t position_offset;
+    std::uint64_t normal_offset;
+    std::uint64_t uv_offset;
+    std::uint64_t albedo_offset;
+    std::uint64_t uniform_albedo_offset;
+    std::uint64_t tangent_offset;
+    float uv_origin[2];
+    float uv_step[2];
+    float error;
+    std::uint32_t reserved;
+};
+
+/**
+ * @brief Layout of a mesh cache file: a Mesh and its levels of detail, ready to be mapped.
+ *
+ * The MeshCacheHeader is followed by one MeshCacheLevel per level, then by the raw buffers of
+ * every level exactly as Mesh and VertexStreams hold them, in native byte order. Every buffer
+ * starts on an ALIGNMENT boundary, so read_mesh_cache() can map the file and point the mesh, and
+ * through it Embree, straight at its contents without copying or parsing anything. The file is
+ * only meant to be read on the kind of machine that wrote it.
+ */
+struct MeshCacheLayout {
+    static constexpr char MAGIC[8] = {'H', 'U', 'I', 'R', 'A', 'M', 'S', 'H'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint64_t ALIGNMENT = 64;
+};
+
+std::uint64_t mesh_cache_key(const fs::path& source, std::uint64_t options = 0);
+
+template <IsSpectral TSpectral>
+void write_mesh_cache(const fs::path& filepath,
+                      const Mesh<TSpectral>& mesh,
+                      std::uint64_t source_key = 0);
+
+template <IsSpectral TSpectral>
+bool mesh_cache_matches(const fs::path& filepath, std::uint64_t source_key);
+
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> read_mesh_cache(const fs::path& filepath);
+} // namespace huira
+
+#include "huira_impl/geometry/io/mesh_cache.ipp"
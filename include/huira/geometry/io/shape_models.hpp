@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/geometry/mesh.hpp"
+#include "huira/geometry/vertex.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Vertices and triangles of a small-body shape model, as read from the file.
+ *
+ * Positions are kept in double precision and in the file's units (kilometres for both DSK and
+ * ICQ), so that the model can be centred before it is converted to a float Mesh.
+ */
+struct ShapeModelBuffers {
+    std::vector<Vec3<double>> positions;
+    IndexBuffer indices;
+};
+
+ShapeModelBuffers read_dsk_plates(const fs::path& filepath);
+ShapeModelBuffers read_icq_plates(const fs::path& filepath);
+
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> make_shape_model_mesh(const ShapeModelBuffers& buffers,
+                                                       Vec3<double>& center,
+                                                       double units_to_meters = 1000.0);
+
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> read_dsk(const fs::path& filepath, Vec3<double>& center);
+
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> read_icq(const fs::path& filepath, Vec3<double>& center);
+} // namespace huira
+
+#include "huira_impl/geometry/io/shape_models.ipp"
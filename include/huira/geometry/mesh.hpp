@@ -1,15 +1,20 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "embree4/rtcore.h"
 #include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/shared_span.hpp"
 #include "huira/core/types.hpp"
 #include "huira/geometry/geometry.hpp"
 #include "huira/geometry/ray.hpp"
 #include "huira/geometry/vertex.hpp"
+#include "huira/geometry/vertex_streams.hpp"
 #include "huira/materials/material.hpp"
 #include "huira/render/interaction.hpp"
 
@@ -18,25 +23,42 @@ namespace huira {
  * @brief Represents a 3D triangle mesh with vertex and index data.
  *
  * Mesh stores geometry data as indexed triangles, with each triangle defined
- * by three indices into a vertex buffer. The vertex buffer contains positions,
- * normals, and spectral properties. Meshes are movable but not copyable.
+ * by three indices into its vertices. Vertices are given as a VertexBuffer but
+ * kept as compact VertexStreams, one stream per attribute, with normals and uvs
+ * quantised and albedo stored only when it varies. All buffers are immutable
+ * SharedSpans, which lets a mesh read by read_mesh_cache() trace straight out
+ * of the mapped file. Meshes are movable but not copyable.
  *
  * Each Mesh owns an Embree BLAS (bottom-level acceleration structure) built
  * over its triangle data. The BLAS is constructed lazily on first access via
- * blas(), using shared buffers (zero-copy). The RTCDevice must be assigned
- * (via set_device()) before the BLAS can be built — this is handled
- * automatically by Scene::add_mesh().
+ * blas(), sharing the index buffer and position stream (zero-copy). The
+ * RTCDevice must be assigned (via set_device()) before the BLAS can be
+ * built — this is handled automatically by Scene::add_mesh().
+ *
+ * A Mesh may also carry a chain of coarser levels of detail, made by generate_lods() or supplied
+ * with add_lod(). Each SceneView traces the coarsest level whose error projects to at most
+ * lod_pixel_error() pixels at the mesh's nearest instance, and keeps that level's BLAS and
+ * buffers for as long as it lives, so neither later views nor edits to the levels change what it
+ * traces. Switching to a coarser level than the previous view's, reported by lod_level(), waits
+ * until it fits with a margin set by lod_hysteresis(), so that a slowly moving camera does not
+ * flip between two levels from frame to frame. The buffer accessors always return the full
+ * resolution mesh, and so do hits resolved on the mesh itself.
  *
  * @tparam TSpectral The spectral representation type.
  */
 template <IsSpectral TSpectral>
 class Mesh : public Geometry<TSpectral> {
   public:
+    static constexpr std::size_t MIN_LOD_TRIANGLES = 64;
+
     Mesh() = default;
-    Mesh(IndexBuffer index_buffer, VertexBuffer<TSpectral> vertex_buffer);
+    Mesh(IndexBuffer index_buffer, const VertexBuffer<TSpectral>& vertex_buffer);
     Mesh(IndexBuffer index_buffer,
-         VertexBuffer<TSpectral> vertex_buffer,
+         const VertexBuffer<TSpectral>& vertex_buffer,
          TangentBuffer tangent_buffer);
+    Mesh(SharedSpan<std::uint32_t> index_buffer,
+         VertexStreams<TSpectral> vertices,
+         SharedSpan<Tangent> tangent_buffer);
     ~Mesh() override = default;
 
     Mesh(const Mesh&) = delete;
@@ -50,12 +72,40 @@ class Mesh : public Geometry<TSpectral> {
     std::size_t vertex_count() const noexcept;
     std::size_t triangle_count() const noexcept;
 
-    [[nodiscard]] const IndexBuffer& index_buffer() const noexcept;
-    [[nodiscard]] const VertexBuffer<TSpectral>& vertex_buffer() const noexcept;
-    [[nodiscard]] const TangentBuffer& tangent_buffer() const noexcept;
+    [[nodiscard]] std::span<const std::uint32_t> index_buffer() const noexcept;
+    [[nodiscard]] const VertexStreams<TSpectral>& vertex_streams() const noexcept;
+    [[nodiscard]] VertexBuffer<TSpectral> vertex_buffer() const;
+    [[nodiscard]] std::span<const Tangent> tangent_buffer() const noexcept;
 
     [[nodiscard]] bool has_tangents() const noexcept { return !tangent_buffer_.empty(); }
 
+    // Levels of detail; level 0 is the full resolution mesh
+    void generate_lods(std::size_t max_levels = 6, float reduction = 0.25f);
+    void add_lod(IndexBuffer index_buffer,
+                 const VertexBuffer<TSpectral>& vertex_buffer,
+                 TangentBuffer tangent_buffer,
+                 float error);
+    void add_lod(SharedSpan<std::uint32_t> index_buffer,
+                 VertexStreams<TSpectral> vertices,
+                 SharedSpan<Tangent> tangent_buffer,
+                 float error);
+    void clear_lods();
+
+    [[nodiscard]] std::size_t lod_count() const noexcept { return lods_.size() + 1; }
+    [[nodiscard]] std::size_t lod_level() const noexcept { return lod_level_; }
+    [[nodiscard]] std::span<const std::uint32_t> lod_index_buffer(std::size_t level) const;
+    [[nodiscard]] const VertexStreams<TSpectral>& lod_vertex_streams(std::size_t level) const;
+    [[nodiscard]] std::span<const Tangent> lod_tangent_buffer(std::size_t level) const;
+    [[nodiscard]] float lod_error(std::size_t level) const;
+    [[nodiscard]] std::size_t select_lod_level(const std::vector<Vec3<float>>& eyes,
+                                               float pixel_angle,
+                                               std::size_t current = 0) const;
+
+    void set_lod_pixel_error(float pixels);
+    [[nodiscard]] float lod_pixel_error() const noexcept { return lod_pixel_error_; }
+    void set_lod_hysteresis(float hysteresis);
+    [[nodiscard]] float lod_hysteresis() const noexcept { return lod_hysteresis_; }
+
     // Geometry overrides
     void compute_surface_interaction(const HitRecord& hit,
                                      Interaction<TSpectral>& isect) const override;
@@ -63,11 +113,55 @@ class Mesh : public Geometry<TSpectral> {
     std::string type() const override { return "Mesh"; }
 
   private:
+    struct LodLevel {
+        SharedSpan<std::uint32_t> index_buffer;
+        VertexStreams<TSpectral> vertices;
+        SharedSpan<Tangent> tangent_buffer;
+        float error; // Estimated largest distance from the full resolution surface
+    };
+
+    // A level's BLAS as handed to SceneViews, with the buffers it shares:
+    struct Build : GeometryBuild {
+        std::size_t level;
+        LodLevel lod;
+    };
+
     void build_blas_() const override;
+    [[nodiscard]] std::shared_ptr<const GeometryBuild>
+    build_for_view_(const std::vector<Vec3<float>>& eyes, float pixel_angle) const override;
+    void compute_surface_interaction_(const GeometryBuild& build,
+                                      const HitRecord& hit,
+                                      Interaction<TSpectral>& isect) const override;
+    [[nodiscard]] Vec2<float> compute_uv_(const GeometryBuild& build,
+                                          const HitRecord& hit) const override;
+
+    [[nodiscard]] LodLevel lod_(std::size_t level) const;
+    [[nodiscard]] UniqueRTCScene build_scene_(const LodLevel& lod, std::size_t level) const;
+    static void surface_interaction_(std::span<const std::uint32_t> indices,
+                                     const VertexStreams<TSpectral>& vertices,
+                                     std::span<const Tangent> tangents,
+                                     const HitRecord& hit,
+                                     Interaction<TSpectral>& isect);
+    [[nodiscard]] static Vec2<float> uv_(std::span<const std::uint32_t> indices,
+                                         const VertexStreams<TSpectral>& vertices,
+                                         const HitRecord& hit);
+    void update_lod_bounds_();
+
+    SharedSpan<std::uint32_t> index_buffer_;
+    VertexStreams<TSpectral> vertices_;
+    SharedSpan<Tangent> tangent_buffer_;
+
+    std::vector<LodLevel> lods_; // Level L is lods_[L - 1]
+    float lod_pixel_error_ = 1.f;
+    float lod_hysteresis_ = 0.25f;
+    Vec3<float> lod_center_{0.f};
+    float lod_radius_ = 0.f;
+
+    // The level chosen for the latest SceneView, which the hysteresis is measured from:
+    mutable std::size_t lod_level_ = 0;
 
-    IndexBuffer index_buffer_;
-    VertexBuffer<TSpectral> vertex_buffer_;
-    TangentBuffer tangent_buffer_;
+    // Each level's build, kept alive by the SceneViews tracing it:
+    mutable std::vector<std::weak_ptr<const Build>> builds_;
 };
 
 } // namespace huira
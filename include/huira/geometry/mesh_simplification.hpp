@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "huira/core/types.hpp"
+#include "huira/geometry/vertex.hpp"
+
+namespace huira {
+/**
+ * @brief A triangle mesh reduced by simplify_mesh().
+ */
+struct SimplifiedMesh {
+    IndexBuffer index_buffer;
+
+    // The input vertex behind each output vertex, in increasing order:
+    std::vector<std::uint32_t> vertices;
+
+    // Estimated largest distance of the simplified surface from the input, in mesh units:
+    float error = 0.f;
+};
+
+SimplifiedMesh simplify_mesh(std::span<const std::uint32_t> index_buffer,
+                             std::span<const Vec3<float>> positions,
+                             std::size_t target_triangles);
+} // namespace huira
+
+#include "huira_impl/geometry/mesh_simplification.ipp"
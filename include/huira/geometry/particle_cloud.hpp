@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "embree4/rtcore.h"
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/geometry/geometry.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief The primitive each particle of a ParticleCloud is drawn as.
+ *
+ * Spheres are shaded as spheres. Discs always face the ray, which is cheaper to intersect and
+ * suits particles far below a pixel, where their shape cannot be resolved anyway.
+ */
+enum class ParticleShape { Sphere, Disc };
+
+/**
+ * @brief A cloud of tiny bodies, such as dust, ejecta, ring particles or debris.
+ *
+ * Each particle is a single Embree point primitive (RTC_GEOMETRY_TYPE_SPHERE_POINT or
+ * RTC_GEOMETRY_TYPE_DISC_POINT) with its own position, radius and albedo, so a cloud of millions
+ * of particles costs one BLAS over points rather than one instance per body. The points are kept
+ * in the (x, y, z, radius) layout Embree reads, and handed to it without copying.
+ *
+ * Particles may move during the exposure: add_time_step() gives their positions at further times,
+ * evenly spaced across the exposure, and Embree blurs between them. A hit is placed on the
+ * particle where it was at the hit's time. Each SceneView keeps the time steps it traces, so
+ * motion may be changed while earlier views are still in use. Particles carry no texture
+ * coordinates, so their albedo comes from the per-particle values and the material alone.
+ *
+ * @tparam TSpectral The spectral type of the scene
+ */
+template <IsSpectral TSpectral>
+class ParticleCloud : public Geometry<TSpectral> {
+  public:
+    ParticleCloud(std::vector<Vec4<float>> points,
+                  std::vector<TSpectral> albedos = {},
+                  ParticleShape shape = ParticleShape::Sphere);
+    ParticleCloud(const std::vector<Vec3<float>>& positions,
+                  const std::vector<float>& radii,
+                  std::vector<TSpectral> albedos = {},
+                  ParticleShape shape = ParticleShape::Sphere);
+    ~ParticleCloud() override = default;
+
+    ParticleCloud(const ParticleCloud&) = delete;
+    ParticleCloud& operator=(const ParticleCloud&) = delete;
+
+    ParticleCloud(ParticleCloud&&) noexcept = default;
+    ParticleCloud& operator=(ParticleCloud&&) noexcept = default;
+
+    // Geometry overrides
+    void compute_surface_interaction(const HitRecord& hit,
+                                     Interaction<TSpectral>& isect) const override;
+    Vec2<float> compute_uv(const HitRecord& hit) const override;
+
+    std::string type() const override { return "ParticleCloud"; }
+
+    [[nodiscard]] std::size_t size() const noexcept { return time_steps_[0]->size(); }
+    [[nodiscard]] ParticleShape shape() const noexcept { return shape_; }
+    [[nodiscard]] std::size_t time_step_count() const noexcept { return time_steps_.size(); }
+
+    [[nodiscard]] Vec3<float> position(std::size_t i, std::size_t time_step = 0) const
+    {
+        return Vec3<float>{(*time_steps_[time_step])[i]};
+    }
+    [[nodiscard]] Vec3<float> position_at(std::size_t i, float time) const;
+    [[nodiscard]] float radius(std::size_t i) const { return (*time_steps_[0])[i].w; }
+    [[nodiscard]] const TSpectral& albedo(std::size_t i) const
+    {
+        return albedos_.size() == 1 ? albedos_[0] : albedos_[i];
+    }
+    [[nodiscard]] bool has_particle_albedo() const noexcept { return albedos_.size() > 1; }
+
+    void add_time_step(const std::vector<Vec3<float>>& positions);
+    void clear_motion();
+
+    static std::vector<Vec4<float>> read_raw(const fs::path& path);
+
+  private:
+    using Points = std::vector<Vec4<float>>; // (x, y, z, radius) per particle
+    using TimeSteps = std::vector<std::shared_ptr<const Points>>;
+
+    // The cached BLAS as handed to a SceneView, with the time steps it was built from:
+    struct Build : GeometryBuild {
+        TimeSteps time_steps;
+    };
+
+    TimeSteps time_steps_;
+    std::vector<TSpectral> albedos_; // One per particle, or one for all
+    ParticleShape shape_;
+
+    void build_blas_() const override;
+    [[nodiscard]] std::shared_ptr<const GeometryBuild>
+    build_for_view_(const std::vector<Vec3<float>>& eyes, float pixel_angle) const override;
+    void compute_surface_interaction_(const GeometryBuild& build,
+                                      const HitRecord& hit,
+                                      Interaction<TSpectral>& isect) const override;
+
+    void surface_interaction_(const TimeSteps& time_steps,
+                              const HitRecord& hit,
+                              Interaction<TSpectral>& isect) const;
+    static Vec3<float> position_at_(const TimeSteps& time_steps, std::size_t i, float time);
+
+    static std::vector<Vec4<float>> pack_(const std::vector<Vec3<float>>& positions,
+                                          const std::vector<float>& radii);
+};
+} // namespace huira
+
+#include "huira_impl/geometry/particle_cloud.ipp"
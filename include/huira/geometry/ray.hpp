@@ -29,10 +29,46 @@ class Ray {
     // Evaluate ray at parameter t: origin + t * direction
     [[nodiscard]] Vec3<float> at(float t) const noexcept { return origin_ + t * direction_; }
 
+    // Ray differentials: the rays through the neighbouring pixels in x and y, used to estimate the
+    // texture footprint at a hit. Only camera rays carry them.
+    void set_differentials(const Vec3<float>& rx_origin,
+                           const Vec3<float>& rx_direction,
+                           const Vec3<float>& ry_origin,
+                           const Vec3<float>& ry_direction) noexcept
+    {
+        rx_origin_ = rx_origin;
+        rx_direction_ = rx_direction;
+        ry_origin_ = ry_origin;
+        ry_direction_ = ry_direction;
+        has_differentials_ = true;
+    }
+
+    // Shrink the differentials when several samples are taken per pixel, so each sample filters
+    // over its share of the pixel:
+    void scale_differentials(float s) noexcept
+    {
+        rx_origin_ = origin_ + (rx_origin_ - origin_) * s;
+        ry_origin_ = origin_ + (ry_origin_ - origin_) * s;
+        rx_direction_ = direction_ + (rx_direction_ - direction_) * s;
+        ry_direction_ = direction_ + (ry_direction_ - direction_) * s;
+    }
+
+    [[nodiscard]] bool has_differentials() const noexcept { return has_differentials_; }
+    [[nodiscard]] const Vec3<float>& rx_origin() const noexcept { return rx_origin_; }
+    [[nodiscard]] const Vec3<float>& rx_direction() const noexcept { return rx_direction_; }
+    [[nodiscard]] const Vec3<float>& ry_origin() const noexcept { return ry_origin_; }
+    [[nodiscard]] const Vec3<float>& ry_direction() const noexcept { return ry_direction_; }
+
   private:
     Vec3<float> origin_{0, 0, 0};
     Vec3<float> direction_{0, 0, -1};
     Vec3<float> reciprocal_direction_{0, 0, -1};
+
+    bool has_differentials_ = false;
+    Vec3<float> rx_origin_{0, 0, 0};
+    Vec3<float> rx_direction_{0, 0, -1};
+    Vec3<float> ry_origin_{0, 0, 0};
+    Vec3<float> ry_direction_{0, 0, -1};
 };
 
 struct HitRecord {
@@ -43,6 +79,7 @@ struct HitRecord {
     unsigned int geom_id = RTC_INVALID_GEOMETRY_ID;   ///< Geometry ID in BLAS
     unsigned int prim_id = 0;                         ///< Triangle index
     Vec3<float> Ng{};                                 ///< Geometric face normal (unnormalized)
+    float time = 0.f;                                 ///< Ray time across the exposure, 0 to 1
 
     [[nodiscard]] bool hit() const noexcept { return inst_id != RTC_INVALID_GEOMETRY_ID; }
 };
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/shared_span.hpp"
+#include "huira/core/types.hpp"
+#include "huira/geometry/vertex.hpp"
+
+namespace huira {
+/**
+ * @brief A unit vector folded onto an octahedron and stored as two 16-bit signed integers.
+ */
+struct OctNormal {
+    std::int16_t x = 0;
+    std::int16_t y = 0;
+};
+
+OctNormal encode_oct_normal(const Vec3<float>& normal);
+Vec3<float> decode_oct_normal(OctNormal encoded);
+
+/**
+ * @brief A texture coordinate stored as two 16-bit fractions of a mesh's uv bounding box.
+ */
+struct QuantizedUV {
+    std::uint16_t u = 0;
+    std::uint16_t v = 0;
+};
+
+/**
+ * @brief Mesh vertex attributes stored as one compact stream per attribute.
+ *
+ * Positions are kept as full floats, since Embree traces them directly. Normals are
+ * octahedron-encoded into 4 bytes and uvs quantised to 16 bits over their bounding box, which
+ * keeps them within about 0.005 degrees and 1/65535 of the uv extent respectively. Per-vertex
+ * albedo is only stored when the vertices disagree; otherwise a single value stands for all of
+ * them. Hit resolution then reads just the streams it needs, and an 8-bin spectral vertex shrinks
+ * from 64 bytes to 20.
+ *
+ * The streams are immutable SharedSpans, so copies are cheap and the streams may live in a
+ * mapped file (see read_mesh_cache()).
+ *
+ * @tparam TSpectral The spectral representation type.
+ */
+template <IsSpectral TSpectral>
+class VertexStreams {
+  public:
+    VertexStreams() = default;
+    explicit VertexStreams(const VertexBuffer<TSpectral>& vertices);
+    VertexStreams(SharedSpan<Vec3<float>> padded_positions,
+                  SharedSpan<OctNormal> normals,
+                  SharedSpan<QuantizedUV> uvs,
+                  SharedSpan<TSpectral> albedos,
+                  Vec2<float> uv_offset,
+                  Vec2<float> uv_scale,
+                  const TSpectral& uniform_albedo);
+
+    [[nodiscard]] std::size_t size() const noexcept { return normals_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return normals_.empty(); }
+
+    [[nodiscard]] const Vec3<float>& position(std::size_t i) const { return positions_[i]; }
+    [[nodiscard]] Vec3<float> normal(std::size_t i) const { return decode_oct_normal(normals_[i]); }
+    [[nodiscard]] Vec2<float> uv(std::size_t i) const;
+    [[nodiscard]] const TSpectral& albedo(std::size_t i) const
+    {
+        return albedos_.empty() ? uniform_albedo_ : albedos_[i];
+    }
+
+    [[nodiscard]] bool has_vertex_albedo() const noexcept { return !albedos_.empty(); }
+
+    // Followed in memory by padding, so that Embree can read the last position with a 16-byte
+    // load when sharing the buffer:
+    [[nodiscard]] std::span<const Vec3<float>> positions() const noexcept
+    {
+        return {positions_.data(), size()};
+    }
+
+    // The encoded streams, as stored:
+    [[nodiscard]] std::span<const OctNormal> encoded_normals() const noexcept { return normals_; }
+    [[nodiscard]] std::span<const QuantizedUV> encoded_uvs() const noexcept { return uvs_; }
+    [[nodiscard]] std::span<const TSpectral> vertex_albedos() const noexcept { return albedos_; }
+    [[nodiscard]] const Vec2<float>& uv_offset() const noexcept { return uv_offset_; }
+    [[nodiscard]] const Vec2<float>& uv_scale() const noexcept { return uv_scale_; }
+    [[nodiscard]] const TSpectral& uniform_albedo() const noexcept { return uniform_albedo_; }
+
+    [[nodiscard]] Vertex<TSpectral> vertex(std::size_t i) const;
+    [[nodiscard]] VertexBuffer<TSpectral> unpack() const;
+    [[nodiscard]] VertexStreams subset(const std::vector<std::uint32_t>& indices) const;
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept;
+
+  private:
+    SharedSpan<Vec3<float>> positions_; // One more than size(), the last being padding
+    SharedSpan<OctNormal> normals_;
+    SharedSpan<QuantizedUV> uvs_;
+    SharedSpan<TSpectral> albedos_; // Empty when uniform_albedo_ applies to every vertex
+
+    Vec2<float> uv_offset_{0.f};
+    Vec2<float> uv_scale_{0.f};
+    TSpectral uniform_albedo_{1};
+};
+} // namespace huira
+
+#include "huira_impl/geometry/vertex_streams.ipp"
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/geometry/heightfield.hpp"
+#include "huira/handles/geometry/geometry_handle.hpp"
+
+namespace huira {
+/**
+ * @brief Handle for referencing a Heightfield asset in the scene.
+ *
+ * @tparam TSpectral Spectral type for the scene
+ */
+template <IsSpectral TSpectral>
+class HeightfieldHandle : public GeometryHandle<TSpectral> {
+  public:
+    using GeometryHandle<TSpectral>::GeometryHandle;
+
+    HeightfieldHandle() = delete;
+
+    std::size_t width() const { return this->get_heightfield_()->width(); }
+    std::size_t height() const { return this->get_heightfield_()->height(); }
+    std::size_t tile_count() const { return this->get_heightfield_()->tile_count(); }
+
+    void set_lod_pixels(float lod_pixels) const
+    {
+        this->get_heightfield_()->set_lod_pixels(lod_pixels);
+    }
+    float lod_pixels() const { return this->get_heightfield_()->lod_pixels(); }
+
+  private:
+    std::shared_ptr<Heightfield<TSpectral>> get_heightfield_() const
+    {
+        auto ptr = this->template get<Heightfield<TSpectral>>();
+        if (ptr) {
+            return ptr;
+        } else {
+            HUIRA_THROW_ERROR("HeightfieldHandle::get_heightfield_ - Invalid handle or does not "
+                              "contain a Heightfield");
+        }
+    }
+};
+} // namespace huira
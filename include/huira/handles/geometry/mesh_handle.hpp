@@ -23,10 +23,30 @@ class MeshHandle : public GeometryHandle<TSpectral> {
 
     MeshHandle() = delete;
 
-    std::size_t get_vertex_count() const { return this->get_mesh_()->vertex_buffer().size(); }
+    std::size_t get_vertex_count() const { return this->get_mesh_()->vertex_count(); }
 
     std::shared_ptr<Mesh<TSpectral>> get_mesh_shared() const { return this->get_mesh_(); }
 
+    void generate_lods(std::size_t max_levels = 6, float reduction = 0.25f) const
+    {
+        this->get_mesh_()->generate_lods(max_levels, reduction);
+    }
+    std::size_t lod_count() const { return this->get_mesh_()->lod_count(); }
+    std::size_t lod_level() const { return this->get_mesh_()->lod_level(); }
+    float lod_error(std::size_t level) const { return this->get_mesh_()->lod_error(level); }
+    std::size_t lod_triangle_count(std::size_t level) const
+    {
+        return this->get_mesh_()->lod_index_buffer(level).size() / 3;
+    }
+
+    void set_lod_pixel_error(float pixels) const { this->get_mesh_()->set_lod_pixel_error(pixels); }
+    float lod_pixel_error() const { return this->get_mesh_()->lod_pixel_error(); }
+    void set_lod_hysteresis(float hysteresis) const
+    {
+        this->get_mesh_()->set_lod_hysteresis(hysteresis);
+    }
+    float lod_hysteresis() const { return this->get_mesh_()->lod_hysteresis(); }
+
   private:
     std::shared_ptr<Mesh<TSpectral>> get_mesh_() const
     {
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/geometry/particle_cloud.hpp"
+#include "huira/handles/geometry/geometry_handle.hpp"
+
+namespace huira {
+/**
+ * @brief Handle for referencing a ParticleCloud asset in the scene.
+ *
+ * @tparam TSpectral Spectral type for the scene
+ */
+template <IsSpectral TSpectral>
+class ParticleCloudHandle : public GeometryHandle<TSpectral> {
+  public:
+    using GeometryHandle<TSpectral>::GeometryHandle;
+
+    ParticleCloudHandle() = delete;
+
+    std::size_t size() const { return this->get_particle_cloud_()->size(); }
+    ParticleShape shape() const { return this->get_particle_cloud_()->shape(); }
+    std::size_t time_step_count() const { return this->get_particle_cloud_()->time_step_count(); }
+
+    void add_time_step(const std::vector<Vec3<float>>& positions) const
+    {
+        this->get_particle_cloud_()->add_time_step(positions);
+    }
+    void clear_motion() const { this->get_particle_cloud_()->clear_motion(); }
+
+  private:
+    std::shared_ptr<ParticleCloud<TSpectral>> get_particle_cloud_() const
+    {
+        auto ptr = this->template get<ParticleCloud<TSpectral>>();
+        if (ptr) {
+            return ptr;
+        } else {
+            HUIRA_THROW_ERROR("ParticleCloudHandle::get_particle_cloud_ - Invalid handle or does "
+                              "not contain a ParticleCloud");
+        }
+    }
+};
+} // namespace huira
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/handles/handle.hpp"
+#include "huira/volumes/atmosphere.hpp"
+
+namespace huira {
+/**
+ * @brief Handle for manipulating an Atmosphere in a scene.
+ */
+template <IsSpectral TSpectral>
+class AtmosphereHandle : public Handle<Atmosphere<TSpectral>> {
+  public:
+    AtmosphereHandle() = delete;
+    using Handle<Atmosphere<TSpectral>>::Handle;
+};
+
+} // namespace huira
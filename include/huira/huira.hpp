@@ -25,7 +25,9 @@
 // #include "huira/handles/handle.hpp"            // Not part of public API
 #include "huira/handles/assets/light_handle.hpp"
 #include "huira/handles/assets/model_handle.hpp"
+#include "huira/handles/geometry/heightfield_handle.hpp"
 #include "huira/handles/geometry/mesh_handle.hpp"
+#include "huira/handles/geometry/particle_cloud_handle.hpp"
 #include "huira/handles/scene/instance_handle.hpp"
 // #include "huira/handles/scene/node_handle.hpp"       // Not part of public API
 // #include "huira/handles/root_frame_handle.hpp" // Not part of public API
@@ -33,12 +35,18 @@
 
 // Image interfaces
 #include "huira/images/color_map.hpp"
+#include "huira/images/compact_texture.hpp"
 #include "huira/images/image.hpp"
 #include "huira/images/io/fits_io.hpp"
 #include "huira/images/io/jpeg_io.hpp"
 #include "huira/images/io/png_io.hpp"
 #include "huira/images/io/read_image.hpp"
 #include "huira/images/io/tiff_io.hpp"
+#include "huira/images/io/virtual_texture_io.hpp"
+#include "huira/images/mip_pyramid.hpp"
+#include "huira/images/texture_sampler.hpp"
+#include "huira/images/tile_cache.hpp"
+#include "huira/images/virtual_texture.hpp"
 
 // Materials and BSDFs:
 #include "huira/materials/bsdfs/bsdf.hpp"
@@ -49,6 +57,7 @@
 #include "huira/materials/bsdfs/mcewen_bsdf.hpp"
 #include "huira/materials/bsdfs/null_bsdf.hpp"
 #include "huira/materials/bsdfs/oren_nayar_bsdf.hpp"
+#include "huira/materials/bsdfs/phase_angle_table.hpp"
 
 // platform/ is not part of the public API
 
@@ -57,6 +66,7 @@
 #include "huira/render/frame_buffer.hpp"
 #include "huira/render/interaction.hpp"
 #include "huira/render/renderer.hpp"
+#include "huira/render/surface_cache.hpp"
 // #include "huira/render/sampler.hpp"        // Not part of the public API
 
 // Scene management
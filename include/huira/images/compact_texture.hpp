@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/core/types.hpp"
+#include "huira/images/image.hpp"
+#include "huira/images/texture_sampler.hpp"
+
+namespace huira {
+/**
+ * @brief Storage formats for CompactTexture texels.
+ */
+enum class CompactTexelFormat {
+    RGB8,  ///< 8 bits per channel, sRGB encoded (3 bytes per texel)
+    RGB16, ///< 16 bits per channel, linear (6 bytes per texel)
+    Half   ///< IEEE half float per channel, linear, for values outside [0, 1] (6 bytes per texel)
+};
+
+/**
+ * @brief A linear map from linear RGB to a spectral type.
+ *
+ * The columns are the spectra of unit red, green and blue, found by evaluating an RGB to spectral
+ * conversion on the unit vectors. This reproduces the conversion exactly when it is linear, as
+ * convert_rgb_to_spectral() is, and lets textures be filtered in RGB and converted once per
+ * lookup rather than once per texel.
+ *
+ * @tparam TSpectral The spectral type produced
+ */
+template <IsSpectral TSpectral>
+class RGBSpectralBasis {
+  public:
+    RGBSpectralBasis();
+    explicit RGBSpectralBasis(const std::function<TSpectral(RGB)>& conversion);
+
+    [[nodiscard]] TSpectral operator()(const RGB& rgb) const
+    {
+        return columns_[0] * rgb[0] + columns_[1] * rgb[1] + columns_[2] * rgb[2];
+    }
+
+    [[nodiscard]] bool linear() const noexcept { return linear_; }
+
+  private:
+    std::array<TSpectral, 3> columns_;
+    bool linear_ = true;
+};
+
+/**
+ * @brief A spectral texture stored as compact RGB texels and converted on lookup.
+ *
+ * Holds a full mip chain in one of the CompactTexelFormat encodings. Lookups filter exactly as
+ * MipPyramid does (see texture_footprint()), decoding texels to linear RGB, and convert the
+ * filtered colour to TSpectral through an RGBSpectralBasis. An 8-bit colour map stored this way
+ * takes 3 bytes per texel instead of sizeof(TSpectral), e.g. a tenth of the memory of an 8-bin
+ * Image<TSpectral>. Texels are stored in the ImageLayout::Tiled order.
+ *
+ * @tparam TSpectral The spectral type returned by lookups
+ */
+template <IsSpectral TSpectral>
+class CompactTexture : public TextureSampler<TSpectral> {
+  public:
+    /// Largest preview_level() size along either axis.
+    static constexpr int PREVIEW_SIZE = 256;
+
+    CompactTexture(const Image<RGB>& linear_rgb,
+                   CompactTexelFormat format,
+                   RGBSpectralBasis<TSpectral> basis = RGBSpectralBasis<TSpectral>{});
+
+    [[nodiscard]] TSpectral sample(const Vec2<float>& uv,
+                                   const Vec2<float>& duvdx,
+                                   const Vec2<float>& duvdy) const override;
+
+    [[nodiscard]] RGB sample_bilinear(std::size_t level, float u, float v) const;
+    [[nodiscard]] RGB sample_trilinear(float u, float v, float lod) const;
+
+    [[nodiscard]] Resolution resolution() const noexcept override
+    {
+        return levels_.front().resolution;
+    }
+    [[nodiscard]] std::size_t levels() const noexcept { return levels_.size(); }
+    [[nodiscard]] Resolution level_resolution(std::size_t level) const;
+    [[nodiscard]] CompactTexelFormat format() const noexcept { return format_; }
+    [[nodiscard]] const RGBSpectralBasis<TSpectral>& basis() const noexcept { return basis_; }
+    [[nodiscard]] std::size_t bytes() const noexcept;
+
+    [[nodiscard]] RGB texel(std::size_t level, int x, int y) const;
+    [[nodiscard]] std::size_t preview_level() const noexcept;
+    [[nodiscard]] Image<TSpectral> decode_level(std::size_t level) const;
+
+    [[nodiscard]] bool holds(const Image<RGB>& linear_rgb,
+                             CompactTexelFormat format,
+                             const RGBSpectralBasis<TSpectral>& basis) const;
+
+  private:
+    struct Level {
+        Resolution resolution{0, 0};
+        std::vector<std::uint8_t> data;
+    };
+
+    CompactTexelFormat format_;
+    RGBSpectralBasis<TSpectral> basis_;
+    std::vector<Level> levels_;
+    Vec2<float> texel_scale_{0.f, 0.f};
+
+    template <CompactTexelFormat Format>
+    [[nodiscard]] RGB sample_bilinear_(const Level& level, float u, float v) const;
+
+    template <CompactTexelFormat Format>
+    [[nodiscard]] RGB sample_trilinear_(float u, float v, float lod) const;
+
+    template <CompactTexelFormat Format>
+    [[nodiscard]] TSpectral sample_(const Vec2<float>& uv,
+                                    const Vec2<float>& duvdx,
+                                    const Vec2<float>& duvdy) const;
+};
+
+CompactTexelFormat compact_texel_format(const Image<RGB>& linear_rgb, int bit_depth);
+} // namespace huira
+
+#include "huira_impl/images/compact_texture.ipp"
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -50,6 +51,38 @@ enum class WrapMode {
     Mirror  ///< Mirror texture at boundaries
 };
 
+/**
+ * @brief Order in which an Image stores its pixels.
+ *
+ * Tiled storage keeps each 8x8 block of pixels contiguous, so the four texels of a bilinear
+ * lookup, or a small neighbourhood read in any direction, usually share one or two cache lines
+ * instead of touching two or more rows that are a full image width apart. Rows are grouped into
+ * bands 8 pixels high, each band stored as consecutive tiles left to right; tiles on the right
+ * and bottom edges are narrower rather than padded, so storage holds exactly width * height
+ * pixels in either layout.
+ */
+enum class ImageLayout {
+    RowMajor, ///< Rows stored one after another (the default, and what image I/O expects)
+    Tiled     ///< 8x8 tiles, for images that are sampled at arbitrary positions
+};
+
+namespace detail {
+/**
+ * @brief Storage index of pixel (x, y) in an ImageLayout::Tiled image.
+ */
+inline std::size_t tiled_pixel_index(int x, int y, int width, int height) noexcept
+{
+    constexpr int tile = 8;
+    const int band_y = y & ~(tile - 1);
+    const int tile_x = x & ~(tile - 1);
+    const int band_height = std::min(tile, height - band_y);
+    const int tile_width = std::min(tile, width - tile_x);
+    return static_cast<std::size_t>(band_y) * static_cast<std::size_t>(width) +
+           static_cast<std::size_t>(tile_x) * static_cast<std::size_t>(band_height) +
+           static_cast<std::size_t>((y & (tile - 1)) * tile_width + (x & (tile - 1)));
+}
+} // namespace detail
+
 /**
  * @brief A 2D image container with templated pixel types.
  *
@@ -58,9 +91,15 @@ enum class WrapMode {
  * SpectralBins for spectral imaging. It offers both checked and unchecked access
  * methods, as well as sampling operations with different wrap modes.
  *
- * Memory is stored in row-major order, with the origin at the top-left corner.
- * Pixel coordinates (x, y) map to image space where x increases to the right
- * and y increases downward.
+ * Memory is stored in row-major order by default, with the origin at the
+ * top-left corner. Pixel coordinates (x, y) map to image space where x increases
+ * to the right and y increases downward.
+ *
+ * Images that are mostly sampled, such as textures, can be switched to
+ * ImageLayout::Tiled with set_layout(). Access by coordinates and sampling work
+ * the same in either layout; linear indices (operator[], at(index), data()) follow
+ * the storage order, so they only match row-major arithmetic for RowMajor images.
+ * Element-wise loops over images with the same layout remain valid.
  *
  * @tparam PixelT The type of pixel stored (must satisfy IsImagePixel concept)
  */
@@ -76,6 +115,7 @@ class Image {
     Image(Resolution resolution, const PixelT& fill_value);
     Image(int width, int height);
     Image(int width, int height, const PixelT& fill_value);
+    Image(Resolution resolution, ImageLayout layout);
 
     Image(const Image&) = default;
     Image(Image&&) noexcept = default;
@@ -92,6 +132,9 @@ class Image {
     [[nodiscard]] int height() const noexcept;
     [[nodiscard]] std::size_t size() const noexcept;
 
+    [[nodiscard]] ImageLayout layout() const noexcept { return layout_; }
+    void set_layout(ImageLayout layout);
+
     // Unchecked access (asserts in debug builds only)
     [[nodiscard]] PixelT& operator[](std::size_t index);
     [[nodiscard]] const PixelT& operator[](std::size_t index) const;
@@ -136,8 +179,12 @@ class Image {
     Image operator+(const Image& other) const;
 
   private:
+    template <IsImagePixel>
+    friend class Image;
+
     std::vector<PixelT> data_;
     Resolution resolution_;
+    ImageLayout layout_ = ImageLayout::RowMajor;
 
     int sensor_bit_depth_ = 0;
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "huira/concepts/pixel_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/images/image.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Fixed header at the start of a virtual texture file.
+ */
+struct VirtualTextureHeader {
+    char magic[8];             ///< "HUIRAVT\0"
+    std::uint32_t version;     ///< File format version
+    std::uint32_t channels;    ///< Floats per texel
+    std::int32_t width;        ///< Width of level 0
+    std::int32_t height;       ///< Height of level 0
+    std::uint32_t tile_size;   ///< Texels along each tile edge
+    std::uint32_t level_count; ///< Number of mip levels stored
+};
+
+/**
+ * @brief Layout of a virtual texture file: a mip pyramid split into fixed-size square tiles.
+ *
+ * The VirtualTextureHeader is followed by the tiles of every level, level 0 first, each level in
+ * row-major tile order. Every tile holds tile_size * tile_size texels in row-major order, each
+ * texel `channels` native-endian floats; tiles overhanging the level's edge are padded by
+ * repeating the edge texels. Since all tiles are the same size, a tile's offset is computed
+ * rather than stored. Level sizes halve (rounding down, never below 1) exactly as in MipPyramid.
+ */
+struct VirtualTextureLayout {
+    static constexpr char MAGIC[8] = {'H', 'U', 'I', 'R', 'A', 'V', 'T', '\0'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr int DEFAULT_TILE_SIZE = 256;
+
+    std::uint32_t channels = 0;
+    int tile_size = 0;
+    std::vector<Resolution> level_resolutions;
+    std::vector<std::uint64_t> level_first_tile;
+
+    VirtualTextureLayout() = default;
+    VirtualTextureLayout(Resolution resolution, std::uint32_t channels, int tile_size);
+
+    [[nodiscard]] std::size_t levels() const noexcept { return level_resolutions.size(); }
+    [[nodiscard]] int tiles_x(std::size_t level) const noexcept;
+    [[nodiscard]] int tiles_y(std::size_t level) const noexcept;
+    [[nodiscard]] std::uint64_t tile_bytes() const noexcept;
+    [[nodiscard]] std::uint64_t tile_offset(std::size_t level, int tx, int ty) const noexcept;
+};
+
+VirtualTextureLayout read_virtual_texture_layout(const fs::path& filepath);
+
+template <IsImagePixel PixelT>
+void write_virtual_texture(const fs::path& filepath,
+                           const Image<PixelT>& image,
+                           int tile_size = VirtualTextureLayout::DEFAULT_TILE_SIZE);
+
+template <IsImagePixel PixelT, IsImagePixel SourceT, typename Conversion>
+    requires std::is_invocable_r_v<PixelT, Conversion&, const SourceT&>
+void write_virtual_texture(const fs::path& filepath,
+                           const Image<SourceT>& image,
+                           Conversion&& conversion,
+                           int tile_size = VirtualTextureLayout::DEFAULT_TILE_SIZE);
+
+template <IsImagePixel PixelT, typename RowReader>
+    requires std::is_invocable_v<RowReader&, int, std::span<PixelT>>
+void write_virtual_texture(const fs::path& filepath,
+                           Resolution resolution,
+                           RowReader&& read_row,
+                           int tile_size = VirtualTextureLayout::DEFAULT_TILE_SIZE);
+} // namespace huira
+
+#include "huira_impl/images/io/virtual_texture_io.ipp"
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "huira/concepts/pixel_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/images/image.hpp"
+#include "huira/images/texture_sampler.hpp"
+
+namespace huira {
+/**
+ * @brief A chain of successively half-resolution copies of an Image, for filtered sampling.
+ *
+ * Level 0 is the base image itself (shared, not copied). Each further level halves the width and
+ * height (rounding down, never below 1) by averaging 2x2 blocks of the level above, until a 1x1
+ * level is reached. The whole chain costs about a third of the base image's memory.
+ *
+ * Sampling takes the screen-space derivatives of the texture coordinates (see Interaction::duvdx
+ * and Interaction::duvdy) and picks the level whose texels match the pixel footprint. Besides
+ * removing aliasing on distant, heavily minified textures, lookups at coarse levels touch far less
+ * memory than bilinear lookups scattered across a full resolution global mosaic.
+ *
+ * The pyramid is a snapshot: edits to the base image after construction are not propagated.
+ *
+ * @tparam PixelT The pixel type (float, Vec3<float>, or SpectralBins)
+ */
+template <IsImagePixel PixelT>
+class MipPyramid : public TextureSampler<PixelT> {
+    static_assert(std::is_floating_point_v<typename ImagePixelTraits<PixelT>::Scalar>,
+                  "MipPyramid requires floating-point pixels");
+
+  public:
+    explicit MipPyramid(std::shared_ptr<const Image<PixelT>> base);
+
+    [[nodiscard]] std::size_t levels() const noexcept { return levels_.size() + 1; }
+    [[nodiscard]] const Image<PixelT>& level(std::size_t index) const;
+
+    template <WrapMode W = WrapMode::Repeat>
+    [[nodiscard]] PixelT sample_trilinear(float u, float v, float lod) const;
+
+    [[nodiscard]] PixelT sample(const Vec2<float>& uv,
+                                const Vec2<float>& duvdx,
+                                const Vec2<float>& duvdy) const override;
+
+    [[nodiscard]] Resolution resolution() const noexcept override { return base_->resolution(); }
+
+  private:
+    std::shared_ptr<const Image<PixelT>> base_;
+    std::vector<Image<PixelT>> levels_; // Levels 1 .. N-1
+
+    Vec2<float> texel_scale_{0.f, 0.f};
+
+    [[nodiscard]] static Image<PixelT> downsample_(const Image<PixelT>& src);
+};
+} // namespace huira
+
+#include "huira_impl/images/mip_pyramid.ipp"
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "huira/concepts/pixel_concepts.hpp"
+#include "huira/core/types.hpp"
+
+namespace huira {
+/**
+ * @brief Filtered texture lookup interface used by Material.
+ *
+ * Implemented by MipPyramid (fully resident images) and VirtualTexture (tiles streamed from disk
+ * on demand). Both wrap coordinates with WrapMode::Repeat.
+ *
+ * @tparam PixelT The pixel type returned by lookups
+ */
+template <IsImagePixel PixelT>
+class TextureSampler {
+  public:
+    /// Maximum ratio of the footprint's major to minor axis honoured by anisotropic sampling.
+    static constexpr int MAX_ANISOTROPY = 8;
+
+    virtual ~TextureSampler() = default;
+
+    /**
+     * @brief Sample with the footprint given by the screen-space uv derivatives.
+     * @param uv Texture coordinates
+     * @param duvdx Change in uv across one pixel in x (zero if unknown)
+     * @param duvdy Change in uv across one pixel in y (zero if unknown)
+     * @return PixelT The filtered value
+     */
+    [[nodiscard]] virtual PixelT sample(const Vec2<float>& uv,
+                                        const Vec2<float>& duvdx,
+                                        const Vec2<float>& duvdy) const = 0;
+
+    [[nodiscard]] virtual Resolution resolution() const noexcept = 0;
+};
+
+/**
+ * @brief Where to take anisotropic probes for one lookup, see texture_footprint().
+ */
+struct TextureFootprint {
+    float lod = 0.f;     ///< Level of detail, log2 of the minor axis in base level texels
+    int probes = 0;      ///< Number of trilinear probes, 0 to sample the base level bilinearly
+    Vec2<float> start{}; ///< uv of the first probe
+    Vec2<float> step{};  ///< uv offset between probes
+};
+
+TextureFootprint texture_footprint(const Vec2<float>& uv,
+                                   const Vec2<float>& duvdx,
+                                   const Vec2<float>& duvdy,
+                                   const Vec2<float>& texel_scale,
+                                   float max_lod);
+
+template <IsImagePixel PixelT, typename TTrilinear>
+PixelT filter_footprint(const TextureFootprint& footprint, const TTrilinear& trilinear);
+} // namespace huira
+
+#include "huira_impl/images/texture_sampler.ipp"
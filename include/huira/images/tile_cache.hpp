@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace huira {
+/**
+ * @brief Identifies one tile of one virtual texture.
+ */
+struct TileKey {
+    std::uint64_t source = 0; ///< Texture identifier, see TileCache::new_source_id()
+    std::uint32_t level = 0;  ///< Mip level
+    std::uint32_t x = 0;      ///< Tile column
+    std::uint32_t y = 0;      ///< Tile row
+
+    bool operator==(const TileKey&) const = default;
+};
+
+struct TileKeyHash {
+    std::size_t operator()(const TileKey& key) const noexcept;
+};
+
+/**
+ * @brief Least-recently-used cache of texture tiles with a fixed memory budget.
+ *
+ * Tiles are type-erased (std::shared_ptr<const void>) so a single cache, and a single budget, can
+ * be shared by virtual textures of every pixel type. Callers hold tiles by shared_ptr, so evicting
+ * a tile never invalidates a lookup in progress on another thread; its memory is released once
+ * the last reader drops it.
+ *
+ * The cache is split into independently locked shards selected by key hash, each holding an equal
+ * share of the budget, so concurrent lookups from render threads rarely contend. A miss loads the
+ * tile outside the lock; if two threads miss on the same tile at once both load it and the first
+ * insert wins.
+ */
+class TileCache {
+  public:
+    static constexpr std::size_t DEFAULT_BUDGET = std::size_t{1} << 30;
+
+    using TilePtr = std::shared_ptr<const void>;
+
+    explicit TileCache(std::size_t budget_bytes = DEFAULT_BUDGET);
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    template <typename TLoader>
+    [[nodiscard]] TilePtr get_or_load(const TileKey& key, std::size_t bytes, TLoader&& load);
+
+    void set_budget(std::size_t budget_bytes);
+    [[nodiscard]] std::size_t budget() const noexcept { return budget_.load(); }
+    [[nodiscard]] std::size_t resident_bytes() const;
+
+    [[nodiscard]] std::uint64_t hits() const noexcept { return hits_.load(); }
+    [[nodiscard]] std::uint64_t misses() const noexcept { return misses_.load(); }
+
+    void clear();
+    void evict_source(std::uint64_t source);
+
+    [[nodiscard]] static std::uint64_t new_source_id() noexcept;
+
+  private:
+    static constexpr std::size_t SHARD_COUNT = 16;
+
+    struct Entry {
+        TileKey key;
+        TilePtr tile;
+        std::size_t bytes = 0;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru; // Most recently used first
+        std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> index;
+        std::size_t bytes = 0;
+    };
+
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<std::size_t> budget_;
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+
+    [[nodiscard]] Shard& shard_(const TileKey& key) noexcept;
+    void evict_(Shard& shard);
+};
+
+std::shared_ptr<TileCache> default_tile_cache();
+} // namespace huira
+
+#include "huira_impl/images/tile_cache.ipp"
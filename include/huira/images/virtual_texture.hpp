@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "huira/concepts/pixel_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/images/image.hpp"
+#include "huira/images/io/virtual_texture_io.hpp"
+#include "huira/images/texture_sampler.hpp"
+#include "huira/images/tile_cache.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief A texture streamed on demand from a tiled mip pyramid on disk.
+ *
+ * Opens a file written by write_virtual_texture() and pages its tiles in through a TileCache as
+ * lookups touch them, so only the tiles around the currently visible footprint are resident. With
+ * ray differentials, distant bodies are sampled from coarse levels, so a global mosaic much larger
+ * than RAM renders from a handful of tiles. The cache's byte budget bounds the memory used no
+ * matter how large the file is; textures sharing a cache share its budget.
+ *
+ * Filtering matches MipPyramid exactly (see texture_footprint()), and lookups are safe to make
+ * from any number of threads.
+ *
+ * @tparam PixelT The pixel type stored in the file (float, Vec3<float>, or SpectralBins)
+ */
+template <IsImagePixel PixelT>
+class VirtualTexture : public TextureSampler<PixelT> {
+  public:
+    explicit VirtualTexture(const fs::path& filepath, std::shared_ptr<TileCache> cache = nullptr);
+    ~VirtualTexture() override;
+
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+    [[nodiscard]] PixelT sample(const Vec2<float>& uv,
+                                const Vec2<float>& duvdx,
+                                const Vec2<float>& duvdy) const override;
+
+    [[nodiscard]] PixelT sample_bilinear(std::size_t level, float u, float v) const;
+    [[nodiscard]] PixelT sample_trilinear(float u, float v, float lod) const;
+
+    [[nodiscard]] Resolution resolution() const noexcept override
+    {
+        return layout_.level_resolutions[0];
+    }
+    [[nodiscard]] std::size_t levels() const noexcept { return layout_.levels(); }
+    [[nodiscard]] Resolution level_resolution(std::size_t level) const;
+    [[nodiscard]] int tile_size() const noexcept { return layout_.tile_size; }
+    [[nodiscard]] const fs::path& path() const noexcept { return filepath_; }
+    [[nodiscard]] const std::shared_ptr<TileCache>& cache() const noexcept { return cache_; }
+
+    [[nodiscard]] std::size_t preview_level() const noexcept;
+    [[nodiscard]] Image<PixelT> read_level(std::size_t level) const;
+
+  private:
+    struct Tile {
+        std::vector<PixelT> texels;
+    };
+
+    fs::path filepath_;
+    VirtualTextureLayout layout_;
+    std::shared_ptr<TileCache> cache_;
+    std::uint64_t source_id_ = 0;
+    Vec2<float> texel_scale_{0.f, 0.f};
+
+    mutable std::mutex file_mutex_;
+    mutable std::ifstream file_;
+
+    [[nodiscard]] std::shared_ptr<const Tile> tile_(std::size_t level, int tx, int ty) const;
+    [[nodiscard]] std::shared_ptr<const Tile> load_tile_(std::size_t level, int tx, int ty) const;
+};
+} // namespace huira
+
+#include "huira_impl/images/virtual_texture.ipp"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "huira/materials/bsdfs/bsdf.hpp"
+#include "huira/materials/bsdfs/phase_angle_table.hpp"
 
 namespace huira {
 
@@ -21,12 +22,21 @@ namespace huira {
  * - b:     DHG phase function asymmetry
  * - c:     DHG phase function forward/backward fraction
  *
+ * With PhotometricEvaluation::Tabulated the albedo-independent factor (1 + B(alpha)) * P(alpha)
+ * is precomputed in a PhaseAngleTable at construction, replacing the per-call pow() evaluations
+ * with a single table lookup. The H-functions depend on the spatially varying albedo and are
+ * always evaluated directly.
+ *
  * @tparam TSpectral The spectral type used in the rendering pipeline
  */
 template <IsSpectral TSpectral>
 class HapkeBSDF final : public BSDF<TSpectral> {
   public:
-    HapkeBSDF(float h, float B0, float b, float c) noexcept : h_(h), B0_(B0), b_(b), c_(c) {}
+    HapkeBSDF(float h,
+              float B0,
+              float b,
+              float c,
+              PhotometricEvaluation evaluation = PhotometricEvaluation::Exact);
 
     [[nodiscard]] BSDFRequirements requirements() const override;
 
@@ -48,14 +58,21 @@ class HapkeBSDF final : public BSDF<TSpectral> {
 
     std::string type() const override { return "HapkeBSDF"; }
 
+    [[nodiscard]] PhotometricEvaluation evaluation() const noexcept { return evaluation_; }
+    [[nodiscard]] float table_error() const noexcept { return phase_table_.max_relative_error(); }
+
   private:
     float h_;
     float B0_;
     float b_;
     float c_;
 
+    PhotometricEvaluation evaluation_;
+    PhaseAngleTable phase_table_;
+
     [[nodiscard]] float phase_function_dhg(float cos_alpha) const noexcept;
     [[nodiscard]] float opposition_effect(float tan_half_alpha) const noexcept;
+    [[nodiscard]] float single_scattering_term(float cos_alpha) const noexcept;
     [[nodiscard]] TSpectral h_function(float mu, const TSpectral& omega) const noexcept;
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "huira/materials/bsdfs/bsdf.hpp"
+#include "huira/materials/bsdfs/phase_angle_table.hpp"
 
 namespace huira {
 
@@ -17,12 +18,15 @@ namespace huira {
  *
  * f(wo, wi) = albedo * ((1 - beta) * Lambert + beta * Lommel_Seeliger)
  *
+ * With PhotometricEvaluation::Tabulated, beta is read from a PhaseAngleTable instead of
+ * evaluating acos() and exp() per call.
+ *
  * @tparam TSpectral The spectral type used in the rendering pipeline
  */
 template <IsSpectral TSpectral>
 class McEwenBSDF final : public BSDF<TSpectral> {
   public:
-    McEwenBSDF() noexcept = default;
+    explicit McEwenBSDF(PhotometricEvaluation evaluation = PhotometricEvaluation::Exact);
 
     [[nodiscard]] BSDFRequirements requirements() const override;
 
@@ -43,6 +47,15 @@ class McEwenBSDF final : public BSDF<TSpectral> {
                             const ShadingParams<TSpectral>& params) const override;
 
     std::string type() const override { return "McEwenBSDF"; }
+
+    [[nodiscard]] PhotometricEvaluation evaluation() const noexcept { return evaluation_; }
+    [[nodiscard]] float table_error() const noexcept { return beta_table_.max_relative_error(); }
+
+  private:
+    PhotometricEvaluation evaluation_;
+    PhaseAngleTable beta_table_;
+
+    [[nodiscard]] static float beta(float cos_alpha) noexcept;
 };
 
 } // namespace huira
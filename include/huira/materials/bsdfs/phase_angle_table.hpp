@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace huira {
+
+/**
+ * @brief How a photometric BSDF evaluates its phase-angle dependent terms.
+ *
+ * - Exact: evaluate the closed-form expressions on every call.
+ * - Tabulated: precompute the terms once at construction and interpolate a table at
+ *   evaluation time, trading a small, measured error for removing the transcendental calls.
+ */
+enum class PhotometricEvaluation { Exact, Tabulated };
+
+/**
+ * @brief Precomputed 1D table of a scalar function of the phase angle.
+ *
+ * Photometric models such as Hapke and McEwen spend most of their evaluation cost in terms that
+ * depend only on the phase angle alpha (opposition surge, particle phase function, limb-darkening
+ * mix). Those terms are independent of the spatially varying albedo, so they can be tabulated
+ * once per BSDF instance.
+ *
+ * The table is split at alpha = 90 degrees. The forward half is sampled uniformly in
+ * sqrt(1 - cos(alpha)) (proportional to sin(alpha / 2)) and the backward half in
+ * sqrt(1 + cos(alpha)) (proportional to cos(alpha / 2)). Either costs a single sqrt to compute
+ * from cos(alpha), is close to linear in alpha at its end of the range (so samples are dense near
+ * zero phase where the opposition surge is sharpest), and avoids the square-root singularity a
+ * single sin(alpha / 2) parameterization has at alpha = 180 degrees. Values are linearly
+ * interpolated.
+ *
+ * At construction the function is also evaluated at the midpoint of every interval, where linear
+ * interpolation error is largest for smooth functions, and the worst relative error is recorded
+ * as max_relative_error(). With the default resolution this is below 1e-4 for the Hapke
+ * opposition/phase term over typical regolith parameters (h >= 0.02, |b| <= 0.6) and below 1e-5
+ * for the McEwen mixing term.
+ */
+class PhaseAngleTable {
+  public:
+    static constexpr std::size_t DEFAULT_RESOLUTION = 4096;
+
+    PhaseAngleTable() = default;
+    PhaseAngleTable(const std::function<float(float)>& f,
+                    std::size_t resolution = DEFAULT_RESOLUTION);
+
+    [[nodiscard]] float operator()(float cos_alpha) const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return values_.empty(); }
+    [[nodiscard]] std::size_t resolution() const noexcept { return values_.size(); }
+    [[nodiscard]] float max_relative_error() const noexcept { return max_relative_error_; }
+
+  private:
+    // Forward half (alpha in [0, 90] deg) followed by the backward half (alpha in [90, 180] deg):
+    std::vector<float> values_;
+    std::size_t half_ = 0;
+    float scale_ = 0.f;
+    float max_relative_error_ = 0.f;
+};
+
+} // namespace huira
+
+#include "huira_impl/materials/bsdfs/phase_angle_table.ipp"
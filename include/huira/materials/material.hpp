@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "huira/concepts/spectral_concepts.hpp"
 #include "huira/images/image.hpp"
+#include "huira/images/mip_pyramid.hpp"
+#include "huira/images/texture_sampler.hpp"
 #include "huira/materials/bsdfs/bsdf.hpp"
 #include "huira/materials/shading_params.hpp"
 #include "huira/render/interaction.hpp"
@@ -23,6 +26,19 @@ struct MaterialEval {
     Interaction<TSpectral> isect;
 };
 
+/**
+ * @brief Material inputs that can be driven by a texture, as bit flags.
+ */
+enum class MaterialChannel : std::uint8_t {
+    Albedo = 1 << 0,
+    Alpha = 1 << 1,
+    Metallic = 1 << 2,
+    Roughness = 1 << 3,
+    Normal = 1 << 4,
+    Transmission = 1 << 5,
+    Emissive = 1 << 6,
+};
+
 /**
  * @brief Surface material: holds image pointers and a BSDF pointer, provides
  *        the primary shading interface for integrators.
@@ -40,6 +56,19 @@ struct MaterialEval {
  *   - normal_image:      1x1 with {0.5, 0.5, 1.0} (unperturbed normal)
  *   - emissive_image:    1x1 black (TSpectral{0})
  *
+ * Whenever a slot or factor changes, the material records which channels are
+ * textured. A slot holding a 1x1 (or empty) image is constant: its value is
+ * folded with the factor once, and evaluate() reads the constant instead of
+ * sampling. Most CAD-imported materials are entirely constant, in which case
+ * evaluate() performs no texture fetches at all. Since the constant is a
+ * snapshot, editing the pixel of a 1x1 image in place after assigning it
+ * requires assigning it again.
+ *
+ * Textured channels are sampled through a TextureSampler, using the uv footprint carried by the
+ * Interaction to pick the mip level. Setters accept the sampler a Texture already owns for the
+ * image (its shared MipPyramid, or a VirtualTexture streamed from disk); when none is given the
+ * material builds a MipPyramid of its own.
+ *
  * @tparam TSpectral The spectral type used in the rendering pipeline
  */
 template <IsSpectral TSpectral>
@@ -58,6 +87,7 @@ class Material : public SceneObject<Material<TSpectral>> {
     Material& operator=(const Material&) = delete;
 
     [[nodiscard]] MaterialEval<TSpectral> evaluate(const Interaction<TSpectral>& isect) const;
+    [[nodiscard]] float opacity_at(const Vec2<float>& uv) const;
 
     [[nodiscard]] TSpectral bsdf_eval(const Vec3<float>& wo,
                                       const Vec3<float>& wi,
@@ -74,36 +104,45 @@ class Material : public SceneObject<Material<TSpectral>> {
 
     void set_bsdf(std::shared_ptr<BSDF<TSpectral>> bsdf);
 
-    void set_albedo(std::shared_ptr<Image<TSpectral>> albedo_image);
+    void set_albedo(std::shared_ptr<Image<TSpectral>> albedo_image,
+                    std::shared_ptr<const TextureSampler<TSpectral>> sampler = nullptr);
     void set_albedo_factor(TSpectral albedo_factor);
     void reset_albedo();
 
-    void set_alpha(std::shared_ptr<Image<float>> alpha_image);
+    void set_alpha(std::shared_ptr<Image<float>> alpha_image,
+                   std::shared_ptr<const TextureSampler<float>> sampler = nullptr);
     void set_alpha_factor(float alpha_factor);
     void reset_alpha();
 
-    void set_metallic_image(std::shared_ptr<Image<float>> metallic_image);
+    void set_metallic_image(std::shared_ptr<Image<float>> metallic_image,
+                            std::shared_ptr<const TextureSampler<float>> sampler = nullptr);
     void set_metallic_factor(float metallic_factor);
     void reset_metallic();
 
-    void set_roughness_image(std::shared_ptr<Image<float>> roughness_image);
+    void set_roughness_image(std::shared_ptr<Image<float>> roughness_image,
+                             std::shared_ptr<const TextureSampler<float>> sampler = nullptr);
     void set_roughness_factor(float roughness_factor);
     void reset_roughness();
 
-    void set_normal_image(std::shared_ptr<Image<Vec3<float>>> normal_image);
+    void set_normal_image(std::shared_ptr<Image<Vec3<float>>> normal_image,
+                          std::shared_ptr<const TextureSampler<Vec3<float>>> sampler = nullptr);
     void set_normal_factor(float normal_factor);
     void reset_normal();
 
-    void set_transmission_image(std::shared_ptr<Image<TSpectral>> transmission_image);
+    void set_transmission_image(std::shared_ptr<Image<TSpectral>> transmission_image,
+                                std::shared_ptr<const TextureSampler<TSpectral>> sampler = nullptr);
     void set_transmission_factor(TSpectral transmission_factor);
     void reset_transmission();
 
-    void set_emissive_image(std::shared_ptr<Image<TSpectral>> emissive_image);
+    void set_emissive_image(std::shared_ptr<Image<TSpectral>> emissive_image,
+                            std::shared_ptr<const TextureSampler<TSpectral>> sampler = nullptr);
     void set_emissive_factor(TSpectral emissive_factor);
     void reset_emissive();
 
     std::string type() const override { return "Material"; }
 
+    [[nodiscard]] bool same_parameters(const Material& other) const;
+
     // TODO Move this to private (access data only!)
     std::shared_ptr<Image<TSpectral>> albedo_image_;
     std::shared_ptr<Image<float>> alpha_image_;
@@ -116,8 +155,31 @@ class Material : public SceneObject<Material<TSpectral>> {
     float alpha_factor() const noexcept { return alpha_factor_; }
     bool has_alpha() const noexcept { return has_alpha_; }
     bool has_alpha_texture() const noexcept { return alpha_image_ != default_alpha_image_; }
+    bool is_alpha_tested() const noexcept
+    {
+        return is_textured(MaterialChannel::Alpha) || alpha_constant_ < 1.0f;
+    }
+    bool is_transmissive() const noexcept
+    {
+        return is_textured(MaterialChannel::Transmission) || transmission_constant_.max() > 0.0f;
+    }
+
+    [[nodiscard]] std::uint8_t textured_channels() const noexcept { return textured_channels_; }
+    [[nodiscard]] bool is_textured(MaterialChannel channel) const noexcept
+    {
+        return (textured_channels_ & static_cast<std::uint8_t>(channel)) != 0;
+    }
 
   private:
+    void update_channels_();
+
+    template <bool AnyTextured>
+    [[nodiscard]] MaterialEval<TSpectral> evaluate_(const Interaction<TSpectral>& isect) const;
+
+    void perturb_normal_(const Vec3<float>& ts_normal,
+                         const Interaction<TSpectral>& isect,
+                         Interaction<TSpectral>& shading_isect) const;
+
     bool eval_albedo_ = true;
     std::shared_ptr<Image<TSpectral>> default_albedo_image_;
 
@@ -137,6 +199,15 @@ class Material : public SceneObject<Material<TSpectral>> {
 
     std::shared_ptr<Image<TSpectral>> default_emissive_image_;
 
+    // Samplers for the textured channels (null for constant channels), see update_channels_():
+    std::shared_ptr<const TextureSampler<TSpectral>> albedo_sampler_;
+    std::shared_ptr<const TextureSampler<float>> alpha_sampler_;
+    std::shared_ptr<const TextureSampler<float>> metallic_sampler_;
+    std::shared_ptr<const TextureSampler<float>> roughness_sampler_;
+    std::shared_ptr<const TextureSampler<Vec3<float>>> normal_sampler_;
+    std::shared_ptr<const TextureSampler<TSpectral>> transmission_sampler_;
+    std::shared_ptr<const TextureSampler<TSpectral>> emissive_sampler_;
+
     std::shared_ptr<BSDF<TSpectral>> bsdf_;
 
     TSpectral albedo_factor_{1.0f};
@@ -147,6 +218,17 @@ class Material : public SceneObject<Material<TSpectral>> {
     TSpectral transmission_factor_{0.0f};
     TSpectral emissive_factor_{0.0f};
 
+    // Channel classification and constants (factor already applied), see update_channels_():
+    std::uint8_t textured_channels_ = 0;
+    TSpectral albedo_constant_{1.0f};
+    float alpha_constant_ = 1.0f;
+    float metallic_constant_ = 0.0f;
+    float roughness_constant_ = 1.0f;
+    Vec3<float> normal_constant_{0.0f, 0.0f, 1.0f};
+    bool constant_normal_is_flat_ = true;
+    TSpectral transmission_constant_{0.0f};
+    TSpectral emissive_constant_{0.0f};
+
     friend class Scene<TSpectral>;
 };
 
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "huira/images/image.hpp"
+#include "huira/images/mip_pyramid.hpp"
+#include "huira/images/texture_sampler.hpp"
+#include "huira/images/virtual_texture.hpp"
 #include "huira/scene/scene_object.hpp"
 
 namespace fs = std::filesystem;
@@ -24,6 +29,19 @@ class Scene;
  * direct access without indirection through this wrapper. Texture is
  * not involved in the rendering hot path.
  *
+ * Images are stored with ImageLayout::Tiled, since textures are read at
+ * arbitrary positions rather than row by row.
+ *
+ * The texture also owns the TextureSampler used for filtered lookups. For
+ * an in-memory image this is a MipPyramid, built on first request
+ * (normally when the texture is first assigned to a material) and shared
+ * by every material using the texture, so each image is reduced only once.
+ *
+ * A texture can instead be backed by another sampler, such as a
+ * VirtualTexture streamed from disk or a CompactTexture holding encoded
+ * RGB texels. Its image is then only a small preview, and lookups go
+ * through that sampler.
+ *
  * @tparam TPixel The pixel type of the underlying Image (e.g., TSpectral,
  *                float, Vec3<float>)
  */
@@ -34,23 +52,60 @@ class Texture : public SceneObject<Texture<TPixel>> {
     Texture& operator=(const Texture&) = delete;
 
     explicit Texture(Image<TPixel>&& image)
-        : image_{std::make_shared<Image<TPixel>>(std::move(image))}
+        : image_{std::make_shared<Image<TPixel>>(std::move(image))},
+          resolution_{image_->resolution()}
     {
+        image_->set_layout(ImageLayout::Tiled);
     }
 
     explicit Texture(const TPixel& constant_value)
-        : image_{std::make_shared<Image<TPixel>>(1, 1, constant_value)}
+        : image_{std::make_shared<Image<TPixel>>(1, 1, constant_value)}, resolution_{1, 1}
+    {
+    }
+
+    explicit Texture(std::shared_ptr<VirtualTexture<TPixel>> virtual_texture)
+        : image_{std::make_shared<Image<TPixel>>(
+              virtual_texture->read_level(virtual_texture->preview_level()))},
+          resolution_{virtual_texture->resolution()}, virtual_texture_{virtual_texture},
+          sampler_{virtual_texture}
+    {
+    }
+
+    Texture(std::shared_ptr<const TextureSampler<TPixel>> sampler, Image<TPixel>&& preview)
+        : image_{std::make_shared<Image<TPixel>>(std::move(preview))},
+          resolution_{sampler->resolution()}, sampler_{std::move(sampler)}
     {
     }
 
     [[nodiscard]] std::shared_ptr<Image<TPixel>> shared_image() const { return image_; }
 
-    [[nodiscard]] Resolution resolution() const noexcept { return image_->resolution(); }
+    [[nodiscard]] std::shared_ptr<const TextureSampler<TPixel>> shared_sampler() const
+    {
+        std::call_once(sampler_once_, [this] {
+            if (!sampler_) {
+                sampler_ = std::make_shared<MipPyramid<TPixel>>(image_);
+            }
+        });
+        return sampler_;
+    }
+
+    [[nodiscard]] std::shared_ptr<VirtualTexture<TPixel>> virtual_texture() const
+    {
+        return virtual_texture_;
+    }
+    [[nodiscard]] bool is_virtual() const noexcept { return virtual_texture_ != nullptr; }
+
+    [[nodiscard]] Resolution resolution() const noexcept { return resolution_; }
 
     [[nodiscard]] std::string type() const override { return "Texture"; }
 
   private:
     std::shared_ptr<Image<TPixel>> image_;
+    Resolution resolution_;
+    std::shared_ptr<VirtualTexture<TPixel>> virtual_texture_;
+
+    mutable std::once_flag sampler_once_;
+    mutable std::shared_ptr<const TextureSampler<TPixel>> sampler_;
 };
 
 } // namespace huira
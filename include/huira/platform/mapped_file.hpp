@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief A file mapped read-only into memory.
+ *
+ * Pages are read from disk as they are first touched and may be dropped again under memory
+ * pressure, so a mapping costs address space rather than RAM, and reopening a file whose pages
+ * are still in the OS page cache is nearly free.
+ */
+class MappedFile {
+  public:
+    explicit MappedFile(const fs::path& filepath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const std::byte* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+    [[nodiscard]] const fs::path& path() const noexcept { return filepath_; }
+
+  private:
+    fs::path filepath_;
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+} // namespace huira
+
+#include "huira_impl/platform/mapped_file.ipp"
@@ -9,8 +9,8 @@ namespace huira {
  * @brief Surface interaction information for rendering.
  *
  * Stores geometric and shading information at a surface intersection point,
- * including position, normals, tangent frame, texture coordinates, interpolated
- * vertex albedo, and outgoing direction. Used in BSDF evaluation, texture
+ * including position, normals, tangent frame, texture coordinates and their
+ * screen-space footprint, interpolated vertex albedo, and outgoing direction. Used in BSDF evaluation, texture
  * lookup, and light transport calculations.
  *
  * @tparam TSpectral Spectral type for the rendering pipeline
@@ -26,6 +26,12 @@ struct Interaction {
 
     Vec2<float> uv; ///< Texture coordinates (u, v)
 
+    Vec3<float> dpdu{0.0f}; ///< Partial derivative of position with respect to u
+    Vec3<float> dpdv{0.0f}; ///< Partial derivative of position with respect to v
+
+    Vec2<float> duvdx{0.0f}; ///< Change in uv across one pixel in x (zero if unknown)
+    Vec2<float> duvdy{0.0f}; ///< Change in uv across one pixel in y (zero if unknown)
+
     Vec3<float> wo; ///< Outgoing direction (towards camera), world space
 
     TSpectral vertex_albedo{1}; ///< Interpolated vertex color (default: white / unity)
@@ -53,6 +59,16 @@ inline void build_default_tangent_frame(const Vec3<float>& normal_s,
     bitangent = Vec3<float>{b, sign + normal_s.y * normal_s.y * a, -normal_s.y};
 }
 
+/**
+ * @brief Computes the screen-space uv derivatives of an interaction from ray differentials.
+ */
+template <IsSpectral TSpectral>
+void compute_uv_differentials(Interaction<TSpectral>& isect,
+                              const Vec3<float>& rx_origin,
+                              const Vec3<float>& rx_direction,
+                              const Vec3<float>& ry_origin,
+                              const Vec3<float>& ry_direction) noexcept;
+
 /**
  * @brief Offsets an intersection point along a normal to prevent self-intersection artifacts.
  */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -7,6 +8,7 @@
 #include "huira/concepts/spectral_concepts.hpp"
 #include "huira/render/frame_buffer.hpp"
 #include "huira/render/sampler.hpp"
+#include "huira/render/surface_cache.hpp"
 #include "huira/scene/scene_view.hpp"
 
 namespace huira {
@@ -37,6 +39,21 @@ class Renderer {
 
     void set_indirect_clamp(float indirect_clamp) { indirect_clamp_threshold_ = indirect_clamp; }
 
+    void set_irradiance_cache(std::shared_ptr<IrradianceCache<TSpectral>> irradiance_cache)
+    {
+        irradiance_cache_ = std::move(irradiance_cache);
+    }
+    std::shared_ptr<IrradianceCache<TSpectral>> irradiance_cache() const
+    {
+        return irradiance_cache_;
+    }
+
+    void set_shadow_cache(std::shared_ptr<ShadowCache<TSpectral>> shadow_cache)
+    {
+        shadow_cache_ = std::move(shadow_cache);
+    }
+    std::shared_ptr<ShadowCache<TSpectral>> shadow_cache() const { return shadow_cache_; }
+
   protected:
     virtual Image<TSpectral> path_trace_(SceneView<TSpectral>& scene_view,
                                          FrameBuffer<TSpectral>& frame_buffer);
@@ -44,6 +61,20 @@ class Renderer {
     virtual Image<TSpectral> render_unresolved_(SceneView<TSpectral>& scene_view,
                                                 FrameBuffer<TSpectral>& frame_buffer);
 
+    /**
+     * @brief Per-instance state shared by the surface caches during a render.
+     */
+    struct SurfaceCacheInstance {
+        SurfaceCacheBody body;
+        Transform<float> world_to_local;
+        std::size_t sun_index = std::numeric_limits<std::size_t>::max(); ///< Dominant light
+        bool irradiance = false; ///< Whether the radiance cache holds this instance this frame
+        bool shadow = false;     ///< Whether the shadow cache holds this instance this frame
+    };
+
+    std::vector<std::vector<SurfaceCacheInstance>>
+    prepare_surface_caches_(const SceneView<TSpectral>& scene_view);
+
     std::shared_ptr<CameraModel<TSpectral>> get_camera(SceneView<TSpectral>& scene_view) const
     {
         return scene_view.camera_model_;
@@ -68,6 +99,9 @@ class Renderer {
     float variance_threshold_ = 0.001f;
 
     float indirect_clamp_threshold_ = std::numeric_limits<float>::infinity();
+
+    std::shared_ptr<IrradianceCache<TSpectral>> irradiance_cache_ = nullptr;
+    std::shared_ptr<ShadowCache<TSpectral>> shadow_cache_ = nullptr;
 };
 } // namespace huira
 
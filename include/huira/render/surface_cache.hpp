@@ -0,0 +1,205 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/units/units.hpp"
+
+namespace huira {
+/**
+ * @brief Identifies a single rendered body (one instance of one primitive) in a surface cache.
+ */
+struct SurfaceCacheBody {
+    std::uint64_t primitive_id = 0;
+    std::size_t instance_index = 0;
+
+    auto operator<=>(const SurfaceCacheBody&) const = default;
+};
+
+/**
+ * @brief A discretized surface location within a body's local frame.
+ *
+ * Cells are built from the instance-local hit position and geometric normal, so a cell keeps the
+ * same key while the camera or the body itself moves through a sequence.
+ */
+struct SurfaceCacheCell {
+    std::int32_t x = 0;
+    std::int32_t y = 0;
+    std::int32_t z = 0;
+    std::uint8_t normal_bin = 0;
+
+    bool operator==(const SurfaceCacheCell&) const = default;
+};
+
+struct SurfaceCacheCellHash {
+    std::size_t operator()(const SurfaceCacheCell& cell) const noexcept;
+};
+
+inline SurfaceCacheCell make_surface_cache_cell(const Vec3<float>& local_position,
+                                                const Vec3<float>& local_normal,
+                                                float inv_cell_size);
+
+/**
+ * @brief Thread-safe hashed grid of averaged values over the surfaces of rendered bodies.
+ *
+ * Values are accumulated per (body, cell) and returned as a running mean once a cell has seen
+ * enough observations. Each body remembers the sun direction (in its local frame) its entries
+ * were computed under; when that direction moves by more than the configured tolerance, the
+ * body's entries are discarded. This lets a single cache be kept alive across all frames of a
+ * sequence while the illumination geometry is effectively fixed. A body whose sun direction moves
+ * beyond the tolerance within one exposure is rendered without the cache for that frame.
+ *
+ * Lookups take a shared lock and insertions an exclusive one. Renderers insert a frame's
+ * observations after the frame, in a fixed order, so that the cache (and so every later frame)
+ * does not depend on thread scheduling.
+ *
+ * @tparam TValue Accumulated value type (must support +=, *= float, and / float)
+ */
+template <typename TValue>
+class SurfaceCache {
+  public:
+    /**
+     * @brief A single observation to be merged into the cache.
+     */
+    struct Record {
+        SurfaceCacheBody body;
+        SurfaceCacheCell cell;
+        TValue value;
+    };
+
+    SurfaceCache(const units::Meter& cell_size,
+                 const units::Radian& sun_tolerance,
+                 int min_samples);
+    virtual ~SurfaceCache() = default;
+
+    SurfaceCache(const SurfaceCache&) = delete;
+    SurfaceCache& operator=(const SurfaceCache&) = delete;
+
+    void set_cell_size(const units::Meter& cell_size);
+    void set_sun_tolerance(const units::Radian& sun_tolerance);
+    void set_min_samples(int min_samples);
+    void set_max_samples(int max_samples);
+
+    [[nodiscard]] float cell_size() const { return cell_size_; }
+    [[nodiscard]] float inv_cell_size() const { return 1.f / cell_size_; }
+    [[nodiscard]] int min_samples() const { return min_samples_; }
+    [[nodiscard]] int max_samples() const { return max_samples_; }
+    [[nodiscard]] bool same_sun_direction(const Vec3<float>& a, const Vec3<float>& b) const
+    {
+        return glm::dot(a, b) >= cos_sun_tolerance_;
+    }
+
+    bool update_sun_direction(const SurfaceCacheBody& body, const Vec3<float>& local_sun_direction);
+
+    [[nodiscard]] std::optional<TValue> lookup(const SurfaceCacheBody& body,
+                                               const SurfaceCacheCell& cell) const;
+
+    void insert(const std::vector<Record>& records);
+
+    void clear();
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    struct Entry {
+        TValue sum{0};
+        int count = 0;
+    };
+
+    struct BodyCache {
+        Vec3<float> sun_direction{0};
+        bool has_sun_direction = false;
+        std::unordered_map<SurfaceCacheCell, Entry, SurfaceCacheCellHash> entries;
+    };
+
+    float cell_size_ = 1.f;
+    float cos_sun_tolerance_ = 1.f;
+    int min_samples_ = 1;
+    int max_samples_ = 4096;
+
+    mutable std::shared_mutex mutex_;
+    std::map<SurfaceCacheBody, BodyCache> bodies_;
+};
+
+/**
+ * @brief World-space radiance cache for multi-bounce surface illumination.
+ *
+ * Stores the outgoing radiance leaving secondary path vertices, normalized by the surface albedo,
+ * in a hashed grid expressed in each body's local frame. The renderer uses it to terminate
+ * indirect paths early with the cached estimate, and feeds completed paths back into it. Because a
+ * terminated path inherits the cached value, each frame extends the effective bounce depth, which
+ * is what makes it useful for regions lit only by terrain reflection (crater floors, permanently
+ * shadowed regions).
+ *
+ * Entries are keyed on geometry and on the sun direction relative to each body (see
+ * SurfaceCache), so one cache can be kept alive and reused across all frames of a sequence.
+ *
+ * The albedo normalization assumes a diffuse-dominated response at secondary vertices; cached
+ * values are an approximation and should not be used where glossy interreflection matters.
+ *
+ * @tparam TSpectral Spectral type for the rendering pipeline
+ */
+template <IsSpectral TSpectral>
+class IrradianceCache : public SurfaceCache<TSpectral> {
+  public:
+    using Record = typename SurfaceCache<TSpectral>::Record;
+
+    /**
+     * @brief Path state at a secondary vertex, held until the path completes.
+     */
+    struct PathVertex {
+        SurfaceCacheBody body;
+        SurfaceCacheCell cell;
+        TSpectral throughput;      ///< Path throughput on arrival at the vertex
+        TSpectral radiance_before; ///< Path radiance accumulated before the vertex
+        TSpectral albedo;          ///< Surface albedo at the vertex
+    };
+
+    IrradianceCache(const units::Meter& cell_size = units::Meter(1.0),
+                    const units::Radian& sun_tolerance = units::Radian(0.01),
+                    int min_samples = 16)
+        : SurfaceCache<TSpectral>(cell_size, sun_tolerance, min_samples)
+    {
+    }
+
+    static void append_records(const std::vector<PathVertex>& vertices,
+                               const TSpectral& path_radiance,
+                               std::vector<Record>& records);
+};
+
+/**
+ * @brief Cached sun visibility over the surfaces of static bodies.
+ *
+ * Stores the mean shadow-ray transmittance toward each body's dominant light (the sun) per
+ * surface cell. Averaging the sampled shadow rays within a cell gives a penumbra estimate at the
+ * resolution of the cell size. Once a cell has enough observations the renderer answers direct
+ * sun visibility from the cache instead of tracing a shadow ray.
+ *
+ * Entries are keyed on the sun direction relative to each body (see SurfaceCache) and are reused
+ * across frames while that direction stays within tolerance. Occluders are assumed to be fixed
+ * relative to the shadowed body; moving occluders (e.g. a spacecraft casting a shadow on the
+ * terrain) require clear() between frames. Shadow rays inside participating media are never
+ * cached.
+ *
+ * @tparam TSpectral Spectral type for the rendering pipeline
+ */
+template <IsSpectral TSpectral>
+class ShadowCache : public SurfaceCache<TSpectral> {
+  public:
+    ShadowCache(const units::Meter& cell_size = units::Meter(1.0),
+                const units::Radian& sun_tolerance = units::Radian(0.001),
+                int min_samples = 8)
+        : SurfaceCache<TSpectral>(cell_size, sun_tolerance, min_samples)
+    {
+    }
+};
+} // namespace huira
+
+#include "huira_impl/render/surface_cache.ipp"
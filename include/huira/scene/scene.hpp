@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <stdexcept>
@@ -15,20 +18,26 @@
 #include "huira/handles/assets/primitive_handle.hpp"
 #include "huira/handles/geometry/ellipsoid_handle.hpp"
 #include "huira/handles/geometry/geometry_handle.hpp"
+#include "huira/handles/geometry/heightfield_handle.hpp"
 #include "huira/handles/geometry/mesh_handle.hpp"
+#include "huira/handles/geometry/particle_cloud_handle.hpp"
 #include "huira/handles/materials/bsdf_handle.hpp"
 #include "huira/handles/materials/material_handle.hpp"
 #include "huira/handles/materials/texture_handle.hpp"
 #include "huira/handles/scene/root_frame_handle.hpp"
+#include "huira/handles/volumes/atmosphere_handle.hpp"
 #include "huira/handles/volumes/density_field_handle.hpp"
 #include "huira/handles/volumes/medium_handle.hpp"
 #include "huira/handles/volumes/phase_function_handle.hpp"
+#include "huira/images/compact_texture.hpp"
 #include "huira/images/image.hpp"
+#include "huira/materials/bsdfs/phase_angle_table.hpp"
 #include "huira/materials/material.hpp"
 #include "huira/materials/texture.hpp"
 #include "huira/scene/name_registry.hpp"
 #include "huira/stars/io/star_data.hpp"
 #include "huira/stars/star.hpp"
+#include "huira/util/content_hash.hpp"
 #include "huira/volumes/medium.hpp"
 
 namespace fs = std::filesystem;
@@ -70,10 +79,39 @@ class Scene {
                                    const VertexBuffer<TSpectral>& vertex_buffer,
                                    const TangentBuffer& tangent_buffer,
                                    std::string name = "");
+    MeshHandle<TSpectral> load_mesh(const fs::path& file,
+                                    std::string name = "",
+                                    std::size_t lod_levels = 0,
+                                    bool use_cache = true);
     EllipsoidHandle<TSpectral> add_ellipsoid(const units::Meter& x,
                                              const units::Meter& y,
                                              const units::Meter& z,
                                              std::string name = "");
+    HeightfieldHandle<TSpectral> add_heightfield(std::size_t width,
+                                                 std::size_t height,
+                                                 std::vector<float> elevations,
+                                                 const HeightfieldMapping& mapping,
+                                                 std::string name = "");
+    HeightfieldHandle<TSpectral> load_heightfield(const fs::path& path,
+                                                  const HeightfieldMapping& mapping,
+                                                  float height_scale = 1.f,
+                                                  float height_offset = 0.f,
+                                                  std::string name = "");
+    HeightfieldHandle<TSpectral> load_raw_heightfield(const fs::path& path,
+                                                      std::size_t width,
+                                                      std::size_t height,
+                                                      const HeightfieldMapping& mapping,
+                                                      float height_scale = 1.f,
+                                                      float height_offset = 0.f,
+                                                      std::string name = "");
+    ParticleCloudHandle<TSpectral> add_particles(const std::vector<Vec3<float>>& positions,
+                                                 const std::vector<float>& radii,
+                                                 std::vector<TSpectral> albedos = {},
+                                                 ParticleShape shape = ParticleShape::Sphere,
+                                                 std::string name = "");
+    ParticleCloudHandle<TSpectral> load_raw_particles(const fs::path& path,
+                                                      ParticleShape shape = ParticleShape::Sphere,
+                                                      std::string name = "");
     GeometryHandle<TSpectral> add_geometry(std::shared_ptr<Geometry<TSpectral>> geom,
                                            std::string name = "");
     void set_name(const GeometryHandle<TSpectral>& geom_handle, const std::string& name);
@@ -95,6 +133,8 @@ class Scene {
     void set_name(const PrimitiveHandle<TSpectral>& primitive_handle, const std::string& name);
     PrimitiveHandle<TSpectral> get_primitive(const std::string& name) const;
     void delete_primitive(const PrimitiveHandle<TSpectral>& primitive_handle);
+    void set_atmosphere(const PrimitiveHandle<TSpectral>& primitive_handle,
+                        const AtmosphereHandle<TSpectral>& atmosphere_handle);
 
     LightHandle<TSpectral> new_sphere_light(
         const units::Meter& radius,
@@ -166,17 +206,25 @@ class Scene {
     ModelHandle<TSpectral> load_model(
         const fs::path& file,
         std::string name = "",
-        unsigned int post_process_flags = ModelLoader<TSpectral>::DEFAULT_POST_PROCESS_FLAGS);
+        unsigned int post_process_flags = ModelLoader<TSpectral>::DEFAULT_POST_PROCESS_FLAGS,
+        std::size_t lod_levels = 0);
     void set_name(const ModelHandle<TSpectral>& model_handle, const std::string& name);
     ModelHandle<TSpectral> get_model(const std::string& name) const;
     void delete_model(const ModelHandle<TSpectral>& model_handle);
 
     BSDFHandle<TSpectral> new_bsdf_cook_torrance(std::string name = "");
     BSDFHandle<TSpectral>
-    new_bsdf_hapke(float h, float B0, float b, float c, std::string name = "");
+    new_bsdf_hapke(float h,
+                   float B0,
+                   float b,
+                   float c,
+                   std::string name = "",
+                   PhotometricEvaluation evaluation = PhotometricEvaluation::Exact);
     BSDFHandle<TSpectral> new_bsdf_lambertian(std::string name = "");
     BSDFHandle<TSpectral> new_bsdf_lommel_seeliger(std::string name = "");
-    BSDFHandle<TSpectral> new_bsdf_mcewen(std::string name = "");
+    BSDFHandle<TSpectral>
+    new_bsdf_mcewen(std::string name = "",
+                    PhotometricEvaluation evaluation = PhotometricEvaluation::Exact);
     BSDFHandle<TSpectral> new_bsdf_null(std::string name = "");
     BSDFHandle<TSpectral> new_bsdf_oren_nayar(std::string name = "");
     BSDFHandle<TSpectral> add_bsdf(std::shared_ptr<BSDF<TSpectral>> bsdf, std::string name = "");
@@ -188,11 +236,42 @@ class Scene {
 
     DensityFieldHandle<TSpectral>
     new_constant_density_field(TSpectral absorption, TSpectral scattering, std::string name = "");
+    DensityFieldHandle<TSpectral> new_exponential_density_field(const units::Meter& planet_radius,
+                                                                const units::Meter& scale_height,
+                                                                TSpectral absorption,
+                                                                TSpectral scattering,
+                                                                std::string name = "");
+    DensityFieldHandle<TSpectral>
+    new_tabulated_density_field(const units::Meter& planet_radius,
+                                const std::vector<float>& altitudes,
+                                const std::vector<float>& densities,
+                                TSpectral absorption,
+                                TSpectral scattering,
+                                std::string name = "");
+    DensityFieldHandle<TSpectral>
+    new_grid_density_field(const std::array<std::size_t, 3>& resolution,
+                           const std::vector<float>& densities,
+                           const Vec3<float>& bounds_min,
+                           const Vec3<float>& bounds_max,
+                           TSpectral absorption,
+                           TSpectral scattering,
+                           std::string name = "");
+    DensityFieldHandle<TSpectral>
+    load_grid_density_field(const fs::path& path,
+                            const std::array<std::size_t, 3>& resolution,
+                            const Vec3<float>& bounds_min,
+                            const Vec3<float>& bounds_max,
+                            TSpectral absorption,
+                            TSpectral scattering,
+                            std::string name = "");
     DensityFieldHandle<TSpectral>
     add_density_field(std::shared_ptr<DensityField<TSpectral>> density_field,
                       std::string name = "");
 
     PhaseFunctionHandle<TSpectral> new_isotropic_phase_function(std::string name = "");
+    PhaseFunctionHandle<TSpectral> new_rayleigh_phase_function(std::string name = "");
+    PhaseFunctionHandle<TSpectral> new_henyey_greenstein_phase_function(float g,
+                                                                        std::string name = "");
     PhaseFunctionHandle<TSpectral>
     add_phase_function(std::shared_ptr<PhaseFunction<TSpectral>> phase_function,
                        std::string name = "");
@@ -203,6 +282,12 @@ class Scene {
     MediumHandle<TSpectral> add_medium(std::shared_ptr<Medium<TSpectral>> medium,
                                        std::string name = "");
 
+    AtmosphereHandle<TSpectral> new_atmosphere(const std::vector<MediumHandle<TSpectral>>& layers,
+                                               TSpectral ground_albedo = TSpectral{0.f},
+                                               std::string name = "");
+    AtmosphereHandle<TSpectral> add_atmosphere(std::shared_ptr<Atmosphere<TSpectral>> atmosphere,
+                                               std::string name = "");
+
     void set_background_radiance(Image<TSpectral> background);
     void set_background_radiance(TSpectral background);
     void set_background_radiance(float background);
@@ -213,6 +298,13 @@ class Scene {
     TextureHandle<Vec3<float>> add_normal_texture(Image<Vec3<float>>&& image,
                                                   std::string name = "");
     TextureHandle<Vec3<float>> add_normal_texture(Image<RGB>&& image, std::string name = "");
+    TextureHandle<TSpectral>
+    add_compact_texture(const Image<RGB>& linear_rgb,
+                        CompactTexelFormat format = CompactTexelFormat::RGB8,
+                        std::string name = "",
+                        const RGBSpectralBasis<TSpectral>& basis = RGBSpectralBasis<TSpectral>{});
+    TextureHandle<TSpectral> add_virtual_texture(const fs::path& path, std::string name = "");
+    TextureHandle<float> add_virtual_mono_texture(const fs::path& path, std::string name = "");
 
     void set_stars(const std::vector<Star<TSpectral>>& stars);
     void
@@ -253,6 +345,7 @@ class Scene {
     NameRegistry<DensityField<TSpectral>> density_fields_;
     NameRegistry<PhaseFunction<TSpectral>> phase_functions_;
     NameRegistry<Medium<TSpectral>> volumes_;
+    NameRegistry<Atmosphere<TSpectral>> atmospheres_;
 
     // Default textures:
     std::shared_ptr<Image<TSpectral>> default_albedo_image_;
@@ -270,6 +363,18 @@ class Scene {
 
     std::shared_ptr<Image<TSpectral>> background_;
 
+    // Assets created by ModelLoader, keyed by a ContentHasher digest of their content, so that
+    // identical textures, meshes and materials are shared across loads rather than duplicated:
+    template <typename TAsset>
+    using ContentCache = std::unordered_map<std::uint64_t, ContentEntry<TAsset>>;
+    ContentCache<Texture<TSpectral>> spectral_texture_content_;
+    ContentCache<Texture<float>> mono_texture_content_;
+    ContentCache<Texture<Vec3<float>>> vec3_texture_content_;
+    ContentCache<Geometry<TSpectral>> geometry_content_;
+    ContentCache<BSDF<TSpectral>> bsdf_content_;
+    ContentCache<Material<TSpectral>> material_content_;
+    ContentCache<Primitive<TSpectral>> primitive_content_;
+
     bool dynamic_stars_ = false;
     std::vector<Star<TSpectral>> stars_;
     std::vector<StarData> dynamic_star_data_;
@@ -278,6 +383,9 @@ class Scene {
     void print_node_(const Node<TSpectral>* node, const std::string& prefix, bool is_last) const;
     void print_node_details_(const Node<TSpectral>* node) const;
 
+    std::shared_ptr<Material<TSpectral>>
+    make_material_(std::shared_ptr<BSDF<TSpectral>> bsdf) const;
+
     template <typename TAssetPtr>
     void prune_graph_references_(TAssetPtr target_ptr);
 
@@ -35,11 +35,15 @@ class SceneObject : public std::enable_shared_from_this<TDerived> {
     SceneObject& operator=(const SceneObject&) = delete;
 
     // Allow move (copy the atomic's value)
-    SceneObject(SceneObject&& other) noexcept : scene_owned_(other.scene_owned_.load()) {}
+    SceneObject(SceneObject&& other) noexcept
+        : scene_owned_(other.scene_owned_.load()), revision_(other.revision_)
+    {
+    }
 
     SceneObject& operator=(SceneObject&& other) noexcept
     {
         scene_owned_.store(other.scene_owned_.load());
+        revision_ = other.revision_;
         return *this;
     }
 
@@ -67,6 +71,12 @@ class SceneObject : public std::enable_shared_from_this<TDerived> {
      */
     virtual std::uint64_t id() const { return id_; }
 
+    /**
+     * @brief Get the object's revision, which advances whenever its content is edited.
+     * @return std::uint64_t Revision
+     */
+    std::uint64_t revision() const noexcept { return revision_; }
+
     /**
      * @brief Get the object's type string.
      * @return std::string Type
@@ -82,12 +92,19 @@ class SceneObject : public std::enable_shared_from_this<TDerived> {
         return type() + "[" + std::to_string(this->id()) + "]" + (name_.empty() ? "" : " " + name_);
     }
 
+  protected:
+    /**
+     * @brief Mark the object's content as edited.
+     */
+    void touch_() noexcept { ++revision_; }
+
   private:
     std::atomic<bool> scene_owned_{true}; // Only scene should modify this
 
     std::string name_ = ""; // Only NameRegistry should modify this
 
     std::uint64_t id_ = 0;
+    std::uint64_t revision_ = 0;
     static inline std::uint64_t next_id_ = 0;
 
     friend class NameRegistry<TDerived>;
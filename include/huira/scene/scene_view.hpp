@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -52,6 +54,9 @@ class SceneView {
                                                    RandomSampler<float>& sampler,
                                                    float time = 0.5f) const;
 
+    [[nodiscard]] AtmosphereSegment<TSpectral> integrate_atmospheres(const Ray<TSpectral>& ray,
+                                                                     float t_max) const;
+
     [[nodiscard]] Interaction<TSpectral> resolve_hit(const Ray<TSpectral>& ray,
                                                      const HitRecord& hit) const;
 
@@ -67,6 +72,9 @@ class SceneView {
     Time get_start_time() const { return exposure_interval_.start; }
     Time get_end_time() const { return exposure_interval_.end; }
 
+    // Whether rays skip Embree for this view, see collect_analytic_bodies_():
+    [[nodiscard]] bool traces_analytic_bodies() const noexcept { return analytic_; }
+
   private:
     Interval exposure_interval_;
     std::vector<Time> temporal_samples_;
@@ -108,12 +116,19 @@ class SceneView {
 
     std::vector<UnresolvedInstance<TSpectral>> unresolved_objects_;
 
+    std::vector<AtmosphereInstance<TSpectral>> atmospheres_;
+    void collect_atmospheres_();
+
     std::vector<std::vector<Star<TSpectral>>> stars_;
 
     std::shared_ptr<Image<TSpectral>> background_;
 
+    void build_blases_();
     void build_tlas_();
 
+    // What each primitive batch's geometry was built as for this view, see build_blases_():
+    std::vector<std::shared_ptr<const GeometryBuild>> builds_;
+
     std::shared_ptr<EmbreeDevice> device_ = nullptr;
     RTCScene tlas_ = nullptr;
 
@@ -130,6 +145,63 @@ class SceneView {
     };
     std::vector<InstanceMapping> instance_mappings_;
 
+    // Material of each primitive batch whose alpha is tested during traversal, null if opaque:
+    std::vector<const Material<TSpectral>*> alpha_materials_;
+    bool alpha_tested_ = false;
+
+    // Whether each primitive batch lets some light through, which occlusion queries step over:
+    std::vector<bool> transmissive_;
+    bool has_transmissive_ = false;
+
+    [[nodiscard]] bool occluded_(const Ray<TSpectral>& ray,
+                                 float t_far,
+                                 float time,
+                                 bool& crossed_transmissive) const;
+
+    // Scenes made only of a few ellipsoids and sphere lights are traced directly against this
+    // list instead of through Embree, see collect_analytic_bodies_():
+    static constexpr std::size_t ANALYTIC_BODY_LIMIT = 32;
+    struct AnalyticBody {
+        Vec3<double> radii;
+        Vec3<float> center;
+        Rotation<float> to_local;
+        Vec3<float> inv_scale;
+        unsigned int inst_id;
+        unsigned int mask;
+        bool transmissive;
+    };
+    std::vector<AnalyticBody> analytic_bodies_;
+    // Bounding spheres of the bodies, kept as separate arrays so that culling vectorizes:
+    std::vector<double> bound_x_;
+    std::vector<double> bound_y_;
+    std::vector<double> bound_z_;
+    std::vector<double> bound_radius_;
+    bool analytic_ = false;
+
+    void collect_analytic_bodies_();
+    [[nodiscard]] std::size_t cull_analytic_(const Ray<TSpectral>& ray,
+                                             std::array<std::uint8_t, ANALYTIC_BODY_LIMIT>&
+                                                 candidates) const;
+    [[nodiscard]] bool hit_analytic_(const AnalyticBody& body,
+                                     const Ray<TSpectral>& ray,
+                                     float t_max,
+                                     HitRecord& hit) const;
+    [[nodiscard]] HitRecord intersect_analytic_(const Ray<TSpectral>& ray,
+                                                unsigned int mask) const;
+    [[nodiscard]] bool occluded_analytic_(const Ray<TSpectral>& ray,
+                                          float t_far,
+                                          bool& crossed_transmissive) const;
+
+    static void alpha_filter_(const RTCFilterFunctionNArguments* args) noexcept;
+    static void occlusion_filter_(const RTCFilterFunctionNArguments* args) noexcept;
+    static bool alpha_rejects_(const SceneView<TSpectral>* view,
+                               const RTCFilterFunctionNArguments* args,
+                               unsigned int i) noexcept;
+    static float alpha_threshold_(const Vec3<float>& origin,
+                                  const Vec3<float>& direction,
+                                  unsigned int inst_id,
+                                  unsigned int prim_id) noexcept;
+
     friend class Renderer<TSpectral>;
 };
 } // namespace huira
@@ -5,6 +5,7 @@
 
 #include "huira/concepts/spectral_concepts.hpp"
 #include "huira/core/transform.hpp"
+#include "huira/volumes/atmosphere.hpp"
 
 namespace huira {
 // Forward declarations
@@ -46,4 +47,15 @@ struct PrimitiveBatch {
     std::shared_ptr<Primitive<TSpectral>> primitive;
     std::vector<std::vector<Transform<float>>> instances; // Instances Transforms at N times
 };
+
+/**
+ * @brief Instance of an atmosphere in a scene view, with the lights it sees.
+ * @tparam TSpectral Spectral type
+ */
+template <IsSpectral TSpectral>
+struct AtmosphereInstance {
+    std::shared_ptr<Atmosphere<TSpectral>> atmosphere;
+    Transform<float> world_to_local;
+    std::vector<AtmosphereLight<TSpectral>> lights; // In the atmosphere's frame
+};
 } // namespace huira
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+namespace huira {
+/**
+ * @brief Incremental 64-bit hash of asset content, used to share identical assets.
+ *
+ * Bytes are consumed eight at a time, each word scrambled with the splitmix64 finalizer before
+ * being folded into the state, so the digest depends on both the values and their order. It is
+ * not a cryptographic hash, so a matching digest only nominates an asset for sharing: ModelLoader
+ * compares the asset's content before reusing it.
+ *
+ * Values are hashed by their object representation, so only types without padding (floats,
+ * integers and vectors or arrays of them) should be passed to value() and values().
+ */
+class ContentHasher {
+  public:
+    ContentHasher& bytes(const void* data, std::size_t size);
+    ContentHasher& string(std::string_view text);
+
+    template <typename T>
+    ContentHasher& value(const T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "ContentHasher - Values must be trivially copyable");
+        return bytes(&v, sizeof(T));
+    }
+
+    template <typename T>
+    ContentHasher& values(const T* data, std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "ContentHasher - Values must be trivially copyable");
+        return bytes(data, count * sizeof(T));
+    }
+
+    [[nodiscard]] std::uint64_t digest() const noexcept;
+
+  private:
+    std::uint64_t state_ = 0x9E3779B97F4A7C15ull;
+    std::uint64_t length_ = 0;
+
+    void word_(std::uint64_t word) noexcept;
+};
+
+/**
+ * @brief An asset recorded under the digest of its content.
+ *
+ * The asset's revision is recorded with it, so an asset edited since (see SceneObject::revision())
+ * is no longer taken to hold that content.
+ */
+template <typename TAsset>
+struct ContentEntry {
+    std::weak_ptr<TAsset> asset;
+    std::uint64_t revision = 0;
+};
+} // namespace huira
+
+#include "huira_impl/util/content_hash.ipp"
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include "huira/concepts/spectral_concepts.hpp"
 #include "huira/core/types.hpp"
+#include "huira/geometry/ray.hpp"
 #include "huira/util/logger.hpp"
 #include "huira/volumes/density/density_field.hpp"
 #include "huira/volumes/medium_properties.hpp"
@@ -38,6 +40,25 @@ class ConstantDensityField : public DensityField<TSpectral> {
         return properties_;
     }
 
+    [[nodiscard]] float majorant(const Ray<TSpectral>& ray,
+                                 float t_min,
+                                 float t_max) const override
+    {
+        (void)ray;
+        (void)t_min;
+        (void)t_max;
+        return properties_.extinction().max();
+    }
+
+    [[nodiscard]] std::optional<TSpectral>
+    optical_depth(const Ray<TSpectral>& ray, float t_min, float t_max) const override
+    {
+        float length = glm::length(ray.direction()) * (t_max - t_min);
+        return properties_.extinction() * length;
+    }
+
+    [[nodiscard]] bool is_homogeneous() const override { return true; }
+
     std::string type() const override { return "ConstantDensityField"; }
 
   private:
@@ -1,16 +1,36 @@
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include "huira/concepts/spectral_concepts.hpp"
 #include "huira/core/types.hpp"
+#include "huira/geometry/ray.hpp"
 #include "huira/scene/scene_object.hpp"
 #include "huira/volumes/medium_properties.hpp"
 
 namespace huira {
+/**
+ * @brief Spatially varying absorption and scattering coefficients of a medium.
+ *
+ * Besides point evaluation, a field describes itself along a ray so that Medium can track
+ * through it without fixed-step marching: support() bounds where the field is non-zero,
+ * majorant() bounds its extinction over a segment, for_each_majorant_segment() splits a segment
+ * into pieces with tighter bounds, and optical_depth() returns the integrated extinction when the
+ * field can compute it directly. Rays are given in the field's own frame and
+ * ray parameters are in units of the ray direction's length.
+ */
 template <IsSpectral TSpectral>
 class DensityField : public SceneObject<DensityField<TSpectral>> {
   public:
+    // Number of pieces the default for_each_majorant_segment() splits a finite interval into:
+    static constexpr std::size_t MAJORANT_SEGMENTS = 16;
+
     DensityField() = default;
     virtual ~DensityField() override = default;
 
@@ -21,6 +41,71 @@ class DensityField : public SceneObject<DensityField<TSpectral>> {
 
     [[nodiscard]] virtual MediumProperties<TSpectral> evaluate(const Vec3<float>& p) const = 0;
 
+    /**
+     * @brief The interval of ray parameters outside of which the field is zero.
+     * @return std::pair<float, float> The interval, empty if first >= second
+     */
+    [[nodiscard]] virtual std::pair<float, float> support(const Ray<TSpectral>& ray) const
+    {
+        (void)ray;
+        return {0.f, std::numeric_limits<float>::infinity()};
+    }
+
+    /**
+     * @brief An upper bound on every channel of the extinction over [t_min, t_max].
+     */
+    [[nodiscard]] virtual float majorant(const Ray<TSpectral>& ray,
+                                         float t_min,
+                                         float t_max) const = 0;
+
+    /**
+     * @brief Visit [t_min, t_max] in consecutive pieces, each with a bound on the extinction.
+     *
+     * Tracking samples collisions against each piece's majorant in turn, so tighter pieces mean
+     * fewer null collisions. The default splits a finite interval into MAJORANT_SEGMENTS equal
+     * pieces bounded by majorant(). Fields with spatial structure override this to follow it and
+     * skip pieces where they are empty.
+     *
+     * @param visit Called with the start, end and majorant of each piece in order; traversal stops
+     *              when it returns false
+     */
+    virtual void
+    for_each_majorant_segment(const Ray<TSpectral>& ray,
+                              float t_min,
+                              float t_max,
+                              const std::function<bool(float, float, float)>& visit) const
+    {
+        if (!(t_min < t_max)) {
+            return;
+        }
+        const std::size_t segments = std::isfinite(t_max) ? MAJORANT_SEGMENTS : 1;
+        const float length = (t_max - t_min) / static_cast<float>(segments);
+        for (std::size_t k = 0; k < segments; ++k) {
+            float a = t_min + length * static_cast<float>(k);
+            float b = (k + 1 == segments) ? t_max : a + length;
+            if (!visit(a, b, majorant(ray, a, b))) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief The integrated extinction over [t_min, t_max], if the field can compute it directly.
+     */
+    [[nodiscard]] virtual std::optional<TSpectral>
+    optical_depth(const Ray<TSpectral>& ray, float t_min, float t_max) const
+    {
+        (void)ray;
+        (void)t_min;
+        (void)t_max;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief True if the field has the same properties everywhere.
+     */
+    [[nodiscard]] virtual bool is_homogeneous() const { return false; }
+
     virtual std::string type() const override = 0;
 };
 } // namespace huira
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/util/logger.hpp"
+#include "huira/volumes/density/spherical_density_field.hpp"
+
+namespace huira {
+/**
+ * @brief A spherical atmosphere whose density falls off exponentially with altitude.
+ *
+ * The relative density is exp(-h / H) for altitude h and scale height H. Unless given, the top of
+ * the atmosphere is placed at DEFAULT_TOP_SCALE_HEIGHTS scale heights, where the density has
+ * fallen to a few parts per million of its surface value.
+ *
+ * @tparam TSpectral The spectral type of the coefficients
+ */
+template <IsSpectral TSpectral>
+class ExponentialDensityField : public SphericalDensityField<TSpectral> {
+  public:
+    static constexpr float DEFAULT_TOP_SCALE_HEIGHTS = 12.f;
+
+    ExponentialDensityField(float planet_radius,
+                            float scale_height,
+                            TSpectral absorption,
+                            TSpectral scattering,
+                            float top_altitude = 0.f)
+        : SphericalDensityField<TSpectral>(
+              planet_radius,
+              top_altitude_(scale_height, top_altitude),
+              absorption,
+              scattering,
+              [scale_height](float altitude) { return std::exp(-altitude / scale_height); }),
+          scale_height_{scale_height}
+    {
+    }
+
+    ~ExponentialDensityField() override = default;
+
+    [[nodiscard]] float scale_height() const noexcept { return scale_height_; }
+
+    std::string type() const override { return "ExponentialDensityField"; }
+
+  private:
+    float scale_height_;
+
+    static float top_altitude_(float scale_height, float top_altitude)
+    {
+        if (!(scale_height > 0.f)) {
+            HUIRA_THROW_ERROR("ExponentialDensityField::ExponentialDensityField - Scale height "
+                              "must be positive");
+        }
+        return top_altitude > 0.f ? top_altitude : DEFAULT_TOP_SCALE_HEIGHTS * scale_height;
+    }
+};
+} // namespace huira
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/geometry/ray.hpp"
+#include "huira/volumes/density/density_field.hpp"
+#include "huira/volumes/medium_properties.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief A heterogeneous medium sampled on a sparse voxel grid, such as a plume, coma or dust
+ * cloud.
+ *
+ * The grid fills an axis-aligned box in the field's local frame and holds a relative density per
+ * voxel, which scales the given absorption and scattering coefficients. Density is interpolated
+ * trilinearly between voxel centres and is zero outside the box.
+ *
+ * Voxels are stored in bricks of BRICK_SIZE^3, and only bricks with some non-zero density are
+ * kept, so memory follows the occupied volume rather than the bounding box. Each brick also keeps
+ * the largest density that interpolation can reach inside it. These form a coarse majorant grid,
+ * which for_each_majorant_segment() walks with a 3D DDA, skipping empty bricks entirely so that
+ * tracking costs scale with the occupied volume a ray crosses.
+ *
+ * @tparam TSpectral The spectral type of the coefficients
+ */
+template <IsSpectral TSpectral>
+class GridDensityField : public DensityField<TSpectral> {
+  public:
+    static constexpr std::size_t BRICK_SIZE = 8;
+
+    GridDensityField(const std::array<std::size_t, 3>& resolution,
+                     const std::vector<float>& densities,
+                     const Vec3<float>& bounds_min,
+                     const Vec3<float>& bounds_max,
+                     TSpectral absorption,
+                     TSpectral scattering);
+
+    ~GridDensityField() override = default;
+
+    [[nodiscard]] MediumProperties<TSpectral> evaluate(const Vec3<float>& p) const override;
+
+    [[nodiscard]] std::pair<float, float> support(const Ray<TSpectral>& ray) const override;
+
+    [[nodiscard]] float majorant(const Ray<TSpectral>& ray,
+                                 float t_min,
+                                 float t_max) const override;
+
+    void for_each_majorant_segment(
+        const Ray<TSpectral>& ray,
+        float t_min,
+        float t_max,
+        const std::function<bool(float, float, float)>& visit) const override;
+
+    [[nodiscard]] float density(const Vec3<float>& p) const;
+
+    [[nodiscard]] const std::array<std::size_t, 3>& resolution() const noexcept
+    {
+        return resolution_;
+    }
+    [[nodiscard]] const Vec3<float>& bounds_min() const noexcept { return bounds_min_; }
+    [[nodiscard]] const Vec3<float>& bounds_max() const noexcept { return bounds_max_; }
+    [[nodiscard]] std::size_t brick_count() const noexcept { return brick_table_.size(); }
+    [[nodiscard]] std::size_t occupied_brick_count() const noexcept
+    {
+        return brick_data_.size() / BRICK_VOXELS;
+    }
+
+    static std::vector<float> read_raw(const fs::path& path,
+                                       const std::array<std::size_t, 3>& resolution);
+
+    std::string type() const override { return "GridDensityField"; }
+
+  private:
+    static constexpr std::size_t BRICK_VOXELS = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+    static constexpr std::uint32_t EMPTY_BRICK = std::numeric_limits<std::uint32_t>::max();
+
+    std::array<std::size_t, 3> resolution_;
+    std::array<std::size_t, 3> bricks_;
+    Vec3<float> bounds_min_;
+    Vec3<float> bounds_max_;
+    Vec3<float> voxel_size_;
+    TSpectral absorption_;
+    TSpectral scattering_;
+    float max_extinction_;
+
+    std::vector<std::uint32_t> brick_table_;
+    std::vector<float> brick_data_;
+    std::vector<float> brick_majorants_;
+
+    [[nodiscard]] float voxel_(std::size_t i, std::size_t j, std::size_t k) const;
+    [[nodiscard]] bool clip_(const Ray<TSpectral>& ray, float& t_min, float& t_max) const;
+};
+} // namespace huira
+
+#include "huira_impl/volumes/density/grid_density_field.ipp"
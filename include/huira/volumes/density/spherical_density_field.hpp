@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/types.hpp"
+#include "huira/geometry/ray.hpp"
+#include "huira/volumes/density/density_field.hpp"
+#include "huira/volumes/medium_properties.hpp"
+
+namespace huira {
+/**
+ * @brief A spherically symmetric atmosphere whose density depends only on altitude.
+ *
+ * The field is centred on the origin of its local frame. Between the planet radius and the top of
+ * the atmosphere the coefficients are the surface absorption and scattering scaled by a relative
+ * density profile; above the top they are zero. Below the surface the profile is clamped to its
+ * surface value, since the planet itself is expected to block rays there.
+ *
+ * On construction the profile is sampled into a table, along with the largest density at or above
+ * each altitude, which bounds the extinction over any segment from its lowest point. The column
+ * density from any point up to the top of the atmosphere is also precomputed as a function of
+ * radius and the cosine of the zenith angle, so the optical depth of a segment is a difference of
+ * table lookups rather than a march through the atmosphere.
+ *
+ * @tparam TSpectral The spectral type of the coefficients
+ */
+template <IsSpectral TSpectral>
+class SphericalDensityField : public DensityField<TSpectral> {
+  public:
+    static constexpr std::size_t PROFILE_SAMPLES = 1024;
+    static constexpr std::size_t COLUMN_RADIUS_SAMPLES = 128;
+    static constexpr std::size_t COLUMN_ANGLE_SAMPLES = 128;
+    static constexpr std::size_t COLUMN_STEPS = 256;
+
+    ~SphericalDensityField() override = default;
+
+    [[nodiscard]] MediumProperties<TSpectral> evaluate(const Vec3<float>& p) const override;
+
+    [[nodiscard]] std::pair<float, float> support(const Ray<TSpectral>& ray) const override;
+
+    [[nodiscard]] float majorant(const Ray<TSpectral>& ray,
+                                 float t_min,
+                                 float t_max) const override;
+
+    [[nodiscard]] std::optional<TSpectral>
+    optical_depth(const Ray<TSpectral>& ray, float t_min, float t_max) const override;
+
+    [[nodiscard]] float density(float altitude) const;
+    [[nodiscard]] float column_density(float radius, float mu) const;
+
+    [[nodiscard]] float planet_radius() const noexcept { return static_cast<float>(radius_); }
+    [[nodiscard]] float top_altitude() const noexcept { return top_altitude_; }
+    [[nodiscard]] const TSpectral& absorption() const noexcept { return absorption_; }
+    [[nodiscard]] const TSpectral& scattering() const noexcept { return scattering_; }
+
+  protected:
+    SphericalDensityField(float planet_radius,
+                          float top_altitude,
+                          TSpectral absorption,
+                          TSpectral scattering,
+                          const std::function<float(float)>& profile);
+
+  private:
+    double radius_;
+    double top_radius_;
+    float top_altitude_;
+    TSpectral absorption_;
+    TSpectral scattering_;
+    float max_extinction_;
+
+    std::vector<float> profile_;
+    std::vector<float> envelope_;
+    std::vector<float> columns_;
+
+    [[nodiscard]] float envelope_at_(double altitude) const;
+    [[nodiscard]] double column_at_(double radius, double mu) const;
+    [[nodiscard]] double integrate_column_(double radius, double mu) const;
+};
+} // namespace huira
+
+#include "huira_impl/volumes/density/spherical_density_field.ipp"
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/util/logger.hpp"
+#include "huira/volumes/density/spherical_density_field.hpp"
+
+namespace huira {
+/**
+ * @brief A spherical atmosphere with a measured density profile.
+ *
+ * The relative density is interpolated linearly between the given altitudes and held at the first
+ * value below the lowest one. The last altitude is the top of the atmosphere.
+ *
+ * @tparam TSpectral The spectral type of the coefficients
+ */
+template <IsSpectral TSpectral>
+class TabulatedDensityField : public SphericalDensityField<TSpectral> {
+  public:
+    TabulatedDensityField(float planet_radius,
+                          const std::vector<float>& altitudes,
+                          const std::vector<float>& densities,
+                          TSpectral absorption,
+                          TSpectral scattering)
+        : SphericalDensityField<TSpectral>(
+              planet_radius,
+              top_altitude_(altitudes, densities),
+              absorption,
+              scattering,
+              [&altitudes, &densities](float altitude) {
+                  auto upper = std::upper_bound(altitudes.begin(), altitudes.end(), altitude);
+                  if (upper == altitudes.begin()) {
+                      return densities.front();
+                  }
+                  if (upper == altitudes.end()) {
+                      return densities.back();
+                  }
+                  auto i = static_cast<std::size_t>(std::distance(altitudes.begin(), upper));
+                  float f = (altitude - altitudes[i - 1]) / (altitudes[i] - altitudes[i - 1]);
+                  return densities[i - 1] * (1.f - f) + densities[i] * f;
+              })
+    {
+    }
+
+    ~TabulatedDensityField() override = default;
+
+    std::string type() const override { return "TabulatedDensityField"; }
+
+  private:
+    static float top_altitude_(const std::vector<float>& altitudes,
+                               const std::vector<float>& densities)
+    {
+        if (altitudes.size() < 2 || altitudes.size() != densities.size()) {
+            HUIRA_THROW_ERROR("TabulatedDensityField::TabulatedDensityField - Need at least two "
+                              "altitudes, each with a density");
+        }
+        for (std::size_t i = 1; i < altitudes.size(); ++i) {
+            if (!(altitudes[i] > altitudes[i - 1])) {
+                HUIRA_THROW_ERROR("TabulatedDensityField::TabulatedDensityField - Altitudes must "
+                                  "be strictly increasing");
+            }
+        }
+        for (float density : densities) {
+            if (density < 0.f) {
+                HUIRA_THROW_ERROR("TabulatedDensityField::TabulatedDensityField - Densities must "
+                                  "be non-negative");
+            }
+        }
+        return altitudes.back();
+    }
+};
+} // namespace huira
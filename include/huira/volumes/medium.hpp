@@ -1,10 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/transform.hpp"
 #include "huira/core/types.hpp"
 #include "huira/geometry/ray.hpp"
 #include "huira/render/sampler.hpp"
@@ -51,54 +56,156 @@ class Medium : public SceneObject<Medium<TSpectral>> {
         return *phase_function_;
     }
 
-    // Returns transmittance along a segment (could be analytical for constant media,
-    // or delegated to an integrator/marching utility for heterogeneous media)
-    [[nodiscard]] TSpectral
-    evaluate_transmittance(const Ray<TSpectral>& ray, float t, RandomSampler<float>& sampler) const
+    // Shared access to the components, for building atmospheres out of media
+    [[nodiscard]] std::shared_ptr<DensityField<TSpectral>> density_field() const
+    {
+        return density_field_;
+    }
+    [[nodiscard]] std::shared_ptr<PhaseFunction<TSpectral>> phase_function() const
     {
-        (void)sampler;
+        return phase_function_;
+    }
 
+    /**
+     * @brief Transmittance along the first t units of a ray.
+     *
+     * Homogeneous media use Beer-Lambert directly. Otherwise the density field's own optical
+     * depth is used when it has one, and ratio tracking against its majorants when it does not.
+     *
+     * @param ray The ray, in world space
+     * @param t Length of the segment in ray parameter units
+     * @param sampler Sampler for ratio tracking
+     * @param world_to_local Transform from world space into the frame of the density field
+     * @return TSpectral The transmittance
+     */
+    [[nodiscard]] TSpectral
+    evaluate_transmittance(const Ray<TSpectral>& ray,
+                           float t,
+                           RandomSampler<float>& sampler,
+                           const Transform<float>& world_to_local = Transform<float>{}) const
+    {
         if (t <= 0.0f) {
             return TSpectral{1.0f};
         }
 
-        MediumProperties<TSpectral> props = get_properties(ray.origin());
-        TSpectral ext = props.extinction();
+        if (density_field_->is_homogeneous()) {
+            MediumProperties<TSpectral> props = get_properties(ray.origin());
+            TSpectral ext = props.extinction();
+            return (ext * -t).exp();
+        }
 
-        TSpectral Tr{0.0f};
-        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
-            Tr[c] = std::exp(-ext[c] * t);
+        Ray<TSpectral> local = to_local_(ray, world_to_local);
+        if (auto tau = density_field_->optical_depth(local, 0.0f, t)) {
+            return (-*tau).exp();
         }
-        return Tr;
+
+        // Ratio tracking:
+        TSpectral transmittance{1.0f};
+        const float speed = glm::length(local.direction());
+        auto [t_begin, t_end] = tracking_range_(local, t);
+        density_field_->for_each_majorant_segment(
+            local, t_begin, t_end, [&](float a, float b, float majorant) {
+                if (!(majorant > 0.0f)) {
+                    return true;
+                }
+                float s = a;
+                while (true) {
+                    s -= std::log(1.0f - sampler.get_1d()) / (majorant * speed);
+                    if (s >= b) {
+                        return true;
+                    }
+                    TSpectral ext = density_field_->evaluate(local.at(s)).extinction();
+                    for (std::size_t c = 0; c < TSpectral::size(); ++c) {
+                        transmittance[c] *= std::max(1.0f - ext[c] / majorant, 0.0f);
+                    }
+                    if (transmittance.max() <= 0.0f) {
+                        return false;
+                    }
+                }
+            });
+        return transmittance;
     }
 
-    // Samples a distance along the ray to determine if/where a scattering event occurs.
-    // Returns the distance 't' and the sampled optical properties, or std::nullopt if the ray
-    // escapes.
+    /**
+     * @brief Sample where a ray first scatters before t_max, if it does.
+     *
+     * Homogeneous media sample Beer-Lambert with the channel-averaged extinction. Heterogeneous
+     * media use spectral delta tracking: tentative collisions are sampled against the majorant of
+     * each piece of the support the density field visits in turn, and each becomes an
+     * absorption, a scattering event or a null collision with probabilities proportional to the
+     * channel averages of the coefficients there.
+     *
+     * @param ray The ray, in world space
+     * @param t_max Ray parameter of the next surface hit, or infinity
+     * @param sampler Sampler for the free path
+     * @param weight Path throughput, multiplied by the ratio of the sampled path's contribution to
+     *               its probability (zero if the path is absorbed)
+     * @param world_to_local Transform from world space into the frame of the density field
+     * @return std::optional<MediumInteraction<TSpectral>> The scattering event, or std::nullopt if
+     *         the ray reaches t_max or is absorbed
+     */
     [[nodiscard]] std::optional<MediumInteraction<TSpectral>>
-    sample_free_path(const Ray<TSpectral>& ray, RandomSampler<float>& sampler) const
+    sample_free_path(const Ray<TSpectral>& ray,
+                     float t_max,
+                     RandomSampler<float>& sampler,
+                     TSpectral& weight,
+                     const Transform<float>& world_to_local = Transform<float>{}) const
     {
-        // Query properties at the ray origin (perfect for our ConstantDensityField)
-        MediumProperties<TSpectral> props = get_properties(ray.origin());
-        TSpectral ext = props.extinction();
-
-        // Compute scalar average extinction for sampling
-        float avg_ext = 0.0f;
-        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
-            avg_ext += ext[c];
+        if (density_field_->is_homogeneous()) {
+            return sample_homogeneous_(ray, t_max, sampler, weight);
         }
-        avg_ext /= static_cast<float>(TSpectral::size());
 
-        // If the medium is practically a vacuum, the ray escapes infinitely
-        if (avg_ext <= 1e-6f) {
-            return std::nullopt;
-        }
+        // Free paths are sampled in ray parameter units, which differ from local distances by the
+        // length of the local direction:
+        Ray<TSpectral> local = to_local_(ray, world_to_local);
+        const float speed = glm::length(local.direction());
+        auto [t_begin, t_end] = tracking_range_(local, t_max);
+        std::optional<MediumInteraction<TSpectral>> event;
+        bool absorbed = false;
+        density_field_->for_each_majorant_segment(
+            local, t_begin, t_end, [&](float a, float b, float majorant) {
+                if (!(majorant > 0.0f)) {
+                    return true;
+                }
+                float t = a;
+                while (true) {
+                    t -= std::log(1.0f - sampler.get_1d()) / (majorant * speed);
+                    if (t >= b) {
+                        return true;
+                    }
 
-        // Inverse Beer-Lambert sampling
-        float t = -std::log(1.0f - sampler.get_1d()) / avg_ext;
+                    MediumProperties<TSpectral> props = density_field_->evaluate(local.at(t));
+                    TSpectral null_collision = majorant - props.extinction();
+                    for (float& value : null_collision) {
+                        value = std::max(value, 0.0f);
+                    }
 
-        return MediumInteraction<TSpectral>(
-            ray.at(t), t, -ray.direction(), props, phase_function_.get());
+                    float p_absorb = props.absorption.total();
+                    float p_scatter = props.scattering.total();
+                    float p_null = null_collision.total();
+                    float p_total = p_absorb + p_scatter + p_null;
+                    if (!(p_total > 0.0f)) {
+                        continue;
+                    }
+
+                    float xi = sampler.get_1d() * p_total;
+                    if (xi < p_absorb) {
+                        absorbed = true;
+                        return false;
+                    }
+                    if (xi < p_absorb + p_scatter) {
+                        weight = weight * props.scattering * (p_total / (majorant * p_scatter));
+                        event = MediumInteraction<TSpectral>(
+                            ray.at(t), t, -ray.direction(), props, phase_function_.get());
+                        return false;
+                    }
+                    weight = weight * null_collision * (p_total / (majorant * p_null));
+                }
+            });
+        if (absorbed) {
+            weight = TSpectral{0.0f};
+        }
+        return event;
     }
 
     std::string type() const override { return "Medium"; }
@@ -106,6 +213,51 @@ class Medium : public SceneObject<Medium<TSpectral>> {
   private:
     std::shared_ptr<DensityField<TSpectral>> density_field_;
     std::shared_ptr<PhaseFunction<TSpectral>> phase_function_;
+
+    static Ray<TSpectral> to_local_(const Ray<TSpectral>& ray,
+                                    const Transform<float>& world_to_local)
+    {
+        return Ray<TSpectral>(world_to_local.apply_to_point(ray.origin()),
+                              world_to_local.apply_to_direction(ray.direction()));
+    }
+
+    std::pair<float, float> tracking_range_(const Ray<TSpectral>& local, float t_max) const
+    {
+        auto [t_begin, t_end] = density_field_->support(local);
+        return {std::max(t_begin, 0.0f), std::min(t_end, t_max)};
+    }
+
+    std::optional<MediumInteraction<TSpectral>> sample_homogeneous_(const Ray<TSpectral>& ray,
+                                                                   float t_max,
+                                                                   RandomSampler<float>& sampler,
+                                                                   TSpectral& weight) const
+    {
+        MediumProperties<TSpectral> props = get_properties(ray.origin());
+        TSpectral ext = props.extinction();
+
+        // Compute scalar average extinction for sampling
+        float avg_ext = ext.total() / static_cast<float>(TSpectral::size());
+
+        // If the medium is practically a vacuum, the ray escapes
+        if (avg_ext > 1e-6f) {
+            // Inverse Beer-Lambert sampling
+            float t = -std::log(1.0f - sampler.get_1d()) / avg_ext;
+            if (t < t_max) {
+                TSpectral Tr = (ext * -t).exp();
+                float pdf = avg_ext * std::exp(-avg_ext * t);
+                weight = weight * props.scattering * Tr * (1.0f / pdf);
+                return MediumInteraction<TSpectral>(
+                    ray.at(t), t, -ray.direction(), props, phase_function_.get());
+            }
+        }
+
+        if (std::isfinite(t_max)) {
+            TSpectral Tr = (ext * -t_max).exp();
+            float pdf = std::exp(-avg_ext * t_max);
+            weight = weight * Tr * (1.0f / pdf);
+        }
+        return std::nullopt;
+    }
 };
 
 } // namespace huira
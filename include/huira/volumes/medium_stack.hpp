@@ -5,6 +5,7 @@
 
 #include "huira/assets/primitive.hpp"
 #include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/transform.hpp"
 #include "huira/volumes/medium.hpp"
 
 namespace huira {
@@ -13,7 +14,9 @@ namespace huira {
  * @brief A small fixed-capacity stack tracking which media-bearing primitives a ray is inside.
  *
  * The active medium for free-flight sampling is the medium on top of the stack.  The stack is
- * modified only by transmission events.
+ * modified only by transmission events.  Each entry also records the transform from world space
+ * into the local frame of the instance that carries the medium, where its density field is
+ * evaluated.
  */
 template <IsSpectral TSpectral>
 class MediumStack {
@@ -30,6 +33,15 @@ class MediumStack {
         return (size_ == 0) ? nullptr : entries_[size_ - 1].medium;
     }
 
+    /**
+     * @brief Return the world to local transform of the active medium.  The stack must not be
+     * empty.
+     */
+    [[nodiscard]] const Transform<float>& top_world_to_local() const noexcept
+    {
+        return entries_[size_ - 1].world_to_local;
+    }
+
     /**
      * @brief True if no media-bearing primitives are currently on the stack.
      */
@@ -42,8 +54,11 @@ class MediumStack {
 
     /**
      * @brief Toggle membership of a primitive on the stack.
+     * @param primitive The primitive whose boundary was crossed
+     * @param local_to_world The transform of the instance of the primitive that was crossed
      */
-    void toggle(const Primitive<TSpectral>* primitive) noexcept
+    void toggle(const Primitive<TSpectral>* primitive,
+                const Transform<float>& local_to_world = Transform<float>{}) noexcept
     {
         if (primitive == nullptr) {
             return;
@@ -56,7 +71,7 @@ class MediumStack {
         if (size_ > 0 && entries_[size_ - 1].primitive == primitive) {
             --size_;
         } else if (size_ < CAPACITY) {
-            entries_[size_] = {primitive, medium};
+            entries_[size_] = {primitive, medium, local_to_world.inverse()};
             ++size_;
         }
     }
@@ -65,6 +80,7 @@ class MediumStack {
     struct Entry {
         const Primitive<TSpectral>* primitive{nullptr};
         const Medium<TSpectral>* medium{nullptr};
+        Transform<float> world_to_local{};
     };
 
     std::array<Entry, CAPACITY> entries_{};
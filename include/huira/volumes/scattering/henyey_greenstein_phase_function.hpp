@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/constants.hpp"
+#include "huira/core/types.hpp"
+#include "huira/render/interaction.hpp"
+#include "huira/render/sampler.hpp"
+#include "huira/util/logger.hpp"
+#include "huira/volumes/scattering/phase_function.hpp"
+
+namespace huira {
+
+/**
+ * @brief The Henyey-Greenstein phase function, commonly used for aerosols and dust.
+ *
+ * The asymmetry parameter g is the mean cosine of the scattering angle: positive values scatter
+ * forwards, negative values backwards, and zero is isotropic.
+ */
+template <IsSpectral TSpectral>
+class HenyeyGreensteinPhaseFunction : public PhaseFunction<TSpectral> {
+  public:
+    explicit HenyeyGreensteinPhaseFunction(float g) : g_{g}
+    {
+        if (!(g > -1.0f && g < 1.0f)) {
+            HUIRA_THROW_ERROR("HenyeyGreensteinPhaseFunction::HenyeyGreensteinPhaseFunction - "
+                              "Asymmetry parameter must be in (-1, 1)");
+        }
+    }
+    ~HenyeyGreensteinPhaseFunction() override = default;
+
+    [[nodiscard]] float evaluate(const Vec3<float>& wo, const Vec3<float>& wi) const override
+    {
+        return evaluate_(-glm::dot(wo, wi));
+    }
+
+    [[nodiscard]] PhaseSample sample(const Vec3<float>& wo,
+                                     RandomSampler<float>& sampler) const override
+    {
+        Vec2<float> u = sampler.get_2d();
+
+        float cos_theta;
+        if (std::abs(g_) < 1e-3f) {
+            cos_theta = 1.0f - 2.0f * u.x;
+        } else {
+            float s = (1.0f - g_ * g_) / (1.0f - g_ + 2.0f * g_ * u.x);
+            cos_theta = (1.0f + g_ * g_ - s * s) / (2.0f * g_);
+        }
+        cos_theta = std::clamp(cos_theta, -1.0f, 1.0f);
+        float sin_theta = std::sqrt(std::max(0.0f, 1.0f - cos_theta * cos_theta));
+        float phi = 2.0f * PI<float>() * u.y;
+
+        Vec3<float> axis = -wo;
+        Vec3<float> tangent;
+        Vec3<float> bitangent;
+        build_default_tangent_frame(axis, tangent, bitangent);
+        Vec3<float> wi = tangent * (sin_theta * std::cos(phi)) +
+                         bitangent * (sin_theta * std::sin(phi)) + axis * cos_theta;
+
+        return {wi, evaluate_(cos_theta)};
+    }
+
+    [[nodiscard]] float asymmetry() const noexcept { return g_; }
+
+    std::string type() const override { return "HenyeyGreensteinPhaseFunction"; }
+
+  private:
+    float g_;
+
+    [[nodiscard]] float evaluate_(float cos_theta) const
+    {
+        float denom = 1.0f + g_ * g_ - 2.0f * g_ * cos_theta;
+        return (1.0f - g_ * g_) / (4.0f * PI<float>() * denom * std::sqrt(denom));
+    }
+};
+
+} // namespace huira
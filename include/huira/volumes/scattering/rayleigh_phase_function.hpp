@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "huira/concepts/spectral_concepts.hpp"
+#include "huira/core/constants.hpp"
+#include "huira/core/types.hpp"
+#include "huira/render/interaction.hpp"
+#include "huira/render/sampler.hpp"
+#include "huira/volumes/scattering/phase_function.hpp"
+
+namespace huira {
+
+/**
+ * @brief Rayleigh scattering by particles much smaller than the wavelength, e.g. air molecules.
+ *
+ * p(theta) = 3 / (16 pi) * (1 + cos^2 theta), where theta is the angle between the directions of
+ * propagation before and after scattering.
+ */
+template <IsSpectral TSpectral>
+class RayleighPhaseFunction : public PhaseFunction<TSpectral> {
+  public:
+    RayleighPhaseFunction() = default;
+    ~RayleighPhaseFunction() override = default;
+
+    [[nodiscard]] float evaluate(const Vec3<float>& wo, const Vec3<float>& wi) const override
+    {
+        float cos_theta = -glm::dot(wo, wi);
+        return 3.0f / (16.0f * PI<float>()) * (1.0f + cos_theta * cos_theta);
+    }
+
+    [[nodiscard]] PhaseSample sample(const Vec3<float>& wo,
+                                     RandomSampler<float>& sampler) const override
+    {
+        Vec2<float> u = sampler.get_2d();
+
+        // Invert the CDF (cos^3 + 3 cos + 4) / 8 with Cardano's formula:
+        float q = 4.0f - 8.0f * u.x;
+        float c = std::cbrt(-0.5f * q + std::sqrt(0.25f * q * q + 1.0f));
+        float cos_theta = std::clamp(c - 1.0f / c, -1.0f, 1.0f);
+        float sin_theta = std::sqrt(std::max(0.0f, 1.0f - cos_theta * cos_theta));
+        float phi = 2.0f * PI<float>() * u.y;
+
+        Vec3<float> axis = -wo;
+        Vec3<float> tangent;
+        Vec3<float> bitangent;
+        build_default_tangent_frame(axis, tangent, bitangent);
+        Vec3<float> wi = tangent * (sin_theta * std::cos(phi)) +
+                         bitangent * (sin_theta * std::sin(phi)) + axis * cos_theta;
+
+        return {wi, evaluate(wo, wi)};
+    }
+
+    std::string type() const override { return "RayleighPhaseFunction"; }
+};
+
+} // namespace huira
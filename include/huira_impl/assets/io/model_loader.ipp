@@ -1,6 +1,17 @@
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
@@ -9,9 +20,13 @@
 #include "huira/core/types.hpp"
 #include "huira/geometry/vertex.hpp"
 #include "huira/handles/geometry/geometry_handle.hpp"
+#include "huira/images/color_map.hpp"
 #include "huira/images/io/read_image.hpp"
 #include "huira/materials/bsdfs/cook_torrance_bsdf.hpp"
+#include "huira/util/content_hash.hpp"
 #include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 namespace huira {
 /**
@@ -24,6 +39,7 @@ namespace huira {
  * @param file_path Path to the model file
  * @param name Name for the model (optional)
  * @param post_process_flags ASSIMP post-processing flags (optional)
+ * @param lod_levels Levels of detail to generate for each mesh, see Mesh::generate_lods (optional)
  * @return Shared pointer to the loaded Model
  * @throws std::runtime_error if loading fails
  */
@@ -33,6 +49,7 @@ ModelLoader<TSpectral>::load(Scene<TSpectral>& scene,
                              const fs::path& file_path,
                              std::string name,
                              unsigned int post_process_flags,
+                             std::size_t lod_levels,
                              std::function<TSpectral(RGB)> spectral_conversion)
 {
     // Validate file exists
@@ -76,6 +93,10 @@ ModelLoader<TSpectral>::load(Scene<TSpectral>& scene,
     ctx.model = shared_model.get();
     ctx.scene = &scene;
     ctx.spectral_conversion = std::move(spectral_conversion);
+    ctx.lod_levels = lod_levels;
+    if (RGBSpectralBasis<TSpectral> basis(ctx.spectral_conversion); basis.linear()) {
+        ctx.spectral_basis = basis;
+    }
     ctx.base_directory = file_path.parent_path();
 
     // Process all materials:
@@ -114,63 +135,323 @@ ModelLoader<TSpectral>::load(Scene<TSpectral>& scene,
     return shared_model;
 }
 
+/**
+ * @brief Load every mesh in a file as a single Mesh, without materials or scene graph.
+ *
+ * Meant for shape models: node transforms are baked into the vertices and all meshes are merged
+ * into one. Tangents are kept only if every mesh has them.
+ *
+ * @param file_path Path to the model file
+ * @param post_process_flags ASSIMP post-processing flags (optional)
+ * @param spectral_conversion Converts vertex colours to albedo (optional)
+ * @return Shared pointer to the Mesh, not yet added to any scene
+ * @throws std::runtime_error if loading fails or the file holds no triangles
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>>
+ModelLoader<TSpectral>::load_mesh(const fs::path& file_path,
+                                  unsigned int post_process_flags,
+                                  std::function<TSpectral(RGB)> spectral_conversion)
+{
+    HUIRA_TRACE_SCOPE("ModelLoader::load_mesh");
+    if (!fs::exists(file_path)) {
+        HUIRA_THROW_ERROR("ModelLoader::load_mesh - File not found: " + file_path.string());
+    }
+
+    Assimp::Importer importer;
+    const aiScene* ai_scene =
+        importer.ReadFile(file_path.string(), post_process_flags | aiProcess_PreTransformVertices);
+    if (!ai_scene || ai_scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
+        HUIRA_THROW_ERROR("ModelLoader::load_mesh - ASSIMP error loading '" + file_path.string() +
+                          "': " + std::string(importer.GetErrorString()));
+    }
+
+    std::size_t index_count = 0;
+    std::size_t vertex_count = 0;
+    bool tangents = true;
+    for (unsigned int i = 0; i < ai_scene->mNumMeshes; ++i) {
+        index_count += ai_scene->mMeshes[i]->mNumFaces * 3;
+        vertex_count += ai_scene->mMeshes[i]->mNumVertices;
+        tangents = tangents && ai_scene->mMeshes[i]->HasTangentsAndBitangents();
+    }
+    if (vertex_count > std::numeric_limits<std::uint32_t>::max()) {
+        HUIRA_THROW_ERROR("ModelLoader::load_mesh - Too many vertices in " + file_path.string());
+    }
+
+    IndexBuffer indices;
+    VertexBuffer<TSpectral> vertices;
+    TangentBuffer tangent_buffer;
+    indices.reserve(index_count);
+    vertices.reserve(vertex_count);
+    tangent_buffer.reserve(tangents ? vertex_count : 0);
+    for (unsigned int i = 0; i < ai_scene->mNumMeshes; ++i) {
+        append_mesh_(ai_scene->mMeshes[i], spectral_conversion, indices, vertices, tangent_buffer);
+    }
+    if (!tangents) {
+        tangent_buffer.clear();
+    }
+    if (indices.empty()) {
+        HUIRA_THROW_ERROR("ModelLoader::load_mesh - No triangles in " + file_path.string());
+    }
+
+    HUIRA_LOG_INFO("ModelLoader::load_mesh - Loaded " + file_path.string() + " (" +
+                   std::to_string(vertices.size()) + " vertices, " +
+                   std::to_string(indices.size() / 3) + " triangles)");
+    return std::make_shared<Mesh<TSpectral>>(
+        std::move(indices), vertices, std::move(tangent_buffer));
+}
+
+/// Whether a geometry is a mesh holding exactly the given buffers, packed as Mesh packs them
+template <IsSpectral TSpectral>
+bool same_mesh_(const Geometry<TSpectral>& geometry,
+                const IndexBuffer& indices,
+                const VertexBuffer<TSpectral>& vertices,
+                const TangentBuffer& tangent_buffer)
+{
+    const auto* mesh = dynamic_cast<const Mesh<TSpectral>*>(&geometry);
+    if (!mesh || mesh->vertex_count() != vertices.size() ||
+        !std::ranges::equal(mesh->index_buffer(), indices) ||
+        !std::ranges::equal(mesh->tangent_buffer(),
+                            tangent_buffer,
+                            [](const Tangent& a, const Tangent& b) {
+                                return a.tangent == b.tangent && a.bitangent == b.bitangent;
+                            })) {
+        return false;
+    }
+
+    const VertexStreams<TSpectral> packed(vertices);
+    for (std::size_t v = 0; v < packed.size(); ++v) {
+        if (!(mesh->vertex_streams().vertex(v) == packed.vertex(v))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Process all meshes in the ASSIMP scene and create huira Mesh objects.
  *
- * Iterates through all meshes in the ASSIMP scene, converts them, and stores them in the loading
- * context.
+ * Conversion to huira buffers, packing into Mesh objects and level of detail generation are
+ * independent for each mesh, so they are spread across the TBB pool: first every mesh is
+ * converted, then each mesh not already in the scene is built once. Registering the meshes and
+ * their primitives with the Scene stays serial (see add_mesh_), so asset order and naming do not
+ * depend on thread timing.
+ *
+ * The spectral conversion may be called from several threads at once.
  *
  * @param ctx Loading context
  */
 template <IsSpectral TSpectral>
 void ModelLoader<TSpectral>::process_meshes_(LoadContext& ctx)
 {
-    for (unsigned int i = 0; i < ctx.ai_scene->mNumMeshes; ++i) {
+    HUIRA_TRACE_SCOPE("ModelLoader::process_meshes_");
+    const std::size_t mesh_count = ctx.ai_scene->mNumMeshes;
+
+    std::vector<ConvertedMesh> converted(mesh_count);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, mesh_count, 1),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t i = range.begin(); i != range.end(); ++i) {
+                              converted[i] = convert_mesh_(ctx.ai_scene->mMeshes[i], ctx);
+                          }
+                      });
+
+    // Build each distinct mesh once, skipping those the scene already holds. Meshes that only
+    // share a hash are told apart by add_mesh_, which builds them then:
+    std::vector<std::size_t> to_build;
+    std::unordered_set<std::uint64_t> seen;
+    for (std::size_t i = 0; i < mesh_count; ++i) {
+        const ConvertedMesh& mesh = converted[i];
+        auto same = [&mesh](const Geometry<TSpectral>& geometry) {
+            return same_mesh_(geometry, mesh.indices, mesh.vertices, mesh.tangent_buffer);
+        };
+        if (seen.insert(mesh.content_hash).second &&
+            !find_content_(ctx.scene->geometry_content_, mesh.content_hash, same)) {
+            to_build.push_back(i);
+        }
+    }
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, to_build.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t i = range.begin(); i != range.end(); ++i) {
+                              build_mesh_(converted[to_build[i]], ctx);
+                          }
+                      });
+
+    for (std::size_t i = 0; i < mesh_count; ++i) {
         const aiMesh* ai_mesh = ctx.ai_scene->mMeshes[i];
 
-        auto primitive_handle = convert_mesh_(ai_mesh, ctx);
-        ctx.primitive_map.emplace(i, primitive_handle);
+        auto primitive_handle = add_mesh_(ai_mesh, converted[i], ctx);
+        ctx.primitive_map.emplace(static_cast<unsigned int>(i), primitive_handle);
+        converted[i] = ConvertedMesh{};
 
         HUIRA_LOG_DEBUG("ModelLoader::process_meshes_ - Processed mesh " + std::to_string(i) +
                         ": " + std::string(ai_mesh->mName.C_Str()) + " (" +
                         std::to_string(ai_mesh->mNumVertices) + " vertices, " +
                         std::to_string(ai_mesh->mNumFaces) + " faces)");
     }
+
+    HUIRA_LOG_INFO("ModelLoader::process_meshes_ - Built " + std::to_string(to_build.size()) +
+                   " of " + std::to_string(mesh_count) + " meshes");
 }
 
 /**
- * @brief Convert a single ASSIMP mesh to a huira Mesh.
+ * @brief Convert a single ASSIMP mesh to huira buffers.
  *
- * Converts the given ASSIMP mesh to a huira Mesh, including vertex and index buffers.
+ * Only reads from the LoadContext, so several meshes can be converted at once.
  *
  * @param ai_mesh ASSIMP mesh pointer
  * @param ctx Loading context
- * @return Mesh handle for the converted mesh
+ * @return ConvertedMesh The buffers and their content hash
  */
 template <IsSpectral TSpectral>
-PrimitiveHandle<TSpectral> ModelLoader<TSpectral>::convert_mesh_(const aiMesh* ai_mesh,
-                                                                 LoadContext& ctx)
+typename ModelLoader<TSpectral>::ConvertedMesh
+ModelLoader<TSpectral>::convert_mesh_(const aiMesh* ai_mesh, const LoadContext& ctx)
 {
-    // Build index buffer
-    IndexBuffer indices;
-    indices.reserve(ai_mesh->mNumFaces * 3);
+    ConvertedMesh converted;
+    IndexBuffer& indices = converted.indices;
+    VertexBuffer<TSpectral>& vertices = converted.vertices;
+    TangentBuffer& tangent_buffer = converted.tangent_buffer;
+    append_mesh_(ai_mesh, ctx.spectral_conversion, indices, vertices, tangent_buffer);
+
+    ContentHasher content;
+    content.value(indices.size()).values(indices.data(), indices.size());
+    content.value(vertices.size());
+    for (const Vertex<TSpectral>& vertex : vertices) {
+        // Hashed field by field, as Vertex may contain padding:
+        content.value(vertex.position).value(vertex.normal).value(vertex.uv);
+        content.values(vertex.albedo.data(), vertex.albedo.size());
+    }
+    content.value(tangent_buffer.size()).values(tangent_buffer.data(), tangent_buffer.size());
+
+    // Meshes loaded with different levels of detail are kept apart. Hashed last, so that meshes
+    // with the same buffers always differ in digest:
+    content.value(ctx.lod_levels);
+
+    converted.content_hash = content.digest();
+    return converted;
+}
+
+/**
+ * @brief Pack converted buffers into a Mesh and generate its levels of detail.
+ *
+ * The buffers are moved into the mesh. Only reads from the LoadContext, so several meshes can be
+ * built at once.
+ *
+ * @param converted The converted mesh, whose mesh is set
+ * @param ctx Loading context
+ */
+template <IsSpectral TSpectral>
+void ModelLoader<TSpectral>::build_mesh_(ConvertedMesh& converted, const LoadContext& ctx)
+{
+    converted.mesh = std::make_shared<Mesh<TSpectral>>(std::move(converted.indices),
+                                                       converted.vertices,
+                                                       std::move(converted.tangent_buffer));
+    converted.vertices = VertexBuffer<TSpectral>{};
+    if (ctx.lod_levels > 0) {
+        converted.mesh->generate_lods(ctx.lod_levels);
+    }
+}
+
+/**
+ * @brief Add a converted mesh and its primitive to the scene.
+ *
+ * A mesh whose buffers match one already in the scene reuses that mesh (and so its BLAS), and a
+ * primitive pairing the same mesh and material is likewise reused. A mesh not built up front, but
+ * found to differ from the one sharing its hash, is built here.
+ *
+ * @param ai_mesh ASSIMP mesh pointer
+ * @param converted The converted mesh
+ * @param ctx Loading context
+ * @return Primitive handle for the mesh and its material
+ */
+template <IsSpectral TSpectral>
+PrimitiveHandle<TSpectral> ModelLoader<TSpectral>::add_mesh_(const aiMesh* ai_mesh,
+                                                             ConvertedMesh& converted,
+                                                             LoadContext& ctx)
+{
+    GeometryHandle<TSpectral> geom_handle = share_content_(
+        ctx.scene->geometry_content_,
+        converted.content_hash,
+        [&](const Geometry<TSpectral>& geometry) {
+            return same_mesh_(
+                geometry, converted.indices, converted.vertices, converted.tangent_buffer);
+        },
+        [&] {
+            if (!converted.mesh) {
+                build_mesh_(converted, ctx);
+            }
+            return ctx.scene->add_geometry(converted.mesh, std::string(ai_mesh->mName.C_Str()));
+        });
+
+    // Assign material
+    unsigned int material_index = ai_mesh->mMaterialIndex;
+    auto mat_it = ctx.material_map.find(material_index);
+
+    MaterialHandle<TSpectral> mat_handle =
+        (mat_it != ctx.material_map.end())
+            ? mat_it->second
+            : MaterialHandle<TSpectral>{std::weak_ptr<Material<TSpectral>>{}};
+
+    if (mat_it == ctx.material_map.end()) {
+        HUIRA_LOG_WARNING("ModelLoader::add_mesh_ - No material found for mesh " +
+                          std::string(ai_mesh->mName.C_Str()) + " (material index " +
+                          std::to_string(material_index) + "). Using default.");
+    }
+
+    std::shared_ptr<Geometry<TSpectral>> geometry = geom_handle.get();
+    std::shared_ptr<Material<TSpectral>> material =
+        mat_it != ctx.material_map.end() ? mat_handle.get() : nullptr;
+    ContentHasher primitive_content;
+    primitive_content.value(geometry->id());
+    primitive_content.value(material ? material->id() : std::numeric_limits<std::uint64_t>::max());
+    return share_content_(
+        ctx.scene->primitive_content_,
+        primitive_content.digest(),
+        [&](const Primitive<TSpectral>& primitive) {
+            return primitive.geometry == geometry && primitive.material == material &&
+                   primitive.medium == ctx.scene->default_medium_;
+        },
+        [&] {
+            return ctx.scene->add_primitive(
+                geom_handle, mat_handle, std::string(ai_mesh->mName.C_Str()));
+        });
+}
+
+/**
+ * @brief Append the triangles, vertices and tangents of an ASSIMP mesh to a set of buffers.
+ *
+ * Indices are offset past the vertices already in the buffers. Tangents are only appended if the
+ * ASSIMP mesh has them.
+ *
+ * @param ai_mesh ASSIMP mesh pointer
+ * @param spectral_conversion Converts vertex colours to albedo
+ * @param indices Index buffer to append to
+ * @param vertices Vertex buffer to append to
+ * @param tangent_buffer Tangent buffer to append to
+ */
+template <IsSpectral TSpectral>
+void ModelLoader<TSpectral>::append_mesh_(const aiMesh* ai_mesh,
+                                          const std::function<TSpectral(RGB)>& spectral_conversion,
+                                          IndexBuffer& indices,
+                                          VertexBuffer<TSpectral>& vertices,
+                                          TangentBuffer& tangent_buffer)
+{
+    const auto first_vertex = static_cast<std::uint32_t>(vertices.size());
 
+    // Build index buffer
+    indices.reserve(indices.size() + ai_mesh->mNumFaces * 3);
     for (unsigned int i = 0; i < ai_mesh->mNumFaces; ++i) {
         const aiFace& face = ai_mesh->mFaces[i];
         // After triangulation, all faces should have 3 indices
         if (face.mNumIndices == 3) {
-            indices.push_back(face.mIndices[0]);
-            indices.push_back(face.mIndices[1]);
-            indices.push_back(face.mIndices[2]);
+            indices.push_back(first_vertex + face.mIndices[0]);
+            indices.push_back(first_vertex + face.mIndices[1]);
+            indices.push_back(first_vertex + face.mIndices[2]);
         }
         // Skip non-triangle primitives (points, lines) that might remain
     }
 
     // Build vertex buffer
-    VertexBuffer<TSpectral> vertices;
-    TangentBuffer tangent_buffer;
-    vertices.reserve(ai_mesh->mNumVertices);
-
+    vertices.reserve(vertices.size() + ai_mesh->mNumVertices);
     for (unsigned int i = 0; i < ai_mesh->mNumVertices; ++i) {
         Vertex<TSpectral> vertex;
 
@@ -198,7 +479,7 @@ PrimitiveHandle<TSpectral> ModelLoader<TSpectral>::convert_mesh_(const aiMesh* a
             const aiColor4D& color = ai_mesh->mColors[0][i];
             // NOTE: Vertex alpha is ignored
             RGB rgb{color.r, color.g, color.b};
-            vertex.albedo = ctx.spectral_conversion(rgb);
+            vertex.albedo = spectral_conversion(rgb);
         }
 
         // Tangent and bitangent (needed for normal mapping)
@@ -211,27 +492,6 @@ PrimitiveHandle<TSpectral> ModelLoader<TSpectral>::convert_mesh_(const aiMesh* a
 
         vertices.push_back(vertex);
     }
-
-    auto mesh = std::make_shared<Mesh<TSpectral>>(
-        std::move(indices), std::move(vertices), std::move(tangent_buffer));
-    auto geom_handle = ctx.scene->add_geometry(mesh, std::string(ai_mesh->mName.C_Str()));
-
-    // Assign material
-    unsigned int material_index = ai_mesh->mMaterialIndex;
-    auto mat_it = ctx.material_map.find(material_index);
-
-    MaterialHandle<TSpectral> mat_handle =
-        (mat_it != ctx.material_map.end())
-            ? mat_it->second
-            : MaterialHandle<TSpectral>{std::weak_ptr<Material<TSpectral>>{}};
-
-    if (mat_it == ctx.material_map.end()) {
-        HUIRA_LOG_WARNING("ModelLoader::convert_mesh_ - No material found for mesh " +
-                          std::string(ai_mesh->mName.C_Str()) + " (material index " +
-                          std::to_string(material_index) + "). Using default.");
-    }
-
-    return ctx.scene->add_primitive(geom_handle, mat_handle, std::string(ai_mesh->mName.C_Str()));
 }
 
 /**
@@ -362,113 +622,221 @@ Vec3<float> ModelLoader<TSpectral>::convert_vec3_(const aiVector3D& v)
     return Vec3<float>{static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)};
 }
 
+/// The slot holding a material's packed roughness/metallic texture (GLTF stores both in one)
+inline aiTextureType packed_roughness_metallic_type_(const aiMaterial* ai_mat)
+{
+    return ai_mat->GetTextureCount(aiTextureType_DIFFUSE_ROUGHNESS) > 0
+               ? aiTextureType_DIFFUSE_ROUGHNESS
+               : aiTextureType_METALNESS;
+}
+
+/// Extract one channel of a packed texture (GLTF stores roughness in green and metallic in blue)
+inline Image<float> extract_channel_(const Image<Vec3<float>>& packed, int channel)
+{
+    Image<float> result(packed.width(), packed.height());
+    for (int y = 0; y < packed.height(); ++y) {
+        for (int x = 0; x < packed.width(); ++x) {
+            result(x, y) = packed(x, y)[channel];
+        }
+    }
+    return result;
+}
+
+/// Whether an image holds the source's texels, each as stored() would store it
+template <typename TStored, typename TSource, typename TStore>
+bool same_pixels_(const Image<TStored>& image, const Image<TSource>& source, TStore&& stored)
+{
+    if (!(image.resolution() == source.resolution())) {
+        return false;
+    }
+    for (int y = 0; y < source.height(); ++y) {
+        for (int x = 0; x < source.width(); ++x) {
+            if (!(image(x, y) == stored(source(x, y)))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Hash an optional texture slot by the identity of the (already shared) texture it holds
+template <typename TPixel>
+void hash_texture_slot_(ContentHasher& content, const std::optional<TextureHandle<TPixel>>& tex)
+{
+    content.value(tex ? tex->id() : std::numeric_limits<std::uint64_t>::max());
+}
+
+/// Hash an optional spectral or scalar factor
+template <typename T>
+void hash_factor_(ContentHasher& content, const std::optional<T>& factor)
+{
+    content.value(factor.has_value());
+    if (factor) {
+        if constexpr (std::is_floating_point_v<T>) {
+            content.value(*factor);
+        } else {
+            content.values(factor->data(), factor->size());
+        }
+    }
+}
+
+/**
+ * @brief Convert every ASSIMP material, sharing materials identical to ones already in the scene.
+ *
+ * A material's content is its BSDF, the identity of each texture it uses (textures are themselves
+ * shared by content, see load_material_texture_) and its factors. A material matching one from an
+ * earlier load is reused rather than created again.
+ *
+ * @param ctx Loading context
+ */
 template <IsSpectral TSpectral>
 void ModelLoader<TSpectral>::process_materials_(LoadContext& ctx)
 {
-    auto ct_bsdf = ctx.scene->new_bsdf_cook_torrance();
+    decode_textures_(ctx);
+
+    // Cook-Torrance has no parameters, so every loaded model can share one:
+    BSDFHandle<TSpectral> ct_bsdf = share_content_(
+        ctx.scene->bsdf_content_,
+        ContentHasher{}.string("CookTorranceBSDF").digest(),
+        [](const BSDF<TSpectral>& bsdf) {
+            return dynamic_cast<const CookTorranceBSDF<TSpectral>*>(&bsdf) != nullptr;
+        },
+        [&] { return ctx.scene->new_bsdf_cook_torrance(); });
+
     for (unsigned int i = 0; i < ctx.ai_scene->mNumMaterials; ++i) {
         const aiMaterial* ai_mat = ctx.ai_scene->mMaterials[i];
         std::string name = std::string(ai_mat->GetName().C_Str());
-        MaterialHandle<TSpectral> material = ctx.scene->new_material(ct_bsdf, name);
-
-        // Assign albedos:
-        if (auto [tex, alpha] = load_material_texture_<TSpectral>(
-                ai_mat, aiTextureType_BASE_COLOR, ctx, true, true);
-            tex) {
-            material.set_albedo_image(tex.value());
-            if (alpha.has_value()) {
-                material.set_alpha_image(alpha.value());
-            }
-        }
+
+        // Albedos:
+        std::optional<TextureHandle<TSpectral>> albedo_tex;
+        std::optional<TextureHandle<float>> alpha_tex;
+        std::tie(albedo_tex, alpha_tex) = load_material_texture_<TSpectral>(
+            ai_mat, aiTextureType_BASE_COLOR, ctx, true, true);
+        std::optional<TSpectral> albedo_factor;
+        std::optional<float> alpha_factor;
         aiColor4D base_color;
         if (ai_mat->Get(AI_MATKEY_BASE_COLOR, base_color) == AI_SUCCESS) {
-            material.set_albedo_factor(
-                ctx.spectral_conversion(RGB{base_color.r, base_color.g, base_color.b}));
-            material.set_alpha_factor(base_color.a);
+            albedo_factor = ctx.spectral_conversion(RGB{base_color.r, base_color.g, base_color.b});
+            alpha_factor = base_color.a;
         }
 
-        // Load roughness and metallic from packed textures:
+        // Roughness and metallic, from packed textures:
+        std::optional<TextureHandle<float>> roughness_tex;
+        std::optional<TextureHandle<float>> metallic_tex;
         if (ai_mat->GetTextureCount(aiTextureType_DIFFUSE_ROUGHNESS) > 0 ||
             ai_mat->GetTextureCount(aiTextureType_METALNESS) > 0) {
             // Load as RGB to extract individual channels
-            aiTextureType packed_type = ai_mat->GetTextureCount(aiTextureType_DIFFUSE_ROUGHNESS) > 0
-                                            ? aiTextureType_DIFFUSE_ROUGHNESS
-                                            : aiTextureType_METALNESS;
+            aiTextureType packed_type = packed_roughness_metallic_type_(ai_mat);
 
             if (auto [tex, _] =
                     load_material_texture_<Vec3<float>>(ai_mat, packed_type, ctx, false, false);
                 tex) {
                 TextureHandle<Vec3<float>> packed_handle = tex.value();
-
-                std::string rough_cache_key = "split_rough_" + std::to_string(packed_handle.id());
-                std::string metal_cache_key = "split_metal_" + std::to_string(packed_handle.id());
-
-                std::optional<TextureHandle<float>> rough_handle;
-                std::optional<TextureHandle<float>> metal_handle;
-
-                auto rough_it = ctx.mono_texture_cache.find(rough_cache_key);
-                auto metal_it = ctx.mono_texture_cache.find(metal_cache_key);
-
-                if (rough_it != ctx.mono_texture_cache.end() &&
-                    metal_it != ctx.mono_texture_cache.end()) {
-                    rough_handle = rough_it->second;
-                    metal_handle = metal_it->second;
-                } else {
-                    std::shared_ptr<Image<Vec3<float>>> packed_ptr =
-                        packed_handle.get()->shared_image();
-                    const Image<Vec3<float>>& packed = *packed_ptr;
-
-                    Image<float> roughness_img(packed.width(), packed.height());
-                    Image<float> metallic_img(packed.width(), packed.height());
-
-                    for (int y = 0; y < packed.height(); ++y) {
-                        for (int x = 0; x < packed.width(); ++x) {
-                            roughness_img(x, y) = packed(x, y).y; // green
-                            metallic_img(x, y) = packed(x, y).z;  // blue
-                        }
-                    }
-
-                    rough_handle =
-                        ctx.scene->add_texture(std::move(roughness_img), rough_cache_key);
-                    metal_handle = ctx.scene->add_texture(std::move(metallic_img), metal_cache_key);
-
-                    ctx.mono_texture_cache.emplace(rough_cache_key, rough_handle.value());
-                    ctx.mono_texture_cache.emplace(metal_cache_key, metal_handle.value());
-                }
-
-                material.set_roughness_image(rough_handle.value());
-                material.set_metallic_image(metal_handle.value());
+                std::shared_ptr<Image<Vec3<float>>> packed = packed_handle.get()->shared_image();
+                auto split = [&](const std::string& channel_name, int channel) {
+                    std::uint64_t key =
+                        ContentHasher{}.string(channel_name).value(packed_handle.id()).digest();
+                    return share_content_(
+                        ctx.scene->mono_texture_content_,
+                        key,
+                        [&](const Texture<float>& texture) {
+                            return same_pixels_(*texture.shared_image(),
+                                                *packed,
+                                                [channel](const Vec3<float>& texel) {
+                                                    return texel[channel];
+                                                });
+                        },
+                        [&] {
+                            return ctx.scene->add_texture(
+                                extract_channel_(*packed, channel),
+                                "split_" + channel_name + "_" + std::to_string(packed_handle.id()));
+                        });
+                };
+                roughness_tex = split("rough", 1); // green
+                metallic_tex = split("metal", 2);  // blue
             }
         }
 
-        float roughness_factor = 1.0f;
-        if (ai_mat->Get(AI_MATKEY_ROUGHNESS_FACTOR, roughness_factor) == AI_SUCCESS) {
-            material.set_roughness_factor(roughness_factor);
+        std::optional<float> roughness_factor;
+        if (float factor = 1.0f; ai_mat->Get(AI_MATKEY_ROUGHNESS_FACTOR, factor) == AI_SUCCESS) {
+            roughness_factor = factor;
         }
 
-        float metallic_factor = 1.0f;
-        if (ai_mat->Get(AI_MATKEY_METALLIC_FACTOR, metallic_factor) == AI_SUCCESS) {
-            material.set_metallic_factor(metallic_factor);
+        std::optional<float> metallic_factor;
+        if (float factor = 1.0f; ai_mat->Get(AI_MATKEY_METALLIC_FACTOR, factor) == AI_SUCCESS) {
+            metallic_factor = factor;
         }
 
-        // Assign normals:
-        if (auto [tex, _] = load_material_texture_<Vec3<float>>(
-                ai_mat, aiTextureType_NORMALS, ctx, false, false);
-            tex) {
-            material.set_normal_image(tex.value());
+        // Normals:
+        std::optional<TextureHandle<Vec3<float>>> normal_tex =
+            load_material_texture_<Vec3<float>>(ai_mat, aiTextureType_NORMALS, ctx, false, false)
+                .first;
+
+        // Emissive:
+        std::optional<TextureHandle<TSpectral>> emissive_tex =
+            load_material_texture_<TSpectral>(
+                ai_mat, aiTextureType_EMISSION_COLOR, ctx, false, false)
+                .first;
+        std::optional<TSpectral> emissive_factor;
+        aiColor3D emissive;
+        if (ai_mat->Get(AI_MATKEY_COLOR_EMISSIVE, emissive) == AI_SUCCESS) {
+            emissive_factor = ctx.spectral_conversion(RGB{emissive.r, emissive.g, emissive.b});
         }
 
-        // Assign emissive:
-        if (auto [tex, _] = load_material_texture_<TSpectral>(
-                ai_mat, aiTextureType_EMISSION_COLOR, ctx, false, false);
-            tex) {
-            material.set_emissive_image(tex.value());
+        ContentHasher content;
+        content.value(ct_bsdf.id());
+        hash_texture_slot_(content, albedo_tex);
+        hash_texture_slot_(content, alpha_tex);
+        hash_texture_slot_(content, roughness_tex);
+        hash_texture_slot_(content, metallic_tex);
+        hash_texture_slot_(content, normal_tex);
+        hash_texture_slot_(content, emissive_tex);
+        hash_factor_(content, albedo_factor);
+        hash_factor_(content, alpha_factor);
+        hash_factor_(content, roughness_factor);
+        hash_factor_(content, metallic_factor);
+        hash_factor_(content, emissive_factor);
+
+        // Set up apart from the scene, then compared with the material sharing its hash:
+        std::shared_ptr<Material<TSpectral>> candidate = ctx.scene->make_material_(ct_bsdf.get());
+        MaterialHandle<TSpectral> mat{candidate};
+        if (albedo_tex) {
+            mat.set_albedo_image(*albedo_tex);
+            if (alpha_tex) {
+                mat.set_alpha_image(*alpha_tex);
+            }
         }
-        aiColor3D emissive;
-        if (ai_mat->Get(AI_MATKEY_COLOR_EMISSIVE, emissive) == AI_SUCCESS) {
-            material.set_emissive_factor(
-                ctx.spectral_conversion(RGB{emissive.r, emissive.g, emissive.b}));
+        if (albedo_factor) {
+            mat.set_albedo_factor(*albedo_factor);
+            mat.set_alpha_factor(*alpha_factor);
+        }
+        if (roughness_tex) {
+            mat.set_roughness_image(*roughness_tex);
+            mat.set_metallic_image(*metallic_tex);
+        }
+        if (roughness_factor) {
+            mat.set_roughness_factor(*roughness_factor);
         }
+        if (metallic_factor) {
+            mat.set_metallic_factor(*metallic_factor);
+        }
+        if (normal_tex) {
+            mat.set_normal_image(*normal_tex);
+        }
+        if (emissive_tex) {
+            mat.set_emissive_image(*emissive_tex);
+        }
+        if (emissive_factor) {
+            mat.set_emissive_factor(*emissive_factor);
+        }
+
+        MaterialHandle<TSpectral> material = share_content_(
+            ctx.scene->material_content_,
+            content.digest(),
+            [&](const Material<TSpectral>& existing) {
+                return existing.same_parameters(*candidate);
+            },
+            [&] { return ctx.scene->add_material(candidate, name); });
 
         ctx.material_map.emplace(i, material);
 
@@ -477,7 +845,7 @@ void ModelLoader<TSpectral>::process_materials_(LoadContext& ctx)
     }
 }
 
-enum class ImageFormat_ { PNG, JPEG, TGA, BMP, HDR, Unknown };
+enum class ImageFormat_ { PNG, JPEG, TGA, BMP, HDR, TIFF, Unknown };
 inline ImageFormat_ detect_image_format_(const std::string& hint_or_extension)
 {
     std::string lower = hint_or_extension;
@@ -505,6 +873,9 @@ inline ImageFormat_ detect_image_format_(const std::string& hint_or_extension)
     if (lower == "hdr") {
         return ImageFormat_::HDR;
     }
+    if (lower == "tif" || lower == "tiff") {
+        return ImageFormat_::TIFF;
+    }
     return ImageFormat_::Unknown;
 }
 
@@ -524,6 +895,8 @@ inline ImageBundle<RGB> load_rgb_from_buffer_(const unsigned char* data,
         return read_image(ImageFormat::IMAGE_FORMAT_BMP, data, size, read_alpha);
     case ImageFormat_::HDR:
         return read_image(ImageFormat::IMAGE_FORMAT_HDR, data, size, read_alpha);
+    case ImageFormat_::TIFF:
+        return read_image(ImageFormat::IMAGE_FORMAT_TIFF, data, size, read_alpha);
     case ImageFormat_::Unknown:
     default:
         HUIRA_THROW_ERROR("load_rgb_from_buffer_ - Unsupported image format");
@@ -546,6 +919,8 @@ inline ImageBundle<float> load_mono_from_buffer_(const unsigned char* data,
         return read_image_mono(ImageFormat::IMAGE_FORMAT_BMP, data, size, read_alpha);
     case ImageFormat_::HDR:
         return read_image_mono(ImageFormat::IMAGE_FORMAT_HDR, data, size, read_alpha);
+    case ImageFormat_::TIFF:
+        return read_image_mono(ImageFormat::IMAGE_FORMAT_TIFF, data, size, read_alpha);
     case ImageFormat_::Unknown:
     default:
         HUIRA_THROW_ERROR("load_mono_from_buffer_ - Unsupported image format");
@@ -566,6 +941,8 @@ inline ImageBundle<RGB> load_rgb_from_file_(const fs::path& filepath, bool read_
         return read_image_bmp(filepath, read_alpha);
     case ImageFormat_::HDR:
         return read_image_hdr(filepath);
+    case ImageFormat_::TIFF:
+        return read_image_tiff_rgb(filepath, read_alpha);
     case ImageFormat_::Unknown:
     default:
         HUIRA_THROW_ERROR("load_rgb_from_file_ - Unsupported format: " +
@@ -587,6 +964,8 @@ inline ImageBundle<float> load_mono_from_file_(const fs::path& filepath, bool re
         return read_image_bmp_mono(filepath, read_alpha);
     case ImageFormat_::HDR:
         return read_image_hdr_mono(filepath);
+    case ImageFormat_::TIFF:
+        return read_image_tiff_mono(filepath, read_alpha);
     case ImageFormat_::Unknown:
     default:
         HUIRA_THROW_ERROR("load_mono_from_file_ - Unsupported format: " +
@@ -594,6 +973,14 @@ inline ImageBundle<float> load_mono_from_file_(const fs::path& filepath, bool re
     }
 }
 
+/// Hash an image's size, layout and pixels
+template <typename TPixel>
+void hash_image_(ContentHasher& content, const Image<TPixel>& image)
+{
+    content.value(image.width()).value(image.height()).value(image.layout());
+    content.values(image.data(), image.size());
+}
+
 /// Convert Image<RGB> to Image<Vec3<float>> (direct channel copy, for normal maps)
 inline Image<Vec3<float>> rgb_to_vec3_(const Image<RGB>& rgb)
 {
@@ -675,67 +1062,110 @@ inline Image<float> extract_blue_channel_(const Image<RGB>& rgb)
 }
 
 /**
- * @brief Load a texture from an aiMaterial for a given texture type.
+ * @brief Decode every texture referenced by the model's materials, in parallel.
  *
- * Checks whether the material has a texture for the given slot, resolves
- * the path (embedded or on-disk), loads the raw image data, converts it
- * to the target pixel type TPixel, registers it with the Scene, and returns
- * a TextureHandle. Uses the LoadContext caches for deduplication.
+ * Walks the materials in the same order and with the same slot flags as process_materials_, so
+ * each unique texture path is decoded once, with the flags of its first use. The decodes are
+ * independent, so they are spread across the TBB pool instead of running one after another.
+ * Registering the results with the Scene stays serial (see load_material_texture_), so texture
+ * order and naming do not depend on thread timing.
  *
- * @tparam TPixel Target pixel type (TSpectral, float, or Vec3<float>)
- * @param ai_mat The ASSIMP material
- * @param tex_type The ASSIMP texture type slot
- * @param ctx Loading context with scene reference and caches
- * @param read_alpha Whether to also load the alpha channel as a separate texture (if supported by
- * format)
- * @param is_normal_map Whether the texture is a normal map
- * @return TextureHandle if a texture was found and loaded, std::nullopt otherwise
+ * The spectral conversion may be called from several threads at once.
+ *
+ * @param ctx Loading context, whose decoded texture maps are filled in
  */
 template <IsSpectral TSpectral>
-template <typename TPixel>
-std::pair<std::optional<TextureHandle<TPixel>>, std::optional<TextureHandle<float>>>
-ModelLoader<TSpectral>::load_material_texture_(const aiMaterial* ai_mat,
-                                               aiTextureType tex_type,
-                                               LoadContext& ctx,
-                                               bool read_alpha,
-                                               bool is_color_data)
+void ModelLoader<TSpectral>::decode_textures_(LoadContext& ctx)
 {
-    if (ai_mat->GetTextureCount(tex_type) == 0) {
-        return {std::nullopt, std::nullopt};
-    }
+    HUIRA_TRACE_SCOPE("ModelLoader::decode_textures_");
+
+    struct Request {
+        std::string path;
+        bool spectral; // Decoded to TSpectral, otherwise to Vec3<float>
+        bool read_alpha;
+        bool is_color_data;
+    };
+    std::vector<Request> requests;
+    std::unordered_set<std::string> spectral_paths;
+    std::unordered_set<std::string> vec3_paths;
+
+    auto request = [&](const aiMaterial* ai_mat,
+                       aiTextureType tex_type,
+                       bool spectral,
+                       bool read_alpha,
+                       bool is_color_data) {
+        aiString ai_path;
+        if (ai_mat->GetTextureCount(tex_type) == 0 ||
+            ai_mat->GetTexture(tex_type, 0, &ai_path) != AI_SUCCESS) {
+            return;
+        }
+        std::string path(ai_path.C_Str());
+        if ((spectral ? spectral_paths : vec3_paths).insert(path).second) {
+            requests.push_back(Request{std::move(path), spectral, read_alpha, is_color_data});
+        }
+    };
 
-    aiString ai_path;
-    if (ai_mat->GetTexture(tex_type, 0, &ai_path) != AI_SUCCESS) {
-        HUIRA_LOG_WARNING("ModelLoader::load_material_texture_ - "
-                          "Failed to get texture path for type " +
-                          std::to_string(static_cast<int>(tex_type)));
-        return {std::nullopt, std::nullopt};
+    for (unsigned int i = 0; i < ctx.ai_scene->mNumMaterials; ++i) {
+        const aiMaterial* ai_mat = ctx.ai_scene->mMaterials[i];
+        request(ai_mat, aiTextureType_BASE_COLOR, true, true, true);
+        request(ai_mat, packed_roughness_metallic_type_(ai_mat), false, false, false);
+        request(ai_mat, aiTextureType_NORMALS, false, false, false);
+        request(ai_mat, aiTextureType_EMISSION_COLOR, true, false, false);
     }
 
-    const std::string tex_path_str(ai_path.C_Str());
-
-    std::optional<TextureHandle<TPixel>> main_handle = std::nullopt;
-    std::optional<TextureHandle<float>> alpha_handle = std::nullopt;
-
-    // Check deduplication cache
-    auto& cache = get_texture_cache_<TPixel>(ctx);
-    auto cache_it = cache.find(tex_path_str);
-    if (cache_it != cache.end()) {
-        main_handle = cache_it->second;
+    if (requests.empty()) {
+        return;
+    }
 
-        // If the main image was cached, check if we also cached its alpha counterpart
-        if (read_alpha) {
-            auto alpha_it = ctx.mono_texture_cache.find(tex_path_str + "_alpha");
-            if (alpha_it != ctx.mono_texture_cache.end()) {
-                alpha_handle = alpha_it->second;
-            }
+    std::vector<std::optional<DecodedTexture<TSpectral>>> spectral(requests.size());
+    std::vector<std::optional<DecodedTexture<Vec3<float>>>> vec3(requests.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, requests.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t i = range.begin(); i != range.end(); ++i) {
+                              const Request& r = requests[i];
+                              if (r.spectral) {
+                                  spectral[i] = decode_texture_<TSpectral>(
+                                      r.path, ctx, r.read_alpha, r.is_color_data);
+                              } else {
+                                  vec3[i] = decode_texture_<Vec3<float>>(
+                                      r.path, ctx, r.read_alpha, r.is_color_data);
+                              }
+                          }
+                      });
+
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].spectral) {
+            ctx.spectral_decoded.emplace(requests[i].path, std::move(spectral[i]));
+        } else {
+            ctx.vec3_decoded.emplace(requests[i].path, std::move(vec3[i]));
         }
-        return {main_handle, alpha_handle};
     }
 
-    ImageBundle<TPixel> bundle;
-    bool loaded = false;
-    bool has_alpha = false;
+    HUIRA_LOG_INFO("ModelLoader::decode_textures_ - Decoded " + std::to_string(requests.size()) +
+                   " textures");
+}
+
+/**
+ * @brief Decode one texture (embedded or on-disk) to the target pixel type.
+ *
+ * Only reads from the LoadContext, so several textures can be decoded at once.
+ *
+ * @tparam TPixel Target pixel type (TSpectral, float, or Vec3<float>)
+ * @param tex_path_str The texture path from the material (or embedded texture reference)
+ * @param ctx Loading context
+ * @param read_alpha Whether to also decode the alpha channel (if supported by format)
+ * @param is_color_data Whether the texture holds colour, and so may need linearizing
+ * @return The decoded texture, or std::nullopt if it could not be found or decoded
+ */
+template <IsSpectral TSpectral>
+template <typename TPixel>
+std::optional<typename ModelLoader<TSpectral>::template DecodedTexture<TPixel>>
+ModelLoader<TSpectral>::decode_texture_(const std::string& tex_path_str,
+                                        const LoadContext& ctx,
+                                        bool read_alpha,
+                                        bool is_color_data)
+{
+    DecodedTexture<TPixel> decoded;
 
     const aiTexture* embedded = ctx.ai_scene->GetEmbeddedTexture(tex_path_str.c_str());
 
@@ -749,53 +1179,49 @@ ModelLoader<TSpectral>::load_material_texture_(const aiMaterial* ai_mat,
                 HUIRA_LOG_WARNING(
                     "ModelLoader::load_material_texture_ - Unknown embedded format hint: " +
                     std::string(embedded->achFormatHint));
-                return {std::nullopt, std::nullopt};
+                return std::nullopt;
             }
 
             try {
                 if constexpr (std::is_same_v<TPixel, TSpectral>) {
                     ImageBundle<RGB> bundle_rgb =
                         load_rgb_from_buffer_(data, size, format, read_alpha);
-                    bundle.image =
-                        Image<TSpectral>(bundle_rgb.image.width(), bundle_rgb.image.height());
-                    for (int y = 0; y < bundle_rgb.image.height(); ++y) {
-                        for (int x = 0; x < bundle_rgb.image.width(); ++x) {
-                            bundle.image(x, y) = ctx.spectral_conversion(bundle_rgb.image(x, y));
-                        }
+                    if (ctx.spectral_basis) {
+                        decoded.compact_bit_depth = bundle_rgb.bit_depth;
+                        decoded.compact_rgb = std::move(bundle_rgb.image);
+                    } else {
+                        decoded.image = rgb_to_spectral<TSpectral>(std::move(bundle_rgb.image),
+                                                                   ctx.spectral_conversion);
                     }
 
                     if (read_alpha && bundle_rgb.alpha.width() > 0) {
-                        bundle.alpha = bundle_rgb.alpha;
-                        has_alpha = true;
+                        decoded.alpha = std::move(bundle_rgb.alpha);
                     }
                 } else if constexpr (std::is_same_v<TPixel, float>) {
-                    bundle = load_mono_from_buffer_(data, size, format);
+                    decoded.image = load_mono_from_buffer_(data, size, format).image;
                 } else if constexpr (std::is_same_v<TPixel, Vec3<float>>) {
                     ImageBundle<RGB> bundle_rgb = load_rgb_from_buffer_(data, size, format, false);
-                    bundle.image = rgb_to_vec3_(bundle_rgb.image);
+                    decoded.image = rgb_to_vec3_(bundle_rgb.image);
                 }
-                loaded = true;
             } catch (const std::exception& e) {
                 HUIRA_LOG_WARNING(
                     "ModelLoader::load_material_texture_ - Failed to decode embedded texture: " +
                     std::string(e.what()));
-                return {std::nullopt, std::nullopt};
+                return std::nullopt;
             }
         } else {
             try {
                 auto [raw_img, raw_alpha] = convert_embedded_raw_<TSpectral, TPixel>(
                     embedded, ctx.spectral_conversion, read_alpha);
-                bundle.image = std::move(raw_img);
+                decoded.image = std::move(raw_img);
                 if (read_alpha && raw_alpha.width() > 0) {
-                    bundle.alpha = std::move(raw_alpha);
-                    has_alpha = true;
+                    decoded.alpha = std::move(raw_alpha);
                 }
-                loaded = true;
             } catch (const std::exception& e) {
                 HUIRA_LOG_WARNING("ModelLoader::load_material_texture_ - Failed to convert raw "
                                   "embedded texture: " +
                                   std::string(e.what()));
-                return {std::nullopt, std::nullopt};
+                return std::nullopt;
             }
         }
     } else {
@@ -807,7 +1233,7 @@ ModelLoader<TSpectral>::load_material_texture_(const aiMaterial* ai_mat,
         if (!fs::exists(resolved_path)) {
             HUIRA_LOG_WARNING("ModelLoader::load_material_texture_ - Texture file not found: " +
                               tex_path_str);
-            return {std::nullopt, std::nullopt};
+            return std::nullopt;
         }
 
         try {
@@ -823,53 +1249,183 @@ ModelLoader<TSpectral>::load_material_texture_(const aiMaterial* ai_mat,
                     bundle_rgb.color_space = ColorSpaceHint::Linear;
                 }
 
-                bundle.image =
-                    Image<TSpectral>(bundle_rgb.image.width(), bundle_rgb.image.height());
-                for (int y = 0; y < bundle_rgb.image.height(); ++y) {
-                    for (int x = 0; x < bundle_rgb.image.width(); ++x) {
-                        bundle.image(x, y) = ctx.spectral_conversion(bundle_rgb.image(x, y));
-                    }
+                if (ctx.spectral_basis) {
+                    decoded.compact_bit_depth = bundle_rgb.bit_depth;
+                    decoded.compact_rgb = std::move(bundle_rgb.image);
+                } else {
+                    decoded.image = rgb_to_spectral<TSpectral>(std::move(bundle_rgb.image),
+                                                               ctx.spectral_conversion);
                 }
                 if (read_alpha && bundle_rgb.alpha.width() > 0) {
-                    bundle.alpha = bundle_rgb.alpha;
-                    has_alpha = true;
+                    decoded.alpha = std::move(bundle_rgb.alpha);
                 }
             } else if constexpr (std::is_same_v<TPixel, float>) {
-                bundle = load_mono_from_file_(resolved_path);
+                decoded.image = load_mono_from_file_(resolved_path).image;
             } else if constexpr (std::is_same_v<TPixel, Vec3<float>>) {
                 ImageBundle<RGB> bundle_rgb = load_rgb_from_file_(resolved_path, false);
-                bundle.image = rgb_to_vec3_(bundle_rgb.image);
+                decoded.image = rgb_to_vec3_(bundle_rgb.image);
             }
-            loaded = true;
         } catch (const std::exception& e) {
             HUIRA_LOG_WARNING(
                 "ModelLoader::load_material_texture_ - Failed to load texture file: " +
                 std::string(e.what()));
-            return {std::nullopt, std::nullopt};
+            return std::nullopt;
         }
     }
 
-    if (!loaded) {
+    // Hash the pixels, and for compact textures the spectral basis applied to them:
+    ContentHasher content;
+    if constexpr (std::is_same_v<TPixel, TSpectral>) {
+        if (decoded.compact_rgb) {
+            hash_image_(content, *decoded.compact_rgb);
+            content.value(decoded.compact_bit_depth);
+            for (const RGB& unit : {RGB{1, 0, 0}, RGB{0, 1, 0}, RGB{0, 0, 1}}) {
+                TSpectral column = (*ctx.spectral_basis)(unit);
+                content.values(column.data(), column.size());
+            }
+        }
+    }
+    if (decoded.image.width() > 0) {
+        hash_image_(content, decoded.image);
+    }
+    decoded.content_hash = content.digest();
+    if (decoded.alpha.width() > 0) {
+        ContentHasher alpha_content;
+        hash_image_(alpha_content, decoded.alpha);
+        decoded.alpha_hash = alpha_content.digest();
+    }
+    return decoded;
+}
+
+/**
+ * @brief Load a texture from an aiMaterial for a given texture type.
+ *
+ * Checks whether the material has a texture for the given slot, resolves
+ * the path (embedded or on-disk), takes the texture decoded for it by
+ * decode_textures_ (or decodes it now), registers it with the Scene, and
+ * returns a TextureHandle. Uses the LoadContext caches for deduplication.
+ *
+ * @tparam TPixel Target pixel type (TSpectral, float, or Vec3<float>)
+ * @param ai_mat The ASSIMP material
+ * @param tex_type The ASSIMP texture type slot
+ * @param ctx Loading context with scene reference and caches
+ * @param read_alpha Whether to also load the alpha channel as a separate texture (if supported by
+ * format)
+ * @param is_normal_map Whether the texture is a normal map
+ * @return TextureHandle if a texture was found and loaded, std::nullopt otherwise
+ */
+template <IsSpectral TSpectral>
+template <typename TPixel>
+std::pair<std::optional<TextureHandle<TPixel>>, std::optional<TextureHandle<float>>>
+ModelLoader<TSpectral>::load_material_texture_(const aiMaterial* ai_mat,
+                                               aiTextureType tex_type,
+                                               LoadContext& ctx,
+                                               bool read_alpha,
+                                               bool is_color_data)
+{
+    if (ai_mat->GetTextureCount(tex_type) == 0) {
+        return {std::nullopt, std::nullopt};
+    }
+
+    aiString ai_path;
+    if (ai_mat->GetTexture(tex_type, 0, &ai_path) != AI_SUCCESS) {
+        HUIRA_LOG_WARNING("ModelLoader::load_material_texture_ - "
+                          "Failed to get texture path for type " +
+                          std::to_string(static_cast<int>(tex_type)));
+        return {std::nullopt, std::nullopt};
+    }
+
+    const std::string tex_path_str(ai_path.C_Str());
+
+    std::optional<TextureHandle<TPixel>> main_handle = std::nullopt;
+    std::optional<TextureHandle<float>> alpha_handle = std::nullopt;
+
+    // Check deduplication cache
+    auto& cache = get_texture_cache_<TPixel>(ctx);
+    auto cache_it = cache.find(tex_path_str);
+    if (cache_it != cache.end()) {
+        main_handle = cache_it->second;
+
+        // If the main image was cached, check if we also cached its alpha counterpart
+        if (read_alpha) {
+            auto alpha_it = ctx.mono_texture_cache.find(tex_path_str + "_alpha");
+            if (alpha_it != ctx.mono_texture_cache.end()) {
+                alpha_handle = alpha_it->second;
+            }
+        }
+        return {main_handle, alpha_handle};
+    }
+
+    // Take the texture decoded up front, falling back to decoding it here:
+    std::optional<DecodedTexture<TPixel>> decoded;
+    auto& decoded_cache = get_decoded_cache_<TPixel>(ctx);
+    if (auto node = decoded_cache.extract(tex_path_str); !node.empty()) {
+        decoded = std::move(node.mapped());
+    } else {
+        decoded = decode_texture_<TPixel>(tex_path_str, ctx, read_alpha, is_color_data);
+    }
+
+    if (!decoded) {
         return {std::nullopt, std::nullopt};
     }
 
     std::string tex_name = fs::path(tex_path_str).stem().string();
 
-    // Register Main Texture
-    TextureHandle<TPixel> handle = [&]() {
+    // Register Main Texture, sharing an identical texture from an earlier load:
+    ContentHasher content;
+    content.value(decoded->content_hash).value(tex_type == aiTextureType_NORMALS);
+    auto same = [&](const Texture<TPixel>& texture) {
+        if constexpr (std::is_same_v<TPixel, TSpectral>) {
+            if (decoded->compact_rgb) {
+                const Image<RGB>& rgb = *decoded->compact_rgb;
+                auto compact = std::dynamic_pointer_cast<const CompactTexture<TSpectral>>(
+                    texture.shared_sampler());
+                return compact &&
+                       compact->holds(rgb,
+                                      compact_texel_format(rgb, decoded->compact_bit_depth),
+                                      *ctx.spectral_basis);
+            }
+        }
         if constexpr (std::is_same_v<TPixel, Vec3<float>>) {
             if (tex_type == aiTextureType_NORMALS) {
-                return ctx.scene->add_normal_texture(std::move(bundle.image), tex_name);
+                // Normal maps are stored as unit vectors, see Scene::add_normal_texture:
+                return same_pixels_(
+                    *texture.shared_image(), decoded->image, [](const Vec3<float>& texel) {
+                        return glm::normalize(texel * 2.0f - Vec3<float>{1.0f});
+                    });
+            }
+        }
+        return !texture.is_virtual() &&
+               same_pixels_(*texture.shared_image(), decoded->image, std::identity{});
+    };
+    auto& content_cache = get_texture_content_<TPixel>(ctx);
+    TextureHandle<TPixel> handle = share_content_(content_cache, content.digest(), same, [&]() {
+        if constexpr (std::is_same_v<TPixel, TSpectral>) {
+            if (decoded->compact_rgb) {
+                const Image<RGB>& rgb = *decoded->compact_rgb;
+                CompactTexelFormat format = compact_texel_format(rgb, decoded->compact_bit_depth);
+                return ctx.scene->add_compact_texture(rgb, format, tex_name, *ctx.spectral_basis);
             }
         }
-        return ctx.scene->add_texture(std::move(bundle.image), tex_name);
-    }();
+        if constexpr (std::is_same_v<TPixel, Vec3<float>>) {
+            if (tex_type == aiTextureType_NORMALS) {
+                return ctx.scene->add_normal_texture(std::move(decoded->image), tex_name);
+            }
+        }
+        return ctx.scene->add_texture(std::move(decoded->image), tex_name);
+    });
     cache.emplace(tex_path_str, handle);
     main_handle = handle;
 
     // Register Alpha Texture
-    if (has_alpha) {
-        auto a_handle = ctx.scene->add_texture(std::move(bundle.alpha), tex_name + "_alpha");
+    if (decoded->alpha.width() > 0) {
+        auto a_handle = share_content_(
+            ctx.scene->mono_texture_content_,
+            decoded->alpha_hash,
+            [&](const Texture<float>& texture) {
+                return same_pixels_(*texture.shared_image(), decoded->alpha, std::identity{});
+            },
+            [&] { return ctx.scene->add_texture(std::move(decoded->alpha), tex_name + "_alpha"); });
         ctx.mono_texture_cache.emplace(tex_path_str + "_alpha", a_handle);
         alpha_handle = a_handle;
     }
@@ -898,4 +1454,106 @@ auto& ModelLoader<TSpectral>::get_texture_cache_(LoadContext& ctx)
     }
 }
 
+template <IsSpectral TSpectral>
+template <typename TPixel>
+auto& ModelLoader<TSpectral>::get_decoded_cache_(LoadContext& ctx)
+{
+    if constexpr (std::is_same_v<TPixel, TSpectral>) {
+        return ctx.spectral_decoded;
+    } else if constexpr (std::is_same_v<TPixel, float>) {
+        return ctx.mono_decoded;
+    } else if constexpr (std::is_same_v<TPixel, Vec3<float>>) {
+        return ctx.vec3_decoded;
+    } else {
+        static_assert(sizeof(TPixel) == 0, "Unsupported texture pixel type");
+    }
+}
+
+template <IsSpectral TSpectral>
+template <typename TPixel>
+auto& ModelLoader<TSpectral>::get_texture_content_(LoadContext& ctx)
+{
+    if constexpr (std::is_same_v<TPixel, TSpectral>) {
+        return ctx.scene->spectral_texture_content_;
+    } else if constexpr (std::is_same_v<TPixel, float>) {
+        return ctx.scene->mono_texture_content_;
+    } else if constexpr (std::is_same_v<TPixel, Vec3<float>>) {
+        return ctx.scene->vec3_texture_content_;
+    } else {
+        static_assert(sizeof(TPixel) == 0, "Unsupported texture pixel type");
+    }
+}
+
+// =========================================================================
+//  Content sharing
+// =========================================================================
+
+/**
+ * @brief Find the scene asset with the given content.
+ *
+ * A digest only nominates an asset: it must also be unedited since it was recorded, and hold the
+ * content itself, so that neither a hash collision nor a later edit shares the wrong asset.
+ *
+ * @param content_cache The Scene's cache for this kind of asset
+ * @param content_hash ContentHasher digest of the asset's content
+ * @param same Whether a candidate asset holds the content
+ * @return The asset, or nullptr if there is none, it has since been deleted from the scene or
+ * edited, or its content differs
+ */
+template <IsSpectral TSpectral>
+template <typename TAsset, typename TSame>
+std::shared_ptr<TAsset> ModelLoader<TSpectral>::find_content_(
+    const std::unordered_map<std::uint64_t, ContentEntry<TAsset>>& content_cache,
+    std::uint64_t content_hash,
+    TSame&& same)
+{
+    auto it = content_cache.find(content_hash);
+    if (it == content_cache.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<TAsset> asset = it->second.asset.lock();
+    if (!asset || !asset->is_scene_owned() || asset->revision() != it->second.revision) {
+        return nullptr;
+    }
+    if (!same(std::as_const(*asset))) {
+        HUIRA_LOG_DEBUG("ModelLoader - Content hash matched, but not the content, of " +
+                        asset->get_info());
+        return nullptr;
+    }
+    return asset;
+}
+
+/**
+ * @brief Reuse the scene asset with the given content, or create and record it.
+ *
+ * Entries whose asset has since been deleted from the scene, edited, or found to differ are
+ * replaced by the new asset.
+ *
+ * @param content_cache The Scene's cache for this kind of asset
+ * @param content_hash ContentHasher digest of the asset's content
+ * @param same Whether a candidate asset holds the content
+ * @param make Creates and registers the asset, returning its handle
+ * @return The handle of the existing or newly created asset
+ */
+template <IsSpectral TSpectral>
+template <typename TAsset, typename TSame, typename TMake>
+std::invoke_result_t<TMake>
+ModelLoader<TSpectral>::share_content_(
+    std::unordered_map<std::uint64_t, ContentEntry<TAsset>>& content_cache,
+    std::uint64_t content_hash,
+    TSame&& same,
+    TMake&& make)
+{
+    using THandle = std::invoke_result_t<TMake>;
+    if (std::shared_ptr<TAsset> asset = find_content_(content_cache, content_hash, same)) {
+        HUIRA_LOG_DEBUG("ModelLoader - Sharing existing " + asset->get_info());
+        return THandle{asset};
+    }
+
+    THandle handle = make();
+    std::shared_ptr<TAsset> asset = handle.get();
+    content_cache.insert_or_assign(content_hash, ContentEntry<TAsset>{asset, asset->revision()});
+    return handle;
+}
+
 } // namespace huira
@@ -482,33 +482,48 @@ Pixel CameraModel<TSpectral>::try_project_point(const Vec3<float>& point_camera_
     return project_point(point_camera_coords);
 }
 
+/**
+ * @brief Cast a ray through a pixel, sampling the aperture when depth of field is enabled.
+ *
+ * The returned ray carries differentials for the neighbouring pixels in x and y (through the same
+ * aperture point), which the renderer uses to size texture lookups at the hit.
+ *
+ * @param pixel Pixel coordinates
+ * @param sampler Sampler used for the aperture position
+ * @return Ray<TSpectral> The camera-space ray
+ */
 template <IsSpectral TSpectral>
 Ray<TSpectral> CameraModel<TSpectral>::cast_ray(const Pixel& pixel, Sampler<float>& sampler) const
 {
     assert(pixel[0] >= 0 && pixel[0] < rx_ && pixel[1] >= 0 && pixel[1] < ry_);
 
     Vec3<float> origin{0, 0, 0};
-    Vec3<float> direction{0, 0, 1};
-    if (distortion_) {
-        float u = pixel[0] / static_cast<float>(rx_ - 1);
-        float v = pixel[1] / static_cast<float>(ry_ - 1);
-        direction = distortion_field_.sample_bilinear<WrapMode::Clamp>(u, v);
-    } else {
-        direction = pixel_to_direction_<float>(pixel);
-    }
+    Vec3<float> direction = ray_direction_(pixel);
+
+    // Step towards the image interior so the distortion field is never clamped:
+    float step_x = pixel[0] + 1.f <= static_cast<float>(rx_ - 1) ? 1.f : -1.f;
+    float step_y = pixel[1] + 1.f <= static_cast<float>(ry_ - 1) ? 1.f : -1.f;
+    Vec3<float> direction_x = ray_direction_(pixel + Pixel{step_x, 0.f});
+    Vec3<float> direction_y = ray_direction_(pixel + Pixel{0.f, step_y});
+    direction_x = direction + step_x * (direction_x - direction);
+    direction_y = direction + step_y * (direction_y - direction);
 
     if (depth_of_field_) {
         Vec2<float> aperture_sample = aperture_->sample(sampler);
         Vec3<float> aperture_point{aperture_sample.x, aperture_sample.y, 0.f};
 
         if (!std::isinf(d_)) {
-            Vec3<float> focal_point = direction * d_;
-            direction = focal_point - aperture_point;
+            direction = direction * d_ - aperture_point;
+            direction_x = direction_x * d_ - aperture_point;
+            direction_y = direction_y * d_ - aperture_point;
         }
         origin = aperture_point;
     }
 
-    return Ray<TSpectral>{origin, glm::normalize(direction)};
+    Ray<TSpectral> ray{origin, glm::normalize(direction)};
+    ray.set_differentials(
+        origin, glm::normalize(direction_x), origin, glm::normalize(direction_y));
+    return ray;
 }
 
 template <IsSpectral TSpectral>
@@ -517,16 +532,7 @@ Ray<TSpectral> CameraModel<TSpectral>::cast_ray(const Pixel& pixel) const
     assert(pixel[0] >= 0 && pixel[0] < rx_ && pixel[1] >= 0 && pixel[1] < ry_);
 
     Vec3<float> origin{0, 0, 0};
-    Vec3<float> direction{0, 0, 1};
-    if (distortion_) {
-        float u = pixel[0] / static_cast<float>(rx_ - 1);
-        float v = pixel[1] / static_cast<float>(ry_ - 1);
-        direction = distortion_field_.sample_bilinear<WrapMode::Clamp>(u, v);
-    } else {
-        direction = pixel_to_direction_<float>(pixel);
-    }
-
-    return Ray<TSpectral>{origin, glm::normalize(direction)};
+    return Ray<TSpectral>{origin, glm::normalize(ray_direction_(pixel))};
 }
 
 template <IsSpectral TSpectral>
@@ -641,6 +647,22 @@ Vec3<TFloat> CameraModel<TSpectral>::pixel_to_direction_(const Pixel& pixel) con
     return direction;
 }
 
+/**
+ * @brief Get the (unnormalized) camera-space direction through a pixel, including distortion.
+ * @param pixel Pixel coordinates
+ * @return Vec3<float> Direction
+ */
+template <IsSpectral TSpectral>
+Vec3<float> CameraModel<TSpectral>::ray_direction_(const Pixel& pixel) const
+{
+    if (distortion_) {
+        float u = pixel[0] / static_cast<float>(rx_ - 1);
+        float v = pixel[1] / static_cast<float>(ry_ - 1);
+        return distortion_field_.sample_bilinear<WrapMode::Clamp>(u, v);
+    }
+    return pixel_to_direction_<float>(pixel);
+}
+
 template <IsSpectral TSpectral>
 void CameraModel<TSpectral>::compute_distortion_field_()
 {
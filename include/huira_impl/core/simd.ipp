@@ -0,0 +1,458 @@
+#include <cstddef>
+
+namespace huira::detail {
+
+// ============================ //
+// === Register Abstraction === //
+// ============================ //
+#if defined(HUIRA_SIMD_SSE)
+struct SimdF32x4 {
+    using type = __m128;
+    static constexpr std::size_t width = 4;
+
+    static type load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float* p, type v) noexcept { _mm_storeu_ps(p, v); }
+    static type set1(float s) noexcept { return _mm_set1_ps(s); }
+
+    static type add(type a, type b) noexcept { return _mm_add_ps(a, b); }
+    static type sub(type a, type b) noexcept { return _mm_sub_ps(a, b); }
+    static type mul(type a, type b) noexcept { return _mm_mul_ps(a, b); }
+    static type div(type a, type b) noexcept { return _mm_div_ps(a, b); }
+    static type min(type a, type b) noexcept { return _mm_min_ps(a, b); }
+    static type max(type a, type b) noexcept { return _mm_max_ps(a, b); }
+
+    static type fmadd(type a, type b, type c) noexcept
+    {
+#if defined(HUIRA_SIMD_FMA)
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+
+    static float reduce_add(type v) noexcept
+    {
+        type shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        type sums = _mm_add_ps(v, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        sums = _mm_add_ss(sums, shuf);
+        return _mm_cvtss_f32(sums);
+    }
+
+    static float reduce_min(type v) noexcept
+    {
+        type m = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+        return _mm_cvtss_f32(m);
+    }
+
+    static float reduce_max(type v) noexcept
+    {
+        type m = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        return _mm_cvtss_f32(m);
+    }
+};
+#endif
+
+#if defined(HUIRA_SIMD_AVX)
+struct SimdF32x8 {
+    using type = __m256;
+    static constexpr std::size_t width = 8;
+
+    static type load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float* p, type v) noexcept { _mm256_storeu_ps(p, v); }
+    static type set1(float s) noexcept { return _mm256_set1_ps(s); }
+
+    static type add(type a, type b) noexcept { return _mm256_add_ps(a, b); }
+    static type sub(type a, type b) noexcept { return _mm256_sub_ps(a, b); }
+    static type mul(type a, type b) noexcept { return _mm256_mul_ps(a, b); }
+    static type div(type a, type b) noexcept { return _mm256_div_ps(a, b); }
+    static type min(type a, type b) noexcept { return _mm256_min_ps(a, b); }
+    static type max(type a, type b) noexcept { return _mm256_max_ps(a, b); }
+
+    static type fmadd(type a, type b, type c) noexcept
+    {
+#if defined(HUIRA_SIMD_FMA)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    static float reduce_add(type v) noexcept
+    {
+        return SimdF32x4::reduce_add(
+            _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+
+    static float reduce_min(type v) noexcept
+    {
+        return SimdF32x4::reduce_min(
+            _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+
+    static float reduce_max(type v) noexcept
+    {
+        return SimdF32x4::reduce_max(
+            _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+};
+#endif
+
+#if defined(HUIRA_SIMD_AVX512)
+struct SimdF32x16 {
+    using type = __m512;
+    static constexpr std::size_t width = 16;
+
+    static type load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+    static void store(float* p, type v) noexcept { _mm512_storeu_ps(p, v); }
+    static type set1(float s) noexcept { return _mm512_set1_ps(s); }
+
+    static type add(type a, type b) noexcept { return _mm512_add_ps(a, b); }
+    static type sub(type a, type b) noexcept { return _mm512_sub_ps(a, b); }
+    static type mul(type a, type b) noexcept { return _mm512_mul_ps(a, b); }
+    static type div(type a, type b) noexcept { return _mm512_div_ps(a, b); }
+    static type min(type a, type b) noexcept { return _mm512_min_ps(a, b); }
+    static type max(type a, type b) noexcept { return _mm512_max_ps(a, b); }
+
+    static type fmadd(type a, type b, type c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+
+    static float reduce_add(type v) noexcept { return _mm512_reduce_add_ps(v); }
+    static float reduce_min(type v) noexcept { return _mm512_reduce_min_ps(v); }
+    static float reduce_max(type v) noexcept { return _mm512_reduce_max_ps(v); }
+};
+#endif
+
+// ========================= //
+// === Operation Helpers === //
+// ========================= //
+template <SimdOp Op>
+inline float scalar_apply_(float a, float b) noexcept
+{
+    if constexpr (Op == SimdOp::Add) {
+        return a + b;
+    } else if constexpr (Op == SimdOp::Sub) {
+        return a - b;
+    } else if constexpr (Op == SimdOp::Mul) {
+        return a * b;
+    } else if constexpr (Op == SimdOp::Div) {
+        return a / b;
+    } else if constexpr (Op == SimdOp::Min) {
+        return b < a ? b : a;
+    } else {
+        return a < b ? b : a;
+    }
+}
+
+template <SimdOp Op, typename R>
+inline typename R::type simd_apply_(typename R::type a, typename R::type b) noexcept
+{
+    if constexpr (Op == SimdOp::Add) {
+        return R::add(a, b);
+    } else if constexpr (Op == SimdOp::Sub) {
+        return R::sub(a, b);
+    } else if constexpr (Op == SimdOp::Mul) {
+        return R::mul(a, b);
+    } else if constexpr (Op == SimdOp::Div) {
+        return R::div(a, b);
+    } else if constexpr (Op == SimdOp::Min) {
+        return R::min(a, b);
+    } else {
+        return R::max(a, b);
+    }
+}
+
+template <SimdOp Op, typename R>
+inline float simd_reduce_(typename R::type v) noexcept
+{
+    if constexpr (Op == SimdOp::Add) {
+        return R::reduce_add(v);
+    } else if constexpr (Op == SimdOp::Min) {
+        return R::reduce_min(v);
+    } else {
+        static_assert(Op == SimdOp::Max, "Unsupported reduction");
+        return R::reduce_max(v);
+    }
+}
+
+// ======================== //
+// === Chunk Boundaries === //
+// ======================== //
+
+/**
+ * @brief Compile-time split of N floats into AVX-512, AVX, and SSE chunks plus a scalar tail.
+ *
+ * Chunks are laid out back to back: [0, end16) in 16-wide registers, [end16, end8) in 8-wide,
+ * [end8, end4) in 4-wide, and [end4, N) one float at a time. Widths not enabled for the target
+ * contribute empty ranges.
+ */
+template <std::size_t N>
+struct SimdSplit {
+#if defined(HUIRA_SIMD_AVX512)
+    static constexpr std::size_t end16 = N / 16 * 16;
+#else
+    static constexpr std::size_t end16 = 0;
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    static constexpr std::size_t end8 = end16 + (N - end16) / 8 * 8;
+#else
+    static constexpr std::size_t end8 = end16;
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    static constexpr std::size_t end4 = end8 + (N - end8) / 4 * 4;
+#else
+    static constexpr std::size_t end4 = end8;
+#endif
+};
+
+// ===================== //
+// === Chunk Drivers === //
+// ===================== //
+template <SimdOp Op, typename R, std::size_t Begin, std::size_t End>
+inline void simd_binary_chunks_(float* out, const float* a, const float* b) noexcept
+{
+    for (std::size_t i = Begin; i < End; i += R::width) {
+        R::store(out + i, simd_apply_<Op, R>(R::load(a + i), R::load(b + i)));
+    }
+}
+
+template <SimdOp Op, typename R, std::size_t Begin, std::size_t End>
+inline void simd_binary_scalar_chunks_(float* out, const float* a, float s) noexcept
+{
+    if constexpr (End > Begin) {
+        const typename R::type vs = R::set1(s);
+        for (std::size_t i = Begin; i < End; i += R::width) {
+            R::store(out + i, simd_apply_<Op, R>(R::load(a + i), vs));
+        }
+    }
+}
+
+template <typename R, std::size_t Begin, std::size_t End>
+inline void simd_fma_chunks_(float* out, const float* a, const float* b, const float* c) noexcept
+{
+    for (std::size_t i = Begin; i < End; i += R::width) {
+        R::store(out + i, R::fmadd(R::load(a + i), R::load(b + i), R::load(c + i)));
+    }
+}
+
+template <typename R, std::size_t Begin, std::size_t End>
+inline void simd_fma_scalar_chunks_(float* out, const float* a, float s, const float* c) noexcept
+{
+    if constexpr (End > Begin) {
+        const typename R::type vs = R::set1(s);
+        for (std::size_t i = Begin; i < End; i += R::width) {
+            R::store(out + i, R::fmadd(R::load(a + i), vs, R::load(c + i)));
+        }
+    }
+}
+
+template <SimdOp Op, typename R, std::size_t Begin, std::size_t End>
+inline void simd_reduce_chunks_(const float* a, float& acc) noexcept
+{
+    if constexpr (End > Begin) {
+        typename R::type v = R::load(a + Begin);
+        for (std::size_t i = Begin + R::width; i < End; i += R::width) {
+            v = simd_apply_<Op, R>(v, R::load(a + i));
+        }
+        acc = scalar_apply_<Op>(acc, simd_reduce_<Op, R>(v));
+    }
+}
+
+template <typename R, std::size_t Begin, std::size_t End>
+inline void simd_dot_chunks_(const float* a, const float* b, float& acc) noexcept
+{
+    if constexpr (End > Begin) {
+        typename R::type v = R::mul(R::load(a + Begin), R::load(b + Begin));
+        for (std::size_t i = Begin + R::width; i < End; i += R::width) {
+            v = R::fmadd(R::load(a + i), R::load(b + i), v);
+        }
+        acc += R::reduce_add(v);
+    }
+}
+
+// ====================== //
+// === Public Kernels === //
+// ====================== //
+
+/**
+ * @brief Element-wise out[i] = a[i] (op) b[i]. `out` may alias `a` or `b`.
+ */
+template <SimdOp Op, std::size_t N>
+inline void simd_binary(float* out, const float* a, const float* b) noexcept
+{
+    using Split = SimdSplit<N>;
+#if defined(HUIRA_SIMD_AVX512)
+    simd_binary_chunks_<Op, SimdF32x16, 0, Split::end16>(out, a, b);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_binary_chunks_<Op, SimdF32x8, Split::end16, Split::end8>(out, a, b);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_binary_chunks_<Op, SimdF32x4, Split::end8, Split::end4>(out, a, b);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        out[i] = scalar_apply_<Op>(a[i], b[i]);
+    }
+}
+
+/**
+ * @brief Element-wise out[i] = a[i] (op) s. `out` may alias `a`.
+ */
+template <SimdOp Op, std::size_t N>
+inline void simd_binary_scalar(float* out, const float* a, float s) noexcept
+{
+    using Split = SimdSplit<N>;
+#if defined(HUIRA_SIMD_AVX512)
+    simd_binary_scalar_chunks_<Op, SimdF32x16, 0, Split::end16>(out, a, s);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_binary_scalar_chunks_<Op, SimdF32x8, Split::end16, Split::end8>(out, a, s);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_binary_scalar_chunks_<Op, SimdF32x4, Split::end8, Split::end4>(out, a, s);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        out[i] = scalar_apply_<Op>(a[i], s);
+    }
+}
+
+/**
+ * @brief Fused multiply-add out[i] = a[i] * b[i] + c[i].
+ *
+ * Uses hardware FMA when the target supports it, otherwise a multiply followed by an add.
+ */
+template <std::size_t N>
+inline void simd_fma(float* out, const float* a, const float* b, const float* c) noexcept
+{
+    using Split = SimdSplit<N>;
+#if defined(HUIRA_SIMD_AVX512)
+    simd_fma_chunks_<SimdF32x16, 0, Split::end16>(out, a, b, c);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_fma_chunks_<SimdF32x8, Split::end16, Split::end8>(out, a, b, c);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_fma_chunks_<SimdF32x4, Split::end8, Split::end4>(out, a, b, c);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        out[i] = a[i] * b[i] + c[i];
+    }
+}
+
+/**
+ * @brief Fused multiply-add with a broadcast scalar, out[i] = a[i] * s + c[i].
+ */
+template <std::size_t N>
+inline void simd_fma_scalar(float* out, const float* a, float s, const float* c) noexcept
+{
+    using Split = SimdSplit<N>;
+#if defined(HUIRA_SIMD_AVX512)
+    simd_fma_scalar_chunks_<SimdF32x16, 0, Split::end16>(out, a, s, c);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_fma_scalar_chunks_<SimdF32x8, Split::end16, Split::end8>(out, a, s, c);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_fma_scalar_chunks_<SimdF32x4, Split::end8, Split::end4>(out, a, s, c);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        out[i] = a[i] * s + c[i];
+    }
+}
+
+/**
+ * @brief Horizontal sum of N floats.
+ */
+template <std::size_t N>
+inline float simd_sum(const float* a) noexcept
+{
+    using Split = SimdSplit<N>;
+    float acc = 0.f;
+#if defined(HUIRA_SIMD_AVX512)
+    simd_reduce_chunks_<SimdOp::Add, SimdF32x16, 0, Split::end16>(a, acc);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_reduce_chunks_<SimdOp::Add, SimdF32x8, Split::end16, Split::end8>(a, acc);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_reduce_chunks_<SimdOp::Add, SimdF32x4, Split::end8, Split::end4>(a, acc);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        acc += a[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief Dot product of two arrays of N floats.
+ */
+template <std::size_t N>
+inline float simd_dot(const float* a, const float* b) noexcept
+{
+    using Split = SimdSplit<N>;
+    float acc = 0.f;
+#if defined(HUIRA_SIMD_AVX512)
+    simd_dot_chunks_<SimdF32x16, 0, Split::end16>(a, b, acc);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_dot_chunks_<SimdF32x8, Split::end16, Split::end8>(a, b, acc);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_dot_chunks_<SimdF32x4, Split::end8, Split::end4>(a, b, acc);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief Maximum of N floats (N must be non-zero).
+ */
+template <std::size_t N>
+inline float simd_max(const float* a) noexcept
+{
+    static_assert(N > 0, "simd_max requires at least one element");
+    using Split = SimdSplit<N>;
+    float acc = a[0];
+#if defined(HUIRA_SIMD_AVX512)
+    simd_reduce_chunks_<SimdOp::Max, SimdF32x16, 0, Split::end16>(a, acc);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_reduce_chunks_<SimdOp::Max, SimdF32x8, Split::end16, Split::end8>(a, acc);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_reduce_chunks_<SimdOp::Max, SimdF32x4, Split::end8, Split::end4>(a, acc);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        acc = scalar_apply_<SimdOp::Max>(acc, a[i]);
+    }
+    return acc;
+}
+
+/**
+ * @brief Minimum of N floats (N must be non-zero).
+ */
+template <std::size_t N>
+inline float simd_min(const float* a) noexcept
+{
+    static_assert(N > 0, "simd_min requires at least one element");
+    using Split = SimdSplit<N>;
+    float acc = a[0];
+#if defined(HUIRA_SIMD_AVX512)
+    simd_reduce_chunks_<SimdOp::Min, SimdF32x16, 0, Split::end16>(a, acc);
+#endif
+#if defined(HUIRA_SIMD_AVX)
+    simd_reduce_chunks_<SimdOp::Min, SimdF32x8, Split::end16, Split::end8>(a, acc);
+#endif
+#if defined(HUIRA_SIMD_SSE)
+    simd_reduce_chunks_<SimdOp::Min, SimdF32x4, Split::end8, Split::end4>(a, acc);
+#endif
+    for (std::size_t i = Split::end4; i < N; ++i) {
+        acc = scalar_apply_<SimdOp::Min>(acc, a[i]);
+    }
+    return acc;
+}
+
+} // namespace huira::detail
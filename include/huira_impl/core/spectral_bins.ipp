@@ -1,8 +1,11 @@
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 #include "huira/core/physics.hpp"
+#include "huira/core/simd.hpp"
 #include "huira/util/logger.hpp"
 
 namespace huira {
@@ -243,11 +246,7 @@ constexpr SpectralBins<N, Args...> SpectralBins<N, Args...>::from_total(float to
 template <std::size_t N, auto... Args>
 float SpectralBins<N, Args...>::total() const
 {
-    float sum = 0.0f;
-    for (std::size_t i = 0; i < N; ++i) {
-        sum += data_[i];
-    }
-    return sum;
+    return detail::simd_sum<N>(data_.data());
 }
 
 /**
@@ -258,11 +257,7 @@ float SpectralBins<N, Args...>::total() const
 template <std::size_t N, auto... Args>
 float SpectralBins<N, Args...>::magnitude() const
 {
-    float sum_of_squares = 0.0f;
-    for (std::size_t i = 0; i < N; ++i) {
-        sum_of_squares += data_[i] * data_[i];
-    }
-    return std::sqrt(sum_of_squares);
+    return std::sqrt(detail::simd_dot<N>(data_.data(), data_.data()));
 }
 
 /**
@@ -275,14 +270,9 @@ float SpectralBins<N, Args...>::max() const
 {
     if constexpr (N == 0) {
         return 0.0f;
+    } else {
+        return detail::simd_max<N>(data_.data());
     }
-    float max_val = data_[0];
-    for (std::size_t i = 1; i < N; ++i) {
-        if (data_[i] > max_val) {
-            max_val = data_[i];
-        }
-    }
-    return max_val;
 }
 
 /**
@@ -295,14 +285,9 @@ float SpectralBins<N, Args...>::min() const
 {
     if constexpr (N == 0) {
         return 0.0f;
+    } else {
+        return detail::simd_min<N>(data_.data());
     }
-    float min_val = data_[0];
-    for (std::size_t i = 1; i < N; ++i) {
-        if (data_[i] < min_val) {
-            min_val = data_[i];
-        }
-    }
-    return min_val;
 }
 
 /**
@@ -406,14 +391,34 @@ SpectralBins<N, Args...> SpectralBins<N, Args...>::sqrt() const
     return output;
 }
 
+/**
+ * @brief Computes the element-wise exponential, e.g. for Beer-Lambert transmittance.
+ *
+ * @return A SpectralBins instance containing exp() of each bin.
+ */
+template <std::size_t N, auto... Args>
+SpectralBins<N, Args...> SpectralBins<N, Args...>::exp() const
+{
+    SpectralBins<N, Args...> output;
+    for (std::size_t i = 0; i < N; ++i) {
+        output[i] = std::exp(data_[i]);
+    }
+    return output;
+}
+
 // ========================================= //
 // === Array-Array Arithmetic Operations === //
 // ========================================= //
 template <std::size_t N, auto... Args>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator+=(const SpectralBins& other)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] += other.data_[i];
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] += other.data_[i];
+        }
+    } else {
+        detail::simd_binary<detail::SimdOp::Add, N>(data_.data(), data_.data(),
+                                                     other.data_.data());
     }
     return *this;
 }
@@ -421,8 +426,13 @@ constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator+=(const S
 template <std::size_t N, auto... Args>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator-=(const SpectralBins& other)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] -= other.data_[i];
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] -= other.data_[i];
+        }
+    } else {
+        detail::simd_binary<detail::SimdOp::Sub, N>(data_.data(), data_.data(),
+                                                     other.data_.data());
     }
     return *this;
 }
@@ -430,8 +440,13 @@ constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator-=(const S
 template <std::size_t N, auto... Args>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator*=(const SpectralBins& other)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] *= other.data_[i];
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] *= other.data_[i];
+        }
+    } else {
+        detail::simd_binary<detail::SimdOp::Mul, N>(data_.data(), data_.data(),
+                                                     other.data_.data());
     }
     return *this;
 }
@@ -439,8 +454,13 @@ constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator*=(const S
 template <std::size_t N, auto... Args>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator/=(const SpectralBins& other)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] /= other.data_[i];
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] /= other.data_[i];
+        }
+    } else {
+        detail::simd_binary<detail::SimdOp::Div, N>(data_.data(), data_.data(),
+                                                     other.data_.data());
     }
     return *this;
 }
@@ -452,8 +472,13 @@ template <std::size_t N, auto... Args>
 template <typename U>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator+=(const U& scalar)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] += static_cast<float>(scalar);
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] += static_cast<float>(scalar);
+        }
+    } else {
+        detail::simd_binary_scalar<detail::SimdOp::Add, N>(data_.data(), data_.data(),
+                                                            static_cast<float>(scalar));
     }
     return *this;
 }
@@ -462,8 +487,13 @@ template <std::size_t N, auto... Args>
 template <typename U>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator-=(const U& scalar)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] -= static_cast<float>(scalar);
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] -= static_cast<float>(scalar);
+        }
+    } else {
+        detail::simd_binary_scalar<detail::SimdOp::Sub, N>(data_.data(), data_.data(),
+                                                            static_cast<float>(scalar));
     }
     return *this;
 }
@@ -472,8 +502,13 @@ template <std::size_t N, auto... Args>
 template <typename U>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator*=(const U& scalar)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] *= static_cast<float>(scalar);
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] *= static_cast<float>(scalar);
+        }
+    } else {
+        detail::simd_binary_scalar<detail::SimdOp::Mul, N>(data_.data(), data_.data(),
+                                                            static_cast<float>(scalar));
     }
     return *this;
 }
@@ -482,8 +517,13 @@ template <std::size_t N, auto... Args>
 template <typename U>
 constexpr SpectralBins<N, Args...>& SpectralBins<N, Args...>::operator/=(const U& scalar)
 {
-    for (std::size_t i = 0; i < N; ++i) {
-        data_[i] /= static_cast<float>(scalar);
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data_[i] /= static_cast<float>(scalar);
+        }
+    } else {
+        detail::simd_binary_scalar<detail::SimdOp::Div, N>(data_.data(), data_.data(),
+                                                            static_cast<float>(scalar));
     }
     return *this;
 }
@@ -667,6 +707,50 @@ constexpr SpectralBins<N, Args...> operator/(const U& lhs, const SpectralBins<N,
     return result;
 }
 
+// ==================================== //
+// === Fused Multiply-Add Operators === //
+// ==================================== //
+/**
+ * @brief Computes a * b + c element-wise in a single pass.
+ *
+ * Preferred over writing `a * b + c` in hot loops (e.g. accumulators), since it avoids a
+ * temporary and uses hardware FMA where available.
+ */
+template <std::size_t N, auto... Args>
+constexpr SpectralBins<N, Args...> fma(const SpectralBins<N, Args...>& a,
+                                       const SpectralBins<N, Args...>& b,
+                                       const SpectralBins<N, Args...>& c)
+{
+    SpectralBins<N, Args...> result;
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            result[i] = a[i] * b[i] + c[i];
+        }
+    } else {
+        detail::simd_fma<N>(result.data(), a.data(), b.data(), c.data());
+    }
+    return result;
+}
+
+/**
+ * @brief Computes a * s + c element-wise in a single pass.
+ */
+template <std::size_t N, auto... Args>
+constexpr SpectralBins<N, Args...> fma(const SpectralBins<N, Args...>& a,
+                                       float s,
+                                       const SpectralBins<N, Args...>& c)
+{
+    SpectralBins<N, Args...> result;
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < N; ++i) {
+            result[i] = a[i] * s + c[i];
+        }
+    } else {
+        detail::simd_fma_scalar<N>(result.data(), a.data(), s, c.data());
+    }
+    return result;
+}
+
 // ======================== //
 // === Stream Operator === //
 // ======================== //
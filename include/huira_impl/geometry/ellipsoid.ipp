@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -35,6 +36,12 @@ void Ellipsoid<TSpectral>::compute_surface_interaction(const HitRecord& hit,
     // Compute Tangent Frame using partials
     Vec3<float> dpdu = {-radii_.x * sin_theta * sin_phi, radii_.y * sin_theta * cos_phi, 0.0f};
 
+    // Partials with respect to uv (u spans 2 pi in phi, v spans pi in theta):
+    isect.dpdu = (2.0f * PI<float>()) * dpdu;
+    isect.dpdv = PI<float>() * Vec3<float>{radii_.x * cos_theta * cos_phi,
+                                           radii_.y * cos_theta * sin_phi,
+                                           -radii_.z * sin_theta};
+
     // Handle singularity at the poles
     if (glm::dot(dpdu, dpdu) < 1e-8f) {
         dpdu = {1.0f, 0.0f, 0.0f};
@@ -61,6 +68,7 @@ void Ellipsoid<TSpectral>::build_blas_() const
 
     rtcSetGeometryBoundsFunction(geom, bounds_callback, nullptr);
     rtcSetGeometryIntersectFunction(geom, intersect_callback);
+    rtcSetGeometryOccludedFunction(geom, occluded_callback);
 
     rtcCommitGeometry(geom);
 
@@ -68,6 +76,9 @@ void Ellipsoid<TSpectral>::build_blas_() const
     rtcAttachGeometry(this->blas_.get(), geom);
     rtcReleaseGeometry(geom);
 
+    // Let SceneView's alpha-test filter, passed with each query, see hits on this geometry:
+    rtcSetSceneFlags(this->blas_.get(), RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS);
+
     rtcCommitScene(this->blas_.get());
 }
 
@@ -88,108 +99,250 @@ void Ellipsoid<TSpectral>::bounds_callback(const RTCBoundsFunctionArguments* arg
     bounds_o->upper_z = r.z;
 }
 
+/**
+ * @brief Solve for where a ray crosses the ellipsoid surface, in double precision.
+ *
+ * The ray is scaled into the unit sphere frame and the discriminant is taken from the squared
+ * distance of the sphere's centre to the line rather than from b^2 - 4ac, which cancels
+ * catastrophically when the origin is many radii away. Together with double precision this
+ * keeps planet-scale ellipsoids free of acne and limb errors when seen from afar.
+ *
+ * @param origin Ray origin in the ellipsoid's frame
+ * @param direction Ray direction in the ellipsoid's frame, not necessarily unit length
+ * @param radii The ellipsoid radii
+ * @param t0 Nearer crossing, in ray parameter units
+ * @param t1 Farther crossing, in ray parameter units
+ * @return false if the ray misses
+ */
 template <IsSpectral TSpectral>
-void Ellipsoid<TSpectral>::intersect_callback(const RTCIntersectFunctionNArguments* args) noexcept
+bool Ellipsoid<TSpectral>::solve_(const Vec3<double>& origin,
+                                  const Vec3<double>& direction,
+                                  const Vec3<double>& radii,
+                                  double& t0,
+                                  double& t1) noexcept
 {
-    int* valid = args->valid;
-    if (!valid) {
-        return;
+    Vec3<double> f = origin / radii;
+    Vec3<double> d = direction / radii;
+
+    double a = glm::dot(d, d);
+    if (!(a > 0.0)) {
+        return false;
+    }
+    double b = -glm::dot(f, d);
+    Vec3<double> closest = f + (b / a) * d;
+    double discriminant = 1.0 - glm::dot(closest, closest);
+    if (discriminant < 0.0) {
+        return false;
     }
 
-    const auto* ellipsoid = static_cast<const Ellipsoid<TSpectral>*>(args->geometryUserPtr);
-    Vec3<float> r = ellipsoid->radii_;
-    Vec3<float> inv_r = {1.0f / r.x, 1.0f / r.y, 1.0f / r.z};
+    double c = glm::dot(f, f) - 1.0;
+    double q = b + std::copysign(std::sqrt(a * discriminant), b);
+    t0 = c / q;
+    t1 = q / a;
+    if (t0 > t1) {
+        std::swap(t0, t1);
+    }
+    return true;
+}
+
+/**
+ * @brief Build the Embree hit record for a point where a ray crosses the surface.
+ */
+template <IsSpectral TSpectral>
+RTCHit Ellipsoid<TSpectral>::make_hit_(const Vec3<double>& origin,
+                                       const Vec3<double>& direction,
+                                       const Vec3<double>& radii,
+                                       double t,
+                                       unsigned int geom_id,
+                                       unsigned int prim_id,
+                                       unsigned int inst_id) noexcept
+{
+    Vec3<double> p_unit = glm::normalize((origin + t * direction) / radii);
+    double r_max = std::max({radii.x, radii.y, radii.z});
+    Vec3<double> normal = (p_unit / radii) * r_max;
+
+    RTCHit hit{};
+    hit.Ng_x = static_cast<float>(normal.x);
+    hit.Ng_y = static_cast<float>(normal.y);
+    hit.Ng_z = static_cast<float>(normal.z);
+    hit.u = static_cast<float>((std::atan2(p_unit.y, p_unit.x) + PI<double>()) /
+                               (2.0 * PI<double>()));
+    hit.v = static_cast<float>(std::acos(std::clamp(p_unit.z, -1.0, 1.0)) / PI<double>());
+    hit.geomID = geom_id;
+    hit.primID = prim_id;
+    hit.instID[0] = inst_id;
+    return hit;
+}
 
-    RTCRayHitN* rayhit = args->rayhit;
-    RTCRayN* ray = RTCRayHitN_RayN(rayhit, args->N);
-    RTCHitN* hit = RTCRayHitN_HitN(rayhit, args->N);
+/**
+ * @brief Nearest crossing of a ray with an ellipsoid, without going through Embree.
+ *
+ * Fills the hit the same way the intersect callback does, for callers that trace analytic bodies
+ * directly. The instance ID is left for the caller to set.
+ *
+ * @param radii The ellipsoid radii
+ * @param origin Ray origin in the ellipsoid's frame
+ * @param direction Ray direction in the ellipsoid's frame
+ * @param t_min Smallest accepted ray parameter
+ * @param t_max Largest accepted ray parameter
+ * @param hit Filled in if the ray crosses the surface within [t_min, t_max]
+ * @return true if it does
+ */
+template <IsSpectral TSpectral>
+bool Ellipsoid<TSpectral>::intersect_local(const Vec3<double>& radii,
+                                           const Vec3<double>& origin,
+                                           const Vec3<double>& direction,
+                                           float t_min,
+                                           float t_max,
+                                           HitRecord& hit) noexcept
+{
+    double t0;
+    double t1;
+    if (!solve_(origin, direction, radii, t0, t1)) {
+        return false;
+    }
+
+    for (double t : {t0, t1}) {
+        if (t < t_min || t > t_max) {
+            continue;
+        }
+        RTCHit rtc_hit = make_hit_(origin, direction, radii, t, 0, 0, hit.inst_id);
+        hit.t = static_cast<float>(t);
+        hit.u = rtc_hit.u;
+        hit.v = rtc_hit.v;
+        hit.geom_id = rtc_hit.geomID;
+        hit.prim_id = rtc_hit.primID;
+        hit.Ng = Vec3<float>{rtc_hit.Ng_x, rtc_hit.Ng_y, rtc_hit.Ng_z};
+        return true;
+    }
+    return false;
+}
 
-    Vec3<float> O = {RTCRayN_org_x(ray, args->N, 0),
-                     RTCRayN_org_y(ray, args->N, 0),
-                     RTCRayN_org_z(ray, args->N, 0)};
-    Vec3<float> D = {RTCRayN_dir_x(ray, args->N, 0),
-                     RTCRayN_dir_y(ray, args->N, 0),
-                     RTCRayN_dir_z(ray, args->N, 0)};
+/**
+ * @brief Offer each crossing of every valid lane in turn, nearest first.
+ *
+ * For each candidate, accept is called with the lane index, a copy of the lane's ray with tfar
+ * set to the candidate distance, and its hit record. A lane stops at the first candidate that
+ * accept takes, so a front face rejected by a filter falls through to the back face.
+ */
+template <IsSpectral TSpectral>
+template <typename Accept>
+void Ellipsoid<TSpectral>::for_each_crossing_(const Ellipsoid<TSpectral>* ellipsoid,
+                                              const int* valid,
+                                              RTCRayN* ray,
+                                              unsigned int N,
+                                              unsigned int geom_id,
+                                              unsigned int prim_id,
+                                              unsigned int inst_id,
+                                              Accept&& accept) noexcept
+{
+    const Vec3<double> radii{ellipsoid->radii_};
+    for (unsigned int i = 0; i < N; ++i) {
+        if (valid[i] == 0) {
+            continue;
+        }
 
-    Vec3<float> O_s = O * inv_r;
-    Vec3<float> D_s = D * inv_r;
+        RTCRay lane = rtcGetRayFromRayN(ray, N, i);
+        Vec3<double> origin{lane.org_x, lane.org_y, lane.org_z};
+        Vec3<double> direction{lane.dir_x, lane.dir_y, lane.dir_z};
 
-    float L = glm::length(D_s);
-    Vec3<float> D_u = D_s / L;
+        double t0;
+        double t1;
+        if (!solve_(origin, direction, radii, t0, t1)) {
+            continue;
+        }
 
-    float B = 2.0f * glm::dot(O_s, D_u);
-    float C = glm::dot(O_s, O_s) - 1.0f;
+        for (double t : {t0, t1}) {
+            if (t < lane.tnear || t > lane.tfar) {
+                continue;
+            }
+            RTCRay candidate = lane;
+            candidate.tfar = static_cast<float>(t);
+            RTCHit hit = make_hit_(origin, direction, radii, t, geom_id, prim_id, inst_id);
+            if (accept(i, candidate, hit)) {
+                break;
+            }
+        }
+    }
+}
 
-    float discriminant = B * B - 4.0f * C;
-    if (discriminant < 0.0f) {
+template <IsSpectral TSpectral>
+void Ellipsoid<TSpectral>::intersect_callback(const RTCIntersectFunctionNArguments* args) noexcept
+{
+    if (!args->valid) {
         return;
     }
 
-    float sqrt_disc = std::sqrt(discriminant);
-    float q = -0.5f * (B + std::copysign(sqrt_disc, B));
-    float t0_u = q;
-    float t1_u = C / q;
+    const auto* ellipsoid = static_cast<const Ellipsoid<TSpectral>*>(args->geometryUserPtr);
+    RTCRayN* ray = RTCRayHitN_RayN(args->rayhit, args->N);
+    RTCHitN* hits = RTCRayHitN_HitN(args->rayhit, args->N);
+
+    for_each_crossing_(
+        ellipsoid,
+        args->valid,
+        ray,
+        args->N,
+        args->geomID,
+        args->primID,
+        args->context->instID[0],
+        [&](unsigned int i, RTCRay& candidate, RTCHit& hit) {
+            // Filters see the candidate as a single ray, which is then copied back to the lane:
+            int filter_valid = -1;
+            RTCFilterFunctionNArguments fargs;
+            fargs.valid = &filter_valid;
+            fargs.geometryUserPtr = args->geometryUserPtr;
+            fargs.context = args->context;
+            fargs.ray = reinterpret_cast<RTCRayN*>(&candidate);
+            fargs.hit = reinterpret_cast<RTCHitN*>(&hit);
+            fargs.N = 1;
+
+            rtcInvokeIntersectFilterFromGeometry(args, &fargs);
+
+            if (filter_valid == 0) {
+                return false;
+            }
+            RTCRayN_tfar(ray, args->N, i) = candidate.tfar;
+            rtcCopyHitToHitN(hits, &hit, args->N, i);
+            return true;
+        });
+}
 
-    if (t0_u > t1_u) {
-        std::swap(t0_u, t1_u);
+template <IsSpectral TSpectral>
+void Ellipsoid<TSpectral>::occluded_callback(const RTCOccludedFunctionNArguments* args) noexcept
+{
+    if (!args->valid) {
+        return;
     }
 
-    float t0 = t0_u / L;
-    float t1 = t1_u / L;
-
-    // A lambda allows us to cleanly test t0, and if rejected by alpha, test t1
-    auto test_hit = [&](float t_candidate) -> bool {
-        if (t_candidate < RTCRayN_tnear(ray, args->N, 0) ||
-            t_candidate > RTCRayN_tfar(ray, args->N, 0)) {
-            return false;
-        }
-
-        // Save original tfar in case the filter rejects this hit
-        float old_tfar = RTCRayN_tfar(ray, args->N, 0);
-        RTCRayN_tfar(ray, args->N, 0) = t_candidate;
-
-        float t_u = t_candidate * L;
-        Vec3<float> P_s = O_s + t_u * D_u;
-        float r_max = std::max({r.x, r.y, r.z});
-        Vec3<float> normal = (P_s * inv_r) * r_max;
-
-        RTCHitN_Ng_x(hit, args->N, 0) = normal.x;
-        RTCHitN_Ng_y(hit, args->N, 0) = normal.y;
-        RTCHitN_Ng_z(hit, args->N, 0) = normal.z;
-
-        Vec3<float> P_unit = glm::normalize(O_s + t_u * D_u);
-        float u = (std::atan2(P_unit.y, P_unit.x) + PI<float>()) / (2.0f * PI<float>());
-        float v = std::acos(P_unit.z) / PI<float>();
-
-        RTCHitN_u(hit, args->N, 0) = u;
-        RTCHitN_v(hit, args->N, 0) = v;
-        RTCHitN_geomID(hit, args->N, 0) = args->geomID;
-        RTCHitN_primID(hit, args->N, 0) = args->primID;
-        RTCHitN_instID(hit, args->N, 0, 0) = args->context->instID[0];
-
-        int filter_valid = valid[0];
-
-        // Map properties into an Embree filter argument structure
-        RTCFilterFunctionNArguments fargs;
-        fargs.valid = &filter_valid;
-        fargs.geometryUserPtr = args->geometryUserPtr;
-        fargs.context = args->context;
-        fargs.ray = ray;
-        fargs.hit = hit;
-        fargs.N = args->N;
-
-        rtcInvokeIntersectFilterFromGeometry(args, &fargs);
-
-        if (filter_valid == 0) {
-            RTCRayN_tfar(ray, args->N, 0) = old_tfar; // Restore ray extent
-            return false;
-        }
-        return true;
-    };
+    const auto* ellipsoid = static_cast<const Ellipsoid<TSpectral>*>(args->geometryUserPtr);
 
-    // If the ray hits transparency on the front face, let it attempt to hit the back face
-    if (!test_hit(t0)) {
-        test_hit(t1);
-    }
+    // Any accepted crossing blocks the ray, but each still goes through the filters so that
+    // alpha cut-outs and transmissive surfaces can be skipped:
+    for_each_crossing_(
+        ellipsoid,
+        args->valid,
+        args->ray,
+        args->N,
+        args->geomID,
+        args->primID,
+        args->context->instID[0],
+        [&](unsigned int i, RTCRay& candidate, RTCHit& hit) {
+            int filter_valid = -1;
+            RTCFilterFunctionNArguments fargs;
+            fargs.valid = &filter_valid;
+            fargs.geometryUserPtr = args->geometryUserPtr;
+            fargs.context = args->context;
+            fargs.ray = reinterpret_cast<RTCRayN*>(&candidate);
+            fargs.hit = reinterpret_cast<RTCHitN*>(&hit);
+            fargs.N = 1;
+
+            rtcInvokeOccludedFilterFromGeometry(args, &fargs);
+
+            if (filter_valid == 0) {
+                return false;
+            }
+            RTCRayN_tfar(args->ray, args->N, i) = -std::numeric_limits<float>::infinity();
+            return true;
+        });
 }
 } // namespace huira
@@ -0,0 +1,617 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "embree4/rtcore.h"
+#include "glm/glm.hpp"
+#include "huira/images/io/fits_io.hpp"
+#include "huira/images/io/read_image.hpp"
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace huira {
+inline HeightfieldMapping HeightfieldMapping::planar(const units::Meter& sample_spacing)
+{
+    HeightfieldMapping mapping;
+    mapping.projection = Projection::Planar;
+    mapping.sample_spacing = sample_spacing.to_si();
+    return mapping;
+}
+
+inline HeightfieldMapping HeightfieldMapping::equirectangular(const units::Meter& body_radius,
+                                                              const units::Degree& lon_min,
+                                                              const units::Degree& lon_max,
+                                                              const units::Degree& lat_min,
+                                                              const units::Degree& lat_max)
+{
+    HeightfieldMapping mapping;
+    mapping.projection = Projection::Equirectangular;
+    mapping.body_radius = body_radius.to_si();
+    mapping.lon_min = lon_min.to_si();
+    mapping.lon_max = lon_max.to_si();
+    mapping.lat_min = lat_min.to_si();
+    mapping.lat_max = lat_max.to_si();
+    return mapping;
+}
+
+/**
+ * @brief Constructs a Heightfield from a row-major raster of elevations.
+ *
+ * Splits the raster into tiles and records each tile's bounds, horizontal cell size and skirt
+ * depth for level of detail selection. The Embree BLAS is built lazily for each SceneView.
+ *
+ * @param width Samples per row
+ * @param height Number of rows
+ * @param elevations Elevations in metres, row by row starting at row 0
+ * @param mapping Where the samples are placed
+ */
+template <IsSpectral TSpectral>
+Heightfield<TSpectral>::Heightfield(std::size_t width,
+                                    std::size_t height,
+                                    std::vector<float> elevations,
+                                    const HeightfieldMapping& mapping)
+    : width_{width}, height_{height}, elevations_{std::move(elevations)}, mapping_{mapping}
+{
+    HUIRA_TRACE_SCOPE("Heightfield::Heightfield");
+    if (width_ < 2 || height_ < 2) {
+        HUIRA_THROW_ERROR("Heightfield::Heightfield - A heightfield needs at least 2 x 2 samples");
+    }
+    if (elevations_.size() != width_ * height_) {
+        HUIRA_THROW_ERROR("Heightfield::Heightfield - Got " + std::to_string(elevations_.size()) +
+                          " elevations for a " + std::to_string(width_) + " x " +
+                          std::to_string(height_) + " raster");
+    }
+    if (mapping_.projection == HeightfieldMapping::Projection::Planar &&
+        !(mapping_.sample_spacing > 0.0)) {
+        HUIRA_THROW_ERROR("Heightfield::Heightfield - Sample spacing must be positive");
+    }
+    if (mapping_.projection == HeightfieldMapping::Projection::Equirectangular &&
+        (!(mapping_.body_radius > 0.0) || !(mapping_.lon_max > mapping_.lon_min) ||
+         !(mapping_.lat_max > mapping_.lat_min))) {
+        HUIRA_THROW_ERROR("Heightfield::Heightfield - Equirectangular mappings need a positive "
+                          "radius and non-empty longitude and latitude ranges");
+    }
+
+    const std::size_t cells_x = width_ - 1;
+    const std::size_t cells_y = height_ - 1;
+    for (std::size_t row0 = 0; row0 < cells_y; row0 += TILE_CELLS) {
+        for (std::size_t col0 = 0; col0 < cells_x; col0 += TILE_CELLS) {
+            Tile tile{};
+            tile.col0 = col0;
+            tile.row0 = row0;
+            tile.cols = std::min(TILE_CELLS, cells_x - col0);
+            tile.rows = std::min(TILE_CELLS, cells_y - row0);
+
+            float min_elevation = std::numeric_limits<float>::infinity();
+            float max_elevation = -std::numeric_limits<float>::infinity();
+            for (std::size_t row = row0; row <= row0 + tile.rows; ++row) {
+                for (std::size_t col = col0; col <= col0 + tile.cols; ++col) {
+                    min_elevation = std::min(min_elevation, elevation(col, row));
+                    max_elevation = std::max(max_elevation, elevation(col, row));
+                }
+            }
+
+            // Bounds from a coarse lattice over the tile at both elevation extremes, and the
+            // longest cell edge at its corners:
+            constexpr int BOUND_STEPS = 8;
+            Vec3<double> lower{std::numeric_limits<double>::infinity()};
+            Vec3<double> upper{-std::numeric_limits<double>::infinity()};
+            double cell_size = 0.0;
+            for (int j = 0; j <= BOUND_STEPS; ++j) {
+                for (int i = 0; i <= BOUND_STEPS; ++i) {
+                    double col = static_cast<double>(col0) +
+                                 static_cast<double>(tile.cols) * i / BOUND_STEPS;
+                    double row = static_cast<double>(row0) +
+                                 static_cast<double>(tile.rows) * j / BOUND_STEPS;
+                    for (float h : {min_elevation, max_elevation}) {
+                        Vec3<double> p = place_(col, row, h);
+                        lower = glm::min(lower, p);
+                        upper = glm::max(upper, p);
+                    }
+                    if ((i == 0 || i == BOUND_STEPS) && (j == 0 || j == BOUND_STEPS)) {
+                        Vec3<double> p = place_(col, row, 0.0);
+                        cell_size = std::max(
+                            {cell_size,
+                             glm::length(place_(col + (i == 0 ? 1.0 : -1.0), row, 0.0) - p),
+                             glm::length(place_(col, row + (j == 0 ? 1.0 : -1.0), 0.0) - p)});
+                    }
+                }
+            }
+            tile.center = Vec3<float>{(lower + upper) * 0.5};
+            tile.radius = static_cast<float>(glm::length(upper - lower) * 0.5);
+            tile.cell_size = static_cast<float>(cell_size);
+            tile.skirt_depth = std::max(max_elevation - min_elevation, tile.cell_size);
+            tiles_.push_back(tile);
+        }
+    }
+    full_resolution_.levels.assign(tiles_.size(), 0);
+    full_resolution_.tiles = built_tiles_(full_resolution_.levels);
+}
+
+/**
+ * @brief Sets the largest size a rendered cell may have on screen, in pixels.
+ *
+ * Larger values let distant tiles use coarser levels. Zero always uses full resolution.
+ *
+ * @param lod_pixels The target cell size in pixels, finite and non-negative
+ */
+template <IsSpectral TSpectral>
+void Heightfield<TSpectral>::set_lod_pixels(float lod_pixels)
+{
+    if (!(lod_pixels >= 0.f) || !std::isfinite(lod_pixels)) {
+        HUIRA_THROW_ERROR("Heightfield::set_lod_pixels - lod_pixels must be finite and "
+                          "non-negative.");
+    }
+    lod_pixels_ = lod_pixels;
+    this->touch_();
+}
+
+/**
+ * @brief The point on the full resolution surface at a fractional raster position.
+ * @param col Column, 0 to width() - 1
+ * @param row Row, 0 to height() - 1
+ * @return Vec3<float> The point in the heightfield's local frame
+ */
+template <IsSpectral TSpectral>
+Vec3<float> Heightfield<TSpectral>::position(double col, double row) const
+{
+    return Vec3<float>{place_(col, row, elevation_at_(col, row))};
+}
+
+/**
+ * @brief Resolves a hit on the heightfield built at full resolution.
+ */
+template <IsSpectral TSpectral>
+void Heightfield<TSpectral>::compute_surface_interaction(const HitRecord& hit,
+                                                         Interaction<TSpectral>& isect) const
+{
+    compute_surface_interaction_(full_resolution_, hit, isect);
+}
+
+template <IsSpectral TSpectral>
+Vec2<float> Heightfield<TSpectral>::compute_uv(const HitRecord& hit) const
+{
+    return compute_uv_(full_resolution_, hit);
+}
+
+/**
+ * @brief Resolves a hit on a build made by build_for_view_(), from the levels it was built at.
+ */
+template <IsSpectral TSpectral>
+void Heightfield<TSpectral>::compute_surface_interaction_(const GeometryBuild& build,
+                                                          const HitRecord& hit,
+                                                          Interaction<TSpectral>& isect) const
+{
+    // Place the hit on the bilinear patch through the four samples of the built level around it,
+    // which is what Embree intersected:
+    const LevelPatch patch = patch_(static_cast<const Build&>(build).tiles, hit);
+    auto corner = [&](std::size_t col, std::size_t row) {
+        return place_(static_cast<double>(col), static_cast<double>(row), elevation(col, row));
+    };
+    const double fx = patch.fx;
+    const double fy = patch.fy;
+    Vec3<double> p =
+        (1.0 - fy) * ((1.0 - fx) * corner(patch.c0, patch.r0) + fx * corner(patch.c1, patch.r0)) +
+        fy * ((1.0 - fx) * corner(patch.c0, patch.r1) + fx * corner(patch.c1, patch.r1));
+    isect.position = Vec3<float>{p};
+
+    const double col = patch.col();
+    const double row = patch.row();
+    const double max_col = static_cast<double>(width_ - 1);
+    const double max_row = static_cast<double>(height_ - 1);
+    isect.uv = Vec2<float>{static_cast<float>(col / max_col), static_cast<float>(row / max_row)};
+
+    // Partials and shading normal from the full resolution raster:
+    const double col_a = std::max(col - 1.0, 0.0);
+    const double col_b = std::min(col + 1.0, max_col);
+    const double row_a = std::max(row - 1.0, 0.0);
+    const double row_b = std::min(row + 1.0, max_row);
+    Vec3<double> dp_dcol = (place_(col_b, row, elevation_at_(col_b, row)) -
+                            place_(col_a, row, elevation_at_(col_a, row))) /
+                           (col_b - col_a);
+    Vec3<double> dp_drow = (place_(col, row_b, elevation_at_(col, row_b)) -
+                            place_(col, row_a, elevation_at_(col, row_a))) /
+                           (row_b - row_a);
+    isect.dpdu = Vec3<float>{dp_dcol * max_col};
+    isect.dpdv = Vec3<float>{dp_drow * max_row};
+
+    // Rows run southwards, so the raw cross product points into the ground:
+    Vec3<float> normal = glm::normalize(Vec3<float>{glm::cross(dp_drow, dp_dcol)});
+    isect.normal_g = normal;
+    isect.normal_s = normal;
+    isect.tangent = glm::normalize(isect.dpdu);
+    isect.bitangent = glm::normalize(glm::cross(normal, isect.tangent));
+}
+
+template <IsSpectral TSpectral>
+Vec2<float> Heightfield<TSpectral>::compute_uv_(const GeometryBuild& build,
+                                                const HitRecord& hit) const
+{
+    const LevelPatch patch = patch_(static_cast<const Build&>(build).tiles, hit);
+    return Vec2<float>{static_cast<float>(patch.col() / static_cast<double>(width_ - 1)),
+                       static_cast<float>(patch.row() / static_cast<double>(height_ - 1))};
+}
+
+/**
+ * @brief Builds the BLAS at full resolution, for callers of blas() outside a SceneView.
+ */
+template <IsSpectral TSpectral>
+void Heightfield<TSpectral>::build_blas_() const
+{
+    this->blas_ = build_scene_(full_resolution_.tiles);
+}
+
+/**
+ * @brief Hands a SceneView a BLAS built at the levels its camera calls for.
+ *
+ * The last build is kept, and handed out again for as long as views keep choosing its levels.
+ *
+ * @param eyes Camera positions in the heightfield's local frame, one per instance
+ * @param pixel_angle Angle subtended by one pixel, in radians
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<const GeometryBuild>
+Heightfield<TSpectral>::build_for_view_(const std::vector<Vec3<float>>& eyes,
+                                        float pixel_angle) const
+{
+    std::vector<std::uint8_t> levels = select_tile_levels(eyes, pixel_angle);
+    if (last_build_ && last_build_->levels == levels) {
+        return last_build_;
+    }
+    if (!this->device_) {
+        HUIRA_THROW_ERROR("Heightfield::build_for_view_ - Cannot build BLAS: no RTCDevice "
+                          "assigned. Ensure the geometry has been added to a Scene.");
+    }
+
+    auto build = std::make_shared<Build>();
+    build->tiles = built_tiles_(levels);
+    build->levels = std::move(levels);
+    build->blas = build_scene_(build->tiles);
+    last_build_ = build;
+    return build;
+}
+
+/**
+ * @brief The size of each tile's grid at the given levels.
+ * @param levels One level per tile
+ * @return std::vector<BuiltTile> The tiles as they are handed to Embree
+ */
+template <IsSpectral TSpectral>
+std::vector<typename Heightfield<TSpectral>::BuiltTile>
+Heightfield<TSpectral>::built_tiles_(const std::vector<std::uint8_t>& levels) const
+{
+    std::vector<BuiltTile> built(tiles_.size());
+    for (std::size_t t = 0; t < tiles_.size(); ++t) {
+        const Tile& tile = tiles_[t];
+        built[t].step = std::size_t{1} << levels[t];
+        built[t].samples_x = (tile.cols + built[t].step - 1) / built[t].step + 1;
+        built[t].samples_y = (tile.rows + built[t].step - 1) / built[t].step + 1;
+    }
+    return built;
+}
+
+/**
+ * @brief Builds a BLAS as one Embree grid primitive per tile, at the size it is built at.
+ *
+ * Each grid has a ring of extra vertices around it, copies of the edge samples lowered by the
+ * tile's skirt depth, so that tiles built at different levels never show gaps between them.
+ *
+ * @param built_tiles The tiles as built, see built_tiles_()
+ * @return UniqueRTCScene The committed BLAS
+ */
+template <IsSpectral TSpectral>
+UniqueRTCScene Heightfield<TSpectral>::build_scene_(const std::vector<BuiltTile>& built_tiles) const
+{
+    HUIRA_TRACE_SCOPE("Heightfield::build_scene_");
+
+    std::vector<std::size_t> first_vertex(tiles_.size());
+    std::size_t vertex_count = 0;
+    for (std::size_t t = 0; t < tiles_.size(); ++t) {
+        first_vertex[t] = vertex_count;
+        vertex_count += (built_tiles[t].samples_x + 2) * (built_tiles[t].samples_y + 2);
+    }
+
+    RTCGeometry geom = rtcNewGeometry(this->device_->get(), RTC_GEOMETRY_TYPE_GRID);
+    if (!geom) {
+        HUIRA_THROW_ERROR(
+            "Heightfield::build_scene_ - Embree failed to create a grid geometry. Ensure "
+            "EMBREE_GEOMETRY_GRID is enabled in your build. Error: " +
+            std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))));
+    }
+
+    auto* vertices = static_cast<float*>(rtcSetNewGeometryBuffer(
+        geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, 3 * sizeof(float), vertex_count));
+    auto* grids = static_cast<RTCGrid*>(rtcSetNewGeometryBuffer(
+        geom, RTC_BUFFER_TYPE_GRID, 0, RTC_FORMAT_GRID, sizeof(RTCGrid), tiles_.size()));
+    if (!vertices || !grids) {
+        rtcReleaseGeometry(geom);
+        HUIRA_THROW_ERROR(
+            "Heightfield::build_scene_ - Failed to allocate Embree buffers (error: " +
+            std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))) + ").");
+    }
+
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, tiles_.size()),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+            for (std::size_t t = range.begin(); t < range.end(); ++t) {
+                const Tile& tile = tiles_[t];
+                const BuiltTile& built = built_tiles[t];
+                const std::size_t grid_width = built.samples_x + 2;
+                const std::size_t grid_height = built.samples_y + 2;
+
+                for (std::size_t y = 0; y < grid_height; ++y) {
+                    // The outer ring repeats the edge samples:
+                    std::size_t ky = std::clamp<std::size_t>(y, 1, built.samples_y) - 1;
+                    std::size_t row = sample_(tile.row0, tile.rows, built.step, ky);
+                    bool skirt_y = (y == 0 || y == grid_height - 1);
+                    for (std::size_t x = 0; x < grid_width; ++x) {
+                        std::size_t kx = std::clamp<std::size_t>(x, 1, built.samples_x) - 1;
+                        std::size_t col = sample_(tile.col0, tile.cols, built.step, kx);
+                        bool skirt = skirt_y || x == 0 || x == grid_width - 1;
+
+                        double h = elevation(col, row);
+                        if (skirt) {
+                            h -= tile.skirt_depth;
+                        }
+                        Vec3<double> p =
+                            place_(static_cast<double>(col), static_cast<double>(row), h);
+                        float* v = vertices + 3 * (first_vertex[t] + y * grid_width + x);
+                        v[0] = static_cast<float>(p.x);
+                        v[1] = static_cast<float>(p.y);
+                        v[2] = static_cast<float>(p.z);
+                    }
+                }
+
+                grids[t].startVertexID = static_cast<unsigned int>(first_vertex[t]);
+                grids[t].stride = static_cast<unsigned int>(grid_width);
+                grids[t].width = static_cast<unsigned short>(grid_width);
+                grids[t].height = static_cast<unsigned short>(grid_height);
+            }
+        });
+
+    rtcCommitGeometry(geom);
+
+    UniqueRTCScene blas(rtcNewScene(this->device_->get()));
+    if (!blas) {
+        rtcReleaseGeometry(geom);
+        HUIRA_THROW_ERROR(
+            "Heightfield::build_scene_ - Failed to create Embree BLAS scene (error: " +
+            std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))) + ").");
+    }
+
+    rtcAttachGeometry(blas.get(), geom);
+    rtcReleaseGeometry(geom);
+
+    // Let SceneView's alpha-test filter, passed with each query, see hits on this geometry:
+    rtcSetSceneFlags(blas.get(), RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS);
+
+    rtcCommitScene(blas.get());
+
+    HUIRA_LOG_INFO("Built BLAS for Heightfield " + std::to_string(this->id()) + " (samples: " +
+                   std::to_string(width_ * height_) + ", tiles: " +
+                   std::to_string(tiles_.size()) + ", vertices: " +
+                   std::to_string(vertex_count) + ")");
+    return blas;
+}
+
+/**
+ * @brief Chooses each tile's level from how large its cells appear from the nearest eye.
+ *
+ * A cell at level L spans 2^L full resolution cells. Each tile takes the coarsest level whose
+ * cells, seen from the nearest point of the tile's bounding sphere, still subtend no more than
+ * lod_pixels() pixels.
+ *
+ * @param eyes Camera positions in the heightfield's local frame, one per instance
+ * @param pixel_angle Angle subtended by one pixel, in radians
+ * @return std::vector<std::uint8_t> The level of each tile, all 0 without eyes
+ */
+template <IsSpectral TSpectral>
+std::vector<std::uint8_t>
+Heightfield<TSpectral>::select_tile_levels(const std::vector<Vec3<float>>& eyes,
+                                           float pixel_angle) const
+{
+    std::vector<std::uint8_t> levels(tiles_.size(), 0);
+    if (lod_pixels_ > 0.f && pixel_angle > 0.f && !eyes.empty()) {
+        for (std::size_t t = 0; t < tiles_.size(); ++t) {
+            const Tile& tile = tiles_[t];
+            float distance = std::numeric_limits<float>::infinity();
+            for (const Vec3<float>& eye : eyes) {
+                distance = std::min(distance, glm::length(eye - tile.center) - tile.radius);
+            }
+            float allowed = distance * pixel_angle * lod_pixels_ / tile.cell_size;
+            if (allowed >= 2.f) {
+                auto level = static_cast<std::uint8_t>(std::min<float>(
+                    std::floor(std::log2(allowed)), static_cast<float>(max_level_(tile))));
+                levels[t] = level;
+            }
+        }
+    }
+    return levels;
+}
+
+/**
+ * @brief Reads an elevation raster from a TIFF (including GeoTIFF), FITS or other image file.
+ *
+ * Float samples are taken as they are. Integer TIFF and FITS samples arrive normalised to [0, 1]
+ * and need height_scale to restore their range. Georeferencing tags are not read; the placement
+ * is given separately through a HeightfieldMapping.
+ *
+ * @param path The raster file
+ * @param width Set to the samples per row
+ * @param height Set to the number of rows
+ * @param height_scale Factor from sample values to metres
+ * @param height_offset Metres added after scaling
+ * @return std::vector<float> The elevations in metres, row by row
+ */
+template <IsSpectral TSpectral>
+std::vector<float> Heightfield<TSpectral>::read_raster(const fs::path& path,
+                                                       std::size_t& width,
+                                                       std::size_t& height,
+                                                       float height_scale,
+                                                       float height_offset)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    Image<float> raster = (ext == ".fits" || ext == ".fit" || ext == ".fts")
+                              ? read_image_fits(path).first
+                              : read_image_mono(path, false).image;
+
+    width = static_cast<std::size_t>(raster.width());
+    height = static_cast<std::size_t>(raster.height());
+    std::vector<float> elevations(width * height);
+    for (std::size_t row = 0; row < height; ++row) {
+        for (std::size_t col = 0; col < width; ++col) {
+            float value = raster(static_cast<int>(col), static_cast<int>(row));
+            elevations[row * width + col] = value * height_scale + height_offset;
+        }
+    }
+    return elevations;
+}
+
+/**
+ * @brief Reads a headerless raster of 32-bit floats, row by row.
+ * @param path The raster file
+ * @param width Samples per row
+ * @param height Number of rows
+ * @param height_scale Factor from sample values to metres
+ * @param height_offset Metres added after scaling
+ * @return std::vector<float> The elevations in metres
+ */
+template <IsSpectral TSpectral>
+std::vector<float> Heightfield<TSpectral>::read_raw(const fs::path& path,
+                                                    std::size_t width,
+                                                    std::size_t height,
+                                                    float height_scale,
+                                                    float height_offset)
+{
+    const std::size_t sample_count = width * height;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        HUIRA_THROW_ERROR("Heightfield::read_raw - Failed to open file for reading: " +
+                          path.string());
+    }
+
+    const auto file_size = static_cast<std::size_t>(fs::file_size(path));
+    if (file_size != sample_count * sizeof(float)) {
+        HUIRA_THROW_ERROR("Heightfield::read_raw - " + path.filename().string() + " has " +
+                          std::to_string(file_size) + " bytes, expected " +
+                          std::to_string(sample_count * sizeof(float)) + " for the resolution");
+    }
+
+    std::vector<float> elevations(sample_count);
+    in.read(reinterpret_cast<char*>(elevations.data()),
+            static_cast<std::streamsize>(sample_count * sizeof(float)));
+    if (!in) {
+        HUIRA_THROW_ERROR("Heightfield::read_raw - Failed to read " + path.string());
+    }
+    for (float& value : elevations) {
+        value = value * height_scale + height_offset;
+    }
+    return elevations;
+}
+
+template <IsSpectral TSpectral>
+Vec3<double> Heightfield<TSpectral>::place_(double col, double row, double elevation) const
+{
+    if (mapping_.projection == HeightfieldMapping::Projection::Planar) {
+        double half_width = 0.5 * static_cast<double>(width_ - 1);
+        double half_height = 0.5 * static_cast<double>(height_ - 1);
+        return Vec3<double>{(col - half_width) * mapping_.sample_spacing,
+                            (half_height - row) * mapping_.sample_spacing,
+                            elevation};
+    }
+
+    double lon = mapping_.lon_min + (mapping_.lon_max - mapping_.lon_min) * col /
+                                        static_cast<double>(width_ - 1);
+    double lat = mapping_.lat_max - (mapping_.lat_max - mapping_.lat_min) * row /
+                                        static_cast<double>(height_ - 1);
+    double r = mapping_.body_radius + elevation;
+    return Vec3<double>{r * std::cos(lat) * std::cos(lon),
+                        r * std::cos(lat) * std::sin(lon),
+                        r * std::sin(lat)};
+}
+
+template <IsSpectral TSpectral>
+double Heightfield<TSpectral>::elevation_at_(double col, double row) const
+{
+    col = std::clamp(col, 0.0, static_cast<double>(width_ - 1));
+    row = std::clamp(row, 0.0, static_cast<double>(height_ - 1));
+    std::size_t c0 = std::min(static_cast<std::size_t>(col), width_ - 2);
+    std::size_t r0 = std::min(static_cast<std::size_t>(row), height_ - 2);
+    double fx = col - static_cast<double>(c0);
+    double fy = row - static_cast<double>(r0);
+    return (1.0 - fy) * ((1.0 - fx) * elevation(c0, r0) + fx * elevation(c0 + 1, r0)) +
+           fy * ((1.0 - fx) * elevation(c0, r0 + 1) + fx * elevation(c0 + 1, r0 + 1));
+}
+
+/**
+ * @brief The cell of a tile's built level that a hit falls in, from the grid coordinates Embree
+ * reports.
+ */
+template <IsSpectral TSpectral>
+typename Heightfield<TSpectral>::LevelPatch
+Heightfield<TSpectral>::patch_(const std::vector<BuiltTile>& built_tiles,
+                               const HitRecord& hit) const
+{
+    const BuiltTile& built = built_tiles[hit.prim_id];
+    const Tile& tile = tiles_[hit.prim_id];
+
+    // Grid coordinates span the skirt ring as well, one sample beyond each edge. Skirt hits are
+    // moved onto the edge:
+    auto locate = [&](float uv, std::size_t samples, std::size_t& k) {
+        double g = std::clamp(static_cast<double>(uv) * static_cast<double>(samples + 1) - 1.0,
+                              0.0,
+                              static_cast<double>(samples - 1));
+        k = std::min(static_cast<std::size_t>(g), samples - 2);
+        return g - static_cast<double>(k);
+    };
+
+    LevelPatch patch{};
+    std::size_t kx;
+    std::size_t ky;
+    patch.fx = locate(hit.u, built.samples_x, kx);
+    patch.fy = locate(hit.v, built.samples_y, ky);
+    patch.c0 = sample_(tile.col0, tile.cols, built.step, kx);
+    patch.c1 = sample_(tile.col0, tile.cols, built.step, kx + 1);
+    patch.r0 = sample_(tile.row0, tile.rows, built.step, ky);
+    patch.r1 = sample_(tile.row0, tile.rows, built.step, ky + 1);
+    return patch;
+}
+
+/**
+ * @brief The coarsest level of a tile, at which it is a single cell across its longer side.
+ */
+template <IsSpectral TSpectral>
+std::uint8_t Heightfield<TSpectral>::max_level_(const Tile& tile) const
+{
+    std::size_t cells = std::max(tile.cols, tile.rows);
+    std::uint8_t level = 0;
+    while ((std::size_t{1} << (level + 1)) <= cells) {
+        ++level;
+    }
+    return level;
+}
+
+/**
+ * @brief Raster index of the k-th sample of a tile at a given step, ending exactly on its edge.
+ */
+template <IsSpectral TSpectral>
+std::size_t Heightfield<TSpectral>::sample_(std::size_t start,
+                                            std::size_t cells,
+                                            std::size_t step,
+                                            std::size_t k) noexcept
+{
+    return start + std::min(k * step, cells);
+}
+} // namespace huira
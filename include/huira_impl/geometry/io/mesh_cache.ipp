@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "huira/core/shared_span.hpp"
+#include "huira/geometry/vertex_streams.hpp"
+#include "huira/platform/mapped_file.hpp"
+#include "huira/util/content_hash.hpp"
+#include "huira/util/logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+namespace detail {
+inline std::uint64_t align_mesh_cache_offset(std::uint64_t offset)
+{
+    const std::uint64_t a = MeshCacheLayout::ALIGNMENT;
+    return (offset + a - 1) / a * a;
+}
+
+// A section of a mapped mesh cache, checked to lie within the file and to be aligned:
+template <typename T>
+SharedSpan<T> mesh_cache_section(const std::shared_ptr<const MappedFile>& file,
+                                 std::uint64_t offset,
+                                 std::uint64_t count)
+{
+    if (offset % MeshCacheLayout::ALIGNMENT != 0 || offset > file->size() ||
+        count > (file->size() - offset) / sizeof(T)) {
+        HUIRA_THROW_ERROR("read_mesh_cache - Section lies outside the file: " +
+                          file->path().string());
+    }
+    const auto* data = reinterpret_cast<const T*>(file->data() + offset);
+    return SharedSpan<T>(file, std::span<const T>(data, static_cast<std::size_t>(count)));
+}
+} // namespace detail
+
+/**
+ * @brief Identifies a source file as it is now, for telling whether a cache made from it is stale.
+ * @param source Path to the source file
+ * @param options Anything else the cached mesh depends on, such as loader settings
+ * @return std::uint64_t A key that changes when the file's size or modification time does
+ */
+inline std::uint64_t mesh_cache_key(const fs::path& source, std::uint64_t options)
+{
+    ContentHasher key;
+    key.value(static_cast<std::uint64_t>(fs::file_size(source)));
+    key.value(static_cast<std::int64_t>(fs::last_write_time(source).time_since_epoch().count()));
+    key.value(options);
+    return key.digest();
+}
+
+/**
+ * @brief Write a mesh and its levels of detail as a mesh cache file.
+ *
+ * The file is written beside its destination and then renamed into place, so a reader never sees
+ * it half written.
+ *
+ * @param filepath Path to write
+ * @param mesh The mesh
+ * @param source_key Key of the source the mesh was made from, checked by mesh_cache_matches()
+ */
+template <IsSpectral TSpectral>
+void write_mesh_cache(const fs::path& filepath,
+                      const Mesh<TSpectral>& mesh,
+                      std::uint64_t source_key)
+{
+    HUIRA_TRACE_SCOPE("write_mesh_cache");
+    static_assert(std::is_trivially_copyable_v<TSpectral> &&
+                      sizeof(TSpectral) == TSpectral::size() * sizeof(float),
+                  "write_mesh_cache - Spectral type must be a packed array of floats");
+
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, MeshCacheLayout::MAGIC, sizeof(header.magic));
+    header.version = MeshCacheLayout::VERSION;
+    header.albedo_bins = static_cast<std::uint32_t>(TSpectral::size());
+    header.vec3_bytes = static_cast<std::uint32_t>(sizeof(Vec3<float>));
+    header.level_count = static_cast<std::uint32_t>(mesh.lod_count());
+    header.source_key = source_key;
+
+    // Lay out every buffer first, so the level table can be written ahead of them:
+    std::vector<MeshCacheLevel> levels(mesh.lod_count());
+    std::uint64_t cursor = detail::align_mesh_cache_offset(sizeof(MeshCacheHeader) +
+                                                           levels.size() * sizeof(MeshCacheLevel));
+    auto place = [&cursor](std::uint64_t bytes) {
+        std::uint64_t offset = cursor;
+        cursor = detail::align_mesh_cache_offset(cursor + bytes);
+        return offset;
+    };
+    for (std::size_t l = 0; l < levels.size(); ++l) {
+        const VertexStreams<TSpectral>& vertices = mesh.lod_vertex_streams(l);
+        MeshCacheLevel& level = levels[l];
+        level = MeshCacheLevel{};
+        level.index_count = mesh.lod_index_buffer(l).size();
+        level.vertex_count = vertices.size();
+        level.albedo_count = vertices.vertex_albedos().size();
+        level.tangent_count = mesh.lod_tangent_buffer(l).size();
+        level.index_offset = place(level.index_count * sizeof(std::uint32_t));
+        level.position_offset = place((level.vertex_count + 1) * sizeof(Vec3<float>));
+        level.normal_offset = place(level.vertex_count * sizeof(OctNormal));
+        level.uv_offset = place(level.vertex_count * sizeof(QuantizedUV));
+        level.albedo_offset = place(level.albedo_count * sizeof(TSpectral));
+        level.uniform_albedo_offset = place(sizeof(TSpectral));
+        level.tangent_offset = place(level.tangent_count * sizeof(Tangent));
+        level.uv_origin[0] = vertices.uv_offset().x;
+        level.uv_origin[1] = vertices.uv_offset().y;
+        level.uv_step[0] = vertices.uv_scale().x;
+        level.uv_step[1] = vertices.uv_scale().y;
+        level.error = mesh.lod_error(l);
+    }
+
+    fs::path temporary = filepath;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        if (!out) {
+            HUIRA_THROW_ERROR("write_mesh_cache - Failed to open file for writing: " +
+                              temporary.string());
+        }
+
+        std::uint64_t written = 0;
+        auto write_at = [&](std::uint64_t offset, const void* data, std::size_t bytes) {
+            static const char zeros[MeshCacheLayout::ALIGNMENT] = {};
+            while (written < offset) {
+                auto pad = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(offset - written, sizeof(zeros)));
+                out.write(zeros, static_cast<std::streamsize>(pad));
+                written += pad;
+            }
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        };
+
+        write_at(0, &header, sizeof(header));
+        write_at(sizeof(header), levels.data(), levels.size() * sizeof(MeshCacheLevel));
+        const Vec3<float> padding{0.f};
+        for (std::size_t l = 0; l < levels.size(); ++l) {
+            const MeshCacheLevel& level = levels[l];
+            const VertexStreams<TSpectral>& vertices = mesh.lod_vertex_streams(l);
+            auto indices = mesh.lod_index_buffer(l);
+            auto tangents = mesh.lod_tangent_buffer(l);
+            write_at(level.index_offset, indices.data(), indices.size_bytes());
+            write_at(level.position_offset,
+                     vertices.positions().data(),
+                     vertices.positions().size_bytes());
+            write_at(level.position_offset + vertices.positions().size_bytes(),
+                     &padding,
+                     sizeof(padding));
+            write_at(level.normal_offset,
+                     vertices.encoded_normals().data(),
+                     vertices.encoded_normals().size_bytes());
+            write_at(level.uv_offset,
+                     vertices.encoded_uvs().data(),
+                     vertices.encoded_uvs().size_bytes());
+            write_at(level.albedo_offset,
+                     vertices.vertex_albedos().data(),
+                     vertices.vertex_albedos().size_bytes());
+            write_at(level.uniform_albedo_offset, &vertices.uniform_albedo(), sizeof(TSpectral));
+            write_at(level.tangent_offset, tangents.data(), tangents.size_bytes());
+        }
+        // Pad to the end of the layout, so empty sections at the end still lie within the file:
+        write_at(cursor, nullptr, 0);
+
+        if (!out) {
+            HUIRA_THROW_ERROR("write_mesh_cache - Failed to write: " + temporary.string());
+        }
+    }
+
+    std::error_code error;
+    fs::rename(temporary, filepath, error);
+    if (error) {
+        fs::remove(temporary, error);
+        HUIRA_THROW_ERROR("write_mesh_cache - Failed to replace: " + filepath.string());
+    }
+    HUIRA_LOG_INFO("write_mesh_cache - Wrote " + filepath.string() + " (" +
+                   std::to_string(cursor) + " bytes)");
+}
+
+/**
+ * @brief Check whether a mesh cache file exists, can be read here, and was made from a source.
+ * @param filepath Path to the cache file
+ * @param source_key Key of the source, as passed to write_mesh_cache()
+ * @return bool True if read_mesh_cache() may be used instead of loading the source
+ */
+template <IsSpectral TSpectral>
+bool mesh_cache_matches(const fs::path& filepath, std::uint64_t source_key)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    MeshCacheHeader header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return in && std::memcmp(header.magic, MeshCacheLayout::MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == MeshCacheLayout::VERSION &&
+           header.albedo_bins == TSpectral::size() && header.vec3_bytes == sizeof(Vec3<float>) &&
+           header.source_key == source_key;
+}
+
+/**
+ * @brief Map a mesh cache file and build a Mesh that reads its buffers in place.
+ *
+ * Nothing is parsed or copied: the mesh's buffers, and the Embree geometry later built from them,
+ * point into the mapping, which stays open for as long as the mesh does. Pages are read from disk
+ * as rendering first touches them.
+ *
+ * @param filepath Path to the cache file
+ * @return std::shared_ptr<Mesh<TSpectral>> The mesh, with its levels of detail
+ * @throws std::runtime_error if the file is not a valid mesh cache for this build
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> read_mesh_cache(const fs::path& filepath)
+{
+    HUIRA_TRACE_SCOPE("read_mesh_cache");
+    auto file = std::make_shared<const MappedFile>(filepath);
+
+    MeshCacheHeader header{};
+    if (file->size() < sizeof(header)) {
+        HUIRA_THROW_ERROR("read_mesh_cache - Invalid file format: " + filepath.string());
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, MeshCacheLayout::MAGIC, sizeof(header.magic)) != 0) {
+        HUIRA_THROW_ERROR("read_mesh_cache - Invalid file format: " + filepath.string());
+    }
+    if (header.version != MeshCacheLayout::VERSION) {
+        HUIRA_THROW_ERROR("read_mesh_cache - " + filepath.filename().string() +
+                          " has unsupported version " + std::to_string(header.version) +
+                          ". Please re-generate.");
+    }
+    if (header.albedo_bins != TSpectral::size() || header.vec3_bytes != sizeof(Vec3<float>)) {
+        HUIRA_THROW_ERROR("read_mesh_cache - " + filepath.filename().string() +
+                          " was written for a different spectral type or platform");
+    }
+    if (header.level_count < 1 ||
+        header.level_count > (file->size() - sizeof(header)) / sizeof(MeshCacheLevel)) {
+        HUIRA_THROW_ERROR("read_mesh_cache - File is truncated: " + filepath.string());
+    }
+
+    std::shared_ptr<Mesh<TSpectral>> mesh;
+    for (std::uint32_t l = 0; l < header.level_count; ++l) {
+        MeshCacheLevel level{};
+        std::memcpy(&level,
+                    file->data() + sizeof(header) + l * sizeof(MeshCacheLevel),
+                    sizeof(level));
+
+        auto indices =
+            detail::mesh_cache_section<std::uint32_t>(file, level.index_offset, level.index_count);
+        auto uniform_albedo =
+            detail::mesh_cache_section<TSpectral>(file, level.uniform_albedo_offset, 1);
+        VertexStreams<TSpectral> vertices(
+            detail::mesh_cache_section<Vec3<float>>(
+                file, level.position_offset, level.vertex_count + 1),
+            detail::mesh_cache_section<OctNormal>(file, level.normal_offset, level.vertex_count),
+            detail::mesh_cache_section<QuantizedUV>(file, level.uv_offset, level.vertex_count),
+            detail::mesh_cache_section<TSpectral>(file, level.albedo_offset, level.albedo_count),
+            Vec2<float>{level.uv_origin[0], level.uv_origin[1]},
+            Vec2<float>{level.uv_step[0], level.uv_step[1]},
+            uniform_albedo[0]);
+        auto tangents =
+            detail::mesh_cache_section<Tangent>(file, level.tangent_offset, level.tangent_count);
+
+        if (l == 0) {
+            mesh = std::make_shared<Mesh<TSpectral>>(
+                std::move(indices), std::move(vertices), std::move(tangents));
+        } else {
+            mesh->add_lod(
+                std::move(indices), std::move(vertices), std::move(tangents), level.error);
+        }
+    }
+
+    HUIRA_LOG_INFO("read_mesh_cache - Mapped " + filepath.string() + " (triangles: " +
+                   std::to_string(mesh->triangle_count()) +
+                   ", levels: " + std::to_string(mesh->lod_count()) + ")");
+    return mesh;
+}
+} // namespace huira
@@ -0,0 +1,356 @@
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "cspice/SpiceUsr.h"
+#include "huira/core/spice.hpp"
+#include "huira/util/logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+namespace detail {
+// Closes a DAS file opened for reading, even when reading it throws:
+struct DasFileCloser {
+    SpiceInt handle;
+
+    ~DasFileCloser()
+    {
+        dascls_c(handle);
+        if (failed_c()) {
+            reset_c();
+        }
+    }
+};
+
+// Reads the next number from an ICQ file, returning false at the end of the text:
+template <typename T>
+bool next_icq_number(const char*& cursor, const char* end, T& value)
+{
+    while (cursor != end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' ||
+                             *cursor == '\n' || *cursor == '+')) {
+        ++cursor;
+    }
+    if (cursor == end) {
+        return false;
+    }
+    auto [next, error] = std::from_chars(cursor, end, value);
+    if (error != std::errc{}) {
+        return false;
+    }
+    cursor = next;
+    return true;
+}
+} // namespace detail
+
+/**
+ * @brief Read every type 2 (plate model) segment of a SPICE DSK file.
+ *
+ * Segments are concatenated, so a file tiled into several segments loads as one model. Vertices
+ * and plates are copied straight from CSPICE into the buffers, a segment at a time. Segments of
+ * other types are skipped with a warning.
+ *
+ * @param filepath Path to the DSK file
+ * @return ShapeModelBuffers The plates, with positions in kilometres in the body-fixed frame
+ * @throws std::runtime_error if the file cannot be read or holds no plate segments
+ */
+inline ShapeModelBuffers read_dsk_plates(const fs::path& filepath)
+{
+    HUIRA_TRACE_SCOPE("read_dsk_plates");
+    static_assert(sizeof(Vec3<double>) == 3 * sizeof(SpiceDouble),
+                  "read_dsk_plates - Vec3<double> must be three packed doubles");
+    if (!fs::exists(filepath)) {
+        HUIRA_THROW_ERROR("read_dsk_plates - File not found: " + filepath.string());
+    }
+
+    SpiceInt handle = 0;
+    spice::call_spice(dasopr_c, filepath.string().c_str(), &handle);
+    detail::DasFileCloser closer{handle};
+
+    ShapeModelBuffers buffers;
+    SpiceDLADescr dladsc;
+    SpiceBoolean found = SPICEFALSE;
+    spice::call_spice(dlabfs_c, handle, &dladsc, &found);
+    while (found) {
+        SpiceDSKDescr dskdsc;
+        spice::call_spice(dskgd_c, handle, &dladsc, &dskdsc);
+        if (dskdsc.dtype == 2) {
+            SpiceInt nv = 0;
+            SpiceInt np = 0;
+            SpiceInt nvxtot = 0;
+            SpiceDouble vtxbds[3][2];
+            SpiceDouble voxsiz = 0.0;
+            SpiceDouble voxori[3];
+            SpiceInt vgrext[3];
+            SpiceInt cgscal = 0;
+            SpiceInt vtxnpl = 0;
+            SpiceInt voxnpt = 0;
+            SpiceInt voxnpl = 0;
+            spice::call_spice(dskb02_c,
+                              handle,
+                              &dladsc,
+                              &nv,
+                              &np,
+                              &nvxtot,
+                              vtxbds,
+                              &voxsiz,
+                              voxori,
+                              vgrext,
+                              &cgscal,
+                              &vtxnpl,
+                              &voxnpt,
+                              &voxnpl);
+
+            const std::size_t vertex_offset = buffers.positions.size();
+            if (vertex_offset + static_cast<std::size_t>(nv) >
+                std::numeric_limits<std::uint32_t>::max()) {
+                HUIRA_THROW_ERROR("read_dsk_plates - Too many vertices in: " + filepath.string());
+            }
+
+            SpiceInt count = 0;
+            buffers.positions.resize(vertex_offset + static_cast<std::size_t>(nv));
+            auto* vertices =
+                reinterpret_cast<SpiceDouble(*)[3]>(buffers.positions.data() + vertex_offset);
+            spice::call_spice(dskv02_c, handle, &dladsc, 1, nv, &count, vertices);
+            if (count != nv) {
+                HUIRA_THROW_ERROR("read_dsk_plates - Read " + std::to_string(count) + " of " +
+                                  std::to_string(nv) + " vertices in: " + filepath.string());
+            }
+
+            std::vector<SpiceInt> plates(3 * static_cast<std::size_t>(np));
+            auto* plate_vertices = reinterpret_cast<SpiceInt(*)[3]>(plates.data());
+            spice::call_spice(dskp02_c, handle, &dladsc, 1, np, &count, plate_vertices);
+            if (count != np) {
+                HUIRA_THROW_ERROR("read_dsk_plates - Read " + std::to_string(count) + " of " +
+                                  std::to_string(np) + " plates in: " + filepath.string());
+            }
+
+            // Plates number their vertices from one:
+            buffers.indices.reserve(buffers.indices.size() + plates.size());
+            for (SpiceInt vertex : plates) {
+                if (vertex < 1 || vertex > nv) {
+                    HUIRA_THROW_ERROR("read_dsk_plates - Plate refers to a missing vertex in: " +
+                                      filepath.string());
+                }
+                buffers.indices.push_back(static_cast<std::uint32_t>(
+                    vertex_offset + static_cast<std::size_t>(vertex) - 1));
+            }
+        } else {
+            HUIRA_LOG_WARNING("read_dsk_plates - Skipping a type " + std::to_string(dskdsc.dtype) +
+                              " segment in: " + filepath.string());
+        }
+
+        SpiceDLADescr next;
+        spice::call_spice(dlafns_c, handle, &dladsc, &next, &found);
+        dladsc = next;
+    }
+
+    if (buffers.indices.empty()) {
+        HUIRA_THROW_ERROR("read_dsk_plates - No type 2 plate segments in: " + filepath.string());
+    }
+    return buffers;
+}
+
+/**
+ * @brief Read a Gaskell implicitly connected quadrilateral (ICQ) shape model.
+ *
+ * The file gives the resolution q, then the (q + 1)^2 vertices of each of the six faces of a
+ * cube mapped onto the body, one "x y z" line each, with i varying fastest. Faces repeat the
+ * vertices along the edges they share, and these are merged so that normals are smooth across
+ * the seams. Each quad is split into two triangles, and each face is wound so that it faces away
+ * from the centroid of the vertices, since the file does not fix the orientation of its faces.
+ *
+ * @param filepath Path to the ICQ file
+ * @return ShapeModelBuffers The triangles, with positions in kilometres in the body-fixed frame
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+inline ShapeModelBuffers read_icq_plates(const fs::path& filepath)
+{
+    HUIRA_TRACE_SCOPE("read_icq_plates");
+    std::ifstream in(filepath, std::ios::binary);
+    if (!in) {
+        HUIRA_THROW_ERROR("read_icq_plates - Failed to open file for reading: " +
+                          filepath.string());
+    }
+    const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    const char* cursor = text.data();
+    const char* end = text.data() + text.size();
+
+    std::uint64_t q = 0;
+    if (!detail::next_icq_number(cursor, end, q) || q == 0) {
+        HUIRA_THROW_ERROR("read_icq_plates - Missing resolution in: " + filepath.string());
+    }
+    const std::uint64_t side = q + 1;
+    if (q > 65535 || 6 * side * side > std::numeric_limits<std::uint32_t>::max()) {
+        HUIRA_THROW_ERROR("read_icq_plates - Resolution too large in: " + filepath.string());
+    }
+    const auto face_size = static_cast<std::size_t>(side * side);
+
+    // Read every face, merging the vertices repeated along the cube's edges:
+    ShapeModelBuffers buffers;
+    buffers.positions.reserve(6 * face_size);
+    std::vector<std::uint32_t> grid(6 * face_size);
+    std::map<std::array<double, 3>, std::uint32_t> edge_vertices;
+    for (std::size_t f = 0; f < 6; ++f) {
+        for (std::size_t j = 0; j < side; ++j) {
+            for (std::size_t i = 0; i < side; ++i) {
+                std::array<double, 3> xyz;
+                for (double& value : xyz) {
+                    if (!detail::next_icq_number(cursor, end, value)) {
+                        HUIRA_THROW_ERROR("read_icq_plates - Expected " +
+                                          std::to_string(6 * face_size) + " vertices in: " +
+                                          filepath.string());
+                    }
+                }
+
+                auto index = static_cast<std::uint32_t>(buffers.positions.size());
+                bool is_new = true;
+                if (i == 0 || j == 0 || i == q || j == q) {
+                    auto [it, inserted] = edge_vertices.emplace(xyz, index);
+                    index = it->second;
+                    is_new = inserted;
+                }
+                grid[f * face_size + j * side + i] = index;
+                if (is_new) {
+                    buffers.positions.push_back(Vec3<double>{xyz[0], xyz[1], xyz[2]});
+                }
+            }
+        }
+    }
+
+    Vec3<double> centroid{0.0};
+    for (const Vec3<double>& position : buffers.positions) {
+        centroid += position;
+    }
+    centroid /= static_cast<double>(buffers.positions.size());
+
+    buffers.indices.reserve(6 * 6 * static_cast<std::size_t>(q * q));
+    for (std::size_t f = 0; f < 6; ++f) {
+        const std::size_t face_begin = buffers.indices.size();
+        double volume = 0.0;
+        for (std::size_t j = 0; j < q; ++j) {
+            for (std::size_t i = 0; i < q; ++i) {
+                const std::uint32_t* row = grid.data() + f * face_size + j * side;
+                const std::uint32_t a = row[i];
+                const std::uint32_t b = row[i + 1];
+                const std::uint32_t c = row[side + i + 1];
+                const std::uint32_t d = row[side + i];
+                buffers.indices.insert(buffers.indices.end(), {a, b, c, a, c, d});
+
+                // Volume swept from the centroid, positive when the quad faces outwards:
+                const Vec3<double> pa = buffers.positions[a] - centroid;
+                const Vec3<double> pb = buffers.positions[b] - centroid;
+                const Vec3<double> pc = buffers.positions[c] - centroid;
+                const Vec3<double> pd = buffers.positions[d] - centroid;
+                volume += glm::dot(pa, glm::cross(pb, pc)) + glm::dot(pa, glm::cross(pc, pd));
+            }
+        }
+        if (volume < 0.0) {
+            for (std::size_t t = face_begin; t < buffers.indices.size(); t += 3) {
+                std::swap(buffers.indices[t + 1], buffers.indices[t + 2]);
+            }
+        }
+    }
+    return buffers;
+}
+
+/**
+ * @brief Build a Mesh from shape model buffers, centring it in double precision.
+ *
+ * Small-body models are often far from their frame's origin, or large enough that float
+ * positions lose precision, so the centre of the bounding box is subtracted from every vertex
+ * before the conversion to float. Place the mesh's instance at that centre to restore the
+ * model's position in its frame. Vertex normals are the area weighted average of the normals of
+ * the triangles around each vertex, which are wound counter-clockwise seen from outside.
+ *
+ * @param buffers Vertices and triangles
+ * @param center Set to the centre subtracted from the vertices, in metres
+ * @param units_to_meters Metres per unit of the buffers' positions (kilometres by default)
+ * @return std::shared_ptr<Mesh<TSpectral>> The centred mesh
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> make_shape_model_mesh(const ShapeModelBuffers& buffers,
+                                                       Vec3<double>& center,
+                                                       double units_to_meters)
+{
+    if (buffers.positions.empty() || buffers.indices.empty()) {
+        HUIRA_THROW_ERROR("make_shape_model_mesh - Shape model has no triangles");
+    }
+
+    Vec3<double> lower{std::numeric_limits<double>::max()};
+    Vec3<double> upper{std::numeric_limits<double>::lowest()};
+    for (const Vec3<double>& position : buffers.positions) {
+        lower = glm::min(lower, position);
+        upper = glm::max(upper, position);
+    }
+    center = 0.5 * (lower + upper) * units_to_meters;
+
+    std::vector<Vec3<double>> normals(buffers.positions.size(), Vec3<double>{0.0});
+    for (std::size_t t = 0; t + 2 < buffers.indices.size(); t += 3) {
+        const std::uint32_t a = buffers.indices[t];
+        const std::uint32_t b = buffers.indices[t + 1];
+        const std::uint32_t c = buffers.indices[t + 2];
+        if (a >= normals.size() || b >= normals.size() || c >= normals.size()) {
+            HUIRA_THROW_ERROR("make_shape_model_mesh - Triangle refers to a missing vertex");
+        }
+        const Vec3<double> normal = glm::cross(buffers.positions[b] - buffers.positions[a],
+                                               buffers.positions[c] - buffers.positions[a]);
+        normals[a] += normal;
+        normals[b] += normal;
+        normals[c] += normal;
+    }
+
+    VertexBuffer<TSpectral> vertices(buffers.positions.size());
+    for (std::size_t v = 0; v < vertices.size(); ++v) {
+        vertices[v].position = Vec3<float>{buffers.positions[v] * units_to_meters - center};
+        const double length = glm::length(normals[v]);
+        if (length > 0.0) {
+            vertices[v].normal = Vec3<float>{normals[v] / length};
+        }
+    }
+    return std::make_shared<Mesh<TSpectral>>(buffers.indices, vertices);
+}
+
+/**
+ * @brief Load a SPICE DSK type 2 plate model as a Mesh.
+ * @param filepath Path to the DSK file
+ * @param center Set to the centre subtracted from the vertices, see make_shape_model_mesh()
+ * @return std::shared_ptr<Mesh<TSpectral>> The centred mesh, in metres
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> read_dsk(const fs::path& filepath, Vec3<double>& center)
+{
+    ShapeModelBuffers buffers = read_dsk_plates(filepath);
+    HUIRA_LOG_INFO("read_dsk - Read " + std::to_string(buffers.positions.size()) +
+                   " vertices and " + std::to_string(buffers.indices.size() / 3) +
+                   " plates from " + filepath.string());
+    return make_shape_model_mesh<TSpectral>(buffers, center);
+}
+
+/**
+ * @brief Load a Gaskell ICQ shape model as a Mesh.
+ * @param filepath Path to the ICQ file
+ * @param center Set to the centre subtracted from the vertices, see make_shape_model_mesh()
+ * @return std::shared_ptr<Mesh<TSpectral>> The centred mesh, in metres
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<Mesh<TSpectral>> read_icq(const fs::path& filepath, Vec3<double>& center)
+{
+    ShapeModelBuffers buffers = read_icq_plates(filepath);
+    HUIRA_LOG_INFO("read_icq - Read " + std::to_string(buffers.positions.size()) +
+                   " vertices and " + std::to_string(buffers.indices.size() / 3) +
+                   " triangles from " + filepath.string());
+    return make_shape_model_mesh<TSpectral>(buffers, center);
+}
+} // namespace huira
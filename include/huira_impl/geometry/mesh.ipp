@@ -1,7 +1,18 @@
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "embree4/rtcore.h"
+#include "glm/glm.hpp"
+#include "huira/geometry/mesh_simplification.hpp"
 #include "huira/geometry/vertex.hpp"
+#include "huira/geometry/vertex_streams.hpp"
 #include "huira/util/logger.hpp"
 
 namespace huira {
@@ -9,109 +20,243 @@ namespace huira {
 /**
  * @brief Constructs a Mesh from index and vertex buffers.
  *
- * Creates a new mesh by taking ownership of the provided buffers. The index
- * buffer should contain triangle indices (groups of three) that reference
- * vertices in the vertex buffer. The Embree BLAS is not built here — it is
- * constructed lazily on first call to blas() after a device has been assigned.
+ * Creates a new mesh by taking ownership of the index buffer and packing the
+ * vertices into VertexStreams. The index buffer should contain triangle indices
+ * (groups of three) that reference vertices in the vertex buffer. The Embree
+ * BLAS is not built here — it is constructed lazily on first call to blas()
+ * after a device has been assigned.
  *
  * @param index_buffer Buffer containing triangle vertex indices.
  * @param vertex_buffer Buffer containing vertex data (positions, normals, etc.).
  */
 template <IsSpectral TSpectral>
-Mesh<TSpectral>::Mesh(IndexBuffer index_buffer, VertexBuffer<TSpectral> vertex_buffer)
-    : index_buffer_(std::move(index_buffer)), vertex_buffer_(std::move(vertex_buffer))
+Mesh<TSpectral>::Mesh(IndexBuffer index_buffer, const VertexBuffer<TSpectral>& vertex_buffer)
+    : Mesh(std::move(index_buffer), vertex_buffer, TangentBuffer{})
 {
-    HUIRA_TRACE_SCOPE("Mesh::Mesh(index_buffer, vertex_buffer)");
-    const auto c = vertex_buffer_.size();
-    if (std::ranges::any_of(index_buffer_, [c](std::uint32_t i) { return i >= c; })) {
-        HUIRA_THROW_ERROR("Mesh::Mesh - index_buffer contains out-of-bounds indices.");
-    }
 }
 
 template <IsSpectral TSpectral>
 Mesh<TSpectral>::Mesh(IndexBuffer index_buffer,
-                      VertexBuffer<TSpectral> vertex_buffer,
+                      const VertexBuffer<TSpectral>& vertex_buffer,
                       TangentBuffer tangent_buffer)
-    : index_buffer_(std::move(index_buffer)), vertex_buffer_(std::move(vertex_buffer)),
+    : Mesh(SharedSpan<std::uint32_t>(std::move(index_buffer)),
+           VertexStreams<TSpectral>(vertex_buffer),
+           SharedSpan<Tangent>(std::move(tangent_buffer)))
+{
+}
+
+/**
+ * @brief Constructs a Mesh from buffers that are already packed, such as those of a mapped cache.
+ * @param index_buffer Triangle vertex indices
+ * @param vertices Vertex streams
+ * @param tangent_buffer Tangents, either empty or one per vertex
+ */
+template <IsSpectral TSpectral>
+Mesh<TSpectral>::Mesh(SharedSpan<std::uint32_t> index_buffer,
+                      VertexStreams<TSpectral> vertices,
+                      SharedSpan<Tangent> tangent_buffer)
+    : index_buffer_(std::move(index_buffer)), vertices_(std::move(vertices)),
       tangent_buffer_(std::move(tangent_buffer))
 {
-    HUIRA_TRACE_SCOPE("Mesh::Mesh(index_buffer, vertex_buffer, tangent_buffer)");
-    const auto vertex_count = vertex_buffer_.size();
+    HUIRA_TRACE_SCOPE("Mesh::Mesh(index_buffer, vertices, tangent_buffer)");
+    const auto vertex_count = vertices_.size();
     if (std::ranges::any_of(index_buffer_,
                             [vertex_count](std::uint32_t idx) { return idx >= vertex_count; })) {
         HUIRA_THROW_ERROR("Mesh::Mesh - index_buffer contains out-of-bounds indices.");
     }
 
-    if (tangent_buffer_.size() != 0 && tangent_buffer_.size() != vertex_buffer_.size()) {
+    if (tangent_buffer_.size() != 0 && tangent_buffer_.size() != vertices_.size()) {
         HUIRA_THROW_ERROR("Mesh::Mesh - tangent_buffer must be the same size as vertex_buffer.");
     }
 }
 
+/**
+ * @brief Resolves a hit on the full resolution mesh.
+ */
 template <IsSpectral TSpectral>
 void Mesh<TSpectral>::compute_surface_interaction(const HitRecord& hit,
                                                   Interaction<TSpectral>& isect) const
 {
-    std::uint32_t idx0 = index_buffer_[hit.prim_id * 3 + 0];
-    std::uint32_t idx1 = index_buffer_[hit.prim_id * 3 + 1];
-    std::uint32_t idx2 = index_buffer_[hit.prim_id * 3 + 2];
+    surface_interaction_(index_buffer_, vertices_, tangent_buffer_, hit, isect);
+}
+
+template <IsSpectral TSpectral>
+Vec2<float> Mesh<TSpectral>::compute_uv(const HitRecord& hit) const
+{
+    return uv_(index_buffer_, vertices_, hit);
+}
+
+/**
+ * @brief Resolves a hit on a build made by build_for_view_(), on the level it was built from.
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::compute_surface_interaction_(const GeometryBuild& build,
+                                                   const HitRecord& hit,
+                                                   Interaction<TSpectral>& isect) const
+{
+    const LodLevel& lod = static_cast<const Build&>(build).lod;
+    surface_interaction_(lod.index_buffer, lod.vertices, lod.tangent_buffer, hit, isect);
+}
+
+template <IsSpectral TSpectral>
+Vec2<float> Mesh<TSpectral>::compute_uv_(const GeometryBuild& build, const HitRecord& hit) const
+{
+    const LodLevel& lod = static_cast<const Build&>(build).lod;
+    return uv_(lod.index_buffer, lod.vertices, hit);
+}
+
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::surface_interaction_(std::span<const std::uint32_t> indices,
+                                           const VertexStreams<TSpectral>& vertices,
+                                           std::span<const Tangent> tangents,
+                                           const HitRecord& hit,
+                                           Interaction<TSpectral>& isect)
+{
+    std::uint32_t idx0 = indices[hit.prim_id * 3 + 0];
+    std::uint32_t idx1 = indices[hit.prim_id * 3 + 1];
+    std::uint32_t idx2 = indices[hit.prim_id * 3 + 2];
 
     float w = 1.0f - hit.u - hit.v;
 
-    isect.position = w * vertex_buffer_[idx0].position + hit.u * vertex_buffer_[idx1].position +
-                     hit.v * vertex_buffer_[idx2].position;
+    const Vec3<float>& p0 = vertices.position(idx0);
+    const Vec3<float>& p1 = vertices.position(idx1);
+    const Vec3<float>& p2 = vertices.position(idx2);
+    isect.position = w * p0 + hit.u * p1 + hit.v * p2;
 
-    isect.normal_s = w * vertex_buffer_[idx0].normal + hit.u * vertex_buffer_[idx1].normal +
-                     hit.v * vertex_buffer_[idx2].normal;
+    isect.normal_s = w * vertices.normal(idx0) + hit.u * vertices.normal(idx1) +
+                     hit.v * vertices.normal(idx2);
 
-    isect.uv = w * vertex_buffer_[idx0].uv + hit.u * vertex_buffer_[idx1].uv +
-               hit.v * vertex_buffer_[idx2].uv;
+    const Vec2<float> uv0 = vertices.uv(idx0);
+    const Vec2<float> uv1 = vertices.uv(idx1);
+    const Vec2<float> uv2 = vertices.uv(idx2);
+    isect.uv = w * uv0 + hit.u * uv1 + hit.v * uv2;
+
+    // Meshes of uniform albedo skip the interpolation and its memory traffic:
+    if (vertices.has_vertex_albedo()) {
+        isect.vertex_albedo = w * vertices.albedo(idx0) + hit.u * vertices.albedo(idx1) +
+                              hit.v * vertices.albedo(idx2);
+    } else {
+        isect.vertex_albedo = vertices.albedo(idx0);
+    }
 
-    isect.vertex_albedo = w * vertex_buffer_[idx0].albedo + hit.u * vertex_buffer_[idx1].albedo +
-                          hit.v * vertex_buffer_[idx2].albedo;
+    // Position partials with respect to uv, for texture filtering. Left at zero for triangles
+    // with degenerate uvs, which disables filtering for them:
+    const Vec2<float> duv02 = uv0 - uv2;
+    const Vec2<float> duv12 = uv1 - uv2;
+    const Vec3<float> dp02 = p0 - p2;
+    const Vec3<float> dp12 = p1 - p2;
+    const float uv_det = duv02.x * duv12.y - duv02.y * duv12.x;
+    isect.dpdu = Vec3<float>{0.0f};
+    isect.dpdv = Vec3<float>{0.0f};
+    if (std::abs(uv_det) > 1e-12f) {
+        const float inv_det = 1.0f / uv_det;
+        isect.dpdu = (duv12.y * dp02 - duv02.y * dp12) * inv_det;
+        isect.dpdv = (duv02.x * dp12 - duv12.x * dp02) * inv_det;
+    }
 
     // Interpolate tangent frame:
     isect.tangent = Vec3<float>{0.0f};
     isect.bitangent = Vec3<float>{0.0f};
-    if (has_tangents()) {
-        isect.tangent = w * tangent_buffer_[idx0].tangent + hit.u * tangent_buffer_[idx1].tangent +
-                        hit.v * tangent_buffer_[idx2].tangent;
-        isect.bitangent = w * tangent_buffer_[idx0].bitangent +
-                          hit.u * tangent_buffer_[idx1].bitangent +
-                          hit.v * tangent_buffer_[idx2].bitangent;
+    if (!tangents.empty()) {
+        isect.tangent = w * tangents[idx0].tangent + hit.u * tangents[idx1].tangent +
+                        hit.v * tangents[idx2].tangent;
+        isect.bitangent = w * tangents[idx0].bitangent + hit.u * tangents[idx1].bitangent +
+                          hit.v * tangents[idx2].bitangent;
     }
 }
 
 template <IsSpectral TSpectral>
-Vec2<float> Mesh<TSpectral>::compute_uv(const HitRecord& hit) const
+Vec2<float> Mesh<TSpectral>::uv_(std::span<const std::uint32_t> indices,
+                                 const VertexStreams<TSpectral>& vertices,
+                                 const HitRecord& hit)
 {
-    std::uint32_t idx0 = index_buffer_[hit.prim_id * 3 + 0];
-    std::uint32_t idx1 = index_buffer_[hit.prim_id * 3 + 1];
-    std::uint32_t idx2 = index_buffer_[hit.prim_id * 3 + 2];
+    std::uint32_t idx0 = indices[hit.prim_id * 3 + 0];
+    std::uint32_t idx1 = indices[hit.prim_id * 3 + 1];
+    std::uint32_t idx2 = indices[hit.prim_id * 3 + 2];
 
     float w = 1.0f - hit.u - hit.v;
 
-    return w * vertex_buffer_[idx0].uv + hit.u * vertex_buffer_[idx1].uv +
-           hit.v * vertex_buffer_[idx2].uv;
+    return w * vertices.uv(idx0) + hit.u * vertices.uv(idx1) + hit.v * vertices.uv(idx2);
+}
+
+/**
+ * @brief Builds the Embree BLAS of the full resolution mesh, for callers of blas() outside a
+ * SceneView.
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::build_blas_() const
+{
+    this->blas_ = build_scene_(lod_(0), 0);
 }
 
 /**
- * @brief Builds the Embree BLAS for this mesh.
+ * @brief Hands a SceneView the build of the level its camera calls for.
+ *
+ * A level is built when a view chooses it, and handed to every later view choosing it for as
+ * long as some view still holds it. Once no view traces a level its BLAS is freed, and it is
+ * rebuilt if a view needs it again, so a mesh only keeps the levels its live views use.
+ *
+ * @param eyes Camera positions in the mesh's local frame, one per instance
+ * @param pixel_angle Angle subtended by one pixel, in radians
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<const GeometryBuild>
+Mesh<TSpectral>::build_for_view_(const std::vector<Vec3<float>>& eyes, float pixel_angle) const
+{
+    const std::size_t level = select_lod_level(eyes, pixel_angle, lod_level_);
+    lod_level_ = level;
+    builds_.resize(lod_count());
+    if (auto build = builds_[level].lock()) {
+        return build;
+    }
+    if (!this->device_) {
+        HUIRA_THROW_ERROR("Mesh::build_for_view_ - Cannot build BLAS: no RTCDevice assigned. "
+                          "Ensure the geometry has been added to a Scene.");
+    }
+    auto build = std::make_shared<Build>();
+    build->level = level;
+    build->lod = lod_(level);
+    build->blas = build_scene_(build->lod, level);
+    builds_[level] = build;
+    return build;
+}
+
+/**
+ * @brief The buffers of a level of detail, level 0 being the full resolution mesh.
+ */
+template <IsSpectral TSpectral>
+typename Mesh<TSpectral>::LodLevel Mesh<TSpectral>::lod_(std::size_t level) const
+{
+    if (level == 0) {
+        return LodLevel{index_buffer_, vertices_, tangent_buffer_, 0.f};
+    }
+    return lods_[level - 1];
+}
+
+/**
+ * @brief Builds an Embree BLAS over a level of detail.
  *
  * Creates a single triangle geometry using shared buffers (zero-copy) that
- * point directly into the mesh's vertex and index data. The vertex buffer is
- * shared with a stride of sizeof(Vertex<TSpectral>), so Embree reads the
- * float3 position at the start of each vertex struct and skips over the
- * remaining fields (albedo, normal, uv).
+ * point directly into the level's index buffer and position stream. The other
+ * vertex attributes live in their own streams, which Embree never touches.
+ *
+ * The resulting RTCScene is committed and ready to be instanced in a TLAS. It reads the level's
+ * buffers, so whoever holds it must hold those too.
  *
- * The resulting RTCScene is committed and ready to be instanced in a TLAS.
+ * @param lod The level's buffers
+ * @param level The level, for logging
+ * @return UniqueRTCScene The committed BLAS
  */
 template <IsSpectral TSpectral>
-void Mesh<TSpectral>::build_blas_() const
+UniqueRTCScene Mesh<TSpectral>::build_scene_(const LodLevel& lod, std::size_t level) const
 {
+    std::span<const std::uint32_t> indices = lod.index_buffer;
+    const VertexStreams<TSpectral>& vertices = lod.vertices;
+
     RTCGeometry geom = rtcNewGeometry(this->device_->get(), RTC_GEOMETRY_TYPE_TRIANGLE);
     if (!geom) {
         HUIRA_THROW_ERROR(
-            "Mesh::build_blas_ - Failed to create Embree geometry (error: " +
+            "Mesh::build_scene_ - Failed to create Embree geometry (error: " +
             std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))) + ").");
     }
 
@@ -119,46 +264,300 @@ void Mesh<TSpectral>::build_blas_() const
                                RTC_BUFFER_TYPE_VERTEX,
                                0,
                                RTC_FORMAT_FLOAT3,
-                               vertex_buffer_.data(),
+                               vertices.positions().data(),
                                0,
-                               sizeof(Vertex<TSpectral>),
-                               vertex_buffer_.size());
+                               sizeof(Vec3<float>),
+                               vertices.size());
 
     rtcSetSharedGeometryBuffer(geom,
                                RTC_BUFFER_TYPE_INDEX,
                                0,
                                RTC_FORMAT_UINT3,
-                               index_buffer_.data(),
+                               indices.data(),
                                0,
                                3 * sizeof(std::uint32_t),
-                               index_buffer_.size() / 3);
+                               indices.size() / 3);
 
     // Check for errors after setting shared buffers (e.g. invalid stride, null pointer):
     RTCError buffer_error = rtcGetDeviceError(this->device_->get());
     if (buffer_error != RTC_ERROR_NONE) {
         rtcReleaseGeometry(geom);
-        HUIRA_THROW_ERROR("Mesh::build_blas_ - Failed to set shared geometry buffers (error: " +
+        HUIRA_THROW_ERROR("Mesh::build_scene_ - Failed to set shared geometry buffers (error: " +
                           std::to_string(static_cast<int>(buffer_error)) + ").");
     }
 
     rtcCommitGeometry(geom);
 
-    this->blas_.reset(rtcNewScene(this->device_->get()));
-    if (!this->blas_) {
+    UniqueRTCScene blas(rtcNewScene(this->device_->get()));
+    if (!blas) {
         rtcReleaseGeometry(geom);
         HUIRA_THROW_ERROR(
-            "Mesh::build_blas_ - Failed to create Embree BLAS scene (error: " +
+            "Mesh::build_scene_ - Failed to create Embree BLAS scene (error: " +
             std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))) + ").");
     }
 
-    rtcAttachGeometry(this->blas_.get(), geom);
+    rtcAttachGeometry(blas.get(), geom);
     rtcReleaseGeometry(geom);
 
-    rtcCommitScene(this->blas_.get());
+    // Let SceneView's alpha-test filter, passed with each query, see hits on this geometry:
+    rtcSetSceneFlags(blas.get(), RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS);
+
+    rtcCommitScene(blas.get());
 
     HUIRA_LOG_INFO("Built BLAS for Mesh " + std::to_string(this->id()) +
-                   " (vertices: " + std::to_string(vertex_buffer_.size()) +
-                   ", triangles: " + std::to_string(index_buffer_.size() / 3) + ")");
+                   " (vertices: " + std::to_string(vertices.size()) +
+                   ", triangles: " + std::to_string(indices.size() / 3) +
+                   ", level: " + std::to_string(level) + ")");
+    return blas;
+}
+
+/**
+ * @brief Replaces the levels of detail with a chain simplified from the full resolution mesh.
+ *
+ * Each level is simplified from the one before with simplify_mesh(), keeping about reduction of
+ * its triangles. The chain ends early once a level would have fewer than MIN_LOD_TRIANGLES
+ * triangles, or once simplification stalls on a mesh made mostly of borders and seams.
+ *
+ * @param max_levels Most levels to add beyond the full resolution mesh
+ * @param reduction Fraction of triangles kept from one level to the next, in (0, 1)
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::generate_lods(std::size_t max_levels, float reduction)
+{
+    HUIRA_TRACE_SCOPE("Mesh::generate_lods");
+    if (!(reduction > 0.f && reduction < 1.f)) {
+        HUIRA_THROW_ERROR("Mesh::generate_lods - reduction must lie in (0, 1).");
+    }
+
+    clear_lods();
+    update_lod_bounds_();
+    float error = 0.f;
+    for (std::size_t level = 1; level <= max_levels; ++level) {
+        const std::size_t triangles = lod_index_buffer(level - 1).size() / 3;
+        const auto target = static_cast<std::size_t>(static_cast<float>(triangles) * reduction);
+        if (target < MIN_LOD_TRIANGLES) {
+            break;
+        }
+
+        const VertexStreams<TSpectral>& vertices = lod_vertex_streams(level - 1);
+        std::span<const Tangent> tangents = lod_tangent_buffer(level - 1);
+        auto simplified = simplify_mesh(lod_index_buffer(level - 1), vertices.positions(), target);
+        if (static_cast<float>(simplified.index_buffer.size() / 3) >
+            static_cast<float>(triangles) * 0.5f * (1.f + reduction)) {
+            break;
+        }
+
+        // Each level's error is measured against the level before it, so they add up:
+        error += simplified.error;
+        TangentBuffer kept_tangents;
+        if (!tangents.empty()) {
+            kept_tangents.reserve(simplified.vertices.size());
+            for (std::uint32_t v : simplified.vertices) {
+                kept_tangents.push_back(tangents[v]);
+            }
+        }
+        lods_.push_back(LodLevel{std::move(simplified.index_buffer),
+                                 vertices.subset(simplified.vertices),
+                                 std::move(kept_tangents),
+                                 error});
+    }
+
+    std::string counts;
+    for (std::size_t level = 0; level < lod_count(); ++level) {
+        counts += (level ? ", " : "") + std::to_string(lod_index_buffer(level).size() / 3);
+    }
+    HUIRA_LOG_INFO("Generated " + std::to_string(lods_.size()) + " levels of detail for Mesh " +
+                   std::to_string(this->id()) + " (triangles: " + counts + ")");
+}
+
+/**
+ * @brief Appends a level of detail, such as one read back from a cache of generate_lods() output.
+ * @param index_buffer Triangle vertex indices of the level
+ * @param vertex_buffer Vertices of the level
+ * @param tangent_buffer Tangents of the level, either empty or one per vertex
+ * @param error Largest distance of the level from the full resolution surface, in mesh units. Must
+ * not be smaller than the error of the level before.
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::add_lod(IndexBuffer index_buffer,
+                              const VertexBuffer<TSpectral>& vertex_buffer,
+                              TangentBuffer tangent_buffer,
+                              float error)
+{
+    add_lod(SharedSpan<std::uint32_t>(std::move(index_buffer)),
+            VertexStreams<TSpectral>(vertex_buffer),
+            SharedSpan<Tangent>(std::move(tangent_buffer)),
+            error);
+}
+
+/**
+ * @brief Appends a level of detail whose vertices are already packed.
+ * @see add_lod
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::add_lod(SharedSpan<std::uint32_t> index_buffer,
+                              VertexStreams<TSpectral> vertices,
+                              SharedSpan<Tangent> tangent_buffer,
+                              float error)
+{
+    const auto vertex_count = vertices.size();
+    if (std::ranges::any_of(index_buffer,
+                            [vertex_count](std::uint32_t idx) { return idx >= vertex_count; })) {
+        HUIRA_THROW_ERROR("Mesh::add_lod - index_buffer contains out-of-bounds indices.");
+    }
+    if (tangent_buffer.size() != 0 && tangent_buffer.size() != vertex_count) {
+        HUIRA_THROW_ERROR("Mesh::add_lod - tangent_buffer must be the same size as vertex_buffer.");
+    }
+    if (!(error >= lod_error(lod_count() - 1))) {
+        HUIRA_THROW_ERROR("Mesh::add_lod - Levels must be added in order of increasing error.");
+    }
+
+    if (lods_.empty()) {
+        update_lod_bounds_();
+    }
+    lods_.push_back(
+        LodLevel{std::move(index_buffer), std::move(vertices), std::move(tangent_buffer), error});
+    builds_.clear();
+    this->touch_();
+}
+
+/**
+ * @brief Removes all levels of detail, returning the mesh to full resolution.
+ *
+ * SceneViews built before keep tracing the levels they chose.
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::clear_lods()
+{
+    lod_level_ = 0;
+    lods_.clear();
+    builds_.clear();
+    this->touch_();
+}
+
+template <IsSpectral TSpectral>
+std::span<const std::uint32_t> Mesh<TSpectral>::lod_index_buffer(std::size_t level) const
+{
+    if (level > lods_.size()) {
+        HUIRA_THROW_ERROR("Mesh::lod_index_buffer - No level of detail " + std::to_string(level));
+    }
+    return level == 0 ? index_buffer_ : lods_[level - 1].index_buffer;
+}
+
+template <IsSpectral TSpectral>
+const VertexStreams<TSpectral>& Mesh<TSpectral>::lod_vertex_streams(std::size_t level) const
+{
+    if (level > lods_.size()) {
+        HUIRA_THROW_ERROR("Mesh::lod_vertex_streams - No level of detail " +
+                          std::to_string(level));
+    }
+    return level == 0 ? vertices_ : lods_[level - 1].vertices;
+}
+
+template <IsSpectral TSpectral>
+std::span<const Tangent> Mesh<TSpectral>::lod_tangent_buffer(std::size_t level) const
+{
+    if (level > lods_.size()) {
+        HUIRA_THROW_ERROR("Mesh::lod_tangent_buffer - No level of detail " +
+                          std::to_string(level));
+    }
+    return level == 0 ? tangent_buffer_ : lods_[level - 1].tangent_buffer;
+}
+
+template <IsSpectral TSpectral>
+float Mesh<TSpectral>::lod_error(std::size_t level) const
+{
+    if (level > lods_.size()) {
+        HUIRA_THROW_ERROR("Mesh::lod_error - No level of detail " + std::to_string(level));
+    }
+    return level == 0 ? 0.f : lods_[level - 1].error;
+}
+
+/**
+ * @brief Sets how far, in pixels, a level's error may project before a finer level is used.
+ * @param pixels Pixel tolerance. Zero keeps the mesh at full resolution.
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::set_lod_pixel_error(float pixels)
+{
+    if (!(pixels >= 0.f)) {
+        HUIRA_THROW_ERROR("Mesh::set_lod_pixel_error - pixels must be non-negative.");
+    }
+    lod_pixel_error_ = pixels;
+    this->touch_();
+}
+
+/**
+ * @brief Sets the margin a coarser level must fit the pixel tolerance by before it is used.
+ * @param hysteresis Fraction of the tolerance, in [0, 1). A coarser level is used once its error
+ * projects to at most (1 - hysteresis) times lod_pixel_error() pixels.
+ */
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::set_lod_hysteresis(float hysteresis)
+{
+    if (!(hysteresis >= 0.f && hysteresis < 1.f)) {
+        HUIRA_THROW_ERROR("Mesh::set_lod_hysteresis - hysteresis must lie in [0, 1).");
+    }
+    lod_hysteresis_ = hysteresis;
+    this->touch_();
+}
+
+/**
+ * @brief Chooses the coarsest level of detail that fits the pixel tolerance.
+ *
+ * The nearest instance decides, since every instance of the mesh in a view traces the same level.
+ * Levels finer than the current one are taken as soon as the current one is too coarse, while
+ * coarser ones must fit with the hysteresis margin.
+ *
+ * @param eyes Camera positions in the mesh's local frame, one per instance
+ * @param pixel_angle Angle subtended by one pixel, in radians
+ * @param current The level traced so far, such as lod_level()
+ * @return std::size_t The level to trace, current if there is no camera to judge from
+ */
+template <IsSpectral TSpectral>
+std::size_t Mesh<TSpectral>::select_lod_level(const std::vector<Vec3<float>>& eyes,
+                                              float pixel_angle,
+                                              std::size_t current) const
+{
+    current = std::min(current, lods_.size());
+    if (lods_.empty() || eyes.empty() || !(pixel_angle > 0.f)) {
+        return current;
+    }
+
+    float distance = std::numeric_limits<float>::infinity();
+    for (const Vec3<float>& eye : eyes) {
+        distance = std::min(distance, glm::length(eye - lod_center_) - lod_radius_);
+    }
+    const float tolerance = lod_pixel_error_ * pixel_angle * std::max(distance, 0.f);
+
+    std::size_t level = current;
+    while (level > 0 && lod_error(level) > tolerance) {
+        --level;
+    }
+    while (level < lods_.size() && lod_error(level + 1) <= tolerance * (1.f - lod_hysteresis_)) {
+        ++level;
+    }
+    return level;
+}
+
+// Bounding sphere of the full resolution mesh, which every level lies close to:
+template <IsSpectral TSpectral>
+void Mesh<TSpectral>::update_lod_bounds_()
+{
+    if (vertices_.empty()) {
+        return;
+    }
+    Vec3<float> lower = vertices_.position(0);
+    Vec3<float> upper = vertices_.position(0);
+    for (const Vec3<float>& position : vertices_.positions()) {
+        lower = glm::min(lower, position);
+        upper = glm::max(upper, position);
+    }
+    lod_center_ = 0.5f * (lower + upper);
+    lod_radius_ = 0.f;
+    for (const Vec3<float>& position : vertices_.positions()) {
+        lod_radius_ = std::max(lod_radius_, glm::length(position - lod_center_));
+    }
 }
 
 template <IsSpectral TSpectral>
@@ -170,7 +569,7 @@ std::size_t Mesh<TSpectral>::index_count() const noexcept
 template <IsSpectral TSpectral>
 std::size_t Mesh<TSpectral>::vertex_count() const noexcept
 {
-    return vertex_buffer_.size();
+    return vertices_.size();
 }
 
 template <IsSpectral TSpectral>
@@ -180,19 +579,28 @@ std::size_t Mesh<TSpectral>::triangle_count() const noexcept
 }
 
 template <IsSpectral TSpectral>
-[[nodiscard]] const IndexBuffer& Mesh<TSpectral>::index_buffer() const noexcept
+[[nodiscard]] std::span<const std::uint32_t> Mesh<TSpectral>::index_buffer() const noexcept
 {
     return index_buffer_;
 }
 
 template <IsSpectral TSpectral>
-[[nodiscard]] const VertexBuffer<TSpectral>& Mesh<TSpectral>::vertex_buffer() const noexcept
+[[nodiscard]] const VertexStreams<TSpectral>& Mesh<TSpectral>::vertex_streams() const noexcept
+{
+    return vertices_;
+}
+
+/**
+ * @brief Unpacks the full resolution vertices, with normals and uvs as quantised.
+ */
+template <IsSpectral TSpectral>
+[[nodiscard]] VertexBuffer<TSpectral> Mesh<TSpectral>::vertex_buffer() const
 {
-    return vertex_buffer_;
+    return vertices_.unpack();
 }
 
 template <IsSpectral TSpectral>
-[[nodiscard]] const TangentBuffer& Mesh<TSpectral>::tangent_buffer() const noexcept
+[[nodiscard]] std::span<const Tangent> Mesh<TSpectral>::tangent_buffer() const noexcept
 {
     return tangent_buffer_;
 }
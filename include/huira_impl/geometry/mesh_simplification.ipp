@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "huira/core/types.hpp"
+#include "huira/util/logger.hpp"
+
+namespace huira {
+namespace detail {
+// Sum of squared distances to a set of planes, kept as the upper triangle of a symmetric 4x4
+// matrix so that it can be evaluated at any point:
+struct PlaneQuadric {
+    std::array<double, 10> m{};
+
+    static PlaneQuadric from_plane(const Vec3<double>& n, double d)
+    {
+        PlaneQuadric q;
+        q.m = {n.x * n.x,
+               n.x * n.y,
+               n.x * n.z,
+               n.x * d,
+               n.y * n.y,
+               n.y * n.z,
+               n.y * d,
+               n.z * n.z,
+               n.z * d,
+               d * d};
+        return q;
+    }
+
+    PlaneQuadric& operator+=(const PlaneQuadric& other)
+    {
+        for (std::size_t i = 0; i < m.size(); ++i) {
+            m[i] += other.m[i];
+        }
+        return *this;
+    }
+
+    [[nodiscard]] double evaluate(const Vec3<double>& p) const
+    {
+        double value = m[0] * p.x * p.x + m[4] * p.y * p.y + m[7] * p.z * p.z + m[9];
+        value += 2.0 * (m[1] * p.x * p.y + m[2] * p.x * p.z + m[5] * p.y * p.z);
+        value += 2.0 * (m[3] * p.x + m[6] * p.y + m[8] * p.z);
+        return std::max(value, 0.0);
+    }
+};
+} // namespace detail
+
+/**
+ * @brief Reduces a triangle mesh with quadric error metric edge collapses.
+ *
+ * Each step collapses the edge whose removal moves the surface least, as measured by the sum of
+ * squared distances to the planes of the input triangles around it (Garland and Heckbert). Edges
+ * collapse onto one of their vertices rather than an optimised position, so the output reuses a
+ * subset of the input vertices, whose other attributes can be carried over unchanged.
+ *
+ * Only vertices whose triangle fan is closed are removed. Vertices on open borders, and on uv or
+ * normal seams where the input splits a position into several vertices, stay in place, so the
+ * output neither shrinks its outline nor tears along seams. Collapses that would fold a triangle
+ * over or make the surface non-manifold are skipped. Triangles of zero area are dropped.
+ *
+ * @param index_buffer Triangle vertex indices of the input
+ * @param positions Vertex positions of the input
+ * @param target_triangles Triangle count to stop at. Fewer collapses happen if the mesh runs out
+ * of removable vertices first.
+ * @return SimplifiedMesh The reduced mesh and an estimate of its error
+ */
+inline SimplifiedMesh simplify_mesh(std::span<const std::uint32_t> index_buffer,
+                                    std::span<const Vec3<float>> positions,
+                                    std::size_t target_triangles)
+{
+    HUIRA_TRACE_SCOPE("simplify_mesh");
+    const std::size_t vertex_count = positions.size();
+    const std::size_t triangle_count = index_buffer.size() / 3;
+    if (std::ranges::any_of(index_buffer,
+                            [vertex_count](std::uint32_t i) { return i >= vertex_count; })) {
+        HUIRA_THROW_ERROR("simplify_mesh - index_buffer contains out-of-bounds indices.");
+    }
+
+    auto position = [&](std::uint32_t v) { return Vec3<double>(positions[v]); };
+
+    IndexBuffer corners(index_buffer.begin(), index_buffer.end());
+    std::vector<bool> alive(triangle_count, false);
+    std::vector<std::vector<std::uint32_t>> fans(vertex_count);
+    std::vector<detail::PlaneQuadric> quadrics(vertex_count);
+    std::size_t alive_count = 0;
+
+    for (std::uint32_t t = 0; t < triangle_count; ++t) {
+        const std::uint32_t* c = &corners[3 * t];
+        Vec3<double> p0 = position(c[0]);
+        Vec3<double> n = glm::cross(position(c[1]) - p0, position(c[2]) - p0);
+        double length = glm::length(n);
+        if (!(length > 0.0)) {
+            continue;
+        }
+        n = n / length;
+
+        auto plane = detail::PlaneQuadric::from_plane(n, -glm::dot(n, p0));
+        for (int k = 0; k < 3; ++k) {
+            quadrics[c[k]] += plane;
+            fans[c[k]].push_back(t);
+        }
+        alive[t] = true;
+        ++alive_count;
+    }
+
+    auto contains = [&](std::uint32_t t, std::uint32_t v) {
+        return corners[3 * t] == v || corners[3 * t + 1] == v || corners[3 * t + 2] == v;
+    };
+
+    // The vertices sharing a live triangle with v, sorted, each with the number of such
+    // triangles:
+    using Ring = std::vector<std::pair<std::uint32_t, int>>;
+    std::vector<std::uint32_t> others;
+    auto neighbours = [&](std::uint32_t v) {
+        others.clear();
+        for (std::uint32_t t : fans[v]) {
+            if (!alive[t]) {
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                if (corners[3 * t + k] != v) {
+                    others.push_back(corners[3 * t + k]);
+                }
+            }
+        }
+        std::ranges::sort(others);
+
+        Ring ring;
+        for (std::uint32_t w : others) {
+            if (!ring.empty() && ring.back().first == w) {
+                ++ring.back().second;
+            } else {
+                ring.emplace_back(w, 1);
+            }
+        }
+        return ring;
+    };
+
+    auto collapse_allowed = [&](std::uint32_t u, std::uint32_t v, const Ring& u_ring) {
+        // Vertices sharing two triangles with u but not with the edge would end up joined by
+        // more than two triangles:
+        Ring v_ring = neighbours(v);
+        int shared = 0;
+        auto a = u_ring.begin();
+        auto b = v_ring.begin();
+        while (a != u_ring.end() && b != v_ring.end()) {
+            if (a->first < b->first) {
+                ++a;
+            } else if (b->first < a->first) {
+                ++b;
+            } else {
+                ++shared;
+                ++a;
+                ++b;
+            }
+        }
+        if (shared != 2) {
+            return false;
+        }
+
+        // No triangle may flip over or turn sharply as u moves onto v:
+        const Vec3<double> target = position(v);
+        for (std::uint32_t t : fans[u]) {
+            if (!alive[t] || contains(t, v)) {
+                continue;
+            }
+            std::array<Vec3<double>, 3> p;
+            std::array<Vec3<double>, 3> q;
+            for (int k = 0; k < 3; ++k) {
+                p[k] = position(corners[3 * t + k]);
+                q[k] = corners[3 * t + k] == u ? target : p[k];
+            }
+            Vec3<double> before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            Vec3<double> after = glm::cross(q[1] - q[0], q[2] - q[0]);
+            if (glm::dot(before, after) <= 0.25 * glm::length(before) * glm::length(after)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    struct Candidate {
+        double cost;
+        std::uint32_t u;
+        std::uint32_t v;
+        std::uint32_t version;
+
+        bool operator>(const Candidate& other) const
+        {
+            return cost != other.cost ? cost > other.cost : u > other.u;
+        }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> queue;
+    std::vector<std::uint32_t> versions(vertex_count, 0);
+    std::vector<bool> removed(vertex_count, false);
+
+    // Queues the cheapest allowed collapse of u, if u can be removed at all:
+    auto push_best = [&](std::uint32_t u) {
+        ++versions[u];
+        auto ring = neighbours(u);
+        if (ring.empty() ||
+            std::ranges::any_of(ring, [](const auto& entry) { return entry.second != 2; })) {
+            return;
+        }
+
+        std::vector<std::pair<double, std::uint32_t>> costs;
+        costs.reserve(ring.size());
+        for (const auto& [v, count] : ring) {
+            detail::PlaneQuadric q = quadrics[u];
+            q += quadrics[v];
+            costs.emplace_back(q.evaluate(position(v)), v);
+        }
+        std::ranges::sort(costs);
+        for (const auto& [cost, v] : costs) {
+            if (collapse_allowed(u, v, ring)) {
+                queue.push(Candidate{cost, u, v, versions[u]});
+                return;
+            }
+        }
+    };
+
+    for (std::uint32_t u = 0; u < vertex_count; ++u) {
+        push_best(u);
+    }
+
+    double max_cost = 0.0;
+    while (alive_count > target_triangles && !queue.empty()) {
+        Candidate candidate = queue.top();
+        queue.pop();
+        const std::uint32_t u = candidate.u;
+        const std::uint32_t v = candidate.v;
+        if (removed[u] || candidate.version != versions[u]) {
+            continue;
+        }
+        if (removed[v] || !collapse_allowed(u, v, neighbours(u))) {
+            push_best(u);
+            continue;
+        }
+
+        max_cost = std::max(max_cost, candidate.cost);
+        quadrics[v] += quadrics[u];
+        for (std::uint32_t t : fans[u]) {
+            if (!alive[t]) {
+                continue;
+            }
+            if (contains(t, v)) {
+                alive[t] = false;
+                --alive_count;
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                if (corners[3 * t + k] == u) {
+                    corners[3 * t + k] = v;
+                }
+            }
+            fans[v].push_back(t);
+        }
+        removed[u] = true;
+        fans[u].clear();
+        std::erase_if(fans[v], [&](std::uint32_t t) { return !alive[t]; });
+
+        push_best(v);
+        for (const auto& [w, count] : neighbours(v)) {
+            push_best(w);
+        }
+    }
+
+    // Keep the surviving vertices in their original order:
+    SimplifiedMesh result;
+    std::vector<bool> used(vertex_count, false);
+    for (std::uint32_t t = 0; t < triangle_count; ++t) {
+        if (alive[t]) {
+            for (int k = 0; k < 3; ++k) {
+                used[corners[3 * t + k]] = true;
+            }
+        }
+    }
+    std::vector<std::uint32_t> remap(vertex_count, 0);
+    for (std::uint32_t v = 0; v < vertex_count; ++v) {
+        if (used[v]) {
+            remap[v] = static_cast<std::uint32_t>(result.vertices.size());
+            result.vertices.push_back(v);
+        }
+    }
+    result.index_buffer.reserve(3 * alive_count);
+    for (std::uint32_t t = 0; t < triangle_count; ++t) {
+        if (alive[t]) {
+            for (int k = 0; k < 3; ++k) {
+                result.index_buffer.push_back(remap[corners[3 * t + k]]);
+            }
+        }
+    }
+    result.error = static_cast<float>(std::sqrt(max_cost));
+    return result;
+}
+} // namespace huira
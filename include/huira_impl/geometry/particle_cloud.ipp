@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "embree4/rtcore.h"
+#include "glm/glm.hpp"
+#include "huira/util/logger.hpp"
+
+namespace huira {
+/**
+ * @brief Constructs a particle cloud from points already packed as (x, y, z, radius).
+ * @param points One point per particle, in metres
+ * @param albedos One albedo per particle, a single albedo for every particle, or none for white
+ * @param shape The primitive each particle is drawn as
+ */
+template <IsSpectral TSpectral>
+ParticleCloud<TSpectral>::ParticleCloud(std::vector<Vec4<float>> points,
+                                        std::vector<TSpectral> albedos,
+                                        ParticleShape shape)
+    : albedos_(std::move(albedos)), shape_{shape}
+{
+    HUIRA_TRACE_SCOPE("ParticleCloud::ParticleCloud");
+    if (points.empty()) {
+        HUIRA_THROW_ERROR("ParticleCloud::ParticleCloud - A particle cloud needs particles.");
+    }
+    for (const Vec4<float>& point : points) {
+        if (!(point.w >= 0.f) || !std::isfinite(point.w)) {
+            HUIRA_THROW_ERROR("ParticleCloud::ParticleCloud - Radii must be finite and not "
+                              "negative.");
+        }
+    }
+    if (albedos_.empty()) {
+        albedos_.push_back(TSpectral{1});
+    } else if (albedos_.size() != 1 && albedos_.size() != points.size()) {
+        HUIRA_THROW_ERROR("ParticleCloud::ParticleCloud - albedos must hold one value per "
+                          "particle or a single value.");
+    }
+    time_steps_.push_back(std::make_shared<const Points>(std::move(points)));
+}
+
+/**
+ * @brief Constructs a particle cloud from separate positions and radii.
+ * @param positions One position per particle, in metres
+ * @param radii One radius per particle, or a single radius for every particle, in metres
+ * @param albedos One albedo per particle, a single albedo for every particle, or none for white
+ * @param shape The primitive each particle is drawn as
+ */
+template <IsSpectral TSpectral>
+ParticleCloud<TSpectral>::ParticleCloud(const std::vector<Vec3<float>>& positions,
+                                        const std::vector<float>& radii,
+                                        std::vector<TSpectral> albedos,
+                                        ParticleShape shape)
+    : ParticleCloud(pack_(positions, radii), std::move(albedos), shape)
+{
+}
+
+/**
+ * @brief Resolves a hit on the particles as they currently move.
+ */
+template <IsSpectral TSpectral>
+void ParticleCloud<TSpectral>::compute_surface_interaction(const HitRecord& hit,
+                                                           Interaction<TSpectral>& isect) const
+{
+    surface_interaction_(time_steps_, hit, isect);
+}
+
+template <IsSpectral TSpectral>
+Vec2<float> ParticleCloud<TSpectral>::compute_uv(const HitRecord& /*hit*/) const
+{
+    return Vec2<float>{0.0f};
+}
+
+/**
+ * @brief Resolves a hit on a build made by build_for_view_(), on the time steps it traced.
+ */
+template <IsSpectral TSpectral>
+void ParticleCloud<TSpectral>::compute_surface_interaction_(const GeometryBuild& build,
+                                                            const HitRecord& hit,
+                                                            Interaction<TSpectral>& isect) const
+{
+    surface_interaction_(static_cast<const Build&>(build).time_steps, hit, isect);
+}
+
+template <IsSpectral TSpectral>
+void ParticleCloud<TSpectral>::surface_interaction_(const TimeSteps& time_steps,
+                                                    const HitRecord& hit,
+                                                    Interaction<TSpectral>& isect) const
+{
+    const Vec3<float> center = position_at_(time_steps, hit.prim_id, hit.time);
+    const float radius = (*time_steps[0])[hit.prim_id].w;
+
+    // Embree reports the sphere's normal at the hit, or for a disc the direction back along the
+    // ray:
+    Vec3<float> normal = glm::normalize(hit.Ng);
+    isect.position = shape_ == ParticleShape::Sphere ? center + radius * normal : center;
+    isect.normal_g = normal;
+    isect.normal_s = normal;
+    isect.uv = compute_uv(hit);
+    isect.dpdu = Vec3<float>{0.0f};
+    isect.dpdv = Vec3<float>{0.0f};
+    build_default_tangent_frame(normal, isect.tangent, isect.bitangent);
+    isect.vertex_albedo = albedo(hit.prim_id);
+}
+
+/**
+ * @brief The position of a particle at a time during the exposure, as Embree blurs it.
+ *
+ * Embree moves each particle linearly between consecutive time steps.
+ *
+ * @param i The particle
+ * @param time Time across the exposure, from 0 to 1
+ * @return Vec3<float> The position, in metres
+ */
+template <IsSpectral TSpectral>
+Vec3<float> ParticleCloud<TSpectral>::position_at(std::size_t i, float time) const
+{
+    return position_at_(time_steps_, i, time);
+}
+
+template <IsSpectral TSpectral>
+Vec3<float>
+ParticleCloud<TSpectral>::position_at_(const TimeSteps& time_steps, std::size_t i, float time)
+{
+    const Vec3<float> first{(*time_steps[0])[i]};
+    if (time_steps.size() == 1) {
+        return first;
+    }
+    const float segments = static_cast<float>(time_steps.size() - 1);
+    const float s = std::clamp(time, 0.f, 1.f) * segments;
+    const auto step = static_cast<std::size_t>(std::min(std::floor(s), segments - 1.f));
+    const float f = s - static_cast<float>(step);
+    return (1.f - f) * Vec3<float>{(*time_steps[step])[i]} +
+           f * Vec3<float>{(*time_steps[step + 1])[i]};
+}
+
+/**
+ * @brief Adds the positions of every particle at a further time during the exposure.
+ *
+ * The time steps are spread evenly across the exposure, the first being the positions the cloud
+ * was constructed with. Radii stay those of the first time step.
+ *
+ * @param positions One position per particle, in metres, in the order of the first time step
+ */
+template <IsSpectral TSpectral>
+void ParticleCloud<TSpectral>::add_time_step(const std::vector<Vec3<float>>& positions)
+{
+    if (positions.size() != size()) {
+        HUIRA_THROW_ERROR("ParticleCloud::add_time_step - Expected " + std::to_string(size()) +
+                          " positions, got " + std::to_string(positions.size()) + ".");
+    }
+
+    Points points(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        points[i] = Vec4<float>{positions[i], radius(i)};
+    }
+    time_steps_.push_back(std::make_shared<const Points>(std::move(points)));
+    this->blas_.reset();
+    this->touch_();
+}
+
+/**
+ * @brief Removes every time step after the first, leaving the particles still.
+ *
+ * SceneViews built before keep tracing the motion they were built with.
+ */
+template <IsSpectral TSpectral>
+void ParticleCloud<TSpectral>::clear_motion()
+{
+    if (time_steps_.size() > 1) {
+        time_steps_.resize(1);
+        this->blas_.reset();
+        this->touch_();
+    }
+}
+
+/**
+ * @brief Reads particles from a headerless file of 32-bit float (x, y, z, radius) records.
+ *
+ * The records are laid out exactly as the cloud and Embree hold them, so the file is read in a
+ * single pass with no conversion.
+ *
+ * @param path The particle file
+ * @return std::vector<Vec4<float>> One point per particle
+ */
+template <IsSpectral TSpectral>
+std::vector<Vec4<float>> ParticleCloud<TSpectral>::read_raw(const fs::path& path)
+{
+    static_assert(sizeof(Vec4<float>) == 4 * sizeof(float),
+                  "ParticleCloud::read_raw - Vec4<float> must be four packed floats");
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        HUIRA_THROW_ERROR("ParticleCloud::read_raw - Failed to open file for reading: " +
+                          path.string());
+    }
+
+    const auto file_size = static_cast<std::size_t>(fs::file_size(path));
+    if (file_size == 0 || file_size % sizeof(Vec4<float>) != 0) {
+        HUIRA_THROW_ERROR("ParticleCloud::read_raw - " + path.filename().string() + " has " +
+                          std::to_string(file_size) + " bytes, expected a multiple of " +
+                          std::to_string(sizeof(Vec4<float>)));
+    }
+
+    std::vector<Vec4<float>> points(file_size / sizeof(Vec4<float>));
+    in.read(reinterpret_cast<char*>(points.data()), static_cast<std::streamsize>(file_size));
+    if (!in) {
+        HUIRA_THROW_ERROR("ParticleCloud::read_raw - Failed to read " + path.string());
+    }
+    return points;
+}
+
+/**
+ * @brief Builds the Embree BLAS for this cloud.
+ *
+ * Creates a single point geometry with one shared vertex buffer per time step (zero-copy). The
+ * time steps span Embree's default time range of [0, 1], the same range SceneView gives to
+ * instance motion across the exposure. The buffers outlive the BLAS, see build_for_view_().
+ */
+template <IsSpectral TSpectral>
+void ParticleCloud<TSpectral>::build_blas_() const
+{
+    HUIRA_TRACE_SCOPE("ParticleCloud::build_blas_");
+    const RTCGeometryType type = shape_ == ParticleShape::Sphere ? RTC_GEOMETRY_TYPE_SPHERE_POINT
+                                                                 : RTC_GEOMETRY_TYPE_DISC_POINT;
+    RTCGeometry geom = rtcNewGeometry(this->device_->get(), type);
+    if (!geom) {
+        HUIRA_THROW_ERROR(
+            "ParticleCloud::build_blas_ - Embree failed to create a point geometry. Ensure "
+            "EMBREE_GEOMETRY_POINT is enabled in your build. Error: " +
+            std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))));
+    }
+
+    rtcSetGeometryTimeStepCount(geom, static_cast<unsigned int>(time_steps_.size()));
+    for (std::size_t step = 0; step < time_steps_.size(); ++step) {
+        rtcSetSharedGeometryBuffer(geom,
+                                   RTC_BUFFER_TYPE_VERTEX,
+                                   static_cast<unsigned int>(step),
+                                   RTC_FORMAT_FLOAT4,
+                                   time_steps_[step]->data(),
+                                   0,
+                                   sizeof(Vec4<float>),
+                                   time_steps_[step]->size());
+    }
+
+    RTCError err = rtcGetDeviceError(this->device_->get());
+    if (err != RTC_ERROR_NONE) {
+        rtcReleaseGeometry(geom);
+        HUIRA_THROW_ERROR(
+            "ParticleCloud::build_blas_ - Failed to set shared point buffers (error: " +
+            std::to_string(static_cast<int>(err)) + ").");
+    }
+
+    rtcCommitGeometry(geom);
+
+    this->blas_.reset(rtcNewScene(this->device_->get()));
+    if (!this->blas_) {
+        rtcReleaseGeometry(geom);
+        HUIRA_THROW_ERROR(
+            "ParticleCloud::build_blas_ - Failed to create Embree BLAS scene (error: " +
+            std::to_string(static_cast<int>(rtcGetDeviceError(this->device_->get()))) + ").");
+    }
+
+    rtcAttachGeometry(this->blas_.get(), geom);
+    rtcReleaseGeometry(geom);
+
+    // Let SceneView's alpha-test filter, passed with each query, see hits on this geometry:
+    rtcSetSceneFlags(this->blas_.get(), RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS);
+
+    rtcCommitScene(this->blas_.get());
+
+    HUIRA_LOG_INFO("Built BLAS for ParticleCloud " + std::to_string(this->id()) +
+                   " (particles: " + std::to_string(size()) +
+                   ", time steps: " + std::to_string(time_steps_.size()) + ")");
+}
+
+/**
+ * @brief Hands a SceneView the cached BLAS, together with the time steps it shares.
+ *
+ * add_time_step() and clear_motion() replace the cached BLAS, but the view's copy keeps the
+ * buffers Embree reads alive for as long as the view traces them.
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<const GeometryBuild>
+ParticleCloud<TSpectral>::build_for_view_(const std::vector<Vec3<float>>& /*eyes*/,
+                                          float /*pixel_angle*/) const
+{
+    RTCScene scene = this->blas();
+    rtcRetainScene(scene);
+    auto build = std::make_shared<Build>();
+    build->blas.reset(scene);
+    build->time_steps = time_steps_;
+    return build;
+}
+
+template <IsSpectral TSpectral>
+std::vector<Vec4<float>> ParticleCloud<TSpectral>::pack_(const std::vector<Vec3<float>>& positions,
+                                                         const std::vector<float>& radii)
+{
+    if (radii.size() != 1 && radii.size() != positions.size()) {
+        HUIRA_THROW_ERROR("ParticleCloud::ParticleCloud - radii must hold one value per particle "
+                          "or a single value.");
+    }
+    std::vector<Vec4<float>> points(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        points[i] = Vec4<float>{positions[i], radii.size() == 1 ? radii[0] : radii[i]};
+    }
+    return points;
+}
+} // namespace huira
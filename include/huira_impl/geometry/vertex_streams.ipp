@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "huira/util/logger.hpp"
+
+namespace huira {
+namespace detail {
+inline std::int16_t to_snorm16(float x)
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(x, -1.f, 1.f) * 32767.f));
+}
+
+inline float from_snorm16(std::int16_t x)
+{
+    return std::max(static_cast<float>(x) / 32767.f, -1.f);
+}
+} // namespace detail
+
+/**
+ * @brief Encodes a unit vector by projecting it onto an octahedron and unfolding the lower half.
+ * @param normal The vector, which need not be normalised. A zero vector encodes as +z.
+ * @return OctNormal The encoded vector
+ */
+inline OctNormal encode_oct_normal(const Vec3<float>& normal)
+{
+    float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (!(l1 > 0.f)) {
+        return OctNormal{};
+    }
+    float x = normal.x / l1;
+    float y = normal.y / l1;
+    if (normal.z < 0.f) {
+        float folded_x = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+        float folded_y = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = folded_x;
+        y = folded_y;
+    }
+    return OctNormal{detail::to_snorm16(x), detail::to_snorm16(y)};
+}
+
+/**
+ * @brief Decodes a vector encoded by encode_oct_normal().
+ * @param encoded The encoded vector
+ * @return Vec3<float> The unit vector
+ */
+inline Vec3<float> decode_oct_normal(OctNormal encoded)
+{
+    float x = detail::from_snorm16(encoded.x);
+    float y = detail::from_snorm16(encoded.y);
+    float z = 1.f - std::abs(x) - std::abs(y);
+    if (z < 0.f) {
+        float t = -z;
+        x += x >= 0.f ? -t : t;
+        y += y >= 0.f ? -t : t;
+    }
+    return glm::normalize(Vec3<float>{x, y, z});
+}
+
+/**
+ * @brief Packs a buffer of vertices into separate streams.
+ * @param vertices The vertices
+ */
+template <IsSpectral TSpectral>
+VertexStreams<TSpectral>::VertexStreams(const VertexBuffer<TSpectral>& vertices)
+{
+    const std::size_t count = vertices.size();
+    std::vector<Vec3<float>> positions;
+    std::vector<OctNormal> normals;
+    std::vector<QuantizedUV> uvs;
+    positions.reserve(count + 1);
+    normals.reserve(count);
+    uvs.reserve(count);
+
+    Vec2<float> uv_min{0.f};
+    Vec2<float> uv_max{0.f};
+    if (count > 0) {
+        uv_min = vertices[0].uv;
+        uv_max = vertices[0].uv;
+        uniform_albedo_ = vertices[0].albedo;
+    }
+    bool uniform = true;
+    for (const Vertex<TSpectral>& vertex : vertices) {
+        positions.push_back(vertex.position);
+        normals.push_back(encode_oct_normal(vertex.normal));
+        uv_min = Vec2<float>{std::min(uv_min.x, vertex.uv.x), std::min(uv_min.y, vertex.uv.y)};
+        uv_max = Vec2<float>{std::max(uv_max.x, vertex.uv.x), std::max(uv_max.y, vertex.uv.y)};
+        uniform = uniform && vertex.albedo == uniform_albedo_;
+    }
+    positions.push_back(Vec3<float>{0.f});
+
+    uv_offset_ = uv_min;
+    uv_scale_ = (uv_max - uv_min) / 65535.f;
+    auto quantize = [](float value, float offset, float scale) {
+        float t = scale > 0.f ? (value - offset) / scale : 0.f;
+        return static_cast<std::uint16_t>(std::lround(std::clamp(t, 0.f, 65535.f)));
+    };
+    for (const Vertex<TSpectral>& vertex : vertices) {
+        uvs.push_back(QuantizedUV{quantize(vertex.uv.x, uv_offset_.x, uv_scale_.x),
+                                  quantize(vertex.uv.y, uv_offset_.y, uv_scale_.y)});
+    }
+
+    if (!uniform) {
+        std::vector<TSpectral> albedos;
+        albedos.reserve(count);
+        for (const Vertex<TSpectral>& vertex : vertices) {
+            albedos.push_back(vertex.albedo);
+        }
+        albedos_ = std::move(albedos);
+    }
+    positions_ = std::move(positions);
+    normals_ = std::move(normals);
+    uvs_ = std::move(uvs);
+}
+
+/**
+ * @brief Wraps streams that are already encoded, such as those of a mapped mesh cache.
+ * @param padded_positions Vertex positions followed by one element of padding
+ * @param normals Encoded normals, one per vertex
+ * @param uvs Quantised uvs, one per vertex
+ * @param albedos Albedo of each vertex, or empty if they all share uniform_albedo
+ * @param uv_offset The uv that quantises to zero
+ * @param uv_scale The uv step of one quantisation level
+ * @param uniform_albedo Albedo of every vertex when albedos is empty
+ */
+template <IsSpectral TSpectral>
+VertexStreams<TSpectral>::VertexStreams(SharedSpan<Vec3<float>> padded_positions,
+                                        SharedSpan<OctNormal> normals,
+                                        SharedSpan<QuantizedUV> uvs,
+                                        SharedSpan<TSpectral> albedos,
+                                        Vec2<float> uv_offset,
+                                        Vec2<float> uv_scale,
+                                        const TSpectral& uniform_albedo)
+    : positions_{std::move(padded_positions)}, normals_{std::move(normals)}, uvs_{std::move(uvs)},
+      albedos_{std::move(albedos)}, uv_offset_{uv_offset}, uv_scale_{uv_scale},
+      uniform_albedo_{uniform_albedo}
+{
+    const std::size_t count = normals_.size();
+    if (positions_.size() != count + 1 || uvs_.size() != count ||
+        (!albedos_.empty() && albedos_.size() != count)) {
+        HUIRA_THROW_ERROR("VertexStreams::VertexStreams - Stream sizes do not match.");
+    }
+}
+
+template <IsSpectral TSpectral>
+Vec2<float> VertexStreams<TSpectral>::uv(std::size_t i) const
+{
+    return Vec2<float>{uv_offset_.x + uv_scale_.x * static_cast<float>(uvs_[i].u),
+                       uv_offset_.y + uv_scale_.y * static_cast<float>(uvs_[i].v)};
+}
+
+/**
+ * @brief Unpacks one vertex.
+ * @param i Index of the vertex
+ * @return Vertex<TSpectral> The vertex, with its normal and uv as stored
+ */
+template <IsSpectral TSpectral>
+Vertex<TSpectral> VertexStreams<TSpectral>::vertex(std::size_t i) const
+{
+    Vertex<TSpectral> v;
+    v.position = position(i);
+    v.albedo = albedo(i);
+    v.normal = normal(i);
+    v.uv = uv(i);
+    return v;
+}
+
+/**
+ * @brief Unpacks every vertex.
+ */
+template <IsSpectral TSpectral>
+VertexBuffer<TSpectral> VertexStreams<TSpectral>::unpack() const
+{
+    VertexBuffer<TSpectral> vertices;
+    vertices.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        vertices.push_back(vertex(i));
+    }
+    return vertices;
+}
+
+/**
+ * @brief Copies some of the vertices into new streams, keeping their encoding unchanged.
+ * @param indices Index of each vertex to keep, in the order to keep them
+ * @return VertexStreams<TSpectral> The selected vertices
+ */
+template <IsSpectral TSpectral>
+VertexStreams<TSpectral> VertexStreams<TSpectral>::subset(
+    const std::vector<std::uint32_t>& indices) const
+{
+    std::vector<Vec3<float>> positions;
+    std::vector<OctNormal> normals;
+    std::vector<QuantizedUV> uvs;
+    std::vector<TSpectral> albedos;
+    positions.reserve(indices.size() + 1);
+    normals.reserve(indices.size());
+    uvs.reserve(indices.size());
+    for (std::uint32_t i : indices) {
+        positions.push_back(positions_[i]);
+        normals.push_back(normals_[i]);
+        uvs.push_back(uvs_[i]);
+        if (!albedos_.empty()) {
+            albedos.push_back(albedos_[i]);
+        }
+    }
+    positions.push_back(Vec3<float>{0.f});
+    return VertexStreams<TSpectral>(std::move(positions),
+                                    std::move(normals),
+                                    std::move(uvs),
+                                    std::move(albedos),
+                                    uv_offset_,
+                                    uv_scale_,
+                                    uniform_albedo_);
+}
+
+/**
+ * @brief Bytes held by the streams, not counting unused vector capacity.
+ */
+template <IsSpectral TSpectral>
+std::size_t VertexStreams<TSpectral>::memory_bytes() const noexcept
+{
+    return positions_.size() * sizeof(Vec3<float>) + normals_.size() * sizeof(OctNormal) +
+           uvs_.size() * sizeof(QuantizedUV) + albedos_.size() * sizeof(TSpectral);
+}
+} // namespace huira
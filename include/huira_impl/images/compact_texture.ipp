@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "huira/images/io/color_space.hpp"
+#include "huira/images/mip_pyramid.hpp"
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace huira {
+namespace detail {
+/**
+ * @brief Convert a float to IEEE half precision bits, rounding to nearest even.
+ */
+inline std::uint16_t float_to_half(float value)
+{
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    std::uint32_t magnitude = bits & 0x7fffffffu;
+
+    if (magnitude >= 0x7f800000u) {
+        // Infinity stays infinity, NaN stays (quiet) NaN:
+        return static_cast<std::uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477ff000u) {
+        return static_cast<std::uint16_t>(sign | 0x7c00u); // Rounds past 65504
+    }
+    if (magnitude < 0x38800000u) {
+        // Subnormal half, in units of 2^-24:
+        const float scaled = std::bit_cast<float>(magnitude) * 16777216.f;
+        const auto mantissa = static_cast<std::uint32_t>(std::nearbyint(scaled));
+        return static_cast<std::uint16_t>(sign | mantissa);
+    }
+
+    magnitude += 0xfffu + ((magnitude >> 13) & 1u);
+    return static_cast<std::uint16_t>(sign | ((magnitude - 0x38000000u) >> 13));
+}
+
+/**
+ * @brief Convert IEEE half precision bits to a float.
+ */
+inline float half_to_float(std::uint16_t half)
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1fu;
+    const std::uint32_t mantissa = half & 0x3ffu;
+
+    if (exponent == 0) {
+        const float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    }
+    if (exponent == 31) {
+        return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/**
+ * @brief Linear values of the 256 sRGB encoded 8-bit levels.
+ */
+inline const std::array<float, 256>& srgb8_to_linear_table()
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = srgb_to_linear(static_cast<float>(i) / 255.f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+inline std::size_t compact_texel_bytes(CompactTexelFormat format)
+{
+    return format == CompactTexelFormat::RGB8 ? 3 : 6;
+}
+
+inline void encode_compact_texel(CompactTexelFormat format, const RGB& rgb, std::uint8_t* out)
+{
+    if (format == CompactTexelFormat::RGB8) {
+        for (std::size_t c = 0; c < 3; ++c) {
+            const float encoded = linear_to_srgb(std::clamp(rgb[c], 0.f, 1.f));
+            out[c] = static_cast<std::uint8_t>(std::lround(encoded * 255.f));
+        }
+        return;
+    }
+
+    std::array<std::uint16_t, 3> channels{};
+    for (std::size_t c = 0; c < 3; ++c) {
+        if (format == CompactTexelFormat::RGB16) {
+            const float value = std::clamp(rgb[c], 0.f, 1.f);
+            channels[c] = static_cast<std::uint16_t>(std::lround(value * 65535.f));
+        } else {
+            channels[c] = float_to_half(rgb[c]);
+        }
+    }
+    std::memcpy(out, channels.data(), sizeof(channels));
+}
+
+template <CompactTexelFormat Format>
+RGB decode_compact_texel(const std::uint8_t* in)
+{
+    if constexpr (Format == CompactTexelFormat::RGB8) {
+        const std::array<float, 256>& table = srgb8_to_linear_table();
+        return RGB{table[in[0]], table[in[1]], table[in[2]]};
+    } else {
+        std::array<std::uint16_t, 3> channels;
+        std::memcpy(channels.data(), in, sizeof(channels));
+        if constexpr (Format == CompactTexelFormat::RGB16) {
+            constexpr float scale = 1.f / 65535.f;
+            return RGB{static_cast<float>(channels[0]) * scale,
+                       static_cast<float>(channels[1]) * scale,
+                       static_cast<float>(channels[2]) * scale};
+        } else {
+            return RGB{half_to_float(channels[0]),
+                       half_to_float(channels[1]),
+                       half_to_float(channels[2])};
+        }
+    }
+}
+} // namespace detail
+
+/**
+ * @brief The basis of convert_rgb_to_spectral().
+ */
+template <IsSpectral TSpectral>
+RGBSpectralBasis<TSpectral>::RGBSpectralBasis()
+    : RGBSpectralBasis(std::function<TSpectral(RGB)>(convert_rgb_to_spectral<TSpectral>))
+{
+}
+
+/**
+ * @brief Build the basis of an RGB to spectral conversion.
+ *
+ * The conversion is also evaluated at one mixed colour to check that it is linear; if it is not,
+ * linear() returns false and the basis only approximates it.
+ *
+ * @param conversion The conversion to reproduce
+ */
+template <IsSpectral TSpectral>
+RGBSpectralBasis<TSpectral>::RGBSpectralBasis(const std::function<TSpectral(RGB)>& conversion)
+{
+    columns_[0] = conversion(RGB{1.f, 0.f, 0.f});
+    columns_[1] = conversion(RGB{0.f, 1.f, 0.f});
+    columns_[2] = conversion(RGB{0.f, 0.f, 1.f});
+
+    const RGB probe{0.2f, 0.5f, 0.9f};
+    const TSpectral expected = conversion(probe);
+    const TSpectral actual = (*this)(probe);
+    for (std::size_t i = 0; i < TSpectral::size(); ++i) {
+        if (std::abs(expected[i] - actual[i]) > 1e-4f * std::max(std::abs(expected[i]), 1.f)) {
+            linear_ = false;
+        }
+    }
+}
+
+/**
+ * @brief Encode an image and its mip chain.
+ * @param linear_rgb Level 0, in linear RGB
+ * @param format Texel storage format
+ * @param basis Conversion applied to filtered lookups
+ */
+template <IsSpectral TSpectral>
+CompactTexture<TSpectral>::CompactTexture(const Image<RGB>& linear_rgb,
+                                          CompactTexelFormat format,
+                                          RGBSpectralBasis<TSpectral> basis)
+    : format_{format}, basis_{std::move(basis)}
+{
+    if (linear_rgb.empty()) {
+        HUIRA_THROW_ERROR("CompactTexture::CompactTexture - Image must not be empty");
+    }
+    if (!basis_.linear()) {
+        HUIRA_LOG_WARNING("CompactTexture::CompactTexture - The RGB to spectral conversion is not "
+                          "linear, so lookups only approximate it");
+    }
+
+    texel_scale_ = Vec2<float>{static_cast<float>(std::max(linear_rgb.width() - 1, 1)),
+                               static_cast<float>(std::max(linear_rgb.height() - 1, 1))};
+
+    // Filter in float, then encode each level. The pyramid only needs the image for this call:
+    MipPyramid<RGB> mips(
+        std::shared_ptr<const Image<RGB>>(&linear_rgb, [](const Image<RGB>*) {}));
+    const std::size_t texel_bytes = detail::compact_texel_bytes(format_);
+    levels_.resize(mips.levels());
+    for (std::size_t l = 0; l < mips.levels(); ++l) {
+        const Image<RGB>& src = mips.level(l);
+        Level& level = levels_[l];
+        level.resolution = src.resolution();
+        level.data.resize(src.size() * texel_bytes);
+        auto encode_rows = [&](const tbb::blocked_range<int>& rows) {
+            for (int y = rows.begin(); y < rows.end(); ++y) {
+                for (int x = 0; x < src.width(); ++x) {
+                    const std::size_t index =
+                        detail::tiled_pixel_index(x, y, src.width(), src.height());
+                    detail::encode_compact_texel(
+                        format_, src(x, y), level.data.data() + index * texel_bytes);
+                }
+            }
+        };
+        tbb::parallel_for(tbb::blocked_range<int>(0, src.height()), encode_rows);
+    }
+}
+
+/**
+ * @brief Sample with the footprint given by the screen-space uv derivatives.
+ * @param uv Texture coordinates
+ * @param duvdx Change in uv across one pixel in x
+ * @param duvdy Change in uv across one pixel in y
+ * @return TSpectral The filtered value
+ */
+template <IsSpectral TSpectral>
+TSpectral CompactTexture<TSpectral>::sample(const Vec2<float>& uv,
+                                            const Vec2<float>& duvdx,
+                                            const Vec2<float>& duvdy) const
+{
+    switch (format_) {
+    case CompactTexelFormat::RGB8:
+        return sample_<CompactTexelFormat::RGB8>(uv, duvdx, duvdy);
+    case CompactTexelFormat::RGB16:
+        return sample_<CompactTexelFormat::RGB16>(uv, duvdx, duvdy);
+    case CompactTexelFormat::Half:
+    default:
+        return sample_<CompactTexelFormat::Half>(uv, duvdx, duvdy);
+    }
+}
+
+/**
+ * @brief Sample one level bilinearly, with the same texel mapping as Image::sample_bilinear.
+ * @param level Mip level
+ * @param u The horizontal texture coordinate (repeating)
+ * @param v The vertical texture coordinate (repeating)
+ * @return RGB The interpolated linear colour
+ */
+template <IsSpectral TSpectral>
+RGB CompactTexture<TSpectral>::sample_bilinear(std::size_t level, float u, float v) const
+{
+    const Level& data = levels_[std::min(level, levels_.size() - 1)];
+    switch (format_) {
+    case CompactTexelFormat::RGB8:
+        return sample_bilinear_<CompactTexelFormat::RGB8>(data, u, v);
+    case CompactTexelFormat::RGB16:
+        return sample_bilinear_<CompactTexelFormat::RGB16>(data, u, v);
+    case CompactTexelFormat::Half:
+    default:
+        return sample_bilinear_<CompactTexelFormat::Half>(data, u, v);
+    }
+}
+
+/**
+ * @brief Sample at a fractional level, blending bilinear lookups from the two nearest levels.
+ * @param u The horizontal texture coordinate
+ * @param v The vertical texture coordinate
+ * @param lod Level of detail, log2 of the footprint width in base level texels
+ * @return RGB The filtered linear colour
+ */
+template <IsSpectral TSpectral>
+RGB CompactTexture<TSpectral>::sample_trilinear(float u, float v, float lod) const
+{
+    switch (format_) {
+    case CompactTexelFormat::RGB8:
+        return sample_trilinear_<CompactTexelFormat::RGB8>(u, v, lod);
+    case CompactTexelFormat::RGB16:
+        return sample_trilinear_<CompactTexelFormat::RGB16>(u, v, lod);
+    case CompactTexelFormat::Half:
+    default:
+        return sample_trilinear_<CompactTexelFormat::Half>(u, v, lod);
+    }
+}
+
+/**
+ * @brief Get the resolution of a level.
+ * @param level Mip level
+ * @return Resolution The level's resolution
+ */
+template <IsSpectral TSpectral>
+Resolution CompactTexture<TSpectral>::level_resolution(std::size_t level) const
+{
+    if (level >= levels_.size()) {
+        HUIRA_THROW_ERROR("CompactTexture::level_resolution - Level " + std::to_string(level) +
+                          " is out of range");
+    }
+    return levels_[level].resolution;
+}
+
+/**
+ * @brief Memory held by the texels of every level.
+ * @return std::size_t Size in bytes
+ */
+template <IsSpectral TSpectral>
+std::size_t CompactTexture<TSpectral>::bytes() const noexcept
+{
+    std::size_t total = 0;
+    for (const Level& level : levels_) {
+        total += level.data.size();
+    }
+    return total;
+}
+
+/**
+ * @brief Decode a single texel.
+ * @param level Mip level
+ * @param x Column
+ * @param y Row
+ * @return RGB The texel's linear colour
+ */
+template <IsSpectral TSpectral>
+RGB CompactTexture<TSpectral>::texel(std::size_t level, int x, int y) const
+{
+    const Resolution res = level_resolution(level);
+    if (x < 0 || y < 0 || x >= res.width || y >= res.height) {
+        HUIRA_THROW_ERROR("CompactTexture::texel - Texel is out of range");
+    }
+    const std::size_t index = detail::tiled_pixel_index(x, y, res.width, res.height);
+    const std::uint8_t* data =
+        levels_[level].data.data() + index * detail::compact_texel_bytes(format_);
+    switch (format_) {
+    case CompactTexelFormat::RGB8:
+        return detail::decode_compact_texel<CompactTexelFormat::RGB8>(data);
+    case CompactTexelFormat::RGB16:
+        return detail::decode_compact_texel<CompactTexelFormat::RGB16>(data);
+    case CompactTexelFormat::Half:
+    default:
+        return detail::decode_compact_texel<CompactTexelFormat::Half>(data);
+    }
+}
+
+/**
+ * @brief The finest level no larger than PREVIEW_SIZE on either axis.
+ * @return std::size_t The level index
+ */
+template <IsSpectral TSpectral>
+std::size_t CompactTexture<TSpectral>::preview_level() const noexcept
+{
+    std::size_t level = 0;
+    while (levels_[level].resolution.width > PREVIEW_SIZE ||
+           levels_[level].resolution.height > PREVIEW_SIZE) {
+        ++level;
+    }
+    return level;
+}
+
+/**
+ * @brief Decode a whole level to the spectral type.
+ * @param level Mip level
+ * @return Image<TSpectral> The level's texels
+ */
+template <IsSpectral TSpectral>
+Image<TSpectral> CompactTexture<TSpectral>::decode_level(std::size_t level) const
+{
+    const Resolution res = level_resolution(level);
+    Image<TSpectral> image(res.width, res.height);
+    for (int y = 0; y < res.height; ++y) {
+        for (int x = 0; x < res.width; ++x) {
+            image(x, y) = basis_(texel(level, x, y));
+        }
+    }
+    return image;
+}
+
+/**
+ * @brief Whether the texture is the one the constructor would make from the given arguments.
+ *
+ * Level 0 is compared texel by texel after encoding. The coarser levels are filtered from it, so
+ * they can differ at most by rounding and are not compared.
+ *
+ * @param linear_rgb Level 0, in linear RGB
+ * @param format Texel storage format
+ * @param basis Conversion applied to filtered lookups
+ * @return bool True if the texture holds linear_rgb in format, converted by basis
+ */
+template <IsSpectral TSpectral>
+bool CompactTexture<TSpectral>::holds(const Image<RGB>& linear_rgb,
+                                      CompactTexelFormat format,
+                                      const RGBSpectralBasis<TSpectral>& basis) const
+{
+    if (format != format_ || !(linear_rgb.resolution() == resolution())) {
+        return false;
+    }
+    for (const RGB& unit : {RGB{1, 0, 0}, RGB{0, 1, 0}, RGB{0, 0, 1}}) {
+        if (!(basis(unit) == basis_(unit))) {
+            return false;
+        }
+    }
+
+    const Level& level = levels_.front();
+    const std::size_t texel_bytes = detail::compact_texel_bytes(format_);
+    std::array<std::uint8_t, 6> encoded{};
+    for (int y = 0; y < linear_rgb.height(); ++y) {
+        for (int x = 0; x < linear_rgb.width(); ++x) {
+            detail::encode_compact_texel(format_, linear_rgb(x, y), encoded.data());
+            const std::size_t index =
+                detail::tiled_pixel_index(x, y, linear_rgb.width(), linear_rgb.height());
+            if (std::memcmp(encoded.data(), level.data.data() + index * texel_bytes, texel_bytes) !=
+                0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <IsSpectral TSpectral>
+template <CompactTexelFormat Format>
+RGB CompactTexture<TSpectral>::sample_bilinear_(const Level& level, float u, float v) const
+{
+    const Resolution& res = level.resolution;
+
+    u = std::fmod(u, 1.0f);
+    v = std::fmod(v, 1.0f);
+    u = u < 0.0f ? u + 1.0f : u;
+    v = v < 0.0f ? v + 1.0f : v;
+
+    float px = u * static_cast<float>(res.width - 1);
+    float py = v * static_cast<float>(res.height - 1);
+    auto x0 = static_cast<int>(px);
+    auto y0 = static_cast<int>(py);
+    int x1 = std::min(x0 + 1, res.width - 1);
+    int y1 = std::min(y0 + 1, res.height - 1);
+    float fx = px - static_cast<float>(x0);
+    float fy = py - static_cast<float>(y0);
+
+    constexpr std::size_t texel_bytes = Format == CompactTexelFormat::RGB8 ? 3 : 6;
+    auto texel = [&](int x, int y) {
+        const std::size_t index = detail::tiled_pixel_index(x, y, res.width, res.height);
+        return detail::decode_compact_texel<Format>(level.data.data() + index * texel_bytes);
+    };
+
+    RGB result = texel(x0, y0) * ((1.0f - fx) * (1.0f - fy));
+    result += texel(x1, y0) * (fx * (1.0f - fy));
+    result += texel(x0, y1) * ((1.0f - fx) * fy);
+    result += texel(x1, y1) * (fx * fy);
+    return result;
+}
+
+template <IsSpectral TSpectral>
+template <CompactTexelFormat Format>
+RGB CompactTexture<TSpectral>::sample_trilinear_(float u, float v, float lod) const
+{
+    if (!(lod > 0.f)) {
+        return sample_bilinear_<Format>(levels_.front(), u, v);
+    }
+
+    const std::size_t last = levels_.size() - 1;
+    if (lod >= static_cast<float>(last)) {
+        return sample_bilinear_<Format>(levels_.back(), u, v);
+    }
+
+    auto fine = static_cast<std::size_t>(lod);
+    float t = lod - static_cast<float>(fine);
+    return sample_bilinear_<Format>(levels_[fine], u, v) * (1.f - t) +
+           sample_bilinear_<Format>(levels_[fine + 1], u, v) * t;
+}
+
+template <IsSpectral TSpectral>
+template <CompactTexelFormat Format>
+TSpectral CompactTexture<TSpectral>::sample_(const Vec2<float>& uv,
+                                             const Vec2<float>& duvdx,
+                                             const Vec2<float>& duvdy) const
+{
+    const auto max_lod = static_cast<float>(levels_.size() - 1);
+    TextureFootprint footprint = texture_footprint(uv, duvdx, duvdy, texel_scale_, max_lod);
+    if (footprint.probes == 0) {
+        return basis_(sample_bilinear_<Format>(levels_.front(), uv.x, uv.y));
+    }
+    return basis_(filter_footprint<RGB>(footprint, [this](const Vec2<float>& p, float lod) {
+        return sample_trilinear_<Format>(p.x, p.y, lod);
+    }));
+}
+
+/**
+ * @brief Pick the smallest format that holds an image without visible loss.
+ *
+ * Images with values outside [0, 1] need Half; otherwise sources of more than 8 bits get RGB16,
+ * and 8-bit sources RGB8.
+ *
+ * @param linear_rgb The image, in linear RGB
+ * @param bit_depth Bits per channel of the source file
+ * @return CompactTexelFormat The format to store it in
+ */
+inline CompactTexelFormat compact_texel_format(const Image<RGB>& linear_rgb, int bit_depth)
+{
+    for (std::size_t i = 0; i < linear_rgb.size(); ++i) {
+        for (std::size_t c = 0; c < 3; ++c) {
+            if (!(linear_rgb[i][c] >= 0.f && linear_rgb[i][c] <= 1.f)) {
+                return CompactTexelFormat::Half;
+            }
+        }
+    }
+    return bit_depth > 8 ? CompactTexelFormat::RGB16 : CompactTexelFormat::RGB8;
+}
+} // namespace huira
@@ -75,6 +75,21 @@ Image<PixelT>::Image(int width, int height, const PixelT& fill_value)
 {
 }
 
+/**
+ * @brief Constructs an image with the specified resolution and storage layout.
+ *
+ * Pixels are default-initialized.
+ *
+ * @param resolution The width and height of the image
+ * @param layout The order in which pixels are stored
+ */
+template <IsImagePixel PixelT>
+Image<PixelT>::Image(Resolution resolution, ImageLayout layout)
+    : data_(static_cast<std::size_t>(resolution.x * resolution.y)), resolution_{resolution},
+      layout_{layout}
+{
+}
+
 /**
  * @brief Checks if the image has no pixels.
  *
@@ -141,6 +156,30 @@ std::size_t Image<PixelT>::size() const noexcept
     return data_.size();
 }
 
+/**
+ * @brief Reorders the pixels into a new storage layout.
+ *
+ * Pixel values at each (x, y) are unchanged; only linear indices move.
+ *
+ * @param layout The layout to store pixels in
+ */
+template <IsImagePixel PixelT>
+void Image<PixelT>::set_layout(ImageLayout layout)
+{
+    if (layout == layout_) {
+        return;
+    }
+
+    Image<PixelT> reordered(resolution_, layout);
+    for (int y = 0; y < resolution_.height; ++y) {
+        for (int x = 0; x < resolution_.width; ++x) {
+            reordered(x, y) = (*this)(x, y);
+        }
+    }
+    data_ = std::move(reordered.data_);
+    layout_ = layout;
+}
+
 /**
  * @brief Provides unchecked access to a pixel by linear index.
  *
@@ -537,9 +576,17 @@ Image<PixelT> Image<PixelT>::operator+(const Image<PixelT>& other) const
     if (this->resolution() != other.resolution()) {
         HUIRA_THROW_ERROR("Image::operator+ - Images with different resolutions cannot be added");
     }
-    Image<PixelT> output(this->resolution());
-    for (std::size_t i = 0; i < this->size(); ++i) {
-        output[i] = this->data_[i] + other[i];
+    Image<PixelT> output(this->resolution(), layout_);
+    if (other.layout() == layout_) {
+        for (std::size_t i = 0; i < this->size(); ++i) {
+            output[i] = this->data_[i] + other[i];
+        }
+    } else {
+        for (int y = 0; y < this->height(); ++y) {
+            for (int x = 0; x < this->width(); ++x) {
+                output(x, y) = (*this)(x, y) + other(x, y);
+            }
+        }
     }
     return output;
 }
@@ -551,7 +598,7 @@ Image<float> Image<PixelT>::get_channel(std::size_t channel) const
         HUIRA_THROW_ERROR("Image::get_channel - Channel index out of bounds");
     }
 
-    Image<float> output(this->resolution());
+    Image<float> output(this->resolution(), layout_);
     for (std::size_t i = 0; i < this->size(); ++i) {
         if constexpr (ImagePixelTraits<PixelT>::channels == 1) {
             output[i] = static_cast<float>(data_[i]);
@@ -572,12 +619,15 @@ Image<float> Image<PixelT>::get_channel(std::size_t channel) const
  *
  * @param x The x-coordinate (column)
  * @param y The y-coordinate (row)
- * @return The linear index in row-major order
+ * @return The linear index in the image's storage layout
  */
 template <IsImagePixel PixelT>
 std::size_t Image<PixelT>::to_linear(int x, int y) const noexcept
 {
-    return static_cast<std::size_t>(y * resolution_.width + x);
+    if (layout_ == ImageLayout::RowMajor) {
+        return static_cast<std::size_t>(y * resolution_.width + x);
+    }
+    return detail::tiled_pixel_index(x, y, resolution_.width, resolution_.height);
 }
 
 /**
@@ -621,7 +671,7 @@ void Image<PixelT>::convolve_direct_(const Image<PixelT>& kernel)
     const int kcx = kw / 2;
     const int kcy = kh / 2;
 
-    Image<PixelT> result(this->resolution());
+    Image<PixelT> result(this->resolution(), layout_);
 
     for (int y = 0; y < this->height(); ++y) {
         for (int x = 0; x < this->width(); ++x) {
@@ -702,7 +752,7 @@ void Image<PixelT>::convolve_fft_(const Image<PixelT>& kernel)
         }
     };
 
-    Image<PixelT> result(this->resolution());
+    Image<PixelT> result(this->resolution(), layout_);
 
     for (std::size_t c = 0; c < num_channels; ++c) {
         // Pack kernel channel into buf_b with wrap-around
@@ -311,9 +311,11 @@ inline void
 write_image_jpeg(const fs::path& filepath, const ImageBundle<float>& output_image, int quality)
 {
     Image<RGB> image_rgb(output_image.image.width(), output_image.image.height());
-    for (std::size_t i = 0; i < output_image.image.size(); ++i) {
-        float val = output_image.image[i];
-        image_rgb[i] = RGB{val, val, val};
+    for (int y = 0; y < output_image.image.height(); ++y) {
+        for (int x = 0; x < output_image.image.width(); ++x) {
+            float val = output_image.image(x, y);
+            image_rgb(x, y) = RGB{val, val, val};
+        }
     }
     ImageBundle<RGB> output_bundle(output_image, std::move(image_rgb));
     write_image_jpeg(filepath, output_bundle, quality);
@@ -306,6 +306,7 @@ inline ImageBundle<RGB> read_image_png(const unsigned char* data, std::size_t si
     ImageBundle<RGB> bundle{Image<RGB>(png_data.resolution)};
 
     read_color_space(png_data.color_info, bundle);
+    bundle.bit_depth = png_data.final_bit_depth;
 
     png_data.has_alpha = read_alpha && png_data.has_alpha;
     if (png_data.has_alpha) {
@@ -399,6 +400,7 @@ read_image_png_mono(const unsigned char* data, std::size_t size, bool read_alpha
     ImageBundle<float> bundle{Image<float>(png_data.resolution)};
 
     read_color_space(png_data.color_info, bundle);
+    bundle.bit_depth = png_data.final_bit_depth;
 
     png_data.has_alpha = read_alpha && png_data.has_alpha;
 
@@ -479,9 +481,11 @@ inline ImageBundle<float> read_image_png_mono(const fs::path& filepath, bool rea
 inline void write_image_png(const fs::path& filepath, const ImageBundle<float>& output_image)
 {
     Image<RGB> rgb_pixels(output_image.image.resolution());
-    for (std::size_t i = 0; i < output_image.image.size(); ++i) {
-        float val = output_image.image[i];
-        rgb_pixels[i] = RGB{val, val, val};
+    for (int y = 0; y < output_image.image.height(); ++y) {
+        for (int x = 0; x < output_image.image.width(); ++x) {
+            float val = output_image.image(x, y);
+            rgb_pixels(x, y) = RGB{val, val, val};
+        }
     }
     ImageBundle<RGB> output_image_rgb(output_image, std::move(rgb_pixels));
     write_image_png(filepath, output_image_rgb);
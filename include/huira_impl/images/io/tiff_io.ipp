@@ -40,6 +40,7 @@ struct TIFFData {
 
     std::vector<std::vector<float>> channels;
     std::size_t num_channels = 0;
+    int bit_depth = 8;
 
     uint16_t photometric = PHOTOMETRIC_MINISBLACK;
     bool has_alpha = false;
@@ -464,6 +465,7 @@ inline TIFFData read_tiff_raw_(const unsigned char* data, std::size_t size)
     tiff_data.num_channels = num_channels;
     tiff_data.photometric = photometric;
     tiff_data.has_alpha = has_alpha;
+    tiff_data.bit_depth = bits_per_sample;
     tiff_data.alpha_index = alpha_index;
 
     return tiff_data;
@@ -503,6 +505,7 @@ read_image_tiff_rgb(const unsigned char* data, std::size_t size, bool read_alpha
     bool extract_alpha = tiff_data.has_alpha && read_alpha;
 
     ImageBundle<RGB> bundle{Image<RGB>(tiff_data.resolution)};
+    bundle.bit_depth = std::min(tiff_data.bit_depth, 16); // Writers support 8 and 16 bits
 
     if (extract_alpha) {
         bundle.alpha = Image<float>(tiff_data.resolution, 1.0f);
@@ -584,6 +587,7 @@ read_image_tiff_mono(const unsigned char* data, std::size_t size, bool read_alph
     bool extract_alpha = tiff_data.has_alpha && read_alpha;
 
     ImageBundle<float> bundle{Image<float>(tiff_data.resolution)};
+    bundle.bit_depth = std::min(tiff_data.bit_depth, 16); // Writers support 8 and 16 bits
 
     if (extract_alpha) {
         bundle.alpha = Image<float>(tiff_data.resolution, 1.0f);
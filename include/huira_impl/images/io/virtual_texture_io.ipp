@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Compute the layout of a virtual texture.
+ * @param resolution Resolution of level 0
+ * @param channels Floats per texel
+ * @param tile_size Texels along each tile edge
+ */
+inline VirtualTextureLayout::VirtualTextureLayout(Resolution resolution,
+                                                  std::uint32_t channels,
+                                                  int tile_size)
+    : channels{channels}, tile_size{tile_size}
+{
+    if (resolution.width < 1 || resolution.height < 1) {
+        HUIRA_THROW_ERROR("VirtualTextureLayout - Resolution must be at least 1x1");
+    }
+    if (tile_size < 1 || channels < 1) {
+        HUIRA_THROW_ERROR("VirtualTextureLayout - Tile size and channel count must be positive");
+    }
+
+    std::uint64_t first_tile = 0;
+    int w = resolution.width;
+    int h = resolution.height;
+    while (true) {
+        level_resolutions.emplace_back(w, h);
+        level_first_tile.push_back(first_tile);
+        first_tile += static_cast<std::uint64_t>(tiles_x(levels() - 1)) *
+                      static_cast<std::uint64_t>(tiles_y(levels() - 1));
+        if (w == 1 && h == 1) {
+            break;
+        }
+        w = std::max(w / 2, 1);
+        h = std::max(h / 2, 1);
+    }
+}
+
+inline int VirtualTextureLayout::tiles_x(std::size_t level) const noexcept
+{
+    return (level_resolutions[level].width + tile_size - 1) / tile_size;
+}
+
+inline int VirtualTextureLayout::tiles_y(std::size_t level) const noexcept
+{
+    return (level_resolutions[level].height + tile_size - 1) / tile_size;
+}
+
+inline std::uint64_t VirtualTextureLayout::tile_bytes() const noexcept
+{
+    return static_cast<std::uint64_t>(tile_size) * static_cast<std::uint64_t>(tile_size) *
+           channels * sizeof(float);
+}
+
+/**
+ * @brief Byte offset of a tile from the start of the file.
+ * @param level Mip level
+ * @param tx Tile column
+ * @param ty Tile row
+ * @return std::uint64_t Offset in bytes
+ */
+inline std::uint64_t VirtualTextureLayout::tile_offset(std::size_t level,
+                                                       int tx,
+                                                       int ty) const noexcept
+{
+    const auto row = static_cast<std::uint64_t>(ty) * static_cast<std::uint64_t>(tiles_x(level));
+    std::uint64_t index = level_first_tile[level] + row + static_cast<std::uint64_t>(tx);
+    return sizeof(VirtualTextureHeader) + index * tile_bytes();
+}
+
+/**
+ * @brief Read and validate the header of a virtual texture file.
+ * @param filepath Path to the file
+ * @return VirtualTextureLayout The layout described by the header
+ */
+inline VirtualTextureLayout read_virtual_texture_layout(const fs::path& filepath)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if (!in) {
+        HUIRA_THROW_ERROR("read_virtual_texture_layout - Failed to open file: " +
+                          filepath.string());
+    }
+
+    VirtualTextureHeader header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, VirtualTextureLayout::MAGIC, sizeof(header.magic)) != 0) {
+        HUIRA_THROW_ERROR("read_virtual_texture_layout - Invalid file format: " +
+                          filepath.string());
+    }
+    if (header.version != VirtualTextureLayout::VERSION) {
+        HUIRA_THROW_ERROR("read_virtual_texture_layout - " + filepath.filename().string() +
+                          " has unsupported version " + std::to_string(header.version) +
+                          ". Please re-generate.");
+    }
+
+    VirtualTextureLayout layout(Resolution{header.width, header.height},
+                                header.channels,
+                                static_cast<int>(header.tile_size));
+    if (layout.levels() != header.level_count) {
+        HUIRA_THROW_ERROR("read_virtual_texture_layout - Level count does not match resolution: " +
+                          filepath.string());
+    }
+
+    const std::size_t last = layout.levels() - 1;
+    const std::uint64_t tile_count =
+        layout.level_first_tile.back() +
+        static_cast<std::uint64_t>(layout.tiles_x(last)) * layout.tiles_y(last);
+    const std::uint64_t expected = sizeof(VirtualTextureHeader) + tile_count * layout.tile_bytes();
+    if (fs::file_size(filepath) < expected) {
+        HUIRA_THROW_ERROR("read_virtual_texture_layout - File is truncated: " + filepath.string());
+    }
+    return layout;
+}
+
+namespace detail {
+/**
+ * @brief Writes a virtual texture from the rows of level 0, building the lower levels as it goes.
+ *
+ * Each level keeps only the tile row it is filling and the partial sums of the next level's
+ * current row, so memory stays proportional to the width of level 0 times the tile size. Every
+ * finished tile row is written at its offset, and every finished row of a level is box filtered
+ * into the next exactly as MipPyramid does it, summing texels in the same order so the result is
+ * identical.
+ */
+template <IsImagePixel PixelT>
+class VirtualTextureWriter {
+  public:
+    VirtualTextureWriter(const fs::path& filepath, const VirtualTextureLayout& layout)
+        : filepath_{filepath}, layout_{layout}, out_{filepath, std::ios::binary}
+    {
+        if (!out_) {
+            HUIRA_THROW_ERROR("write_virtual_texture - Failed to open file for writing: " +
+                              filepath.string());
+        }
+
+        VirtualTextureHeader header{};
+        std::memcpy(header.magic, VirtualTextureLayout::MAGIC, sizeof(header.magic));
+        header.version = VirtualTextureLayout::VERSION;
+        header.channels = layout_.channels;
+        header.width = layout_.level_resolutions[0].width;
+        header.height = layout_.level_resolutions[0].height;
+        header.tile_size = static_cast<std::uint32_t>(layout_.tile_size);
+        header.level_count = static_cast<std::uint32_t>(layout_.levels());
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const auto tile_size = static_cast<std::size_t>(layout_.tile_size);
+        levels_.resize(layout_.levels());
+        for (std::size_t level = 0; level < levels_.size(); ++level) {
+            const auto width = static_cast<std::size_t>(layout_.level_resolutions[level].width);
+            levels_[level].band.resize(tile_size * width);
+            if (level + 1 < levels_.size()) {
+                levels_[level].sums.resize(
+                    static_cast<std::size_t>(layout_.level_resolutions[level + 1].width));
+            }
+        }
+        tiles_.resize(static_cast<std::size_t>(layout_.tiles_x(0)) * tile_size * tile_size);
+    }
+
+    void push_row(std::size_t level, std::span<const PixelT> row);
+
+    void finish()
+    {
+        out_.flush();
+        if (!out_) {
+            HUIRA_THROW_ERROR("write_virtual_texture - Failed to write: " + filepath_.string());
+        }
+    }
+
+  private:
+    struct LevelState {
+        std::vector<PixelT> band; // The tile row being filled
+        std::vector<PixelT> sums; // Partial sums of the next level's current row
+        int rows = 0;             // Rows received so far
+        int next_row = 0;         // Row of the next level being summed
+    };
+
+    fs::path filepath_;
+    const VirtualTextureLayout& layout_;
+    std::ofstream out_;
+    std::vector<LevelState> levels_;
+    std::vector<PixelT> tiles_;
+
+    void write_tile_row_(std::size_t level, int ty, int filled_rows);
+
+    static std::pair<int, int> span_(int d, int s, int dn)
+    {
+        auto begin = static_cast<std::int64_t>(d) * s / dn;
+        auto end = static_cast<std::int64_t>(d + 1) * s / dn;
+        return {static_cast<int>(begin), static_cast<int>(end)};
+    }
+};
+
+template <IsImagePixel PixelT>
+void VirtualTextureWriter<PixelT>::push_row(std::size_t level, std::span<const PixelT> row)
+{
+    LevelState& state = levels_[level];
+    const Resolution resolution = layout_.level_resolutions[level];
+    const int tile_size = layout_.tile_size;
+    const int y = state.rows++;
+
+    std::copy(row.begin(),
+              row.end(),
+              state.band.begin() + static_cast<std::ptrdiff_t>(y % tile_size) * resolution.width);
+    if ((y + 1) % tile_size == 0 || y + 1 == resolution.height) {
+        write_tile_row_(level, y / tile_size, y % tile_size + 1);
+    }
+
+    if (level + 1 == levels_.size()) {
+        return;
+    }
+
+    // Add the row to the next level's row whose span covers it:
+    const Resolution next = layout_.level_resolutions[level + 1];
+    auto [y0, y1] = span_(state.next_row, resolution.height, next.height);
+    for (int x = 0; x < next.width; ++x) {
+        auto [x0, x1] = span_(x, resolution.width, next.width);
+        PixelT& sum = state.sums[static_cast<std::size_t>(x)];
+        int sx = x0;
+        if (y == y0) {
+            sum = row[static_cast<std::size_t>(sx++)];
+        }
+        for (; sx < x1; ++sx) {
+            sum += row[static_cast<std::size_t>(sx)];
+        }
+    }
+
+    if (y + 1 == y1) {
+        for (int x = 0; x < next.width; ++x) {
+            auto [x0, x1] = span_(x, resolution.width, next.width);
+            float weight = 1.f / static_cast<float>((x1 - x0) * (y1 - y0));
+            PixelT& sum = state.sums[static_cast<std::size_t>(x)];
+            sum = sum * weight;
+        }
+        ++state.next_row;
+        push_row(level + 1, state.sums);
+    }
+}
+
+template <IsImagePixel PixelT>
+void VirtualTextureWriter<PixelT>::write_tile_row_(std::size_t level, int ty, int filled_rows)
+{
+    const LevelState& state = levels_[level];
+    const int width = layout_.level_resolutions[level].width;
+    const int tile_size = layout_.tile_size;
+    const int tiles_x = layout_.tiles_x(level);
+    const std::size_t tile_texels =
+        static_cast<std::size_t>(tile_size) * static_cast<std::size_t>(tile_size);
+
+    // Cut the band into tiles, repeating the edge texels where the tiles overhang the level:
+    auto cut_tiles = [&](const tbb::blocked_range<int>& range) {
+        for (int tx = range.begin(); tx < range.end(); ++tx) {
+            PixelT* tile = tiles_.data() + static_cast<std::size_t>(tx) * tile_texels;
+            for (int y = 0; y < tile_size; ++y) {
+                const PixelT* band_row = state.band.data() +
+                                         static_cast<std::size_t>(std::min(y, filled_rows - 1)) *
+                                             static_cast<std::size_t>(width);
+                for (int x = 0; x < tile_size; ++x) {
+                    tile[y * tile_size + x] = band_row[std::min(tx * tile_size + x, width - 1)];
+                }
+            }
+        }
+    };
+    tbb::parallel_for(tbb::blocked_range<int>(0, tiles_x), cut_tiles);
+
+    out_.seekp(static_cast<std::streamoff>(layout_.tile_offset(level, 0, ty)));
+    out_.write(reinterpret_cast<const char*>(tiles_.data()),
+               static_cast<std::streamsize>(static_cast<std::size_t>(tiles_x) * tile_texels *
+                                            sizeof(PixelT)));
+}
+} // namespace detail
+
+/**
+ * @brief Write a virtual texture from rows of level 0 supplied one at a time.
+ *
+ * This is the writer for textures larger than memory: the source is read row by row, top to
+ * bottom, and each level of the pyramid is filtered and written as its rows complete, so only a
+ * tile row per level is ever resident.
+ *
+ * @tparam PixelT The stored pixel type, which must be given explicitly
+ * @param filepath Path to write
+ * @param resolution Resolution of level 0
+ * @param read_row Called as read_row(y, row) to fill the resolution.width texels of row y
+ * @param tile_size Texels along each tile edge
+ */
+template <IsImagePixel PixelT, typename RowReader>
+    requires std::is_invocable_v<RowReader&, int, std::span<PixelT>>
+void write_virtual_texture(const fs::path& filepath,
+                           Resolution resolution,
+                           RowReader&& read_row,
+                           int tile_size)
+{
+    static_assert(std::is_trivially_copyable_v<PixelT>,
+                  "write_virtual_texture - Pixel type must be trivially copyable");
+    static_assert(sizeof(PixelT) % sizeof(float) == 0 &&
+                      std::is_same_v<typename ImagePixelTraits<PixelT>::Scalar, float>,
+                  "write_virtual_texture - Pixel type must be made of floats");
+
+    const auto channels = static_cast<std::uint32_t>(sizeof(PixelT) / sizeof(float));
+    VirtualTextureLayout layout(resolution, channels, tile_size);
+    detail::VirtualTextureWriter<PixelT> writer(filepath, layout);
+
+    std::vector<PixelT> row(static_cast<std::size_t>(resolution.width));
+    for (int y = 0; y < resolution.height; ++y) {
+        read_row(y, std::span<PixelT>(row));
+        writer.push_row(0, row);
+    }
+    writer.finish();
+
+    HUIRA_LOG_INFO("write_virtual_texture - Wrote " + std::to_string(layout.levels()) +
+                   " levels of " + std::to_string(tile_size) + "x" + std::to_string(tile_size) +
+                   " tiles to: " + filepath.string());
+}
+
+/**
+ * @brief Write an image as a virtual texture file, converting texels as they are written.
+ *
+ * Each row is converted as it is read, so e.g. an RGB mosaic can be turned into a spectral
+ * virtual texture while only the RGB image is resident. Conversion is assumed to be linear, so
+ * that filtering before or after it is equivalent.
+ *
+ * @tparam PixelT The stored pixel type, which must be given explicitly
+ * @param filepath Path to write
+ * @param image Level 0 of the texture
+ * @param conversion Converts a source texel to the stored pixel type
+ * @param tile_size Texels along each tile edge
+ */
+template <IsImagePixel PixelT, IsImagePixel SourceT, typename Conversion>
+    requires std::is_invocable_r_v<PixelT, Conversion&, const SourceT&>
+void write_virtual_texture(const fs::path& filepath,
+                           const Image<SourceT>& image,
+                           Conversion&& conversion,
+                           int tile_size)
+{
+    if (image.empty()) {
+        HUIRA_THROW_ERROR("write_virtual_texture - Image is empty");
+    }
+    write_virtual_texture<PixelT>(
+        filepath,
+        image.resolution(),
+        [&](int y, std::span<PixelT> row) {
+            for (int x = 0; x < image.width(); ++x) {
+                row[static_cast<std::size_t>(x)] = conversion(image(x, y));
+            }
+        },
+        tile_size);
+}
+
+/**
+ * @brief Write an image as a virtual texture file.
+ * @param filepath Path to write
+ * @param image Level 0 of the texture
+ * @param tile_size Texels along each tile edge
+ */
+template <IsImagePixel PixelT>
+void write_virtual_texture(const fs::path& filepath, const Image<PixelT>& image, int tile_size)
+{
+    write_virtual_texture<PixelT>(
+        filepath, image, [](const PixelT& texel) { return texel; }, tile_size);
+}
+} // namespace huira
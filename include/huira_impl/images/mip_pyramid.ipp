@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace huira {
+/**
+ * @brief Build the pyramid for an image.
+ * @param base The full resolution image (level 0)
+ */
+template <IsImagePixel PixelT>
+MipPyramid<PixelT>::MipPyramid(std::shared_ptr<const Image<PixelT>> base) : base_{std::move(base)}
+{
+    if (!base_ || base_->empty()) {
+        HUIRA_THROW_ERROR("MipPyramid::MipPyramid - Base image must not be empty");
+    }
+
+    texel_scale_ = Vec2<float>{static_cast<float>(std::max(base_->width() - 1, 1)),
+                               static_cast<float>(std::max(base_->height() - 1, 1))};
+
+    const Image<PixelT>* previous = base_.get();
+    while (previous->width() > 1 || previous->height() > 1) {
+        levels_.push_back(downsample_(*previous));
+        previous = &levels_.back();
+    }
+}
+
+/**
+ * @brief Get a level of the pyramid.
+ * @param index Level index, 0 being the base image
+ * @return const Image<PixelT>& The image at that level
+ */
+template <IsImagePixel PixelT>
+const Image<PixelT>& MipPyramid<PixelT>::level(std::size_t index) const
+{
+    if (index >= levels()) {
+        HUIRA_THROW_ERROR("MipPyramid::level - Level " + std::to_string(index) +
+                          " is out of range");
+    }
+    return index == 0 ? *base_ : levels_[index - 1];
+}
+
+/**
+ * @brief Sample at a fractional level, blending bilinear lookups from the two nearest levels.
+ * @param u The horizontal texture coordinate
+ * @param v The vertical texture coordinate
+ * @param lod Level of detail, log2 of the footprint width in base level texels
+ * @return PixelT The filtered value
+ */
+template <IsImagePixel PixelT>
+template <WrapMode W>
+PixelT MipPyramid<PixelT>::sample_trilinear(float u, float v, float lod) const
+{
+    if (!(lod > 0.f)) {
+        return base_->template sample_bilinear<W>(u, v);
+    }
+
+    const float max_lod = static_cast<float>(levels() - 1);
+    if (lod >= max_lod) {
+        return level(levels() - 1).template sample_bilinear<W>(u, v);
+    }
+
+    auto fine = static_cast<std::size_t>(lod);
+    float t = lod - static_cast<float>(fine);
+    PixelT a = level(fine).template sample_bilinear<W>(u, v);
+    PixelT b = level(fine + 1).template sample_bilinear<W>(u, v);
+    return a * (1.f - t) + b * t;
+}
+
+/**
+ * @brief Sample with the footprint given by the screen-space uv derivatives.
+ *
+ * See texture_footprint() for how the footprint maps to levels and probes. A zero footprint (no
+ * ray differentials available) samples the base level.
+ *
+ * @param uv Texture coordinates
+ * @param duvdx Change in uv across one pixel in x
+ * @param duvdy Change in uv across one pixel in y
+ * @return PixelT The filtered value
+ */
+template <IsImagePixel PixelT>
+PixelT MipPyramid<PixelT>::sample(const Vec2<float>& uv,
+                                  const Vec2<float>& duvdx,
+                                  const Vec2<float>& duvdy) const
+{
+    const auto max_lod = static_cast<float>(levels_.size());
+    TextureFootprint footprint = texture_footprint(uv, duvdx, duvdy, texel_scale_, max_lod);
+    if (footprint.probes == 0) {
+        return base_->sample_bilinear(uv.x, uv.y);
+    }
+    return filter_footprint<PixelT>(footprint, [this](const Vec2<float>& p, float lod) {
+        return sample_trilinear(p.x, p.y, lod);
+    });
+}
+
+/**
+ * @brief Box filter an image down to half its resolution.
+ *
+ * Odd sizes round down; each destination texel then averages the 2 or 3 source texels its span
+ * covers along that axis, so no source row or column is dropped.
+ *
+ * @param src The image to reduce
+ * @return Image<PixelT> The reduced image
+ */
+template <IsImagePixel PixelT>
+Image<PixelT> MipPyramid<PixelT>::downsample_(const Image<PixelT>& src)
+{
+    const int sw = src.width();
+    const int sh = src.height();
+    const int dw = std::max(sw / 2, 1);
+    const int dh = std::max(sh / 2, 1);
+    Image<PixelT> dst(Resolution{dw, dh}, src.layout());
+
+    auto span = [](int d, int s, int dn) {
+        auto begin = static_cast<std::int64_t>(d) * s / dn;
+        auto end = static_cast<std::int64_t>(d + 1) * s / dn;
+        return std::pair<int, int>{static_cast<int>(begin), static_cast<int>(end)};
+    };
+
+    tbb::parallel_for(tbb::blocked_range<int>(0, dh), [&](const tbb::blocked_range<int>& rows) {
+        for (int y = rows.begin(); y < rows.end(); ++y) {
+            auto [y0, y1] = span(y, sh, dh);
+            for (int x = 0; x < dw; ++x) {
+                auto [x0, x1] = span(x, sw, dw);
+                PixelT sum = src(x0, y0);
+                for (int sy = y0; sy < y1; ++sy) {
+                    for (int sx = (sy == y0 ? x0 + 1 : x0); sx < x1; ++sx) {
+                        sum += src(sx, sy);
+                    }
+                }
+                float weight = 1.f / static_cast<float>((x1 - x0) * (y1 - y0));
+                dst(x, y) = sum * weight;
+            }
+        }
+    });
+    return dst;
+}
+} // namespace huira
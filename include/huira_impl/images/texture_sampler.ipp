@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cmath>
+
+namespace huira {
+/**
+ * @brief Reduce a pixel footprint to a level of detail and a set of probes along its major axis.
+ *
+ * The level is chosen from the minor axis of the footprint, and up to MAX_ANISOTROPY probes are
+ * spread along the major axis, so surfaces seen at grazing angles stay sharp across the footprint
+ * instead of blurring to the level of its longest side. Beyond the anisotropy limit the minor axis
+ * is widened rather than taking more probes.
+ *
+ * @param uv Texture coordinates at the footprint centre
+ * @param duvdx Change in uv across one pixel in x
+ * @param duvdy Change in uv across one pixel in y
+ * @param texel_scale Size of the base level in texels, as used by Image::sample_bilinear
+ * @param max_lod Index of the coarsest level (0 disables filtering)
+ * @return TextureFootprint The probes, with probes == 0 for a zero or invalid footprint
+ */
+inline TextureFootprint texture_footprint(const Vec2<float>& uv,
+                                          const Vec2<float>& duvdx,
+                                          const Vec2<float>& duvdy,
+                                          const Vec2<float>& texel_scale,
+                                          float max_lod)
+{
+    TextureFootprint footprint;
+
+    // Footprint axes in base level texels:
+    Vec2<float> ax = duvdx * texel_scale;
+    Vec2<float> ay = duvdy * texel_scale;
+    float len_x = std::sqrt(ax.x * ax.x + ax.y * ax.y);
+    float len_y = std::sqrt(ay.x * ay.x + ay.y * ay.y);
+
+    const bool x_major = len_x >= len_y;
+    const Vec2<float>& major_axis = x_major ? duvdx : duvdy;
+    float major = x_major ? len_x : len_y;
+    float minor = x_major ? len_y : len_x;
+    if (!(major > 0.f) || !std::isfinite(major) || !(max_lod > 0.f)) {
+        return footprint;
+    }
+
+    constexpr int max_anisotropy = TextureSampler<float>::MAX_ANISOTROPY;
+    minor = std::max(minor, major / static_cast<float>(max_anisotropy));
+    footprint.lod = std::log2(minor);
+
+    footprint.probes =
+        std::clamp(static_cast<int>(std::ceil(major / minor - 0.01f)), 1, max_anisotropy);
+    footprint.step = major_axis * (1.f / static_cast<float>(footprint.probes));
+    footprint.start = footprint.probes == 1 ? uv : uv - 0.5f * major_axis + 0.5f * footprint.step;
+    return footprint;
+}
+
+/**
+ * @brief Average trilinear lookups over the probes of a footprint.
+ * @param footprint Probes from texture_footprint(), with probes > 0
+ * @param trilinear Callable (Vec2<float> uv, float lod) -> PixelT
+ * @return PixelT The filtered value
+ */
+template <IsImagePixel PixelT, typename TTrilinear>
+PixelT filter_footprint(const TextureFootprint& footprint, const TTrilinear& trilinear)
+{
+    Vec2<float> p = footprint.start;
+    PixelT result = trilinear(p, footprint.lod);
+    if (footprint.probes == 1) {
+        return result;
+    }
+    for (int i = 1; i < footprint.probes; ++i) {
+        p += footprint.step;
+        result += trilinear(p, footprint.lod);
+    }
+    return result * (1.f / static_cast<float>(footprint.probes));
+}
+} // namespace huira
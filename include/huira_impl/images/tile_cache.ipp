@@ -0,0 +1,181 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace huira {
+/**
+ * @brief Hash a tile key.
+ * @param key The key to hash
+ * @return std::size_t Hash value
+ */
+inline std::size_t TileKeyHash::operator()(const TileKey& key) const noexcept
+{
+    // splitmix64 finalizer over the packed fields:
+    std::uint64_t h = key.source * 0x9E3779B97F4A7C15ull;
+    h ^= (static_cast<std::uint64_t>(key.level) << 48) ^
+         (static_cast<std::uint64_t>(key.y) << 24) ^ static_cast<std::uint64_t>(key.x);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return static_cast<std::size_t>(h);
+}
+
+/**
+ * @brief Construct a tile cache.
+ * @param budget_bytes Maximum total size of resident tiles
+ */
+inline TileCache::TileCache(std::size_t budget_bytes) : budget_{budget_bytes} {}
+
+/**
+ * @brief Look up a tile, loading it on a miss.
+ *
+ * A hit marks the tile as most recently used. On a miss, load() is called without holding any
+ * lock, the tile is inserted, and least recently used tiles are evicted until the shard is back
+ * within its share of the budget.
+ *
+ * @param key The tile to look up
+ * @param bytes Size of the tile, charged against the budget
+ * @param load Callable returning a TilePtr with the tile's contents
+ * @return TilePtr The tile
+ */
+template <typename TLoader>
+TileCache::TilePtr TileCache::get_or_load(const TileKey& key, std::size_t bytes, TLoader&& load)
+{
+    Shard& shard = shard_(key);
+    {
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second->tile;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    TilePtr tile = std::forward<TLoader>(load)();
+
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        // Another thread loaded the same tile in the meantime:
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->tile;
+    }
+    shard.lru.push_front(Entry{key, tile, bytes});
+    shard.index.emplace(key, shard.lru.begin());
+    shard.bytes += bytes;
+    evict_(shard);
+    return tile;
+}
+
+/**
+ * @brief Change the memory budget, evicting tiles if the cache is now over it.
+ * @param budget_bytes Maximum total size of resident tiles
+ */
+inline void TileCache::set_budget(std::size_t budget_bytes)
+{
+    budget_.store(budget_bytes);
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        evict_(shard);
+    }
+}
+
+/**
+ * @brief Get the total size of the resident tiles.
+ * @return std::size_t Size in bytes
+ */
+inline std::size_t TileCache::resident_bytes() const
+{
+    std::size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+/**
+ * @brief Drop every resident tile.
+ */
+inline void TileCache::clear()
+{
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        shard.lru.clear();
+        shard.index.clear();
+        shard.bytes = 0;
+    }
+}
+
+/**
+ * @brief Drop every resident tile of one texture, e.g. when it is destroyed.
+ * @param source The texture identifier
+ */
+inline void TileCache::evict_source(std::uint64_t source)
+{
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+            if (it->key.source == source) {
+                shard.bytes -= it->bytes;
+                shard.index.erase(it->key);
+                it = shard.lru.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Get a process-wide unique identifier for a new tile source.
+ * @return std::uint64_t The identifier
+ */
+inline std::uint64_t TileCache::new_source_id() noexcept
+{
+    static std::atomic<std::uint64_t> next_id{1};
+    return next_id.fetch_add(1);
+}
+
+inline TileCache::Shard& TileCache::shard_(const TileKey& key) noexcept
+{
+    // Use the high bits, so the shard choice is independent of the bucket choice within a shard:
+    return shards_[(TileKeyHash{}(key) >> 56) % SHARD_COUNT];
+}
+
+/**
+ * @brief Evict least recently used tiles until the shard fits its share of the budget.
+ *
+ * The most recently used tile is always kept, so a budget smaller than one tile per shard still
+ * makes progress. Must be called with the shard's lock held.
+ *
+ * @param shard The shard to trim
+ */
+inline void TileCache::evict_(Shard& shard)
+{
+    const std::size_t shard_budget = budget_.load() / SHARD_COUNT;
+    while (shard.bytes > shard_budget && shard.lru.size() > 1) {
+        const Entry& victim = shard.lru.back();
+        shard.bytes -= victim.bytes;
+        shard.index.erase(victim.key);
+        shard.lru.pop_back();
+    }
+}
+
+/**
+ * @brief Get the cache shared by virtual textures that are not given one explicitly.
+ * @return std::shared_ptr<TileCache> The shared cache, with TileCache::DEFAULT_BUDGET
+ */
+inline std::shared_ptr<TileCache> default_tile_cache()
+{
+    static std::shared_ptr<TileCache> cache = std::make_shared<TileCache>();
+    return cache;
+}
+} // namespace huira
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "huira/util/logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Open a virtual texture file.
+ * @param filepath Path to a file written by write_virtual_texture()
+ * @param cache Tile cache to page through (default_tile_cache() if null)
+ */
+template <IsImagePixel PixelT>
+VirtualTexture<PixelT>::VirtualTexture(const fs::path& filepath, std::shared_ptr<TileCache> cache)
+    : filepath_{filepath}, layout_{read_virtual_texture_layout(filepath)},
+      cache_{cache ? std::move(cache) : default_tile_cache()},
+      source_id_{TileCache::new_source_id()}
+{
+    static_assert(std::is_trivially_copyable_v<PixelT>,
+                  "VirtualTexture - Pixel type must be trivially copyable");
+
+    if (layout_.channels * sizeof(float) != sizeof(PixelT)) {
+        HUIRA_THROW_ERROR("VirtualTexture::VirtualTexture - " + filepath.filename().string() +
+                          " stores " + std::to_string(layout_.channels) +
+                          " channels, which does not match the requested pixel type");
+    }
+
+    file_.open(filepath, std::ios::binary);
+    if (!file_) {
+        HUIRA_THROW_ERROR("VirtualTexture::VirtualTexture - Failed to open file: " +
+                          filepath.string());
+    }
+
+    const Resolution& base = layout_.level_resolutions[0];
+    texel_scale_ = Vec2<float>{static_cast<float>(std::max(base.width - 1, 1)),
+                               static_cast<float>(std::max(base.height - 1, 1))};
+
+    HUIRA_LOG_INFO("VirtualTexture - Opened " + filepath.filename().string() + " (" +
+                   std::to_string(base.width) + "x" + std::to_string(base.height) + ", " +
+                   std::to_string(layout_.levels()) + " levels)");
+}
+
+/**
+ * @brief Release this texture's tiles from the cache.
+ */
+template <IsImagePixel PixelT>
+VirtualTexture<PixelT>::~VirtualTexture()
+{
+    cache_->evict_source(source_id_);
+}
+
+/**
+ * @brief Sample with the footprint given by the screen-space uv derivatives.
+ * @param uv Texture coordinates
+ * @param duvdx Change in uv across one pixel in x
+ * @param duvdy Change in uv across one pixel in y
+ * @return PixelT The filtered value
+ */
+template <IsImagePixel PixelT>
+PixelT VirtualTexture<PixelT>::sample(const Vec2<float>& uv,
+                                      const Vec2<float>& duvdx,
+                                      const Vec2<float>& duvdy) const
+{
+    const auto max_lod = static_cast<float>(layout_.levels() - 1);
+    TextureFootprint footprint = texture_footprint(uv, duvdx, duvdy, texel_scale_, max_lod);
+    if (footprint.probes == 0) {
+        return sample_bilinear(0, uv.x, uv.y);
+    }
+    return filter_footprint<PixelT>(footprint, [this](const Vec2<float>& p, float lod) {
+        return sample_trilinear(p.x, p.y, lod);
+    });
+}
+
+/**
+ * @brief Sample one level bilinearly, with the same texel mapping as Image::sample_bilinear.
+ * @param level Mip level
+ * @param u The horizontal texture coordinate (repeating)
+ * @param v The vertical texture coordinate (repeating)
+ * @return PixelT The interpolated value
+ */
+template <IsImagePixel PixelT>
+PixelT VirtualTexture<PixelT>::sample_bilinear(std::size_t level, float u, float v) const
+{
+    const Resolution& res = layout_.level_resolutions[level];
+    const int ts = layout_.tile_size;
+
+    u = std::fmod(u, 1.0f);
+    v = std::fmod(v, 1.0f);
+    u = u < 0.0f ? u + 1.0f : u;
+    v = v < 0.0f ? v + 1.0f : v;
+
+    float px = u * static_cast<float>(res.width - 1);
+    float py = v * static_cast<float>(res.height - 1);
+    auto x0 = static_cast<int>(px);
+    auto y0 = static_cast<int>(py);
+    int x1 = std::min(x0 + 1, res.width - 1);
+    int y1 = std::min(y0 + 1, res.height - 1);
+    float fx = px - static_cast<float>(x0);
+    float fy = py - static_cast<float>(y0);
+
+    // The four texels usually share a tile, so only look it up again when crossing a tile edge:
+    std::shared_ptr<const Tile> tile;
+    int tile_x = -1;
+    int tile_y = -1;
+    auto texel = [&](int x, int y) -> const PixelT& {
+        if (x / ts != tile_x || y / ts != tile_y) {
+            tile_x = x / ts;
+            tile_y = y / ts;
+            tile = tile_(level, tile_x, tile_y);
+        }
+        return tile->texels[static_cast<std::size_t>((y % ts) * ts + (x % ts))];
+    };
+
+    PixelT result = texel(x0, y0) * ((1.0f - fx) * (1.0f - fy));
+    result += texel(x1, y0) * (fx * (1.0f - fy));
+    result += texel(x0, y1) * ((1.0f - fx) * fy);
+    result += texel(x1, y1) * (fx * fy);
+    return result;
+}
+
+/**
+ * @brief Sample at a fractional level, blending bilinear lookups from the two nearest levels.
+ * @param u The horizontal texture coordinate
+ * @param v The vertical texture coordinate
+ * @param lod Level of detail, log2 of the footprint width in base level texels
+ * @return PixelT The filtered value
+ */
+template <IsImagePixel PixelT>
+PixelT VirtualTexture<PixelT>::sample_trilinear(float u, float v, float lod) const
+{
+    if (!(lod > 0.f)) {
+        return sample_bilinear(0, u, v);
+    }
+
+    const std::size_t last = layout_.levels() - 1;
+    if (lod >= static_cast<float>(last)) {
+        return sample_bilinear(last, u, v);
+    }
+
+    auto fine = static_cast<std::size_t>(lod);
+    float t = lod - static_cast<float>(fine);
+    return sample_bilinear(fine, u, v) * (1.f - t) + sample_bilinear(fine + 1, u, v) * t;
+}
+
+/**
+ * @brief Get the resolution of a level.
+ * @param level Mip level
+ * @return Resolution The level's resolution
+ */
+template <IsImagePixel PixelT>
+Resolution VirtualTexture<PixelT>::level_resolution(std::size_t level) const
+{
+    if (level >= layout_.levels()) {
+        HUIRA_THROW_ERROR("VirtualTexture::level_resolution - Level " + std::to_string(level) +
+                          " is out of range");
+    }
+    return layout_.level_resolutions[level];
+}
+
+/**
+ * @brief The finest level that fits in a single tile, a cheap stand-in for the whole texture.
+ * @return std::size_t The level index
+ */
+template <IsImagePixel PixelT>
+std::size_t VirtualTexture<PixelT>::preview_level() const noexcept
+{
+    std::size_t level = 0;
+    while (layout_.tiles_x(level) > 1 || layout_.tiles_y(level) > 1) {
+        ++level;
+    }
+    return level;
+}
+
+/**
+ * @brief Read a whole level into memory, bypassing the cache.
+ * @param level Mip level
+ * @return Image<PixelT> The level's texels
+ */
+template <IsImagePixel PixelT>
+Image<PixelT> VirtualTexture<PixelT>::read_level(std::size_t level) const
+{
+    const Resolution res = level_resolution(level);
+    const int ts = layout_.tile_size;
+    Image<PixelT> image(res.width, res.height);
+    for (int ty = 0; ty < layout_.tiles_y(level); ++ty) {
+        for (int tx = 0; tx < layout_.tiles_x(level); ++tx) {
+            std::shared_ptr<const Tile> tile = load_tile_(level, tx, ty);
+            const int w = std::min(ts, res.width - tx * ts);
+            const int h = std::min(ts, res.height - ty * ts);
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    image(tx * ts + x, ty * ts + y) =
+                        tile->texels[static_cast<std::size_t>(y * ts + x)];
+                }
+            }
+        }
+    }
+    return image;
+}
+
+template <IsImagePixel PixelT>
+std::shared_ptr<const typename VirtualTexture<PixelT>::Tile>
+VirtualTexture<PixelT>::tile_(std::size_t level, int tx, int ty) const
+{
+    TileKey key{source_id_,
+                static_cast<std::uint32_t>(level),
+                static_cast<std::uint32_t>(tx),
+                static_cast<std::uint32_t>(ty)};
+    TileCache::TilePtr tile = cache_->get_or_load(
+        key, layout_.tile_bytes(), [&] { return TileCache::TilePtr(load_tile_(level, tx, ty)); });
+    return std::static_pointer_cast<const Tile>(tile);
+}
+
+/**
+ * @brief Read one tile from the file.
+ * @param level Mip level
+ * @param tx Tile column
+ * @param ty Tile row
+ * @return std::shared_ptr<const Tile> The tile's texels
+ */
+template <IsImagePixel PixelT>
+std::shared_ptr<const typename VirtualTexture<PixelT>::Tile>
+VirtualTexture<PixelT>::load_tile_(std::size_t level, int tx, int ty) const
+{
+    auto tile = std::make_shared<Tile>();
+    tile->texels.resize(static_cast<std::size_t>(layout_.tile_size) *
+                        static_cast<std::size_t>(layout_.tile_size));
+
+    std::lock_guard lock(file_mutex_);
+    file_.seekg(static_cast<std::streamoff>(layout_.tile_offset(level, tx, ty)));
+    file_.read(reinterpret_cast<char*>(tile->texels.data()),
+               static_cast<std::streamsize>(layout_.tile_bytes()));
+    if (!file_) {
+        file_.clear();
+        HUIRA_THROW_ERROR("VirtualTexture::load_tile_ - Failed to read tile (" +
+                          std::to_string(tx) + ", " + std::to_string(ty) + ") of level " +
+                          std::to_string(level) + " from: " + filepath_.string());
+    }
+    return tile;
+}
+} // namespace huira
@@ -1,11 +1,34 @@
 #include <algorithm>
 #include <cmath>
+#include <string>
 
 #include "huira/core/constants.hpp"
 #include "huira/materials/sampling_utils.hpp"
+#include "huira/util/logger.hpp"
 
 namespace huira {
 
+/**
+ * @brief Construct a Hapke BSDF.
+ * @param h Opposition effect width
+ * @param B0 Opposition effect amplitude
+ * @param b DHG phase function asymmetry
+ * @param c DHG phase function forward/backward fraction
+ * @param evaluation Whether to evaluate the phase-angle terms exactly or from a table
+ */
+template <IsSpectral TSpectral>
+HapkeBSDF<TSpectral>::HapkeBSDF(
+    float h, float B0, float b, float c, PhotometricEvaluation evaluation)
+    : h_(h), B0_(B0), b_(b), c_(c), evaluation_(evaluation)
+{
+    if (evaluation_ == PhotometricEvaluation::Tabulated) {
+        phase_table_ =
+            PhaseAngleTable([this](float cos_alpha) { return single_scattering_term(cos_alpha); });
+        HUIRA_LOG_INFO("HapkeBSDF - Tabulated phase terms, max relative error " +
+                       std::to_string(phase_table_.max_relative_error()));
+    }
+}
+
 template <IsSpectral TSpectral>
 BSDFRequirements HapkeBSDF<TSpectral>::requirements() const
 {
@@ -41,6 +64,14 @@ float HapkeBSDF<TSpectral>::opposition_effect(float tan_half_alpha) const noexce
     return B0_ / (1.0f + (tan_half_alpha / h_));
 }
 
+template <IsSpectral TSpectral>
+float HapkeBSDF<TSpectral>::single_scattering_term(float cos_alpha) const noexcept
+{
+    // tan(alpha / 2) = sqrt((1 - cos(alpha)) / (1 + cos(alpha))), which avoids acos() and tan():
+    float tan_half_alpha = std::sqrt((1.0f - cos_alpha) / std::max(1.0f + cos_alpha, 1e-12f));
+    return (1.0f + opposition_effect(tan_half_alpha)) * phase_function_dhg(cos_alpha);
+}
+
 template <IsSpectral TSpectral>
 TSpectral HapkeBSDF<TSpectral>::h_function(float mu, const TSpectral& omega) const noexcept
 {
@@ -66,16 +97,11 @@ TSpectral HapkeBSDF<TSpectral>::eval(const Vec3<float>& wo,
 
     const TSpectral& omega = params.albedo;
 
-    // Phase angle calculations
+    // Single scattering with opposition effect, (1 + B(alpha)) * P(alpha):
     float cos_alpha = std::clamp(glm::dot(wi, wo), -1.0f, 1.0f);
-    float alpha = std::acos(cos_alpha);
-    float tan_half_alpha = std::tan(alpha * 0.5f);
-
-    // Single Scattering Phase Function
-    float P = phase_function_dhg(cos_alpha);
-
-    // Opposition Effect
-    float B = opposition_effect(tan_half_alpha);
+    float single_scattering = evaluation_ == PhotometricEvaluation::Tabulated
+                                  ? phase_table_(cos_alpha)
+                                  : single_scattering_term(cos_alpha);
 
     // Multiple Scattering (H-Functions)
     TSpectral H_i = h_function(cos_i, omega);
@@ -85,7 +111,7 @@ TSpectral HapkeBSDF<TSpectral>::eval(const Vec3<float>& wo,
     // f = (omega / (4 * pi * (cos_i + cos_o))) * [ (1 + B) * P + H(cos_i)*H(cos_o) - 1 ]
 
     TSpectral lommel_seeliger_base = omega / (4.0f * PI<float>() * (cos_i + cos_o));
-    TSpectral bracket_term = TSpectral{(1.0f + B) * P - 1.0f} + (H_i * H_o);
+    TSpectral bracket_term = TSpectral{single_scattering - 1.0f} + (H_i * H_o);
 
     return lommel_seeliger_base * bracket_term;
 }
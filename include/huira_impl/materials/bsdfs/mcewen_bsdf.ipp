@@ -1,10 +1,35 @@
 #include <algorithm>
 #include <cmath>
+#include <string>
 
 #include "huira/core/constants.hpp"
 #include "huira/materials/sampling_utils.hpp"
+#include "huira/util/logger.hpp"
 
 namespace huira {
+/**
+ * @brief Construct a McEwen BSDF.
+ * @param evaluation Whether to evaluate the phase-angle mixing term exactly or from a table
+ */
+template <IsSpectral TSpectral>
+McEwenBSDF<TSpectral>::McEwenBSDF(PhotometricEvaluation evaluation) : evaluation_(evaluation)
+{
+    if (evaluation_ == PhotometricEvaluation::Tabulated) {
+        beta_table_ = PhaseAngleTable(&McEwenBSDF::beta);
+        HUIRA_LOG_INFO("McEwenBSDF - Tabulated phase terms, max relative error " +
+                       std::to_string(beta_table_.max_relative_error()));
+    }
+}
+
+template <IsSpectral TSpectral>
+float McEwenBSDF<TSpectral>::beta(float cos_alpha) noexcept
+{
+    // McEwen's empirically derived beta factor
+    // 60 degrees = PI / 3 radians, so division by (PI/3) is multiplication by (3/PI)
+    constexpr float inv_alpha0 = 3.0f * INV_PI<float>();
+    float alpha = std::acos(cos_alpha);
+    return std::exp(-alpha * inv_alpha0);
+}
 template <IsSpectral TSpectral>
 BSDFRequirements McEwenBSDF<TSpectral>::requirements() const
 {
@@ -31,12 +56,8 @@ TSpectral McEwenBSDF<TSpectral>::eval(const Vec3<float>& wo,
 
     // Phase angle (angle between incoming and outgoing light directions)
     float cos_alpha = std::clamp(glm::dot(wi, wo), -1.0f, 1.0f);
-    float alpha = std::acos(cos_alpha);
-
-    // McEwen's empirically derived beta factor
-    // 60 degrees = PI / 3 radians, so division by (PI/3) is multiplication by (3/PI)
-    constexpr float inv_alpha0 = 3.0f * INV_PI<float>();
-    float beta = std::exp(-alpha * inv_alpha0);
+    float beta = evaluation_ == PhotometricEvaluation::Tabulated ? beta_table_(cos_alpha)
+                                                                 : McEwenBSDF::beta(cos_alpha);
 
     float lambert = INV_PI<float>();
     float lommel_seeliger = 1.0f / (4.0f * PI<float>() * (cos_i + cos_o));
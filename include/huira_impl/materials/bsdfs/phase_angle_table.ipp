@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "huira/util/logger.hpp"
+
+namespace huira {
+
+/**
+ * @brief Build a table of f(cos_alpha).
+ * @param f Function of the cosine of the phase angle to tabulate
+ * @param resolution Total number of table entries, split evenly between both halves (at least 4)
+ */
+inline PhaseAngleTable::PhaseAngleTable(const std::function<float(float)>& f,
+                                        std::size_t resolution)
+{
+    if (resolution < 4) {
+        HUIRA_THROW_ERROR("PhaseAngleTable::PhaseAngleTable - Resolution must be at least 4");
+    }
+
+    half_ = resolution / 2;
+    const float inv_scale = 1.f / static_cast<float>(half_ - 1);
+    scale_ = static_cast<float>(half_ - 1);
+
+    // u = sqrt(1 - cos) on the forward half and u = sqrt(1 + cos) on the backward half:
+    auto cos_front = [](float u) { return 1.f - u * u; };
+    auto cos_back = [](float u) { return u * u - 1.f; };
+
+    values_.resize(2 * half_);
+    for (std::size_t k = 0; k < half_; ++k) {
+        float u = static_cast<float>(k) * inv_scale;
+        values_[k] = f(cos_front(u));
+        values_[half_ + k] = f(cos_back(u));
+    }
+
+    auto record_error = [&](float cos_alpha) {
+        float exact = f(cos_alpha);
+        float error = std::abs((*this)(cos_alpha) - exact) / std::max(std::abs(exact), 1e-6f);
+        max_relative_error_ = std::max(max_relative_error_, error);
+    };
+    for (std::size_t k = 0; k + 1 < half_; ++k) {
+        float u = (static_cast<float>(k) + 0.5f) * inv_scale;
+        record_error(cos_front(u));
+        record_error(cos_back(u));
+    }
+}
+
+/**
+ * @brief Interpolate the table.
+ * @param cos_alpha Cosine of the phase angle, in [-1, 1]
+ * @return float Interpolated function value
+ */
+inline float PhaseAngleTable::operator()(float cos_alpha) const noexcept
+{
+    // Written as selects rather than branches, since the phase angle varies randomly per sample:
+    const bool forward = cos_alpha >= 0.f;
+    const float* values = values_.data() + (forward ? 0 : half_);
+
+    float u = std::sqrt(std::max(1.f - std::abs(cos_alpha), 0.f));
+    float x = std::min(u * scale_, scale_);
+    std::size_t i = std::min(static_cast<std::size_t>(x), half_ - 2);
+    float t = x - static_cast<float>(i);
+    return values[i] + t * (values[i + 1] - values[i]);
+}
+
+} // namespace huira
@@ -1,10 +1,35 @@
+#include <memory>
+#include <type_traits>
+#include <utility>
+
 namespace huira {
+namespace detail {
+/**
+ * @brief Whether sampling an image anywhere returns the same value (1x1 or empty).
+ */
+template <typename PixelT>
+bool is_constant_image(const Image<PixelT>& image)
+{
+    return image.width() <= 1 && image.height() <= 1;
+}
+
+/**
+ * @brief The value sample_bilinear() returns everywhere on a constant image.
+ */
+template <typename PixelT>
+PixelT constant_image_value(const Image<PixelT>& image)
+{
+    return image.empty() ? PixelT{} : image(0, 0);
+}
+} // namespace detail
+
 /**
  * @brief Evaluate all material textures at the given interaction point.
  *
- * Samples all image slots (no branching), applies scalar factors,
- * incorporates vertex albedo, and perturbs the shading normal from
- * the normal map. Returns everything the BSDF needs on the stack.
+ * Dispatches to a path that reads every channel from its precomputed constant when no channel
+ * is textured, and otherwise to a path that samples only the textured channels. Applies scalar
+ * factors, incorporates vertex albedo, and perturbs the shading normal from the normal map.
+ * Returns everything the BSDF needs on the stack.
  *
  * @param isect The surface interaction from the ray-geometry hit
  * @return MaterialEval<TSpectral> with ShadingParams and modified Interaction
@@ -12,44 +37,86 @@ namespace huira {
 template <IsSpectral TSpectral>
 MaterialEval<TSpectral> Material<TSpectral>::evaluate(const Interaction<TSpectral>& isect) const
 {
-    const Vec2<float>& uv = isect.uv;
+    if (textured_channels_ == 0) {
+        return evaluate_<false>(isect);
+    }
+    return evaluate_<true>(isect);
+}
+
+/**
+ * @brief Opacity at a texture coordinate, sampling only the alpha channel.
+ *
+ * Used for alpha testing during traversal, where there is no ray footprint, so textured alpha is
+ * read from the finest level.
+ *
+ * @param uv Texture coordinates of the hit
+ * @return float The opacity, 1 for fully opaque
+ */
+template <IsSpectral TSpectral>
+float Material<TSpectral>::opacity_at(const Vec2<float>& uv) const
+{
+    if (!is_textured(MaterialChannel::Alpha)) {
+        return alpha_constant_;
+    }
+    return alpha_sampler_->sample(uv, Vec2<float>{0.0f}, Vec2<float>{0.0f}) * alpha_factor_;
+}
+
+template <IsSpectral TSpectral>
+template <bool AnyTextured>
+MaterialEval<TSpectral> Material<TSpectral>::evaluate_(const Interaction<TSpectral>& isect) const
+{
+    auto textured = [this](MaterialChannel channel) {
+        return AnyTextured && is_textured(channel);
+    };
+    auto fetch = [&isect](const auto& sampler) {
+        return sampler->sample(isect.uv, isect.duvdx, isect.duvdy);
+    };
 
     ShadingParams<TSpectral> params;
 
     if (eval_albedo_) {
-        params.albedo =
-            albedo_image_->sample_bilinear(uv.x, uv.y) * albedo_factor_ * isect.vertex_albedo;
+        params.albedo = textured(MaterialChannel::Albedo)
+                            ? fetch(albedo_sampler_) * albedo_factor_
+                            : albedo_constant_;
+        params.albedo *= isect.vertex_albedo;
     }
 
-    // if (has_alpha_) {
-    params.opacity = alpha_image_->sample_bilinear(uv.x, uv.y) * alpha_factor_;
-    //}
+    params.opacity = textured(MaterialChannel::Alpha)
+                         ? fetch(alpha_sampler_) * alpha_factor_
+                         : alpha_constant_;
 
     if (eval_metallic_) {
-        params.metallic = metallic_image_->sample_bilinear(uv.x, uv.y) * metallic_factor_;
+        params.metallic = textured(MaterialChannel::Metallic)
+                              ? fetch(metallic_sampler_) * metallic_factor_
+                              : metallic_constant_;
     }
 
     if (eval_roughness_) {
-        params.roughness = roughness_image_->sample_bilinear(uv.x, uv.y) * roughness_factor_;
+        params.roughness = textured(MaterialChannel::Roughness)
+                               ? fetch(roughness_sampler_) * roughness_factor_
+                               : roughness_constant_;
     }
 
-    params.transmission = transmission_image_->sample_bilinear(uv.x, uv.y) * transmission_factor_;
+    params.transmission =
+        textured(MaterialChannel::Transmission)
+            ? fetch(transmission_sampler_) * transmission_factor_
+            : transmission_constant_;
 
-    params.emission = emissive_image_->sample_bilinear(uv.x, uv.y) * emissive_factor_;
+    params.emission = textured(MaterialChannel::Emissive)
+                          ? fetch(emissive_sampler_) * emissive_factor_
+                          : emissive_constant_;
 
     Interaction<TSpectral> shading_isect = isect;
 
-    if (eval_normal_) {
-        if (isect.tangent != Vec3<float>{0.0f}) {
-            Vec3<float> ts_normal = glm::normalize(normal_image_->sample_bilinear(uv.x, uv.y));
+    if (eval_normal_ && isect.tangent != Vec3<float>{0.0f}) {
+        if (textured(MaterialChannel::Normal)) {
+            Vec3<float> ts_normal = glm::normalize(fetch(normal_sampler_));
 
             ts_normal.x *= normal_factor_;
             ts_normal.y *= normal_factor_;
-            ts_normal = glm::normalize(ts_normal);
-
-            Vec3<float> perturbed = isect.tangent * ts_normal.x + isect.bitangent * ts_normal.y +
-                                    isect.normal_s * ts_normal.z;
-            shading_isect.normal_s = glm::normalize(perturbed);
+            perturb_normal_(glm::normalize(ts_normal), isect, shading_isect);
+        } else if (!constant_normal_is_flat_) {
+            perturb_normal_(normal_constant_, isect, shading_isect);
         }
     }
 
@@ -64,6 +131,72 @@ MaterialEval<TSpectral> Material<TSpectral>::evaluate(const Interaction<TSpectra
     return result;
 }
 
+/**
+ * @brief Rotate the shading normal by a tangent-space normal.
+ * @param ts_normal Normalized tangent-space normal (normal factor already applied)
+ * @param isect The unperturbed interaction
+ * @param shading_isect [out] Interaction whose shading normal is replaced
+ */
+template <IsSpectral TSpectral>
+void Material<TSpectral>::perturb_normal_(const Vec3<float>& ts_normal,
+                                          const Interaction<TSpectral>& isect,
+                                          Interaction<TSpectral>& shading_isect) const
+{
+    Vec3<float> perturbed = isect.tangent * ts_normal.x + isect.bitangent * ts_normal.y +
+                            isect.normal_s * ts_normal.z;
+    shading_isect.normal_s = glm::normalize(perturbed);
+}
+
+/**
+ * @brief Classify each channel as textured or constant and fold constant slots with their factors.
+ *
+ * Called whenever an image slot or factor changes. Image setters replace the channel's sampler
+ * along with its image, so a textured channel without one gets a MipPyramid built here.
+ */
+template <IsSpectral TSpectral>
+void Material<TSpectral>::update_channels_()
+{
+    textured_channels_ = 0;
+    auto classify = [this](const auto& image, auto& sampler, MaterialChannel channel) {
+        using PixelT = typename std::decay_t<decltype(*image)>::PixelType;
+        if (detail::is_constant_image(*image)) {
+            sampler.reset();
+        } else {
+            textured_channels_ |= static_cast<std::uint8_t>(channel);
+            if (!sampler) {
+                sampler = std::make_shared<MipPyramid<PixelT>>(image);
+            }
+        }
+        return detail::constant_image_value(*image);
+    };
+
+    albedo_constant_ =
+        classify(albedo_image_, albedo_sampler_, MaterialChannel::Albedo) * albedo_factor_;
+    alpha_constant_ =
+        classify(alpha_image_, alpha_sampler_, MaterialChannel::Alpha) * alpha_factor_;
+    metallic_constant_ =
+        classify(metallic_image_, metallic_sampler_, MaterialChannel::Metallic) * metallic_factor_;
+    roughness_constant_ =
+        classify(roughness_image_, roughness_sampler_, MaterialChannel::Roughness) *
+        roughness_factor_;
+    transmission_constant_ =
+        classify(transmission_image_, transmission_sampler_, MaterialChannel::Transmission) *
+        transmission_factor_;
+    emissive_constant_ =
+        classify(emissive_image_, emissive_sampler_, MaterialChannel::Emissive) * emissive_factor_;
+
+    Vec3<float> ts_normal = classify(normal_image_, normal_sampler_, MaterialChannel::Normal);
+    ts_normal.x *= normal_factor_;
+    ts_normal.y *= normal_factor_;
+    if (glm::dot(ts_normal, ts_normal) > 0.0f) {
+        normal_constant_ = glm::normalize(ts_normal);
+    } else {
+        normal_constant_ = Vec3<float>{0.0f, 0.0f, 1.0f};
+    }
+    constant_normal_is_flat_ = normal_constant_.x == 0.0f && normal_constant_.y == 0.0f;
+    this->touch_();
+}
+
 template <IsSpectral TSpectral>
 TSpectral Material<TSpectral>::bsdf_eval(const Vec3<float>& wo,
                                          const Vec3<float>& wi,
@@ -100,18 +233,23 @@ void Material<TSpectral>::set_bsdf(std::shared_ptr<BSDF<TSpectral>> bsdf)
     eval_metallic_ = reqs.needs_metallic;
     eval_roughness_ = reqs.needs_roughness;
     eval_normal_ = reqs.needs_normal;
+    this->touch_();
 }
 
 template <IsSpectral TSpectral>
-void Material<TSpectral>::set_albedo(std::shared_ptr<Image<TSpectral>> albedo_image)
+void Material<TSpectral>::set_albedo(std::shared_ptr<Image<TSpectral>> albedo_image,
+                                     std::shared_ptr<const TextureSampler<TSpectral>> sampler)
 {
     albedo_image_ = albedo_image;
+    albedo_sampler_ = std::move(sampler);
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_albedo_factor(TSpectral albedo_factor)
 {
     albedo_factor_ = albedo_factor;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -119,13 +257,17 @@ void Material<TSpectral>::reset_albedo()
 {
     albedo_image_ = default_albedo_image_;
     albedo_factor_ = TSpectral{1.0f};
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
-void Material<TSpectral>::set_alpha(std::shared_ptr<Image<float>> alpha_image)
+void Material<TSpectral>::set_alpha(std::shared_ptr<Image<float>> alpha_image,
+                                    std::shared_ptr<const TextureSampler<float>> sampler)
 {
     alpha_image_ = alpha_image;
+    alpha_sampler_ = std::move(sampler);
     has_alpha_ = true;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -135,6 +277,7 @@ void Material<TSpectral>::set_alpha_factor(float alpha_factor)
     if (alpha_factor_ < 1.0f) {
         has_alpha_ = true;
     }
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -143,21 +286,26 @@ void Material<TSpectral>::reset_alpha()
     alpha_image_ = default_alpha_image_;
     alpha_factor_ = 1.0f;
     has_alpha_ = false;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
-void Material<TSpectral>::set_metallic_image(std::shared_ptr<Image<float>> metallic_image)
+void Material<TSpectral>::set_metallic_image(std::shared_ptr<Image<float>> metallic_image,
+                                             std::shared_ptr<const TextureSampler<float>> sampler)
 {
     metallic_image_ = metallic_image;
+    metallic_sampler_ = std::move(sampler);
     if (metallic_factor_ == 0.f) {
         metallic_factor_ = 1.f;
     }
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_metallic_factor(float metallic_factor)
 {
     metallic_factor_ = metallic_factor;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -165,18 +313,23 @@ void Material<TSpectral>::reset_metallic()
 {
     metallic_image_ = default_metallic_image_;
     metallic_factor_ = 0.0f;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
-void Material<TSpectral>::set_roughness_image(std::shared_ptr<Image<float>> roughness_image)
+void Material<TSpectral>::set_roughness_image(std::shared_ptr<Image<float>> roughness_image,
+                                              std::shared_ptr<const TextureSampler<float>> sampler)
 {
     roughness_image_ = roughness_image;
+    roughness_sampler_ = std::move(sampler);
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_roughness_factor(float roughness_factor)
 {
     roughness_factor_ = roughness_factor;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -184,18 +337,24 @@ void Material<TSpectral>::reset_roughness()
 {
     roughness_image_ = default_roughness_image_;
     roughness_factor_ = 1.0f;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
-void Material<TSpectral>::set_normal_image(std::shared_ptr<Image<Vec3<float>>> normal_image)
+void Material<TSpectral>::set_normal_image(
+    std::shared_ptr<Image<Vec3<float>>> normal_image,
+    std::shared_ptr<const TextureSampler<Vec3<float>>> sampler)
 {
     normal_image_ = normal_image;
+    normal_sampler_ = std::move(sampler);
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_normal_factor(float normal_factor)
 {
     normal_factor_ = normal_factor;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -203,22 +362,27 @@ void Material<TSpectral>::reset_normal()
 {
     normal_image_ = default_normal_image_;
     normal_factor_ = 1.0f;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_transmission_image(
-    std::shared_ptr<Image<TSpectral>> transmission_image)
+    std::shared_ptr<Image<TSpectral>> transmission_image,
+    std::shared_ptr<const TextureSampler<TSpectral>> sampler)
 {
     transmission_image_ = transmission_image;
+    transmission_sampler_ = std::move(sampler);
     if (transmission_factor_ == TSpectral{0.f}) {
         transmission_factor_ = TSpectral{1.f};
     }
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_transmission_factor(TSpectral transmission_factor)
 {
     transmission_factor_ = transmission_factor;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -226,21 +390,27 @@ void Material<TSpectral>::reset_transmission()
 {
     transmission_image_ = default_transmission_image_;
     transmission_factor_ = TSpectral{0.0f};
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
-void Material<TSpectral>::set_emissive_image(std::shared_ptr<Image<TSpectral>> emissive_image)
+void Material<TSpectral>::set_emissive_image(
+    std::shared_ptr<Image<TSpectral>> emissive_image,
+    std::shared_ptr<const TextureSampler<TSpectral>> sampler)
 {
     emissive_image_ = emissive_image;
+    emissive_sampler_ = std::move(sampler);
     if (emissive_factor_ == TSpectral{0.f}) {
         emissive_factor_ = TSpectral{1.f};
     }
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
 void Material<TSpectral>::set_emissive_factor(TSpectral emissive_factor)
 {
     emissive_factor_ = emissive_factor;
+    update_channels_();
 }
 
 template <IsSpectral TSpectral>
@@ -248,6 +418,30 @@ void Material<TSpectral>::reset_emissive()
 {
     emissive_image_ = default_emissive_image_;
     emissive_factor_ = TSpectral{0.0f};
+    update_channels_();
+}
+
+/**
+ * @brief Whether another material has the same BSDF, images and factors.
+ *
+ * The BSDF and images are compared by identity, so two materials using the same textures match.
+ *
+ * @param other The material to compare with
+ * @return bool True if the materials shade alike
+ */
+template <IsSpectral TSpectral>
+bool Material<TSpectral>::same_parameters(const Material& other) const
+{
+    return bsdf_ == other.bsdf_ && albedo_image_ == other.albedo_image_ &&
+           alpha_image_ == other.alpha_image_ && metallic_image_ == other.metallic_image_ &&
+           roughness_image_ == other.roughness_image_ && normal_image_ == other.normal_image_ &&
+           transmission_image_ == other.transmission_image_ &&
+           emissive_image_ == other.emissive_image_ && albedo_factor_ == other.albedo_factor_ &&
+           alpha_factor_ == other.alpha_factor_ && metallic_factor_ == other.metallic_factor_ &&
+           roughness_factor_ == other.roughness_factor_ &&
+           normal_factor_ == other.normal_factor_ &&
+           transmission_factor_ == other.transmission_factor_ &&
+           emissive_factor_ == other.emissive_factor_;
 }
 
 template <IsSpectral TSpectral>
@@ -273,5 +467,6 @@ Material<TSpectral>::Material(std::shared_ptr<BSDF<TSpectral>> bsdf,
     emissive_image_ = default_emissive_image_;
 
     set_bsdf(bsdf);
+    update_channels_();
 };
 } // namespace huira
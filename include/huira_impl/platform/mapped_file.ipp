@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#include "huira/platform/windows_minmax.hpp"
+
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "huira/util/logger.hpp"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Maps the whole of a file into memory.
+ * @param filepath Path to the file
+ * @throws std::runtime_error if the file cannot be opened or mapped
+ */
+inline MappedFile::MappedFile(const fs::path& filepath) : filepath_{filepath}
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filepath.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        HUIRA_THROW_ERROR("MappedFile::MappedFile - Failed to open file: " + filepath.string());
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        HUIRA_THROW_ERROR("MappedFile::MappedFile - Failed to get size of: " + filepath.string());
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    file_ = file;
+    if (size_ == 0) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        HUIRA_THROW_ERROR("MappedFile::MappedFile - Failed to map file: " + filepath.string());
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const std::byte*>(view);
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        HUIRA_THROW_ERROR("MappedFile::MappedFile - Failed to open file: " + filepath.string());
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        HUIRA_THROW_ERROR("MappedFile::MappedFile - Failed to get size of: " + filepath.string());
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        return;
+    }
+
+    // The mapping holds its own reference to the file, so the descriptor can be closed now:
+    void* view = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        HUIRA_THROW_ERROR("MappedFile::MappedFile - Failed to map file: " + filepath.string());
+    }
+    data_ = static_cast<const std::byte*>(view);
+#endif
+}
+
+inline MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+    if (file_) {
+        CloseHandle(static_cast<HANDLE>(file_));
+    }
+#else
+    if (data_) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+}
+} // namespace huira
@@ -4,10 +4,67 @@
 #include <cstring>
 #include <type_traits>
 
+#include "glm/glm.hpp"
 #include "huira/concepts/numeric_concepts.hpp"
+#include "huira/concepts/spectral_concepts.hpp"
 #include "huira/core/types.hpp"
 
 namespace huira {
+/**
+ * @brief Computes the screen-space uv derivatives of an interaction from ray differentials.
+ *
+ * Each offset ray is intersected with the tangent plane at the hit, giving the change in position
+ * across one pixel, which is then expressed in terms of dpdu and dpdv by least squares (Section
+ * 10.1.1 of "Physically Based Rendering"). The result is stored in isect.duvdx and isect.duvdy;
+ * they are left at zero when the offset rays are parallel to the surface or the uv
+ * parameterization is degenerate, which makes texture lookups fall back to the finest level.
+ *
+ * @param isect [in,out] Interaction with position, normal_g, dpdu and dpdv set
+ * @param rx_origin Origin of the ray offset by one pixel in x
+ * @param rx_direction Direction of the ray offset by one pixel in x
+ * @param ry_origin Origin of the ray offset by one pixel in y
+ * @param ry_direction Direction of the ray offset by one pixel in y
+ */
+template <IsSpectral TSpectral>
+void compute_uv_differentials(Interaction<TSpectral>& isect,
+                              const Vec3<float>& rx_origin,
+                              const Vec3<float>& rx_direction,
+                              const Vec3<float>& ry_origin,
+                              const Vec3<float>& ry_direction) noexcept
+{
+    isect.duvdx = Vec2<float>{0.0f};
+    isect.duvdy = Vec2<float>{0.0f};
+
+    const Vec3<float>& n = isect.normal_g;
+    const float plane_d = glm::dot(n, isect.position);
+    const float tx = (plane_d - glm::dot(n, rx_origin)) / glm::dot(n, rx_direction);
+    const float ty = (plane_d - glm::dot(n, ry_origin)) / glm::dot(n, ry_direction);
+    if (!std::isfinite(tx) || !std::isfinite(ty)) {
+        return;
+    }
+    const Vec3<float> dpdx = rx_origin + tx * rx_direction - isect.position;
+    const Vec3<float> dpdy = ry_origin + ty * ry_direction - isect.position;
+
+    // Normal equations of [dpdu dpdv] * duv = dp:
+    const float ata00 = glm::dot(isect.dpdu, isect.dpdu);
+    const float ata01 = glm::dot(isect.dpdu, isect.dpdv);
+    const float ata11 = glm::dot(isect.dpdv, isect.dpdv);
+    const float inv_det = 1.0f / (ata00 * ata11 - ata01 * ata01);
+    if (!std::isfinite(inv_det)) {
+        return;
+    }
+
+    auto solve = [&](const Vec3<float>& dp) {
+        const float atb0 = glm::dot(isect.dpdu, dp);
+        const float atb1 = glm::dot(isect.dpdv, dp);
+        Vec2<float> duv{(ata11 * atb0 - ata01 * atb1) * inv_det,
+                        (ata00 * atb1 - ata01 * atb0) * inv_det};
+        return std::isfinite(duv.x) && std::isfinite(duv.y) ? duv : Vec2<float>{0.0f};
+    };
+    isect.duvdx = solve(dpdx);
+    isect.duvdy = solve(dpdy);
+}
+
 /**
  * @brief Threshold below which direct floating-point offset is used for intersection offsetting.
  * @tparam T Floating-point type
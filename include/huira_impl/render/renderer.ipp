@@ -1,7 +1,10 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <limits>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "tbb/blocked_range.h"
@@ -112,6 +115,10 @@ inline Transform<float> interpolate_transform(const std::vector<Transform<float>
  * The rendering is parallelized over tiles using TBB. Each tile accumulates
  * results from multiple samples per pixel (spp_) into the frame buffer.
  *
+ * When an IrradianceCache is set, secondary vertices may terminate on a cached radiance
+ * estimate. When a ShadowCache is set, visibility toward each body's dominant light is answered
+ * from the cache once a surface cell has enough samples. Both caches are fed by the traced paths.
+ *
  * @tparam TSpectral Spectral type for the rendering pipeline
  * @param scene_view The scene view containing geometry, lights, and environment
  * @param frame_buffer The frame buffer to render into
@@ -140,6 +147,29 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
     float time = 0.f;
     const bool has_motion_blur = scene_view.temporal_samples_.size() > 1;
 
+    // Each of the spp jittered samples filters textures over its share of the pixel, down to an
+    // eighth, past which the extra sharpness is not worth the extra texture memory traffic:
+    const float differential_scale =
+        std::max(0.125f, 1.0f / std::sqrt(static_cast<float>(std::max(spp_, 1))));
+
+    // Surface caches, shared across frames:
+    IrradianceCache<TSpectral>* irradiance_cache = irradiance_cache_.get();
+    ShadowCache<TSpectral>* shadow_cache = shadow_cache_.get();
+    std::vector<std::vector<SurfaceCacheInstance>> cache_instances;
+    if (irradiance_cache || shadow_cache) {
+        cache_instances = prepare_surface_caches_(scene_view);
+    }
+    const float irradiance_inv_cell_size =
+        irradiance_cache ? irradiance_cache->inv_cell_size() : 0.f;
+    const float shadow_inv_cell_size = shadow_cache ? shadow_cache->inv_cell_size() : 0.f;
+
+    // Observations are kept per tile and merged once the frame is done, so lookups during the
+    // frame see only earlier frames and the result does not depend on how tiles are scheduled:
+    std::vector<std::vector<typename IrradianceCache<TSpectral>::Record>> irradiance_records(
+        irradiance_cache ? static_cast<std::size_t>(num_tiles) : 0);
+    std::vector<std::vector<typename ShadowCache<TSpectral>::Record>> shadow_records(
+        shadow_cache ? static_cast<std::size_t>(num_tiles) : 0);
+
     tbb::parallel_for(
         tbb::blocked_range<int>(0, num_tiles), [&](const tbb::blocked_range<int>& range) {
             for (int tile_idx = range.begin(); tile_idx < range.end(); ++tile_idx) {
@@ -154,6 +184,10 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                 // Per-tile RNG seeded from tile index for reproducibility:
                 RandomSampler<float> sampler(static_cast<unsigned int>(tile_idx));
 
+                std::vector<typename IrradianceCache<TSpectral>::PathVertex> cache_vertices;
+                std::vector<typename IrradianceCache<TSpectral>::Record> cache_records;
+                std::vector<typename ShadowCache<TSpectral>::Record> tile_shadow_records;
+
                 for (int y = y0; y < y1; ++y) {
                     for (int x = x0; x < x1; ++x) {
 
@@ -178,6 +212,7 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
 
                             // Generate camera ray from pixel coordinates:
                             Ray<TSpectral> ray = camera->cast_ray(Pixel{sx, sy}, sampler);
+                            ray.scale_differentials(differential_scale);
 
                             // Motion blur: randomize time sample per ray
                             if (has_motion_blur) {
@@ -194,32 +229,21 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                             Interaction<TSpectral> prev_isect;
 
                             MediumStack<TSpectral> medium_stack;
+                            cache_vertices.clear();
 
                             for (int bounce = 0; bounce < max_bounces_; ++bounce) {
                                 HitRecord hit = scene_view.intersect(ray, time);
 
                                 if (!medium_stack.is_empty()) {
                                     const Medium<TSpectral>* current_medium = medium_stack.top();
-                                    auto opt_mi = current_medium->sample_free_path(ray, sampler);
-                                    auto props = current_medium->get_properties(ray.origin());
-                                    TSpectral ext = props.extinction();
-
-                                    float avg_ext = 0.0f;
-                                    for (std::size_t c = 0; c < TSpectral::size(); ++c) {
-                                        avg_ext += ext[c];
-                                    }
-                                    avg_ext /= static_cast<float>(TSpectral::size());
-
-                                    if (opt_mi && opt_mi->t < hit.t) {
-                                        float t = opt_mi->t;
-                                        TSpectral Tr{0.f};
-                                        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
-                                            Tr[c] = std::exp(-ext[c] * t);
-                                        }
-                                        float pdf = avg_ext * std::exp(-avg_ext * t);
-                                        throughput =
-                                            throughput * props.scattering * Tr * (1.0f / pdf);
-
+                                    auto opt_mi = current_medium->sample_free_path(
+                                        ray,
+                                        hit.t,
+                                        sampler,
+                                        throughput,
+                                        medium_stack.top_world_to_local());
+
+                                    if (opt_mi) {
                                         Interaction<TSpectral> vol_isect;
                                         vol_isect.position = opt_mi->p;
                                         vol_isect.wo = opt_mi->wo;
@@ -275,13 +299,24 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                                         prev_bsdf_pdf = ps.p;
                                         continue;
 
+                                    }
+                                    if (throughput.max() <= 0.0f) {
+                                        break;
+                                    }
+                                }
+
+                                // Light scattered by planetary atmospheres up to the next hit,
+                                // whether that is a limb, the ground or open space:
+                                if (!scene_view.atmospheres_.empty()) {
+                                    auto segment = scene_view.integrate_atmospheres(ray, hit.t);
+                                    if (bounce == 0) {
+                                        direct_radiance += throughput * segment.radiance;
                                     } else {
-                                        TSpectral Tr{0.f};
-                                        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
-                                            Tr[c] = std::exp(-ext[c] * hit.t);
-                                        }
-                                        float pdf = std::exp(-avg_ext * hit.t);
-                                        throughput = throughput * Tr * (1.0f / pdf);
+                                        indirect_radiance += throughput * segment.radiance;
+                                    }
+                                    throughput *= segment.transmittance;
+                                    if (throughput.max() <= 0.0f) {
+                                        break;
                                     }
                                 }
 
@@ -349,28 +384,10 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                                     const auto& batch = scene_view.primitives_[mapping.batch_index];
                                     const auto* material = batch.primitive->material.get();
 
-                                    // Evaluate material textures to get the opacity parameter:
+                                    // Evaluate material textures. Alpha cut-outs were already
+                                    // skipped during traversal by SceneView::alpha_filter_:
                                     auto [params, shading_isect] = material->evaluate(isect);
 
-                                    if (params.opacity < 1.0f) {
-                                        if (sampler.get_1d() > params.opacity) {
-                                            Vec3<float> pass_through_normal =
-                                                (glm::dot(ray.direction(), isect.normal_g) < 0.0f)
-                                                    ? -isect.normal_g
-                                                    : isect.normal_g;
-                                            Vec3<float> pass_through_origin = offset_intersection_(
-                                                isect.position, pass_through_normal);
-
-                                            ray = Ray<TSpectral>(pass_through_origin,
-                                                                 ray.direction());
-
-                                            medium_stack.toggle(batch.primitive.get());
-
-                                            bounce--; // Don't count this towards bounce counts
-                                            continue;
-                                        }
-                                    }
-
                                     // Path regulatization
                                     if (bounce > 0) {
                                         params.roughness =
@@ -385,8 +402,44 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                                         albedo_total += params.albedo;
                                     }
 
+                                    // Hit location in the instance frame, for surface caches:
+                                    const SurfaceCacheInstance* cache_instance = nullptr;
+                                    Vec3<float> local_position{0.f};
+                                    Vec3<float> local_normal{0.f};
+                                    if (!cache_instances.empty()) {
+                                        cache_instance = &cache_instances[mapping.batch_index]
+                                                                         [mapping.instance_index];
+                                        const auto& to_local = cache_instance->world_to_local;
+                                        local_position = to_local.apply_to_point(isect.position);
+                                        local_normal = glm::normalize(
+                                            to_local.apply_to_direction(isect.normal_g));
+                                    }
+
+                                    // Radiance cache: end secondary paths on a cached estimate,
+                                    // otherwise remember the vertex to feed the cache later.
+                                    if (irradiance_cache && bounce > 0 &&
+                                        cache_instance->irradiance) {
+                                        SurfaceCacheCell cell = make_surface_cache_cell(
+                                            local_position, local_normal, irradiance_inv_cell_size);
+
+                                        auto cached =
+                                            irradiance_cache->lookup(cache_instance->body, cell);
+                                        if (cached) {
+                                            indirect_radiance +=
+                                                throughput * params.albedo * *cached;
+                                            break;
+                                        }
+                                        cache_vertices.push_back({cache_instance->body,
+                                                                  cell,
+                                                                  throughput,
+                                                                  indirect_radiance,
+                                                                  params.albedo});
+                                    }
+
                                     // Direct lighting (next event estimation)
-                                    for (const auto& light_instance : lights) {
+                                    for (std::size_t light_index = 0; light_index < lights.size();
+                                         ++light_index) {
+                                        const auto& light_instance = lights[light_index];
                                         Transform<float> current_transform =
                                             interpolate_transform(light_instance.transforms, time);
 
@@ -404,15 +457,47 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                                             glm::dot(ls.wi, isect.normal_g) <= 0.0f) {
                                             continue;
                                         }
-                                        Vec3<float> shadow_normal =
-                                            (glm::dot(ls.wi, isect.normal_g) < 0.0f)
-                                                ? -isect.normal_g
-                                                : isect.normal_g;
-                                        Vec3<float> shadow_origin =
-                                            offset_intersection_(isect.position, shadow_normal);
-                                        Ray<TSpectral> shadow_ray(shadow_origin, ls.wi);
-                                        TSpectral transmittance = scene_view.evaluate_transmittance(
-                                            shadow_ray, light_dist, medium_stack, sampler, time);
+
+                                        // Sun visibility can be answered from the shadow cache
+                                        // for front-side lighting outside of participating media:
+                                        const bool use_shadow_cache =
+                                            shadow_cache && cache_instance->shadow &&
+                                            medium_stack.is_empty() &&
+                                            cache_instance->sun_index == light_index &&
+                                            glm::dot(ls.wi, isect.normal_g) > 0.0f;
+                                        SurfaceCacheCell shadow_cell{};
+                                        std::optional<TSpectral> cached_transmittance;
+                                        if (use_shadow_cache) {
+                                            shadow_cell = make_surface_cache_cell(
+                                                local_position, local_normal, shadow_inv_cell_size);
+                                            cached_transmittance = shadow_cache->lookup(
+                                                cache_instance->body, shadow_cell);
+                                        }
+
+                                        TSpectral transmittance{0.f};
+                                        if (cached_transmittance) {
+                                            transmittance = *cached_transmittance;
+                                        } else {
+                                            Vec3<float> shadow_normal =
+                                                (glm::dot(ls.wi, isect.normal_g) < 0.0f)
+                                                    ? -isect.normal_g
+                                                    : isect.normal_g;
+                                            Vec3<float> shadow_origin =
+                                                offset_intersection_(isect.position, shadow_normal);
+                                            Ray<TSpectral> shadow_ray(shadow_origin, ls.wi);
+                                            transmittance =
+                                                scene_view.evaluate_transmittance(shadow_ray,
+                                                                                  light_dist,
+                                                                                  medium_stack,
+                                                                                  sampler,
+                                                                                  time);
+                                            if (use_shadow_cache) {
+                                                tile_shadow_records.push_back(
+                                                    {cache_instance->body,
+                                                     shadow_cell,
+                                                     transmittance});
+                                            }
+                                        }
                                         if (transmittance.max() <= 0.0f) {
                                             continue;
                                         }
@@ -476,11 +561,18 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                                     const float wi_side = glm::dot(bs.wi, isect.normal_g);
                                     const bool is_transmission = (wo_side * wi_side) < 0.0f;
                                     if (is_transmission) {
-                                        medium_stack.toggle(batch.primitive.get());
+                                        medium_stack.toggle(
+                                            batch.primitive.get(),
+                                            batch.instances[mapping.instance_index][0]);
                                     }
                                 }
                             }
 
+                            if (irradiance_cache) {
+                                IrradianceCache<TSpectral>::append_records(
+                                    cache_vertices, indirect_radiance, cache_records);
+                            }
+
                             // Indirect radiance clamping:
                             float current_indirect_max = indirect_radiance.max();
                             if (current_indirect_max > indirect_clamp_threshold_) {
@@ -499,9 +591,9 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                             // Welford's online mean/variance update:
                             TSpectral delta = sample_radiance - mean;
                             inv_samples = (1.0f / static_cast<float>(samples_taken));
-                            mean += delta * inv_samples;
+                            mean = fma(delta, inv_samples, mean);
                             TSpectral delta2 = sample_radiance - mean;
-                            M2 += delta * delta2;
+                            M2 = fma(delta, delta2, M2);
 
                             pixel_direct_radiance += direct_radiance;
                             pixel_indirect_radiance += indirect_radiance;
@@ -568,9 +660,25 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
                         }
                     }
                 }
+
+                if (irradiance_cache) {
+                    irradiance_records[static_cast<std::size_t>(tile_idx)] =
+                        std::move(cache_records);
+                }
+                if (shadow_cache) {
+                    shadow_records[static_cast<std::size_t>(tile_idx)] =
+                        std::move(tile_shadow_records);
+                }
             }
         });
 
+    for (const auto& records : irradiance_records) {
+        irradiance_cache->insert(records);
+    }
+    for (const auto& records : shadow_records) {
+        shadow_cache->insert(records);
+    }
+
     if (frame_buffer.has_received_power() && camera->convolve_psf_) {
         const Image<TSpectral>& psf = camera->get_psf_kernel(0.0f, 0.0f);
         received_power.convolve(psf);
@@ -583,6 +691,96 @@ Image<TSpectral> Renderer<TSpectral>::path_trace_(SceneView<TSpectral>& scene_vi
     return received_power;
 }
 
+/**
+ * @brief Refresh the surface caches for the bodies in a scene view.
+ *
+ * For every primitive instance, finds the light delivering the most irradiance (the sun, for
+ * typical scenes), expresses its direction in the instance's local frame, and hands it to each
+ * enabled cache so entries computed under a different illumination geometry are dropped.
+ *
+ * The direction is followed across every temporal sample of the exposure. An instance whose sun
+ * direction moves beyond a cache's tolerance during the exposure (a body spinning or moving past
+ * the sun, rather than a moving observer) is left out of that cache for the frame, since no one
+ * entry could stand for the whole exposure.
+ *
+ * @param scene_view The scene view about to be rendered
+ * @return Per batch, per instance cache state (body key, local frame, dominant light)
+ */
+template <IsSpectral TSpectral>
+std::vector<std::vector<typename Renderer<TSpectral>::SurfaceCacheInstance>>
+Renderer<TSpectral>::prepare_surface_caches_(const SceneView<TSpectral>& scene_view)
+{
+    std::vector<std::vector<SurfaceCacheInstance>> cache_instances(scene_view.primitives_.size());
+
+    for (std::size_t b = 0; b < scene_view.primitives_.size(); ++b) {
+        const auto& batch = scene_view.primitives_[b];
+        cache_instances[b].reserve(batch.instances.size());
+
+        for (std::size_t i = 0; i < batch.instances.size(); ++i) {
+            const std::vector<Transform<float>>& motion = batch.instances[i];
+            const Transform<float>& xf = motion[0];
+
+            SurfaceCacheInstance instance;
+            instance.body = SurfaceCacheBody{batch.primitive->id(), i};
+            instance.world_to_local = xf.inverse();
+
+            float best_irradiance = -1.f;
+            Vec3<float> sun_direction{0.f};
+            for (std::size_t l = 0; l < scene_view.lights_.size(); ++l) {
+                const auto& light_instance = scene_view.lights_[l];
+                Transform<float> light_xf = interpolate_transform(light_instance.transforms, 0.f);
+                float irradiance = light_instance.light->irradiance_at(xf.position, light_xf).max();
+                Vec3<float> to_light = light_xf.position - xf.position;
+                if (irradiance > best_irradiance && glm::length(to_light) > 0.f) {
+                    best_irradiance = irradiance;
+                    sun_direction = glm::normalize(to_light);
+                    instance.sun_index = l;
+                }
+            }
+
+            if (best_irradiance >= 0.f) {
+                Vec3<float> local_sun_direction =
+                    glm::normalize(instance.world_to_local.apply_to_direction(sun_direction));
+
+                // Find how far the local sun direction strays over the exposure:
+                const auto& sun_motion = scene_view.lights_[instance.sun_index].transforms;
+                const std::size_t steps = std::max(motion.size(), sun_motion.size());
+                Vec3<float> furthest = local_sun_direction;
+                for (std::size_t k = 1; k < steps; ++k) {
+                    const float t = static_cast<float>(k) / static_cast<float>(steps - 1);
+                    const Transform<float> xf_t = interpolate_transform(motion, t);
+                    const Vec3<float> to_light =
+                        interpolate_transform(sun_motion, t).position - xf_t.position;
+                    if (glm::length(to_light) <= 0.f) {
+                        continue;
+                    }
+                    const Vec3<float> direction = glm::normalize(
+                        xf_t.inverse().apply_to_direction(glm::normalize(to_light)));
+                    if (glm::dot(direction, local_sun_direction) <
+                        glm::dot(furthest, local_sun_direction)) {
+                        furthest = direction;
+                    }
+                }
+
+                if (irradiance_cache_ &&
+                    irradiance_cache_->same_sun_direction(local_sun_direction, furthest)) {
+                    irradiance_cache_->update_sun_direction(instance.body, local_sun_direction);
+                    instance.irradiance = true;
+                }
+                if (shadow_cache_ &&
+                    shadow_cache_->same_sun_direction(local_sun_direction, furthest)) {
+                    shadow_cache_->update_sun_direction(instance.body, local_sun_direction);
+                    instance.shadow = true;
+                }
+            }
+
+            cache_instances[b].push_back(instance);
+        }
+    }
+
+    return cache_instances;
+}
+
 template <IsSpectral TSpectral>
 struct RenderItem {
     RenderItem(TrajectoryArc set_arc,
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "huira/core/constants.hpp"
+#include "huira/core/types.hpp"
+#include "huira/util/logger.hpp"
+
+namespace huira {
+
+/**
+ * @brief Hash a surface cache cell.
+ * @param cell The cell to hash
+ * @return std::size_t Hash value
+ */
+inline std::size_t SurfaceCacheCellHash::operator()(const SurfaceCacheCell& cell) const noexcept
+{
+    // Spatial hash (Teschner et al. 2003) with the normal bin folded in:
+    std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell.x)) * 73856093ull;
+    h ^= static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell.y)) * 19349663ull;
+    h ^= static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell.z)) * 83492791ull;
+    h ^= static_cast<std::uint64_t>(cell.normal_bin) << 56;
+    return static_cast<std::size_t>(h);
+}
+
+/**
+ * @brief Build a surface cache cell from an instance-local position and normal.
+ *
+ * The normal is binned by its dominant axis and sign, which keeps opposite faces of thin features
+ * (and opposing crater walls sharing a grid cell) from being averaged together.
+ *
+ * @param local_position Hit position in the instance's local frame
+ * @param local_normal Geometric normal in the instance's local frame
+ * @param inv_cell_size Reciprocal of the grid cell edge length
+ * @return SurfaceCacheCell The discretized cell
+ */
+inline SurfaceCacheCell make_surface_cache_cell(const Vec3<float>& local_position,
+                                                const Vec3<float>& local_normal,
+                                                float inv_cell_size)
+{
+    SurfaceCacheCell cell;
+    cell.x = static_cast<std::int32_t>(std::floor(local_position.x * inv_cell_size));
+    cell.y = static_cast<std::int32_t>(std::floor(local_position.y * inv_cell_size));
+    cell.z = static_cast<std::int32_t>(std::floor(local_position.z * inv_cell_size));
+
+    float ax = std::abs(local_normal.x);
+    float ay = std::abs(local_normal.y);
+    float az = std::abs(local_normal.z);
+    if (ax >= ay && ax >= az) {
+        cell.normal_bin = local_normal.x >= 0.f ? 0 : 1;
+    } else if (ay >= az) {
+        cell.normal_bin = local_normal.y >= 0.f ? 2 : 3;
+    } else {
+        cell.normal_bin = local_normal.z >= 0.f ? 4 : 5;
+    }
+    return cell;
+}
+
+/**
+ * @brief Construct a surface cache.
+ * @param cell_size Edge length of a cache cell in the body's local frame
+ * @param sun_tolerance Angle the sun may move (relative to a body) before its entries are dropped
+ * @param min_samples Number of observations a cell needs before lookups return it
+ */
+template <typename TValue>
+SurfaceCache<TValue>::SurfaceCache(const units::Meter& cell_size,
+                                   const units::Radian& sun_tolerance,
+                                   int min_samples)
+{
+    set_cell_size(cell_size);
+    set_sun_tolerance(sun_tolerance);
+    set_min_samples(min_samples);
+}
+
+/**
+ * @brief Set the cell edge length. Clears the cache, since existing cells no longer line up.
+ * @param cell_size Edge length of a cache cell
+ */
+template <typename TValue>
+void SurfaceCache<TValue>::set_cell_size(const units::Meter& cell_size)
+{
+    float size = cell_size.to_si_f();
+    if (!(size > 0.f)) {
+        HUIRA_THROW_ERROR("SurfaceCache::set_cell_size - Cell size must be positive");
+    }
+    cell_size_ = size;
+    clear();
+}
+
+/**
+ * @brief Set the angular tolerance on the local sun direction used to decide when to invalidate.
+ * @param sun_tolerance Tolerance angle
+ */
+template <typename TValue>
+void SurfaceCache<TValue>::set_sun_tolerance(const units::Radian& sun_tolerance)
+{
+    float tolerance = sun_tolerance.to_si_f();
+    if (tolerance < 0.f) {
+        HUIRA_THROW_ERROR("SurfaceCache::set_sun_tolerance - Tolerance must be non-negative");
+    }
+    cos_sun_tolerance_ = std::cos(std::min(tolerance, PI<float>()));
+}
+
+/**
+ * @brief Set the number of observations a cell needs before lookups return it.
+ * @param min_samples Minimum observation count (at least 1)
+ */
+template <typename TValue>
+void SurfaceCache<TValue>::set_min_samples(int min_samples)
+{
+    if (min_samples < 1) {
+        HUIRA_THROW_ERROR("SurfaceCache::set_min_samples - Minimum samples must be at least 1");
+    }
+    min_samples_ = min_samples;
+}
+
+/**
+ * @brief Set the observation count at which a cell starts to forget its oldest contributions.
+ *
+ * Once a cell reaches this count its accumulated sum is halved, turning the running mean into an
+ * exponential moving average, so newer observations gradually replace older ones.
+ *
+ * @param max_samples Maximum observation count (must be at least the minimum count)
+ */
+template <typename TValue>
+void SurfaceCache<TValue>::set_max_samples(int max_samples)
+{
+    if (max_samples < min_samples_) {
+        HUIRA_THROW_ERROR(
+            "SurfaceCache::set_max_samples - Maximum samples must not be below minimum samples");
+    }
+    max_samples_ = max_samples;
+}
+
+/**
+ * @brief Record the sun direction for a body, invalidating its entries if it moved too far.
+ * @param body The body whose lighting is being updated
+ * @param local_sun_direction Unit direction to the sun in the body's local frame
+ * @return bool True if the body's existing entries were discarded
+ */
+template <typename TValue>
+bool SurfaceCache<TValue>::update_sun_direction(const SurfaceCacheBody& body,
+                                                const Vec3<float>& local_sun_direction)
+{
+    std::unique_lock lock(mutex_);
+    BodyCache& body_cache = bodies_[body];
+    if (body_cache.has_sun_direction &&
+        glm::dot(body_cache.sun_direction, local_sun_direction) >= cos_sun_tolerance_) {
+        return false;
+    }
+
+    bool invalidated = !body_cache.entries.empty();
+    body_cache.entries.clear();
+    body_cache.sun_direction = local_sun_direction;
+    body_cache.has_sun_direction = true;
+    if (invalidated) {
+        HUIRA_LOG_INFO("SurfaceCache::update_sun_direction - Sun moved beyond tolerance, "
+                       "invalidated cache for primitive " +
+                       std::to_string(body.primitive_id));
+    }
+    return invalidated;
+}
+
+/**
+ * @brief Look up the mean value cached for a cell.
+ * @param body The body that was hit
+ * @param cell The cell that was hit
+ * @return std::optional<TValue> The cached value, if the cell has enough observations
+ */
+template <typename TValue>
+std::optional<TValue> SurfaceCache<TValue>::lookup(const SurfaceCacheBody& body,
+                                                   const SurfaceCacheCell& cell) const
+{
+    std::shared_lock lock(mutex_);
+    auto body_it = bodies_.find(body);
+    if (body_it == bodies_.end()) {
+        return std::nullopt;
+    }
+    auto it = body_it->second.entries.find(cell);
+    if (it == body_it->second.entries.end() || it->second.count < min_samples_) {
+        return std::nullopt;
+    }
+    return it->second.sum / static_cast<float>(it->second.count);
+}
+
+/**
+ * @brief Merge a batch of observations into the cache.
+ *
+ * Renderers gather records per tile and merge them once the frame is done, one call per tile in
+ * tile order, so that the result does not depend on how tiles were scheduled. Lookups made during
+ * a frame therefore only see earlier frames.
+ *
+ * @param records Observations to merge
+ */
+template <typename TValue>
+void SurfaceCache<TValue>::insert(const std::vector<Record>& records)
+{
+    if (records.empty()) {
+        return;
+    }
+
+    std::unique_lock lock(mutex_);
+    for (const auto& record : records) {
+        auto body_it = bodies_.find(record.body);
+        if (body_it == bodies_.end()) {
+            // Bodies are registered through update_sun_direction; anything else is stale.
+            continue;
+        }
+        Entry& entry = body_it->second.entries[record.cell];
+        if (entry.count >= max_samples_) {
+            entry.sum *= 0.5f;
+            entry.count /= 2;
+        }
+        entry.sum += record.value;
+        entry.count++;
+    }
+}
+
+/**
+ * @brief Remove all cached entries and body lighting state.
+ */
+template <typename TValue>
+void SurfaceCache<TValue>::clear()
+{
+    std::unique_lock lock(mutex_);
+    bodies_.clear();
+}
+
+/**
+ * @brief Get the total number of cached cells across all bodies.
+ * @return std::size_t Number of cells
+ */
+template <typename TValue>
+std::size_t SurfaceCache<TValue>::size() const
+{
+    std::shared_lock lock(mutex_);
+    std::size_t total = 0;
+    for (const auto& [body, body_cache] : bodies_) {
+        total += body_cache.entries.size();
+    }
+    return total;
+}
+
+/**
+ * @brief Convert the vertices of a completed path into cache observations.
+ *
+ * The radiance leaving each vertex is everything the path gathered after reaching it, divided by
+ * the throughput on arrival. It is stored normalized by the vertex albedo.
+ *
+ * @param vertices Secondary vertices recorded along the path
+ * @param path_radiance Total radiance gathered by the path
+ * @param records Output list the observations are appended to
+ */
+template <IsSpectral TSpectral>
+void IrradianceCache<TSpectral>::append_records(const std::vector<PathVertex>& vertices,
+                                                const TSpectral& path_radiance,
+                                                std::vector<Record>& records)
+{
+    for (const auto& vertex : vertices) {
+        TSpectral outgoing = path_radiance - vertex.radiance_before;
+        TSpectral value{0};
+        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
+            float denom = vertex.throughput[c] * vertex.albedo[c];
+            if (denom > 0.f) {
+                value[c] = outgoing[c] / denom;
+            }
+        }
+        if (!value.valid()) {
+            continue;
+        }
+        records.push_back({vertex.body, vertex.cell, value});
+    }
+}
+
+} // namespace huira
@@ -11,6 +11,7 @@
 #include "huira/assets/unresolved/unresolved_sphere.hpp"
 #include "huira/concepts/spectral_concepts.hpp"
 #include "huira/geometry/ellipsoid.hpp"
+#include "huira/geometry/io/mesh_cache.hpp"
 #include "huira/geometry/mesh.hpp"
 #include "huira/handles/assets/model_handle.hpp"
 #include "huira/handles/scene/frame_handle.hpp"
@@ -23,9 +24,15 @@
 #include "huira/materials/bsdfs/oren_nayar_bsdf.hpp"
 #include "huira/stars/io/star_catalog.hpp"
 #include "huira/util/colorful_text.hpp"
+#include "huira/util/content_hash.hpp"
 #include "huira/util/logger.hpp"
 #include "huira/volumes/density/constant_density_field.hpp"
+#include "huira/volumes/density/exponential_density_field.hpp"
+#include "huira/volumes/density/grid_density_field.hpp"
+#include "huira/volumes/density/tabulated_density_field.hpp"
+#include "huira/volumes/scattering/henyey_greenstein_phase_function.hpp"
 #include "huira/volumes/scattering/isotropic_scatter.hpp"
+#include "huira/volumes/scattering/rayleigh_phase_function.hpp"
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
 
@@ -132,6 +139,75 @@ MeshHandle<TSpectral> Scene<TSpectral>::add_mesh(const IndexBuffer& index_buffer
     return MeshHandle<TSpectral>{mesh_shared};
 }
 
+/**
+ * @brief Loads a shape model file as a single mesh, through a memory-mapped cache.
+ *
+ * The first load parses the file with ModelLoader::load_mesh(), generates any levels of detail
+ * and writes the result to a mesh cache beside the file (the file name with ".hmesh" appended).
+ * Later loads map that cache instead, which skips parsing, tangent generation and simplification
+ * entirely, and lets Embree build straight from the mapped buffers. The cache is rewritten
+ * whenever the source file's size or modification time, the levels of detail asked for, or the
+ * spectral bins change. A cache that cannot be read is rebuilt, and one that cannot be written is
+ * reported and skipped.
+ *
+ * @param file Path to the shape model
+ * @param name Optional name for the mesh; defaults to the file's stem
+ * @param lod_levels Levels of detail to generate, see Mesh::generate_lods
+ * @param use_cache Whether to read and write the cache
+ * @return MeshHandle<TSpectral> Handle to the added mesh
+ */
+template <IsSpectral TSpectral>
+MeshHandle<TSpectral> Scene<TSpectral>::load_mesh(const fs::path& file,
+                                                  std::string name,
+                                                  std::size_t lod_levels,
+                                                  bool use_cache)
+{
+    if (!fs::exists(file)) {
+        HUIRA_THROW_ERROR("Scene::load_mesh - File not found: " + file.string());
+    }
+
+    ContentHasher options;
+    options.value(static_cast<std::uint64_t>(lod_levels));
+    options.value(ModelLoader<TSpectral>::DEFAULT_POST_PROCESS_FLAGS);
+    const auto bins = TSpectral::get_all_bins();
+    options.values(bins.data(), bins.size());
+    const std::uint64_t key = mesh_cache_key(file, options.digest());
+    fs::path cache_path = file;
+    cache_path += ".hmesh";
+
+    std::shared_ptr<Mesh<TSpectral>> mesh_shared;
+    if (use_cache && mesh_cache_matches<TSpectral>(cache_path, key)) {
+        // A header that matches does not prove the rest of the file is sound, so a cache that
+        // fails to map or validate is reported and rebuilt from the source file:
+        try {
+            mesh_shared = read_mesh_cache<TSpectral>(cache_path);
+        } catch (const std::exception& e) {
+            HUIRA_LOG_WARNING("Scene::load_mesh - Rebuilding unreadable mesh cache: " +
+                              std::string(e.what()));
+        }
+    }
+    if (!mesh_shared) {
+        mesh_shared = ModelLoader<TSpectral>::load_mesh(file);
+        if (lod_levels > 0) {
+            mesh_shared->generate_lods(lod_levels);
+        }
+        if (use_cache) {
+            try {
+                write_mesh_cache(cache_path, *mesh_shared, key);
+            } catch (const std::exception& e) {
+                HUIRA_LOG_WARNING("Scene::load_mesh - Continuing without a mesh cache: " +
+                                  std::string(e.what()));
+            }
+        }
+    }
+
+    if (name.empty()) {
+        name = file.stem().string();
+    }
+    add_geometry(mesh_shared, std::move(name));
+    return MeshHandle<TSpectral>{mesh_shared};
+}
+
 /**
  * @brief Adds an ellipsoid to the scene.
  * @param x Semi-axis length along the x-axis.
@@ -150,6 +226,110 @@ EllipsoidHandle<TSpectral> Scene<TSpectral>::add_ellipsoid(const units::Meter& x
     return EllipsoidHandle<TSpectral>{ellipsoid_shared};
 }
 
+/**
+ * @brief Adds a heightfield built from a row-major raster of elevations.
+ * @param width Samples per row
+ * @param height Number of rows
+ * @param elevations Elevations in metres
+ * @param mapping Where the samples are placed
+ * @param name Optional name for the geometry
+ * @return HeightfieldHandle<TSpectral> Handle to the added heightfield
+ */
+template <IsSpectral TSpectral>
+HeightfieldHandle<TSpectral> Scene<TSpectral>::add_heightfield(std::size_t width,
+                                                               std::size_t height,
+                                                               std::vector<float> elevations,
+                                                               const HeightfieldMapping& mapping,
+                                                               std::string name)
+{
+    auto heightfield_shared =
+        std::make_shared<Heightfield<TSpectral>>(width, height, std::move(elevations), mapping);
+    add_geometry(heightfield_shared, std::move(name));
+    return HeightfieldHandle<TSpectral>{heightfield_shared};
+}
+
+/**
+ * @brief Loads a heightfield from an elevation raster such as a GeoTIFF or FITS DEM.
+ * @param path The raster file
+ * @param mapping Where the samples are placed
+ * @param height_scale Factor from sample values to metres
+ * @param height_offset Metres added after scaling
+ * @param name Optional name for the geometry
+ * @return HeightfieldHandle<TSpectral> Handle to the added heightfield
+ */
+template <IsSpectral TSpectral>
+HeightfieldHandle<TSpectral> Scene<TSpectral>::load_heightfield(const fs::path& path,
+                                                                const HeightfieldMapping& mapping,
+                                                                float height_scale,
+                                                                float height_offset,
+                                                                std::string name)
+{
+    std::size_t width = 0;
+    std::size_t height = 0;
+    auto elevations =
+        Heightfield<TSpectral>::read_raster(path, width, height, height_scale, height_offset);
+    return add_heightfield(width, height, std::move(elevations), mapping, std::move(name));
+}
+
+/**
+ * @brief Loads a heightfield from a headerless raster of 32-bit floats.
+ * @see load_heightfield
+ */
+template <IsSpectral TSpectral>
+HeightfieldHandle<TSpectral>
+Scene<TSpectral>::load_raw_heightfield(const fs::path& path,
+                                       std::size_t width,
+                                       std::size_t height,
+                                       const HeightfieldMapping& mapping,
+                                       float height_scale,
+                                       float height_offset,
+                                       std::string name)
+{
+    auto elevations =
+        Heightfield<TSpectral>::read_raw(path, width, height, height_scale, height_offset);
+    return add_heightfield(width, height, std::move(elevations), mapping, std::move(name));
+}
+
+/**
+ * @brief Adds a cloud of particles, such as dust, ejecta or debris.
+ * @param positions One position per particle, in metres
+ * @param radii One radius per particle, or a single radius for every particle, in metres
+ * @param albedos One albedo per particle, a single albedo for every particle, or none for white
+ * @param shape The primitive each particle is drawn as
+ * @param name Optional name for the geometry
+ * @return ParticleCloudHandle<TSpectral> Handle to the added particle cloud
+ */
+template <IsSpectral TSpectral>
+ParticleCloudHandle<TSpectral>
+Scene<TSpectral>::add_particles(const std::vector<Vec3<float>>& positions,
+                                const std::vector<float>& radii,
+                                std::vector<TSpectral> albedos,
+                                ParticleShape shape,
+                                std::string name)
+{
+    auto cloud_shared =
+        std::make_shared<ParticleCloud<TSpectral>>(positions, radii, std::move(albedos), shape);
+    add_geometry(cloud_shared, std::move(name));
+    return ParticleCloudHandle<TSpectral>{cloud_shared};
+}
+
+/**
+ * @brief Loads a cloud of particles from a headerless file of float32 (x, y, z, radius) records.
+ * @param path The particle file, positions and radii in metres
+ * @param shape The primitive each particle is drawn as
+ * @param name Optional name for the geometry
+ * @return ParticleCloudHandle<TSpectral> Handle to the added particle cloud
+ */
+template <IsSpectral TSpectral>
+ParticleCloudHandle<TSpectral>
+Scene<TSpectral>::load_raw_particles(const fs::path& path, ParticleShape shape, std::string name)
+{
+    auto cloud_shared = std::make_shared<ParticleCloud<TSpectral>>(
+        ParticleCloud<TSpectral>::read_raw(path), std::vector<TSpectral>{}, shape);
+    add_geometry(cloud_shared, std::move(name));
+    return ParticleCloudHandle<TSpectral>{cloud_shared};
+}
+
 /**
  * @brief Adds a geometry to the scene.
  * @param geometry std::shared_ptr to the Geometry object
@@ -338,6 +518,28 @@ void Scene<TSpectral>::delete_primitive(const PrimitiveHandle<TSpectral>& primit
     primitives_.remove(primitive_shared);
 }
 
+/**
+ * @brief Surrounds every instance of a primitive with an atmosphere.
+ *
+ * The atmosphere is centred on the origin of each instance and is evaluated analytically from its
+ * precomputed tables, so the primitive needs no medium of its own for it.
+ *
+ * @param primitive_handle Handle to the primitive
+ * @param atmosphere_handle Handle to the atmosphere
+ */
+template <IsSpectral TSpectral>
+void Scene<TSpectral>::set_atmosphere(const PrimitiveHandle<TSpectral>& primitive_handle,
+                                      const AtmosphereHandle<TSpectral>& atmosphere_handle)
+{
+    if (!primitive_handle.valid()) {
+        HUIRA_THROW_ERROR("Scene::set_atmosphere - Invalid Primitive Handle provided");
+    }
+    if (!atmosphere_handle.valid()) {
+        HUIRA_THROW_ERROR("Scene::set_atmosphere - Invalid Atmosphere Handle provided");
+    }
+    primitive_handle.get()->atmosphere = atmosphere_handle.get();
+}
+
 /**
  * @brief Creates a new sphere light with spectral radiance.
  * @param radius Radius of the sphere light
@@ -738,18 +940,26 @@ void Scene<TSpectral>::delete_camera_model(const CameraModelHandle<TSpectral>& c
 
 /**
  * @brief Loads a model from file and adds it to the scene.
+ *
+ * Textures, meshes and materials identical in content to ones loaded earlier (by this or another
+ * model) are shared rather than duplicated, so edits made through a handle to a shared asset apply
+ * to every model using it.
+ *
  * @param file Path to the model file
  * @param name Optional name
  * @param post_process_flags Flags for post-processing
+ * @param lod_levels Levels of detail to generate for each mesh, see Mesh::generate_lods
  * @return ModelHandle<TSpectral> Handle to the loaded model
  */
 template <IsSpectral TSpectral>
 ModelHandle<TSpectral> Scene<TSpectral>::load_model(const fs::path& file,
                                                     std::string name,
-                                                    unsigned int post_process_flags)
+                                                    unsigned int post_process_flags,
+                                                    std::size_t lod_levels)
 {
     // Load the model using ModelLoader
-    auto model_shared = ModelLoader<TSpectral>::load(*this, file, name, post_process_flags);
+    auto model_shared =
+        ModelLoader<TSpectral>::load(*this, file, name, post_process_flags, lod_levels);
     return ModelHandle<TSpectral>{model_shared};
 }
 
@@ -795,10 +1005,10 @@ BSDFHandle<TSpectral> Scene<TSpectral>::new_bsdf_cook_torrance(std::string name)
 }
 
 template <IsSpectral TSpectral>
-BSDFHandle<TSpectral>
-Scene<TSpectral>::new_bsdf_hapke(float h, float B0, float b, float c, std::string name)
+BSDFHandle<TSpectral> Scene<TSpectral>::new_bsdf_hapke(
+    float h, float B0, float b, float c, std::string name, PhotometricEvaluation evaluation)
 {
-    auto bsdf_shared = std::make_shared<HapkeBSDF<TSpectral>>(h, B0, b, c);
+    auto bsdf_shared = std::make_shared<HapkeBSDF<TSpectral>>(h, B0, b, c, evaluation);
     return add_bsdf(bsdf_shared, name);
 }
 
@@ -817,9 +1027,10 @@ BSDFHandle<TSpectral> Scene<TSpectral>::new_bsdf_lommel_seeliger(std::string nam
 }
 
 template <IsSpectral TSpectral>
-BSDFHandle<TSpectral> Scene<TSpectral>::new_bsdf_mcewen(std::string name)
+BSDFHandle<TSpectral> Scene<TSpectral>::new_bsdf_mcewen(std::string name,
+                                                         PhotometricEvaluation evaluation)
 {
-    auto bsdf_shared = std::make_shared<McEwenBSDF<TSpectral>>();
+    auto bsdf_shared = std::make_shared<McEwenBSDF<TSpectral>>(evaluation);
     return add_bsdf(bsdf_shared, name);
 }
 
@@ -849,16 +1060,7 @@ template <IsSpectral TSpectral>
 MaterialHandle<TSpectral> Scene<TSpectral>::new_material(const BSDFHandle<TSpectral>& bsdf_handle,
                                                          std::string name)
 {
-    auto material =
-        std::shared_ptr<Material<TSpectral>>(new Material<TSpectral>(bsdf_handle.get(),
-                                                                     default_albedo_image_,
-                                                                     default_alpha_image_,
-                                                                     default_metallic_image_,
-                                                                     default_roughness_image_,
-                                                                     default_normal_image_,
-                                                                     default_transmission_image_,
-                                                                     default_emission_image_));
-    return this->add_material(material, name);
+    return this->add_material(make_material_(bsdf_handle.get()), name);
 }
 
 template <IsSpectral TSpectral>
@@ -878,6 +1080,114 @@ DensityFieldHandle<TSpectral> Scene<TSpectral>::new_constant_density_field(TSpec
     return add_density_field(density_field, name);
 }
 
+/**
+ * @brief Create a spherical atmosphere whose density falls off exponentially with altitude.
+ *
+ * The atmosphere is centred on the origin of the instance carrying its medium, and its
+ * coefficients are given per metre at the surface.
+ *
+ * @param planet_radius Radius of the planet surface
+ * @param scale_height Altitude over which the density falls by a factor of e
+ * @param absorption Absorption coefficients at the surface, per metre
+ * @param scattering Scattering coefficients at the surface, per metre
+ * @param name Optional name for the density field
+ * @return DensityFieldHandle<TSpectral> Handle to the new density field
+ */
+template <IsSpectral TSpectral>
+DensityFieldHandle<TSpectral>
+Scene<TSpectral>::new_exponential_density_field(const units::Meter& planet_radius,
+                                                const units::Meter& scale_height,
+                                                TSpectral absorption,
+                                                TSpectral scattering,
+                                                std::string name)
+{
+    auto density_field = std::make_shared<ExponentialDensityField<TSpectral>>(
+        planet_radius.to_si_f(), scale_height.to_si_f(), absorption, scattering);
+    return add_density_field(density_field, name);
+}
+
+/**
+ * @brief Create a spherical atmosphere from a tabulated density profile.
+ * @param planet_radius Radius of the planet surface
+ * @param altitudes Strictly increasing altitudes in metres, the last being the top of the
+ *                  atmosphere
+ * @param densities Density at each altitude relative to the given coefficients
+ * @param absorption Absorption coefficients at unit relative density, per metre
+ * @param scattering Scattering coefficients at unit relative density, per metre
+ * @param name Optional name for the density field
+ * @return DensityFieldHandle<TSpectral> Handle to the new density field
+ */
+template <IsSpectral TSpectral>
+DensityFieldHandle<TSpectral>
+Scene<TSpectral>::new_tabulated_density_field(const units::Meter& planet_radius,
+                                              const std::vector<float>& altitudes,
+                                              const std::vector<float>& densities,
+                                              TSpectral absorption,
+                                              TSpectral scattering,
+                                              std::string name)
+{
+    auto density_field = std::make_shared<TabulatedDensityField<TSpectral>>(
+        planet_radius.to_si_f(), altitudes, densities, absorption, scattering);
+    return add_density_field(density_field, name);
+}
+
+/**
+ * @brief Create a heterogeneous medium from a dense grid of voxel densities.
+ *
+ * The grid is stored sparsely, keeping only bricks of voxels with some density, and tracking
+ * skips the empty ones. It fills an axis-aligned box in the frame of the instance carrying its
+ * medium.
+ *
+ * @param resolution Number of voxels along x, y and z
+ * @param densities Relative density of each voxel, with x varying fastest and z slowest
+ * @param bounds_min Corner of the box with the smallest coordinates
+ * @param bounds_max Corner of the box with the largest coordinates
+ * @param absorption Absorption coefficients at unit relative density, per metre
+ * @param scattering Scattering coefficients at unit relative density, per metre
+ * @param name Optional name for the density field
+ * @return DensityFieldHandle<TSpectral> Handle to the new density field
+ */
+template <IsSpectral TSpectral>
+DensityFieldHandle<TSpectral>
+Scene<TSpectral>::new_grid_density_field(const std::array<std::size_t, 3>& resolution,
+                                         const std::vector<float>& densities,
+                                         const Vec3<float>& bounds_min,
+                                         const Vec3<float>& bounds_max,
+                                         TSpectral absorption,
+                                         TSpectral scattering,
+                                         std::string name)
+{
+    auto density_field = std::make_shared<GridDensityField<TSpectral>>(
+        resolution, densities, bounds_min, bounds_max, absorption, scattering);
+    return add_density_field(density_field, name);
+}
+
+/**
+ * @brief Create a heterogeneous medium from a raw binary grid of 32-bit float densities.
+ * @param path Path to the file, holding one native-endian float per voxel with x varying fastest
+ * @param resolution Number of voxels along x, y and z
+ * @param bounds_min Corner of the box with the smallest coordinates
+ * @param bounds_max Corner of the box with the largest coordinates
+ * @param absorption Absorption coefficients at unit relative density, per metre
+ * @param scattering Scattering coefficients at unit relative density, per metre
+ * @param name Optional name for the density field
+ * @return DensityFieldHandle<TSpectral> Handle to the new density field
+ */
+template <IsSpectral TSpectral>
+DensityFieldHandle<TSpectral>
+Scene<TSpectral>::load_grid_density_field(const fs::path& path,
+                                          const std::array<std::size_t, 3>& resolution,
+                                          const Vec3<float>& bounds_min,
+                                          const Vec3<float>& bounds_max,
+                                          TSpectral absorption,
+                                          TSpectral scattering,
+                                          std::string name)
+{
+    auto densities = GridDensityField<TSpectral>::read_raw(path, resolution);
+    return new_grid_density_field(
+        resolution, densities, bounds_min, bounds_max, absorption, scattering, std::move(name));
+}
+
 template <IsSpectral TSpectral>
 DensityFieldHandle<TSpectral>
 Scene<TSpectral>::add_density_field(std::shared_ptr<DensityField<TSpectral>> density_field,
@@ -894,6 +1204,33 @@ PhaseFunctionHandle<TSpectral> Scene<TSpectral>::new_isotropic_phase_function(st
     return add_phase_function(phase_function, name);
 }
 
+/**
+ * @brief Create a Rayleigh phase function, for scattering by particles much smaller than the
+ * wavelength such as air molecules.
+ * @param name Optional name for the phase function
+ * @return PhaseFunctionHandle<TSpectral> Handle to the new phase function
+ */
+template <IsSpectral TSpectral>
+PhaseFunctionHandle<TSpectral> Scene<TSpectral>::new_rayleigh_phase_function(std::string name)
+{
+    auto phase_function = std::make_shared<RayleighPhaseFunction<TSpectral>>();
+    return add_phase_function(phase_function, name);
+}
+
+/**
+ * @brief Create a Henyey-Greenstein phase function, for scattering by aerosols and dust.
+ * @param g Asymmetry parameter in (-1, 1), positive for forward scattering
+ * @param name Optional name for the phase function
+ * @return PhaseFunctionHandle<TSpectral> Handle to the new phase function
+ */
+template <IsSpectral TSpectral>
+PhaseFunctionHandle<TSpectral>
+Scene<TSpectral>::new_henyey_greenstein_phase_function(float g, std::string name)
+{
+    auto phase_function = std::make_shared<HenyeyGreensteinPhaseFunction<TSpectral>>(g);
+    return add_phase_function(phase_function, name);
+}
+
 template <IsSpectral TSpectral>
 PhaseFunctionHandle<TSpectral>
 Scene<TSpectral>::add_phase_function(std::shared_ptr<PhaseFunction<TSpectral>> phase_function,
@@ -922,10 +1259,52 @@ MediumHandle<TSpectral> Scene<TSpectral>::add_medium(std::shared_ptr<Medium<TSpe
     return MediumHandle<TSpectral>{medium};
 }
 
+/**
+ * @brief Create a planetary atmosphere with precomputed scattering from a set of media.
+ *
+ * Each medium is one constituent of the atmosphere and must have a spherical density field, such
+ * as one from new_exponential_density_field(), all with the same planet radius. Attach the
+ * atmosphere to a primitive with set_atmosphere() to render it around that primitive's instances.
+ *
+ * @param layers Media making up the atmosphere
+ * @param ground_albedo Lambertian albedo of the planet surface, for light it reflects back up
+ * @param name Optional name for the atmosphere
+ * @return AtmosphereHandle<TSpectral> Handle to the new atmosphere
+ */
+template <IsSpectral TSpectral>
+AtmosphereHandle<TSpectral>
+Scene<TSpectral>::new_atmosphere(const std::vector<MediumHandle<TSpectral>>& layers,
+                                 TSpectral ground_albedo,
+                                 std::string name)
+{
+    std::vector<AtmosphereLayer<TSpectral>> atmosphere_layers;
+    atmosphere_layers.reserve(layers.size());
+    for (const auto& layer : layers) {
+        if (!layer.valid()) {
+            HUIRA_THROW_ERROR("Scene::new_atmosphere - Invalid Medium Handle provided");
+        }
+        auto medium = layer.get();
+        atmosphere_layers.push_back({medium->density_field(), medium->phase_function()});
+    }
+    auto atmosphere =
+        std::make_shared<Atmosphere<TSpectral>>(std::move(atmosphere_layers), ground_albedo);
+    return add_atmosphere(atmosphere, name);
+}
+
+template <IsSpectral TSpectral>
+AtmosphereHandle<TSpectral>
+Scene<TSpectral>::add_atmosphere(std::shared_ptr<Atmosphere<TSpectral>> atmosphere,
+                                 std::string name)
+{
+    atmospheres_.add(atmosphere, name);
+    return AtmosphereHandle<TSpectral>{atmosphere};
+}
+
 template <IsSpectral TSpectral>
 void Scene<TSpectral>::set_background_radiance(Image<TSpectral> background)
 {
     background_ = std::make_shared<Image<TSpectral>>(std::move(background));
+    background_->set_layout(ImageLayout::Tiled);
 }
 
 template <IsSpectral TSpectral>
@@ -986,6 +1365,66 @@ TextureHandle<Vec3<float>> Scene<TSpectral>::add_normal_texture(Image<RGB>&& ima
     return add_normal_texture(std::move(image_vec3), name);
 }
 
+/**
+ * @brief Adds a spectral texture stored as compact RGB texels.
+ *
+ * The texture keeps an encoded mip chain (see CompactTexture) and converts
+ * filtered lookups to TSpectral, instead of holding an Image<TSpectral>.
+ *
+ * @param linear_rgb The texture, in linear RGB
+ * @param format Texel storage format
+ * @param name Optional name for the texture
+ * @param basis RGB to spectral conversion applied to lookups
+ * @return TextureHandle<TSpectral> Handle to the texture
+ */
+template <IsSpectral TSpectral>
+TextureHandle<TSpectral>
+Scene<TSpectral>::add_compact_texture(const Image<RGB>& linear_rgb,
+                                      CompactTexelFormat format,
+                                      std::string name,
+                                      const RGBSpectralBasis<TSpectral>& basis)
+{
+    auto compact = std::make_shared<CompactTexture<TSpectral>>(linear_rgb, format, basis);
+    Image<TSpectral> preview = compact->decode_level(compact->preview_level());
+    auto texture = std::make_shared<Texture<TSpectral>>(compact, std::move(preview));
+    spectral_textures_.add(texture, name);
+    return TextureHandle<TSpectral>{texture};
+}
+
+/**
+ * @brief Adds a spectral texture streamed from a virtual texture file.
+ *
+ * Tiles are paged in through default_tile_cache() as rendering touches them.
+ *
+ * @param path Path to a file written by write_virtual_texture()
+ * @param name Optional name for the texture
+ * @return TextureHandle<TSpectral> Handle to the texture
+ */
+template <IsSpectral TSpectral>
+TextureHandle<TSpectral> Scene<TSpectral>::add_virtual_texture(const fs::path& path,
+                                                               std::string name)
+{
+    auto texture =
+        std::make_shared<Texture<TSpectral>>(std::make_shared<VirtualTexture<TSpectral>>(path));
+    spectral_textures_.add(texture, name);
+    return TextureHandle<TSpectral>{texture};
+}
+
+/**
+ * @brief Adds a single-channel texture streamed from a virtual texture file.
+ * @param path Path to a file written by write_virtual_texture()
+ * @param name Optional name for the texture
+ * @return TextureHandle<float> Handle to the texture
+ */
+template <IsSpectral TSpectral>
+TextureHandle<float> Scene<TSpectral>::add_virtual_mono_texture(const fs::path& path,
+                                                                std::string name)
+{
+    auto texture = std::make_shared<Texture<float>>(std::make_shared<VirtualTexture<float>>(path));
+    mono_textures_.add(texture, name);
+    return TextureHandle<float>{texture};
+}
+
 /**
  * @brief Sets the stars in the scene.
  * @param stars Vector of stars
@@ -1395,6 +1834,25 @@ Scene<TSpectral>::find_node_in_tree_(const std::shared_ptr<Node<TSpectral>>& cur
     return nullptr;
 }
 
+/**
+ * @brief Creates a material with the scene's default images, without adding it to the scene.
+ * @param bsdf The material's BSDF
+ * @return std::shared_ptr<Material<TSpectral>> The material
+ */
+template <IsSpectral TSpectral>
+std::shared_ptr<Material<TSpectral>>
+Scene<TSpectral>::make_material_(std::shared_ptr<BSDF<TSpectral>> bsdf) const
+{
+    return std::make_shared<Material<TSpectral>>(std::move(bsdf),
+                                                 default_albedo_image_,
+                                                 default_alpha_image_,
+                                                 default_metallic_image_,
+                                                 default_roughness_image_,
+                                                 default_normal_image_,
+                                                 default_transmission_image_,
+                                                 default_emission_image_);
+}
+
 /**
  * @brief Registers a node name in the node registry.
  * @param node Node to register
@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "embree4/rtcore.h"
@@ -7,9 +13,12 @@
 #include "huira/core/physics.hpp"
 #include "huira/core/time.hpp"
 #include "huira/core/transform.hpp"
+#include "huira/geometry/ellipsoid.hpp"
 #include "huira/geometry/mesh.hpp"
 #include "huira/handles/camera_handle.hpp"
 #include "huira/scene/scene.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 namespace huira {
 /**
@@ -140,7 +149,12 @@ SceneView<TSpectral>::SceneView(const Scene<TSpectral>& scene,
                                                                 lights_);
     }
 
+    collect_atmospheres_();
+
+    build_blases_();
     build_tlas_();
+
+    collect_analytic_bodies_();
 }
 
 /**
@@ -155,11 +169,78 @@ SceneView<TSpectral>::~SceneView()
     }
 }
 
+/**
+ * @brief Gather the atmospheres carried by primitive instances, with the lights they see.
+ *
+ * Lights are treated as distant from each atmosphere, in the direction of their position at the
+ * start of the exposure as seen from the atmosphere's centre.
+ */
+template <IsSpectral TSpectral>
+void SceneView<TSpectral>::collect_atmospheres_()
+{
+    for (const auto& batch : primitives_) {
+        if (!batch.primitive->atmosphere) {
+            continue;
+        }
+        for (const auto& instance : batch.instances) {
+            const Transform<float>& local_to_world = instance[0];
+            AtmosphereInstance<TSpectral> atmosphere{batch.primitive->atmosphere,
+                                                     local_to_world.inverse(),
+                                                     {}};
+
+            const Vec3<float> center = local_to_world.position;
+            for (const auto& light : lights_) {
+                const Transform<float>& light_to_world = light.transforms[0];
+                Vec3<float> to_light = light_to_world.position - center;
+                if (glm::dot(to_light, to_light) <= 0.f) {
+                    continue;
+                }
+                Vec3<float> direction =
+                    atmosphere.world_to_local.apply_to_direction(glm::normalize(to_light));
+                TSpectral irradiance = light.light->irradiance_at(center, light_to_world);
+                atmosphere.lights.push_back({glm::normalize(direction), irradiance});
+            }
+            atmospheres_.push_back(std::move(atmosphere));
+        }
+    }
+
+    if (!atmospheres_.empty()) {
+        HUIRA_LOG_INFO("SceneView collected " + std::to_string(atmospheres_.size()) +
+                       " atmosphere instances.");
+    }
+}
+
+/**
+ * @brief Light scattered towards a ray's origin by every atmosphere, and their transmittance.
+ * @param ray The ray, in world space
+ * @param t_max Ray parameter of the next surface hit, or infinity
+ * @return AtmosphereSegment<TSpectral> In-scattered radiance and transmittance along the ray
+ */
+template <IsSpectral TSpectral>
+AtmosphereSegment<TSpectral>
+SceneView<TSpectral>::integrate_atmospheres(const Ray<TSpectral>& ray, float t_max) const
+{
+    AtmosphereSegment<TSpectral> total;
+    for (const auto& instance : atmospheres_) {
+        Ray<TSpectral> local(instance.world_to_local.apply_to_point(ray.origin()),
+                             instance.world_to_local.apply_to_direction(ray.direction()));
+        auto segment = instance.atmosphere->integrate(local, t_max, instance.lights);
+        total.radiance += total.transmittance * segment.radiance;
+        total.transmittance *= segment.transmittance;
+    }
+    return total;
+}
+
 template <IsSpectral TSpectral>
 struct RayContext : public RTCRayQueryContext {
     const SceneView<TSpectral>* scene_view;
 };
 
+template <IsSpectral TSpectral>
+struct OcclusionContext : public RayContext<TSpectral> {
+    bool crossed_transmissive = false;
+};
+
 /**
  * @brief Intersect a ray with the scene and return the hit record.
  * @param ray The ray to intersect.
@@ -170,6 +251,12 @@ template <IsSpectral TSpectral>
 HitRecord
 SceneView<TSpectral>::intersect(const Ray<TSpectral>& ray, float time, unsigned int mask) const
 {
+    if (analytic_) {
+        HitRecord rec = intersect_analytic_(ray, mask);
+        rec.time = time;
+        return rec;
+    }
+
     RTCRayHit rayhit{};
     rayhit.ray.org_x = ray.origin().x;
     rayhit.ray.org_y = ray.origin().y;
@@ -194,6 +281,10 @@ SceneView<TSpectral>::intersect(const Ray<TSpectral>& ray, float time, unsigned
     RTCIntersectArguments args;
     rtcInitIntersectArguments(&args);
     args.context = &context; // Pass &context directly
+    if (alpha_tested_) {
+        args.flags = RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
+        args.filter = &SceneView<TSpectral>::alpha_filter_;
+    }
 
     // Pass the args into the trace call
     rtcIntersect1(tlas_, &rayhit, &args);
@@ -207,6 +298,7 @@ SceneView<TSpectral>::intersect(const Ray<TSpectral>& ray, float time, unsigned
         rec.geom_id = rayhit.hit.geomID;
         rec.prim_id = rayhit.hit.primID;
         rec.Ng = Vec3<float>{rayhit.hit.Ng_x, rayhit.hit.Ng_y, rayhit.hit.Ng_z};
+        rec.time = time;
     }
     return rec;
 }
@@ -225,6 +317,30 @@ TSpectral SceneView<TSpectral>::evaluate_transmittance(const Ray<TSpectral>& ray
                                                        float time) const
 {
     TSpectral transmittance{1.0f};
+    for (const auto& instance : atmospheres_) {
+        Ray<TSpectral> local(instance.world_to_local.apply_to_point(ray.origin()),
+                             instance.world_to_local.apply_to_direction(ray.direction()));
+        transmittance *= instance.atmosphere->transmittance(local, t_far);
+    }
+    if (transmittance.max() <= 0.0f) {
+        return TSpectral{0.0f};
+    }
+
+    // Most shadow rays only need to know whether anything opaque is in the way, which an
+    // occlusion query answers without resolving hits or evaluating materials. Only rays that
+    // pass through transmissive surfaces need the full walk below:
+    bool crossed_transmissive = false;
+    if (occluded_(ray, t_far, time, crossed_transmissive)) {
+        return TSpectral{0.0f};
+    }
+    if (!crossed_transmissive) {
+        if (const Medium<TSpectral>* active = initial_stack.top(); active != nullptr) {
+            transmittance *= active->evaluate_transmittance(
+                ray, t_far, sampler, initial_stack.top_world_to_local());
+        }
+        return transmittance;
+    }
+
     Ray<TSpectral> current_ray = ray;
     float distance_remaining = t_far;
 
@@ -237,7 +353,8 @@ TSpectral SceneView<TSpectral>::evaluate_transmittance(const Ray<TSpectral>& ray
         const float segment_length = surface_in_range ? hit.t : distance_remaining;
 
         if (const Medium<TSpectral>* active = stack.top(); active != nullptr) {
-            transmittance *= active->evaluate_transmittance(current_ray, segment_length, sampler);
+            transmittance *= active->evaluate_transmittance(
+                current_ray, segment_length, sampler, stack.top_world_to_local());
             if (transmittance.max() <= 0.0f) {
                 return TSpectral{0.0f};
             }
@@ -254,21 +371,6 @@ TSpectral SceneView<TSpectral>::evaluate_transmittance(const Ray<TSpectral>& ray
 
         auto [params, shading_isect] = material->evaluate(isect);
 
-        if (params.opacity < 1.0f) {
-            if (sampler.get_1d() > params.opacity) {
-                Vec3<float> bounce_normal =
-                    (glm::dot(current_ray.direction(), isect.normal_g) < 0.0f) ? -isect.normal_g
-                                                                               : isect.normal_g;
-                current_ray = Ray<TSpectral>(offset_intersection_(isect.position, bounce_normal),
-                                             current_ray.direction());
-
-                stack.toggle(batch.primitive.get());
-
-                distance_remaining -= hit.t;
-                continue;
-            }
-        }
-
         TSpectral surface_transmission = params.transmission;
         if (surface_transmission.max() <= 0.0f) {
             return TSpectral{0.0f};
@@ -282,7 +384,7 @@ TSpectral SceneView<TSpectral>::evaluate_transmittance(const Ray<TSpectral>& ray
         current_ray = Ray<TSpectral>(offset_intersection_(isect.position, bounce_normal),
                                      current_ray.direction());
 
-        stack.toggle(batch.primitive.get());
+        stack.toggle(batch.primitive.get(), batch.instances[mapping.instance_index][0]);
 
         distance_remaining -= hit.t;
     }
@@ -290,6 +392,306 @@ TSpectral SceneView<TSpectral>::evaluate_transmittance(const Ray<TSpectral>& ray
     return transmittance;
 }
 
+/**
+ * @brief Test whether an opaque surface lies along the first t_far units of a ray.
+ *
+ * Alpha cut-outs are skipped as in intersect(). Hits on transmissive surfaces are skipped too,
+ * but reported through crossed_transmissive, since only a full walk can weigh what they let
+ * through.
+ *
+ * @param ray The ray to test.
+ * @param t_far Ray parameter beyond which surfaces are ignored.
+ * @param time The time for motion blur.
+ * @param crossed_transmissive Set if the ray passed through a transmissive surface.
+ * @return true if the ray is blocked.
+ */
+template <IsSpectral TSpectral>
+bool SceneView<TSpectral>::occluded_(const Ray<TSpectral>& ray,
+                                     float t_far,
+                                     float time,
+                                     bool& crossed_transmissive) const
+{
+    if (analytic_) {
+        return occluded_analytic_(ray, t_far, crossed_transmissive);
+    }
+
+    RTCRay shadow_ray{};
+    shadow_ray.org_x = ray.origin().x;
+    shadow_ray.org_y = ray.origin().y;
+    shadow_ray.org_z = ray.origin().z;
+    shadow_ray.dir_x = ray.direction().x;
+    shadow_ray.dir_y = ray.direction().y;
+    shadow_ray.dir_z = ray.direction().z;
+    shadow_ray.tnear = 0.f;
+    shadow_ray.tfar = t_far;
+    shadow_ray.time = time;
+    shadow_ray.mask = MASK_GEOMETRY_;
+    shadow_ray.flags = 0;
+
+    OcclusionContext<TSpectral> context;
+    rtcInitRayQueryContext(&context);
+    context.scene_view = this;
+
+    RTCOccludedArguments args;
+    rtcInitOccludedArguments(&args);
+    args.context = &context;
+    if (alpha_tested_ || has_transmissive_) {
+        args.flags = RTC_RAY_QUERY_FLAG_INVOKE_ARGUMENT_FILTER;
+        args.filter = &SceneView<TSpectral>::occlusion_filter_;
+    }
+
+    rtcOccluded1(tlas_, &shadow_ray, &args);
+
+    crossed_transmissive = context.crossed_transmissive;
+    return shadow_ray.tfar == -std::numeric_limits<float>::infinity();
+}
+
+/**
+ * @brief Indices of the analytic bodies whose bounding spheres a ray passes through.
+ *
+ * The test runs over every body in double precision, which keeps small moons seen from far away
+ * from being culled, and is written as one flat loop over the bounding sphere arrays so that it
+ * vectorizes. Only the survivors get the exact ellipsoid test.
+ *
+ * @param ray The ray to cull against.
+ * @param candidates Filled with the indices of the bodies the ray may hit.
+ * @return The number of candidates.
+ */
+template <IsSpectral TSpectral>
+std::size_t SceneView<TSpectral>::cull_analytic_(
+    const Ray<TSpectral>& ray, std::array<std::uint8_t, ANALYTIC_BODY_LIMIT>& candidates) const
+{
+    const double ox = ray.origin().x;
+    const double oy = ray.origin().y;
+    const double oz = ray.origin().z;
+    const double dx = ray.direction().x;
+    const double dy = ray.direction().y;
+    const double dz = ray.direction().z;
+    const double inv_dd = 1.0 / (dx * dx + dy * dy + dz * dz);
+
+    const std::size_t n = analytic_bodies_.size();
+    std::array<std::uint8_t, ANALYTIC_BODY_LIMIT> overlaps{};
+    for (std::size_t i = 0; i < n; ++i) {
+        double cx = bound_x_[i] - ox;
+        double cy = bound_y_[i] - oy;
+        double cz = bound_z_[i] - oz;
+        double r2 = bound_radius_[i] * bound_radius_[i];
+
+        // Distance from the centre to its closest point on the line:
+        double s = (cx * dx + cy * dy + cz * dz) * inv_dd;
+        double px = cx - s * dx;
+        double py = cy - s * dy;
+        double pz = cz - s * dz;
+        bool crosses = px * px + py * py + pz * pz <= r2;
+        bool ahead = s >= 0.0 || cx * cx + cy * cy + cz * cz <= r2;
+        overlaps[i] = static_cast<std::uint8_t>(crosses && ahead);
+    }
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (overlaps[i] != 0) {
+            candidates[count++] = static_cast<std::uint8_t>(i);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Exact test of a ray against one analytic body, filling the hit as Embree would.
+ */
+template <IsSpectral TSpectral>
+bool SceneView<TSpectral>::hit_analytic_(const AnalyticBody& body,
+                                         const Ray<TSpectral>& ray,
+                                         float t_max,
+                                         HitRecord& hit) const
+{
+    Vec3<float> origin = (body.to_local * (ray.origin() - body.center)) * body.inv_scale;
+    Vec3<float> direction = (body.to_local * ray.direction()) * body.inv_scale;
+    hit.inst_id = body.inst_id;
+    return Ellipsoid<TSpectral>::intersect_local(
+        body.radii, Vec3<double>{origin}, Vec3<double>{direction}, 0.f, t_max, hit);
+}
+
+/**
+ * @brief Closest hit of a ray among the analytic bodies, in place of an Embree query.
+ * @param ray The ray to intersect.
+ * @param mask Only bodies whose mask shares a bit with this are tested.
+ * @return The hit record, with an invalid instance ID if nothing was hit.
+ */
+template <IsSpectral TSpectral>
+HitRecord SceneView<TSpectral>::intersect_analytic_(const Ray<TSpectral>& ray,
+                                                    unsigned int mask) const
+{
+    std::array<std::uint8_t, ANALYTIC_BODY_LIMIT> candidates;
+    std::size_t count = cull_analytic_(ray, candidates);
+
+    HitRecord closest;
+    float t_max = std::numeric_limits<float>::infinity();
+    for (std::size_t k = 0; k < count; ++k) {
+        const AnalyticBody& body = analytic_bodies_[candidates[k]];
+        if ((body.mask & mask) == 0) {
+            continue;
+        }
+        HitRecord hit;
+        if (hit_analytic_(body, ray, t_max, hit)) {
+            closest = hit;
+            t_max = hit.t;
+        }
+    }
+    return closest;
+}
+
+/**
+ * @brief Occlusion test among the analytic bodies, in place of an Embree query.
+ * @see occluded_
+ */
+template <IsSpectral TSpectral>
+bool SceneView<TSpectral>::occluded_analytic_(const Ray<TSpectral>& ray,
+                                              float t_far,
+                                              bool& crossed_transmissive) const
+{
+    std::array<std::uint8_t, ANALYTIC_BODY_LIMIT> candidates;
+    std::size_t count = cull_analytic_(ray, candidates);
+
+    crossed_transmissive = false;
+    for (std::size_t k = 0; k < count; ++k) {
+        const AnalyticBody& body = analytic_bodies_[candidates[k]];
+        if ((body.mask & MASK_GEOMETRY_) == 0) {
+            continue;
+        }
+        HitRecord hit;
+        if (!hit_analytic_(body, ray, t_far, hit)) {
+            continue;
+        }
+        if (!body.transmissive) {
+            return true;
+        }
+        crossed_transmissive = true;
+    }
+    return false;
+}
+
+/**
+ * @brief Embree filter that makes alpha-masked surfaces transparent during traversal.
+ */
+template <IsSpectral TSpectral>
+void SceneView<TSpectral>::alpha_filter_(const RTCFilterFunctionNArguments* args) noexcept
+{
+    const auto* context = static_cast<const RayContext<TSpectral>*>(args->context);
+    for (unsigned int i = 0; i < args->N; ++i) {
+        if (args->valid[i] != 0 && alpha_rejects_(context->scene_view, args, i)) {
+            args->valid[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Embree filter for occlusion queries, which also steps over transmissive surfaces.
+ *
+ * An occlusion query stops at the first hit it accepts, so hits on transmissive surfaces are
+ * rejected here and flagged in the OcclusionContext for evaluate_transmittance() to handle.
+ */
+template <IsSpectral TSpectral>
+void SceneView<TSpectral>::occlusion_filter_(const RTCFilterFunctionNArguments* args) noexcept
+{
+    auto* context = static_cast<OcclusionContext<TSpectral>*>(args->context);
+    const SceneView<TSpectral>* view = context->scene_view;
+    for (unsigned int i = 0; i < args->N; ++i) {
+        if (args->valid[i] == 0) {
+            continue;
+        }
+        if (alpha_rejects_(view, args, i)) {
+            args->valid[i] = 0;
+            continue;
+        }
+
+        unsigned int inst_id = RTCHitN_instID(args->hit, args->N, i, 0);
+        if (inst_id >= view->instance_mappings_.size()) {
+            continue;
+        }
+        const auto& mapping = view->instance_mappings_[inst_id];
+        if (mapping.type == GeometryType::Primitive && view->transmissive_[mapping.batch_index]) {
+            context->crossed_transmissive = true;
+            args->valid[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Whether the alpha test discards hit i of a filter call.
+ *
+ * Hits on primitives with alpha-tested materials are kept with probability equal to the opacity
+ * at the hit, so cut-outs cost a texture lookup in place instead of a new traversal from the root
+ * of the scene. The decision comes from a hash of the ray and the triangle rather than a sampler,
+ * which keeps it consistent if Embree tests the same hit twice.
+ */
+template <IsSpectral TSpectral>
+bool SceneView<TSpectral>::alpha_rejects_(const SceneView<TSpectral>* view,
+                                          const RTCFilterFunctionNArguments* args,
+                                          unsigned int i) noexcept
+{
+    HitRecord hit;
+    hit.inst_id = RTCHitN_instID(args->hit, args->N, i, 0);
+    if (hit.inst_id >= view->instance_mappings_.size()) {
+        return false;
+    }
+    const auto& mapping = view->instance_mappings_[hit.inst_id];
+    if (mapping.type != GeometryType::Primitive) {
+        return false;
+    }
+    const Material<TSpectral>* material = view->alpha_materials_[mapping.batch_index];
+    if (material == nullptr) {
+        return false;
+    }
+
+    hit.geom_id = RTCHitN_geomID(args->hit, args->N, i);
+    hit.prim_id = RTCHitN_primID(args->hit, args->N, i);
+    hit.u = RTCHitN_u(args->hit, args->N, i);
+    hit.v = RTCHitN_v(args->hit, args->N, i);
+    const auto& geometry = view->primitives_[mapping.batch_index].primitive->geometry;
+    float opacity =
+        material->opacity_at(geometry->compute_uv_(*view->builds_[mapping.batch_index], hit));
+    if (opacity >= 1.0f) {
+        return false;
+    }
+
+    Vec3<float> origin{RTCRayN_org_x(args->ray, args->N, i),
+                       RTCRayN_org_y(args->ray, args->N, i),
+                       RTCRayN_org_z(args->ray, args->N, i)};
+    Vec3<float> direction{RTCRayN_dir_x(args->ray, args->N, i),
+                          RTCRayN_dir_y(args->ray, args->N, i),
+                          RTCRayN_dir_z(args->ray, args->N, i)};
+    return alpha_threshold_(origin, direction, hit.inst_id, hit.prim_id) >= opacity;
+}
+
+/**
+ * @brief A uniform number in [0, 1) determined by a ray and the primitive it hit.
+ */
+template <IsSpectral TSpectral>
+float SceneView<TSpectral>::alpha_threshold_(const Vec3<float>& origin,
+                                             const Vec3<float>& direction,
+                                             unsigned int inst_id,
+                                             unsigned int prim_id) noexcept
+{
+    auto mix = [](std::uint32_t h, std::uint32_t value) {
+        h ^= value;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return h;
+    };
+
+    std::uint32_t h = 0x9E3779B9u;
+    for (float value : {origin.x, origin.y, origin.z, direction.x, direction.y, direction.z}) {
+        h = mix(h, std::bit_cast<std::uint32_t>(value));
+    }
+    h = mix(h, inst_id);
+    h = mix(h, prim_id);
+    return static_cast<float>(h >> 8) * 0x1.0p-24f;
+}
+
 /**
  * @brief Resolve a hit record into a full interaction, including position, normals, UVs, etc.
  * @param ray The ray that caused the hit.
@@ -307,7 +709,8 @@ Interaction<TSpectral> SceneView<TSpectral>::resolve_hit(const Ray<TSpectral>& r
     const auto& batch = primitives_[mapping.batch_index];
 
     // Get the hit:
-    batch.primitive->geometry->compute_surface_interaction(hit, isect);
+    batch.primitive->geometry->compute_surface_interaction_(
+        *builds_[mapping.batch_index], hit, isect);
     isect.wo = -ray.direction();
     const auto& instance_transforms = batch.instances[mapping.instance_index];
     const Transform<float>& xf = instance_transforms[0];
@@ -328,6 +731,16 @@ Interaction<TSpectral> SceneView<TSpectral>::resolve_hit(const Ray<TSpectral>& r
         isect.bitangent = -isect.bitangent;
     }
 
+    isect.dpdu = xf.apply_to_direction(isect.dpdu);
+    isect.dpdv = xf.apply_to_direction(isect.dpdv);
+    if (ray.has_differentials()) {
+        compute_uv_differentials(isect,
+                                 ray.rx_origin(),
+                                 ray.rx_direction(),
+                                 ray.ry_origin(),
+                                 ray.ry_direction());
+    }
+
     return isect;
 }
 
@@ -580,14 +993,34 @@ void SceneView<TSpectral>::build_tlas_()
 {
     tlas_ = rtcNewScene(device_->get());
     bool motion_blur = (temporal_samples_.size() != 1);
+
+    alpha_materials_.assign(primitives_.size(), nullptr);
+    transmissive_.assign(primitives_.size(), false);
+    for (std::size_t batch_idx = 0; batch_idx < primitives_.size(); ++batch_idx) {
+        const auto* material = primitives_[batch_idx].primitive->material.get();
+        if (material == nullptr) {
+            continue;
+        }
+        if (material->is_alpha_tested()) {
+            alpha_materials_[batch_idx] = material;
+            alpha_tested_ = true;
+        }
+        if (material->is_transmissive()) {
+            transmissive_[batch_idx] = true;
+            has_transmissive_ = true;
+        }
+    }
+
+    int scene_flags = RTC_SCENE_FLAG_FILTER_FUNCTION_IN_ARGUMENTS;
     if (motion_blur) {
-        rtcSetSceneFlags(tlas_, RTC_SCENE_FLAG_DYNAMIC);
+        scene_flags |= RTC_SCENE_FLAG_DYNAMIC;
     }
+    rtcSetSceneFlags(tlas_, static_cast<RTCSceneFlags>(scene_flags));
 
     // Add Primitives
     for (std::size_t batch_idx = 0; batch_idx < primitives_.size(); ++batch_idx) {
         const auto& batch = primitives_[batch_idx];
-        RTCScene blas = batch.primitive->geometry->blas();
+        RTCScene blas = builds_[batch_idx]->blas.get();
 
         for (std::size_t inst_idx = 0; inst_idx < batch.instances.size(); ++inst_idx) {
             std::size_t N = batch.instances[inst_idx].size();
@@ -710,4 +1143,144 @@ void SceneView<TSpectral>::build_tlas_()
 
     rtcCommitScene(tlas_);
 }
+
+/**
+ * @brief Build, or fetch, the BLAS of every geometry in view, as this view traces it.
+ *
+ * Geometry with levels of detail chooses them for this view's camera, seeing it from every batch
+ * and instance it is shared by at once, so that it can satisfy the closest. Each geometry commits
+ * its own Embree scene, so they are built side by side across the TBB pool rather than one at a
+ * time as build_tlas_ reaches them. The view keeps each build until it is destroyed.
+ */
+template <IsSpectral TSpectral>
+void SceneView<TSpectral>::build_blases_()
+{
+    HUIRA_TRACE_SCOPE("SceneView::build_blases_");
+
+    // Angle subtended by a pixel at the centre of the sensor:
+    const bool has_camera = camera_model_ && !camera_to_world_.empty();
+    float pixel_angle = 0.f;
+    if (has_camera) {
+        const Resolution resolution = camera_model_->resolution();
+        const int cx = resolution.width / 2;
+        const int cy = resolution.height / 2;
+        if (cx + 1 < resolution.width) {
+            Vec3<float> a = glm::normalize(camera_model_->cast_ray(cx, cy).direction());
+            Vec3<float> b = glm::normalize(camera_model_->cast_ray(cx + 1, cy).direction());
+            pixel_angle = std::acos(std::clamp(glm::dot(a, b), -1.f, 1.f));
+        }
+    }
+
+    std::vector<const Geometry<TSpectral>*> pending;
+    std::unordered_map<const Geometry<TSpectral>*, std::vector<Vec3<float>>> eyes;
+    for (const auto& batch : primitives_) {
+        const Geometry<TSpectral>* geometry = batch.primitive->geometry.get();
+        pending.push_back(geometry);
+        auto& local_eyes = eyes[geometry];
+        if (has_camera) {
+            const Vec3<float> eye = camera_to_world_[0].position;
+            for (const auto& instance : batch.instances) {
+                local_eyes.push_back(instance[0].inverse().apply_to_point(eye));
+            }
+        }
+    }
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    std::vector<std::shared_ptr<const GeometryBuild>> built(pending.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, pending.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t i = range.begin(); i != range.end(); ++i) {
+                              built[i] = pending[i]->build_for_view_(eyes.at(pending[i]),
+                                                                     pixel_angle);
+                          }
+                      });
+
+    builds_.resize(primitives_.size());
+    for (std::size_t batch_idx = 0; batch_idx < primitives_.size(); ++batch_idx) {
+        const Geometry<TSpectral>* geometry = primitives_[batch_idx].primitive->geometry.get();
+        auto it = std::lower_bound(pending.begin(), pending.end(), geometry);
+        builds_[batch_idx] = built[static_cast<std::size_t>(it - pending.begin())];
+    }
+}
+
+/**
+ * @brief Decide whether the scene can be traced without Embree, and gather its bodies if so.
+ *
+ * Navigation frames often hold nothing but a planet, a few moons and sphere lights. Tracing
+ * those directly against a short list of bounding spheres skips the TLAS, the instance
+ * transforms and the user geometry callbacks. Scenes with meshes, motion blur, alpha-tested
+ * materials or more than ANALYTIC_BODY_LIMIT bodies keep using Embree.
+ */
+template <IsSpectral TSpectral>
+void SceneView<TSpectral>::collect_analytic_bodies_()
+{
+    analytic_ = false;
+    if (temporal_samples_.size() != 1 || alpha_tested_ ||
+        instance_mappings_.size() > ANALYTIC_BODY_LIMIT) {
+        return;
+    }
+
+    std::vector<AnalyticBody> bodies;
+    std::vector<double> bound_x;
+    std::vector<double> bound_y;
+    std::vector<double> bound_z;
+    std::vector<double> bound_radius;
+    for (std::size_t inst_id = 0; inst_id < instance_mappings_.size(); ++inst_id) {
+        const auto& mapping = instance_mappings_[inst_id];
+
+        Vec3<float> radii;
+        const Transform<float>* xf = nullptr;
+        AnalyticBody body{};
+        if (mapping.type == GeometryType::Primitive) {
+            const auto& batch = primitives_[mapping.batch_index];
+            const auto* ellipsoid =
+                dynamic_cast<const Ellipsoid<TSpectral>*>(batch.primitive->geometry.get());
+            if (ellipsoid == nullptr) {
+                return;
+            }
+            radii = ellipsoid->radii();
+            xf = &batch.instances[mapping.instance_index][0];
+            body.mask = MASK_GEOMETRY_;
+            body.transmissive = transmissive_[mapping.batch_index];
+        } else {
+            const auto& light_inst = lights_[mapping.light_index];
+            const auto* sphere_light =
+                dynamic_cast<const SphereLight<TSpectral>*>(light_inst.light.get());
+            if (sphere_light == nullptr) {
+                return;
+            }
+            float radius = sphere_light->radius().to_si_f();
+            radii = Vec3<float>{radius, radius, radius};
+            xf = &light_inst.transforms[0];
+            body.mask = MASK_LIGHT_;
+            body.transmissive = false;
+        }
+
+        body.radii = Vec3<double>{radii};
+        body.center = xf->position;
+        body.to_local = xf->rotation.inverse();
+        body.inv_scale = Vec3<float>{1.f / xf->scale.x, 1.f / xf->scale.y, 1.f / xf->scale.z};
+        body.inst_id = static_cast<unsigned int>(inst_id);
+        bodies.push_back(body);
+
+        Vec3<float> abs_scale = glm::abs(xf->scale);
+        float extent = std::max({radii.x, radii.y, radii.z}) *
+                       std::max({abs_scale.x, abs_scale.y, abs_scale.z});
+        bound_x.push_back(xf->position.x);
+        bound_y.push_back(xf->position.y);
+        bound_z.push_back(xf->position.z);
+        // Padded so that round-off in the cull never drops a grazing hit:
+        bound_radius.push_back(static_cast<double>(extent) * (1.0 + 1e-4));
+    }
+
+    analytic_bodies_ = std::move(bodies);
+    bound_x_ = std::move(bound_x);
+    bound_y_ = std::move(bound_y);
+    bound_z_ = std::move(bound_z);
+    bound_radius_ = std::move(bound_radius);
+    analytic_ = true;
+    HUIRA_LOG_INFO("SceneView tracing " + std::to_string(analytic_bodies_.size()) +
+                   " analytic bodies directly, without Embree.");
+}
 } // namespace huira
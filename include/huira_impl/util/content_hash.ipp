@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace huira {
+namespace detail {
+inline std::uint64_t splitmix64_mix(std::uint64_t x) noexcept
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+} // namespace detail
+
+/**
+ * @brief Hash a block of bytes.
+ * @param data The bytes
+ * @param size Number of bytes
+ * @return ContentHasher& This hasher, for chaining
+ */
+inline ContentHasher& ContentHasher::bytes(const void* data, std::size_t size)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, p + i, sizeof(word));
+        word_(word);
+    }
+    if (i < size) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, p + i, size - i);
+        word_(word);
+    }
+
+    // Without the length, a trailing zero byte would hash like no byte at all:
+    length_ += size;
+    return *this;
+}
+
+/**
+ * @brief Hash a string, prefixed by its length so consecutive strings cannot run together.
+ * @param text The string
+ * @return ContentHasher& This hasher, for chaining
+ */
+inline ContentHasher& ContentHasher::string(std::string_view text)
+{
+    value(static_cast<std::uint64_t>(text.size()));
+    return bytes(text.data(), text.size());
+}
+
+/**
+ * @brief The hash of everything consumed so far.
+ * @return std::uint64_t The digest
+ */
+inline std::uint64_t ContentHasher::digest() const noexcept
+{
+    return detail::splitmix64_mix(state_ ^ length_);
+}
+
+inline void ContentHasher::word_(std::uint64_t word) noexcept
+{
+    state_ = (state_ ^ detail::splitmix64_mix(word + 0x9E3779B97F4A7C15ull)) * 0x100000001B3ull;
+}
+} // namespace huira
@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "huira/core/constants.hpp"
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace huira {
+/**
+ * @brief Build an atmosphere and precompute its tables.
+ * @param layers The constituents of the atmosphere
+ * @param ground_albedo Lambertian albedo of the planet surface, for light it reflects back up
+ */
+template <IsSpectral TSpectral>
+Atmosphere<TSpectral>::Atmosphere(std::vector<AtmosphereLayer<TSpectral>> layers,
+                                  TSpectral ground_albedo)
+    : layers_{std::move(layers)}, ground_albedo_{ground_albedo}
+{
+    HUIRA_TRACE_SCOPE("Atmosphere::Atmosphere");
+
+    if (layers_.empty()) {
+        HUIRA_THROW_ERROR("Atmosphere::Atmosphere - An atmosphere needs at least one layer");
+    }
+
+    for (const auto& layer : layers_) {
+        const auto* field =
+            dynamic_cast<const SphericalDensityField<TSpectral>*>(layer.density_field.get());
+        if (field == nullptr) {
+            HUIRA_THROW_ERROR("Atmosphere::Atmosphere - Every layer needs a spherical density "
+                              "field, such as an ExponentialDensityField");
+        }
+        if (layer.phase_function == nullptr && field->scattering().max() > 0.f) {
+            HUIRA_THROW_ERROR("Atmosphere::Atmosphere - A scattering layer needs a phase function");
+        }
+        fields_.push_back(field);
+    }
+
+    radius_ = fields_.front()->planet_radius();
+    top_radius_ = radius_;
+    for (const auto* field : fields_) {
+        if (std::abs(field->planet_radius() - radius_) > 1e-4 * radius_) {
+            HUIRA_THROW_ERROR("Atmosphere::Atmosphere - All layers must share one planet radius");
+        }
+        top_radius_ = std::max(top_radius_, radius_ + field->top_altitude());
+    }
+
+    build_transmittance_();
+    build_multiple_scattering_();
+
+    HUIRA_LOG_INFO("Atmosphere - Precomputed tables for " + std::to_string(layers_.size()) +
+                   " layers, " + std::to_string((top_radius_ - radius_) / 1000.0) + " km deep");
+}
+
+/**
+ * @brief Integrate the light scattered towards the origin of a ray, and the ray's transmittance.
+ * @param ray The ray, in the atmosphere's frame
+ * @param t_max Ray parameter of the next surface hit, or infinity
+ * @param lights Distant lights illuminating the atmosphere, in the atmosphere's frame
+ * @return AtmosphereSegment<TSpectral> The in-scattered radiance and the transmittance
+ */
+template <IsSpectral TSpectral>
+AtmosphereSegment<TSpectral>
+Atmosphere<TSpectral>::integrate(const Ray<TSpectral>& ray,
+                                 float t_max,
+                                 const std::vector<AtmosphereLight<TSpectral>>& lights) const
+{
+    AtmosphereSegment<TSpectral> segment;
+    float t0;
+    float t1;
+    if (!clip_(ray, t_max, t0, t1)) {
+        return segment;
+    }
+
+    const float length = glm::length(ray.direction());
+    const Vec3<float> wo = -ray.direction() / length;
+    const float dt = (t1 - t0) / static_cast<float>(INSCATTER_STEPS);
+
+    TSpectral depth{0.f};
+    TSpectral previous{1.f};
+    for (std::size_t i = 0; i < INSCATTER_STEPS; ++i) {
+        float a = t0 + dt * static_cast<float>(i);
+        float b = (i + 1 == INSCATTER_STEPS) ? t1 : a + dt;
+
+        // Transmittance to the step boundaries comes from the column densities, so only the
+        // source term, whose ratio to the extinction varies slowly, is sampled at the midpoint:
+        depth += optical_depth_(ray, a, b);
+        TSpectral next = (-depth).exp();
+
+        Vec3<float> p = ray.at(0.5f * (a + b));
+        float radius = glm::length(p);
+        float altitude = radius - static_cast<float>(radius_);
+
+        TSpectral extinction{0.f};
+        TSpectral source{0.f};
+        TSpectral total_scattering{0.f};
+        for (std::size_t l = 0; l < layers_.size(); ++l) {
+            float rho = fields_[l]->density(altitude);
+            if (!(rho > 0.f)) {
+                continue;
+            }
+            extinction += (fields_[l]->absorption() + fields_[l]->scattering()) * rho;
+            if (layers_[l].phase_function == nullptr) {
+                continue;
+            }
+
+            TSpectral scattering = fields_[l]->scattering() * rho;
+            total_scattering += scattering;
+            for (const auto& light : lights) {
+                float mu_sun = glm::dot(p, light.direction) / radius;
+                float phase = layers_[l].phase_function->evaluate(wo, light.direction);
+                source += scattering * transmittance_to_top(radius, mu_sun) * light.irradiance *
+                          phase;
+            }
+        }
+        for (const auto& light : lights) {
+            float mu_sun = glm::dot(p, light.direction) / radius;
+            source += total_scattering * multiple_scattering(radius, mu_sun) * light.irradiance;
+        }
+
+        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
+            float weight = extinction[c] > 1e-12f ? (previous[c] - next[c]) / extinction[c]
+                                                  : previous[c] * (b - a) * length;
+            segment.radiance[c] += source[c] * weight;
+        }
+        previous = next;
+    }
+
+    segment.transmittance = previous;
+    return segment;
+}
+
+/**
+ * @brief Transmittance along a ray through the atmosphere.
+ * @param ray The ray, in the atmosphere's frame
+ * @param t_max Ray parameter of the end of the segment, or infinity
+ * @return TSpectral The transmittance
+ */
+template <IsSpectral TSpectral>
+TSpectral Atmosphere<TSpectral>::transmittance(const Ray<TSpectral>& ray, float t_max) const
+{
+    float t0;
+    float t1;
+    if (!clip_(ray, t_max, t0, t1)) {
+        return TSpectral{1.f};
+    }
+    return (-optical_depth_(ray, t0, t1)).exp();
+}
+
+/**
+ * @brief Transmittance from a point to the top of the atmosphere, zero if the planet is in the
+ * way.
+ * @param radius Distance of the point from the planet centre, in metres
+ * @param mu Cosine of the angle between the direction and the local vertical
+ * @return TSpectral The transmittance
+ */
+template <IsSpectral TSpectral>
+TSpectral Atmosphere<TSpectral>::transmittance_to_top(float radius, float mu) const
+{
+    double r = std::clamp(static_cast<double>(radius), radius_, top_radius_);
+    double ratio = radius_ / r;
+    double mu_horizon = -std::sqrt(std::max(0.0, 1.0 - ratio * ratio));
+    if (mu < mu_horizon) {
+        return TSpectral{0.f};
+    }
+
+    // Rows are spaced by the square root of altitude, and columns by the square root of the angle
+    // above the horizon:
+    double x = std::sqrt((r - radius_) / (top_radius_ - radius_)) *
+               static_cast<double>(TRANSMITTANCE_RADIUS_SAMPLES - 1);
+    double y = std::sqrt(std::clamp((mu - mu_horizon) / (1.0 - mu_horizon), 0.0, 1.0)) *
+               static_cast<double>(TRANSMITTANCE_ANGLE_SAMPLES - 1);
+
+    auto i = std::min(static_cast<std::size_t>(x), TRANSMITTANCE_RADIUS_SAMPLES - 2);
+    auto j = std::min(static_cast<std::size_t>(y), TRANSMITTANCE_ANGLE_SAMPLES - 2);
+    auto fx = static_cast<float>(x - static_cast<double>(i));
+    auto fy = static_cast<float>(y - static_cast<double>(j));
+
+    const TSpectral* row0 = &transmittance_[i * TRANSMITTANCE_ANGLE_SAMPLES];
+    const TSpectral* row1 = row0 + TRANSMITTANCE_ANGLE_SAMPLES;
+    return (row0[j] * (1.f - fy) + row0[j + 1] * fy) * (1.f - fx) +
+           (row1[j] * (1.f - fy) + row1[j + 1] * fy) * fx;
+}
+
+/**
+ * @brief Radiance from second and higher orders of scattering, per unit irradiance.
+ * @param radius Distance of the point from the planet centre, in metres
+ * @param mu_sun Cosine of the angle between the light and the local vertical
+ * @return TSpectral The mean incident radiance over all directions
+ */
+template <IsSpectral TSpectral>
+TSpectral Atmosphere<TSpectral>::multiple_scattering(float radius, float mu_sun) const
+{
+    constexpr std::size_t n = MULTIPLE_SCATTERING_SAMPLES;
+    double r = std::clamp(static_cast<double>(radius), radius_, top_radius_);
+    double x = std::sqrt((r - radius_) / (top_radius_ - radius_)) * static_cast<double>(n - 1);
+    double y = 0.5 * (std::clamp(static_cast<double>(mu_sun), -1.0, 1.0) + 1.0) *
+               static_cast<double>(n - 1);
+
+    auto i = std::min(static_cast<std::size_t>(x), n - 2);
+    auto j = std::min(static_cast<std::size_t>(y), n - 2);
+    auto fx = static_cast<float>(x - static_cast<double>(i));
+    auto fy = static_cast<float>(y - static_cast<double>(j));
+
+    const TSpectral* row0 = &multiple_scattering_[i * n];
+    const TSpectral* row1 = row0 + n;
+    return (row0[j] * (1.f - fy) + row0[j + 1] * fy) * (1.f - fx) +
+           (row1[j] * (1.f - fy) + row1[j + 1] * fy) * fx;
+}
+
+template <IsSpectral TSpectral>
+void Atmosphere<TSpectral>::build_transmittance_()
+{
+    transmittance_.resize(TRANSMITTANCE_RADIUS_SAMPLES * TRANSMITTANCE_ANGLE_SAMPLES);
+    const double depth = top_radius_ - radius_;
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, TRANSMITTANCE_RADIUS_SAMPLES),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+            for (std::size_t i = range.begin(); i < range.end(); ++i) {
+                double u = static_cast<double>(i) /
+                           static_cast<double>(TRANSMITTANCE_RADIUS_SAMPLES - 1);
+                double r = radius_ + depth * u * u;
+                double ratio = radius_ / r;
+                double mu_horizon = -std::sqrt(std::max(0.0, 1.0 - ratio * ratio));
+                for (std::size_t j = 0; j < TRANSMITTANCE_ANGLE_SAMPLES; ++j) {
+                    double v = static_cast<double>(j) /
+                               static_cast<double>(TRANSMITTANCE_ANGLE_SAMPLES - 1);
+                    double mu = mu_horizon + (1.0 - mu_horizon) * v * v;
+                    double sin_theta = std::sqrt(std::max(0.0, 1.0 - mu * mu));
+                    Ray<TSpectral> ray(
+                        Vec3<float>{0.f, 0.f, static_cast<float>(r)},
+                        Vec3<float>{static_cast<float>(sin_theta), 0.f, static_cast<float>(mu)});
+                    transmittance_[i * TRANSMITTANCE_ANGLE_SAMPLES + j] =
+                        (-optical_depth_(ray, 0.f, std::numeric_limits<float>::infinity())).exp();
+                }
+            }
+        });
+}
+
+/**
+ * @brief Tabulate multiple scattering as in Hillaire (2020).
+ *
+ * At each point, second-order scattering is gathered over a uniform set of directions, marching
+ * each to the ground or the top of the atmosphere. The same march gives the fraction of isotropic
+ * light that is scattered back to the point, and the orders beyond the second follow as a
+ * geometric series in that fraction.
+ */
+template <IsSpectral TSpectral>
+void Atmosphere<TSpectral>::build_multiple_scattering_()
+{
+    constexpr std::size_t n = MULTIPLE_SCATTERING_SAMPLES;
+    constexpr std::size_t directions = MULTIPLE_SCATTERING_DIRECTIONS;
+    constexpr std::size_t steps = MULTIPLE_SCATTERING_STEPS;
+    const float isotropic = 1.f / (4.f * PI<float>());
+    const float golden_angle = PI<float>() * (3.f - std::sqrt(5.f));
+    const double depth = top_radius_ - radius_;
+    const auto planet_radius = static_cast<float>(radius_);
+
+    multiple_scattering_.resize(n * n);
+    auto build_rows = [&](const tbb::blocked_range<std::size_t>& range) {
+        for (std::size_t i = range.begin(); i < range.end(); ++i) {
+            double u = static_cast<double>(i) / static_cast<double>(n - 1);
+            auto r = static_cast<float>(radius_ + depth * u * u);
+            const Vec3<float> x{0.f, 0.f, r};
+
+            for (std::size_t j = 0; j < n; ++j) {
+                float mu_sun = -1.f + 2.f * static_cast<float>(j) / static_cast<float>(n - 1);
+                const Vec3<float> sun{
+                    std::sqrt(std::max(0.f, 1.f - mu_sun * mu_sun)), 0.f, mu_sun};
+
+                TSpectral second_order{0.f};
+                TSpectral transfer{0.f};
+                for (std::size_t k = 0; k < directions; ++k) {
+                    float z = 1.f - (2.f * static_cast<float>(k) + 1.f) /
+                                        static_cast<float>(directions);
+                    float s = std::sqrt(std::max(0.f, 1.f - z * z));
+                    float phi = golden_angle * static_cast<float>(k);
+                    Ray<TSpectral> ray(x, Vec3<float>{s * std::cos(phi), s * std::sin(phi), z});
+
+                    float t0;
+                    float t1;
+                    if (!clip_(ray, std::numeric_limits<float>::infinity(), t0, t1)) {
+                        continue;
+                    }
+                    const float dt = (t1 - t0) / static_cast<float>(steps);
+
+                    TSpectral throughput{1.f};
+                    for (std::size_t step = 0; step < steps; ++step) {
+                        Vec3<float> p = ray.at(t0 + dt * (static_cast<float>(step) + 0.5f));
+                        float radius = glm::length(p);
+                        float altitude = radius - planet_radius;
+                        TSpectral extinction = extinction_(altitude);
+                        TSpectral scattering = scattering_(altitude);
+                        TSpectral step_transmittance = (extinction * -dt).exp();
+                        TSpectral sun_transmittance =
+                            transmittance_to_top(radius, glm::dot(p, sun) / radius);
+
+                        for (std::size_t c = 0; c < TSpectral::size(); ++c) {
+                            float weight = extinction[c] > 1e-12f
+                                               ? (1.f - step_transmittance[c]) / extinction[c]
+                                               : dt;
+                            float scattered = throughput[c] * scattering[c] * weight;
+                            second_order[c] += scattered * sun_transmittance[c] * isotropic;
+                            transfer[c] += scattered;
+                        }
+                        throughput *= step_transmittance;
+                    }
+
+                    // Light reflected by the ground, if this direction reaches it:
+                    Vec3<float> end = ray.at(t1);
+                    float end_radius = glm::length(end);
+                    if (end_radius < planet_radius * 1.0001f) {
+                        float mu_ground = glm::dot(end, sun) / end_radius;
+                        if (mu_ground > 0.f) {
+                            second_order += throughput * ground_albedo_ *
+                                            transmittance_to_top(planet_radius, mu_ground) *
+                                            (mu_ground * INV_PI<float>());
+                        }
+                    }
+                }
+
+                second_order /= static_cast<float>(directions);
+                transfer /= static_cast<float>(directions);
+                for (std::size_t c = 0; c < TSpectral::size(); ++c) {
+                    second_order[c] /= 1.f - std::min(transfer[c], 0.99f);
+                }
+                multiple_scattering_[i * n + j] = second_order;
+            }
+        }
+    };
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), build_rows);
+}
+
+template <IsSpectral TSpectral>
+TSpectral Atmosphere<TSpectral>::optical_depth_(const Ray<TSpectral>& ray,
+                                                float t_min,
+                                                float t_max) const
+{
+    TSpectral depth{0.f};
+    for (const auto* field : fields_) {
+        depth += *field->optical_depth(ray, t_min, t_max);
+    }
+    return depth;
+}
+
+template <IsSpectral TSpectral>
+TSpectral Atmosphere<TSpectral>::extinction_(float altitude) const
+{
+    TSpectral extinction{0.f};
+    for (const auto* field : fields_) {
+        extinction += (field->absorption() + field->scattering()) * field->density(altitude);
+    }
+    return extinction;
+}
+
+template <IsSpectral TSpectral>
+TSpectral Atmosphere<TSpectral>::scattering_(float altitude) const
+{
+    TSpectral scattering{0.f};
+    for (const auto* field : fields_) {
+        scattering += field->scattering() * field->density(altitude);
+    }
+    return scattering;
+}
+
+/**
+ * @brief Clip [0, t_max] to the part of a ray inside the atmosphere and above the ground.
+ * @return bool False if nothing is left
+ */
+template <IsSpectral TSpectral>
+bool Atmosphere<TSpectral>::clip_(const Ray<TSpectral>& ray,
+                                  float t_max,
+                                  float& t0,
+                                  float& t1) const
+{
+    const Vec3<double> o(ray.origin());
+    const Vec3<double> d(ray.direction());
+    double a = glm::dot(d, d);
+    double b = glm::dot(o, d);
+    double oo = glm::dot(o, o);
+    if (!(a > 0.0)) {
+        return false;
+    }
+
+    double discriminant = b * b - a * (oo - top_radius_ * top_radius_);
+    if (!(discriminant > 0.0)) {
+        return false;
+    }
+    double root = std::sqrt(discriminant);
+    double enter = (-b - root) / a;
+    double leave = (-b + root) / a;
+
+    double end = std::min(static_cast<double>(t_max), leave);
+    double ground = b * b - a * (oo - radius_ * radius_);
+    if (ground > 0.0) {
+        double hit = (-b - std::sqrt(ground)) / a;
+        if (hit >= 0.0) {
+            end = std::min(end, hit);
+        }
+    }
+
+    t0 = static_cast<float>(std::max(enter, 0.0));
+    t1 = static_cast<float>(end);
+    return t0 < t1;
+}
+} // namespace huira
@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace fs = std::filesystem;
+
+namespace huira {
+/**
+ * @brief Build a sparse grid from dense voxel densities.
+ * @param resolution Number of voxels along x, y and z
+ * @param densities Relative density of each voxel, with x varying fastest and z slowest
+ * @param bounds_min Corner of the grid's box with the smallest coordinates, in the local frame
+ * @param bounds_max Corner of the grid's box with the largest coordinates, in the local frame
+ * @param absorption Absorption coefficients at unit relative density, per unit length
+ * @param scattering Scattering coefficients at unit relative density, per unit length
+ */
+template <IsSpectral TSpectral>
+GridDensityField<TSpectral>::GridDensityField(const std::array<std::size_t, 3>& resolution,
+                                              const std::vector<float>& densities,
+                                              const Vec3<float>& bounds_min,
+                                              const Vec3<float>& bounds_max,
+                                              TSpectral absorption,
+                                              TSpectral scattering)
+    : resolution_{resolution}, bounds_min_{bounds_min}, bounds_max_{bounds_max},
+      absorption_{absorption}, scattering_{scattering},
+      max_extinction_{(absorption + scattering).max()}
+{
+    HUIRA_TRACE_SCOPE("GridDensityField::GridDensityField");
+
+    std::size_t voxel_count = 1;
+    for (int a = 0; a < 3; ++a) {
+        if (resolution_[a] == 0) {
+            HUIRA_THROW_ERROR("GridDensityField::GridDensityField - Resolution must be non-zero");
+        }
+        if (!(bounds_max_[a] > bounds_min_[a])) {
+            HUIRA_THROW_ERROR("GridDensityField::GridDensityField - Bounds must have positive "
+                              "extent along every axis");
+        }
+        voxel_count *= resolution_[a];
+        bricks_[a] = (resolution_[a] + BRICK_SIZE - 1) / BRICK_SIZE;
+        voxel_size_[a] = (bounds_max_[a] - bounds_min_[a]) / static_cast<float>(resolution_[a]);
+    }
+    if (densities.size() != voxel_count) {
+        HUIRA_THROW_ERROR("GridDensityField::GridDensityField - Expected " +
+                          std::to_string(voxel_count) + " densities, got " +
+                          std::to_string(densities.size()));
+    }
+    for (float density : densities) {
+        if (!(density >= 0.f) || !std::isfinite(density)) {
+            HUIRA_THROW_ERROR("GridDensityField::GridDensityField - Densities must be finite and "
+                              "non-negative");
+        }
+    }
+    for (std::size_t i = 0; i < TSpectral::size(); ++i) {
+        if (absorption[i] < 0.f || scattering[i] < 0.f) {
+            HUIRA_THROW_ERROR("GridDensityField::GridDensityField - Absorption and scattering "
+                              "coefficients must be non-negative");
+        }
+    }
+
+    const std::size_t nx = resolution_[0];
+    const std::size_t ny = resolution_[1];
+    const std::size_t nz = resolution_[2];
+    const std::size_t brick_count = bricks_[0] * bricks_[1] * bricks_[2];
+    auto dense = [&](std::size_t i, std::size_t j, std::size_t k) {
+        return densities[i + nx * (j + ny * k)];
+    };
+
+    // The majorant of a brick covers every voxel that trilinear interpolation reaches from inside
+    // it, which extends one voxel beyond the brick on each side:
+    std::vector<std::uint8_t> occupied(brick_count, 0);
+    brick_majorants_.assign(brick_count, 0.f);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, brick_count),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t b = range.begin(); b != range.end(); ++b) {
+                              std::size_t bx = b % bricks_[0];
+                              std::size_t by = (b / bricks_[0]) % bricks_[1];
+                              std::size_t bz = b / (bricks_[0] * bricks_[1]);
+
+                              std::array<std::size_t, 3> lo;
+                              std::array<std::size_t, 3> hi;
+                              std::array<std::size_t, 3> cell{bx, by, bz};
+                              for (int a = 0; a < 3; ++a) {
+                                  std::size_t start = cell[a] * BRICK_SIZE;
+                                  lo[a] = start > 0 ? start - 1 : 0;
+                                  hi[a] = std::min(start + BRICK_SIZE + 1, resolution_[a]);
+                              }
+
+                              float brick_max = 0.f;
+                              bool any = false;
+                              for (std::size_t k = lo[2]; k < hi[2]; ++k) {
+                                  for (std::size_t j = lo[1]; j < hi[1]; ++j) {
+                                      for (std::size_t i = lo[0]; i < hi[0]; ++i) {
+                                          float value = dense(i, j, k);
+                                          brick_max = std::max(brick_max, value);
+                                          any = any || (value > 0.f &&
+                                                        i / BRICK_SIZE == bx &&
+                                                        j / BRICK_SIZE == by &&
+                                                        k / BRICK_SIZE == bz);
+                                      }
+                                  }
+                              }
+                              brick_majorants_[b] = brick_max;
+                              occupied[b] = any ? 1 : 0;
+                          }
+                      });
+
+    // Copy the occupied bricks into the pool:
+    brick_table_.assign(brick_count, EMPTY_BRICK);
+    for (std::size_t b = 0; b < brick_count; ++b) {
+        if (!occupied[b]) {
+            continue;
+        }
+        std::size_t bx = b % bricks_[0];
+        std::size_t by = (b / bricks_[0]) % bricks_[1];
+        std::size_t bz = b / (bricks_[0] * bricks_[1]);
+
+        brick_table_[b] = static_cast<std::uint32_t>(brick_data_.size() / BRICK_VOXELS);
+        std::size_t offset = brick_data_.size();
+        brick_data_.resize(offset + BRICK_VOXELS, 0.f);
+        for (std::size_t k = 0; k < BRICK_SIZE && bz * BRICK_SIZE + k < nz; ++k) {
+            for (std::size_t j = 0; j < BRICK_SIZE && by * BRICK_SIZE + j < ny; ++j) {
+                for (std::size_t i = 0; i < BRICK_SIZE && bx * BRICK_SIZE + i < nx; ++i) {
+                    brick_data_[offset + i + BRICK_SIZE * (j + BRICK_SIZE * k)] =
+                        dense(bx * BRICK_SIZE + i, by * BRICK_SIZE + j, bz * BRICK_SIZE + k);
+                }
+            }
+        }
+    }
+
+    HUIRA_LOG_INFO("GridDensityField - " + std::to_string(occupied_brick_count()) + " of " +
+                   std::to_string(brick_count) + " bricks occupied");
+}
+
+template <IsSpectral TSpectral>
+MediumProperties<TSpectral> GridDensityField<TSpectral>::evaluate(const Vec3<float>& p) const
+{
+    float rho = density(p);
+    return MediumProperties<TSpectral>{absorption_ * rho, scattering_ * rho};
+}
+
+/**
+ * @brief Relative density at a point, interpolated trilinearly between voxel centres.
+ * @param p The point, in the field's local frame
+ * @return float The relative density, zero outside the grid's box
+ */
+template <IsSpectral TSpectral>
+float GridDensityField<TSpectral>::density(const Vec3<float>& p) const
+{
+    std::array<std::size_t, 3> i0;
+    std::array<std::size_t, 3> i1;
+    std::array<float, 3> w;
+    for (int a = 0; a < 3; ++a) {
+        if (!(p[a] >= bounds_min_[a] && p[a] <= bounds_max_[a])) {
+            return 0.f;
+        }
+        float u = (p[a] - bounds_min_[a]) / voxel_size_[a] - 0.5f;
+        float f = std::floor(u);
+        auto last = static_cast<float>(resolution_[a] - 1);
+        i0[a] = static_cast<std::size_t>(std::clamp(f, 0.f, last));
+        i1[a] = static_cast<std::size_t>(std::clamp(f + 1.f, 0.f, last));
+        w[a] = u - f;
+    }
+
+    auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+    float c00 = lerp(voxel_(i0[0], i0[1], i0[2]), voxel_(i1[0], i0[1], i0[2]), w[0]);
+    float c10 = lerp(voxel_(i0[0], i1[1], i0[2]), voxel_(i1[0], i1[1], i0[2]), w[0]);
+    float c01 = lerp(voxel_(i0[0], i0[1], i1[2]), voxel_(i1[0], i0[1], i1[2]), w[0]);
+    float c11 = lerp(voxel_(i0[0], i1[1], i1[2]), voxel_(i1[0], i1[1], i1[2]), w[0]);
+    return lerp(lerp(c00, c10, w[1]), lerp(c01, c11, w[1]), w[2]);
+}
+
+template <IsSpectral TSpectral>
+std::pair<float, float> GridDensityField<TSpectral>::support(const Ray<TSpectral>& ray) const
+{
+    float t_min = -std::numeric_limits<float>::infinity();
+    float t_max = std::numeric_limits<float>::infinity();
+    if (!clip_(ray, t_min, t_max)) {
+        return {0.f, 0.f};
+    }
+    return {t_min, t_max};
+}
+
+template <IsSpectral TSpectral>
+float GridDensityField<TSpectral>::majorant(const Ray<TSpectral>& ray,
+                                            float t_min,
+                                            float t_max) const
+{
+    float result = 0.f;
+    for_each_majorant_segment(ray, t_min, t_max, [&result](float, float, float majorant) {
+        result = std::max(result, majorant);
+        return true;
+    });
+    return result;
+}
+
+/**
+ * @brief Walk the bricks a ray crosses with a 3D DDA, visiting those that are not empty.
+ *
+ * Bricks are visited in order along the ray, each with the bound on its own extinction, and
+ * bricks whose majorant is zero are skipped without calling visit.
+ */
+template <IsSpectral TSpectral>
+void GridDensityField<TSpectral>::for_each_majorant_segment(
+    const Ray<TSpectral>& ray,
+    float t_min,
+    float t_max,
+    const std::function<bool(float, float, float)>& visit) const
+{
+    if (!clip_(ray, t_min, t_max)) {
+        return;
+    }
+
+    const Vec3<float>& origin = ray.origin();
+    const Vec3<float>& direction = ray.direction();
+    const Vec3<float> entry = ray.at(t_min);
+
+    std::array<std::int64_t, 3> cell;
+    std::array<std::int64_t, 3> step;
+    std::array<float, 3> t_next;
+    std::array<float, 3> t_delta;
+    for (int a = 0; a < 3; ++a) {
+        const float extent = voxel_size_[a] * static_cast<float>(BRICK_SIZE);
+        const auto last = static_cast<std::int64_t>(bricks_[a]) - 1;
+        auto c = static_cast<std::int64_t>(std::floor((entry[a] - bounds_min_[a]) / extent));
+        cell[a] = std::clamp<std::int64_t>(c, 0, last);
+
+        if (direction[a] > 0.f) {
+            step[a] = 1;
+            t_next[a] = (bounds_min_[a] + static_cast<float>(cell[a] + 1) * extent - origin[a]) /
+                        direction[a];
+            t_delta[a] = extent / direction[a];
+        } else if (direction[a] < 0.f) {
+            step[a] = -1;
+            t_next[a] =
+                (bounds_min_[a] + static_cast<float>(cell[a]) * extent - origin[a]) / direction[a];
+            t_delta[a] = -extent / direction[a];
+        } else {
+            step[a] = 0;
+            t_next[a] = std::numeric_limits<float>::infinity();
+            t_delta[a] = std::numeric_limits<float>::infinity();
+        }
+    }
+
+    float t = t_min;
+    while (t < t_max) {
+        int axis = 0;
+        if (t_next[1] < t_next[axis]) {
+            axis = 1;
+        }
+        if (t_next[2] < t_next[axis]) {
+            axis = 2;
+        }
+        const float t_exit = std::min(t_next[axis], t_max);
+
+        auto index = static_cast<std::size_t>(cell[0]) +
+                     bricks_[0] * (static_cast<std::size_t>(cell[1]) +
+                                   bricks_[1] * static_cast<std::size_t>(cell[2]));
+        const float brick_majorant = brick_majorants_[index];
+        if (brick_majorant > 0.f && t_exit > t) {
+            if (!visit(t, t_exit, brick_majorant * max_extinction_)) {
+                return;
+            }
+        }
+        if (t_exit >= t_max) {
+            return;
+        }
+
+        t = std::max(t, t_exit);
+        cell[axis] += step[axis];
+        if (cell[axis] < 0 || cell[axis] >= static_cast<std::int64_t>(bricks_[axis])) {
+            return;
+        }
+        t_next[axis] += t_delta[axis];
+    }
+}
+
+/**
+ * @brief Read a dense grid of relative densities from a raw binary file.
+ *
+ * The file holds nothing but 32-bit floats in native byte order, one per voxel, with x varying
+ * fastest and z slowest, as written by most simulation and volume tools' raw exporters.
+ *
+ * @param path Path to the file
+ * @param resolution Number of voxels along x, y and z
+ * @return std::vector<float> The densities, ready for the GridDensityField constructor
+ */
+template <IsSpectral TSpectral>
+std::vector<float>
+GridDensityField<TSpectral>::read_raw(const fs::path& path,
+                                      const std::array<std::size_t, 3>& resolution)
+{
+    const std::size_t voxel_count = resolution[0] * resolution[1] * resolution[2];
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        HUIRA_THROW_ERROR("GridDensityField::read_raw - Failed to open file for reading: " +
+                          path.string());
+    }
+
+    const auto file_size = static_cast<std::size_t>(fs::file_size(path));
+    if (file_size != voxel_count * sizeof(float)) {
+        HUIRA_THROW_ERROR("GridDensityField::read_raw - " + path.filename().string() + " has " +
+                          std::to_string(file_size) + " bytes, expected " +
+                          std::to_string(voxel_count * sizeof(float)) + " for the resolution");
+    }
+
+    std::vector<float> densities(voxel_count);
+    in.read(reinterpret_cast<char*>(densities.data()),
+            static_cast<std::streamsize>(voxel_count * sizeof(float)));
+    if (!in) {
+        HUIRA_THROW_ERROR("GridDensityField::read_raw - Failed to read " + path.string());
+    }
+    return densities;
+}
+
+template <IsSpectral TSpectral>
+float GridDensityField<TSpectral>::voxel_(std::size_t i, std::size_t j, std::size_t k) const
+{
+    std::size_t b = i / BRICK_SIZE + bricks_[0] * (j / BRICK_SIZE + bricks_[1] * (k / BRICK_SIZE));
+    std::uint32_t brick = brick_table_[b];
+    if (brick == EMPTY_BRICK) {
+        return 0.f;
+    }
+    std::size_t local =
+        i % BRICK_SIZE + BRICK_SIZE * (j % BRICK_SIZE + BRICK_SIZE * (k % BRICK_SIZE));
+    return brick_data_[static_cast<std::size_t>(brick) * BRICK_VOXELS + local];
+}
+
+/**
+ * @brief Clip [t_min, t_max] to the part of a ray inside the grid's box.
+ * @return bool False if nothing is left
+ */
+template <IsSpectral TSpectral>
+bool GridDensityField<TSpectral>::clip_(const Ray<TSpectral>& ray,
+                                        float& t_min,
+                                        float& t_max) const
+{
+    for (int a = 0; a < 3; ++a) {
+        const float o = ray.origin()[a];
+        const float d = ray.direction()[a];
+        if (d == 0.f) {
+            if (o < bounds_min_[a] || o > bounds_max_[a]) {
+                return false;
+            }
+            continue;
+        }
+        float t0 = (bounds_min_[a] - o) / d;
+        float t1 = (bounds_max_[a] - o) / d;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        t_min = std::max(t_min, t0);
+        t_max = std::min(t_max, t1);
+    }
+    return t_min < t_max;
+}
+} // namespace huira
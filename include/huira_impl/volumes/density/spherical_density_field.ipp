@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "huira/util/logger.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace huira {
+/**
+ * @brief Sample a density profile and precompute its column densities.
+ * @param planet_radius Radius of the planet surface, in metres
+ * @param top_altitude Altitude above which the density is zero, in metres
+ * @param absorption Absorption coefficients at unit relative density, per metre
+ * @param scattering Scattering coefficients at unit relative density, per metre
+ * @param profile Relative density as a function of altitude in metres
+ */
+template <IsSpectral TSpectral>
+SphericalDensityField<TSpectral>::SphericalDensityField(
+    float planet_radius,
+    float top_altitude,
+    TSpectral absorption,
+    TSpectral scattering,
+    const std::function<float(float)>& profile)
+    : radius_{planet_radius}, top_radius_{static_cast<double>(planet_radius) + top_altitude},
+      top_altitude_{top_altitude}, absorption_{absorption}, scattering_{scattering},
+      max_extinction_{(absorption + scattering).max()}
+{
+    if (!(planet_radius > 0.f)) {
+        HUIRA_THROW_ERROR("SphericalDensityField::SphericalDensityField - Planet radius must be "
+                          "positive");
+    }
+    if (!(top_altitude > 0.f)) {
+        HUIRA_THROW_ERROR("SphericalDensityField::SphericalDensityField - Top altitude must be "
+                          "positive");
+    }
+    for (std::size_t i = 0; i < TSpectral::size(); ++i) {
+        if (absorption[i] < 0.f || scattering[i] < 0.f) {
+            HUIRA_THROW_ERROR("SphericalDensityField::SphericalDensityField - Absorption and "
+                              "scattering coefficients must be non-negative");
+        }
+    }
+
+    profile_.resize(PROFILE_SAMPLES);
+    for (std::size_t i = 0; i < PROFILE_SAMPLES; ++i) {
+        float altitude = top_altitude_ * static_cast<float>(i) /
+                         static_cast<float>(PROFILE_SAMPLES - 1);
+        profile_[i] = std::max(profile(altitude), 0.f);
+    }
+
+    envelope_.resize(PROFILE_SAMPLES);
+    envelope_.back() = profile_.back();
+    for (std::size_t i = PROFILE_SAMPLES - 1; i-- > 0;) {
+        envelope_[i] = std::max(profile_[i], envelope_[i + 1]);
+    }
+
+    // Rows are spaced by the square root of altitude and columns by the square root of mu, which
+    // puts most samples near the ground and near the horizon, where the column density changes
+    // fastest:
+    columns_.resize(COLUMN_RADIUS_SAMPLES * COLUMN_ANGLE_SAMPLES);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, COLUMN_RADIUS_SAMPLES),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t i = range.begin(); i < range.end(); ++i) {
+                              double u = static_cast<double>(i) /
+                                         static_cast<double>(COLUMN_RADIUS_SAMPLES - 1);
+                              double radius = radius_ + top_altitude_ * u * u;
+                              for (std::size_t j = 0; j < COLUMN_ANGLE_SAMPLES; ++j) {
+                                  double v = static_cast<double>(j) /
+                                             static_cast<double>(COLUMN_ANGLE_SAMPLES - 1);
+                                  columns_[i * COLUMN_ANGLE_SAMPLES + j] =
+                                      static_cast<float>(integrate_column_(radius, v * v));
+                              }
+                          }
+                      });
+}
+
+/**
+ * @brief Evaluate the coefficients at a point in the field's frame.
+ * @param p The point, relative to the planet centre
+ * @return MediumProperties<TSpectral> The absorption and scattering at p
+ */
+template <IsSpectral TSpectral>
+MediumProperties<TSpectral> SphericalDensityField<TSpectral>::evaluate(const Vec3<float>& p) const
+{
+    double radius = glm::length(Vec3<double>(p));
+    float rho = density(static_cast<float>(radius - radius_));
+
+    MediumProperties<TSpectral> props;
+    props.absorption = absorption_ * rho;
+    props.scattering = scattering_ * rho;
+    return props;
+}
+
+/**
+ * @brief The interval of the ray inside the top of the atmosphere.
+ * @param ray The ray, in the field's frame
+ * @return std::pair<float, float> The entry and exit parameters, empty if the ray misses
+ */
+template <IsSpectral TSpectral>
+std::pair<float, float> SphericalDensityField<TSpectral>::support(const Ray<TSpectral>& ray) const
+{
+    const Vec3<double> o(ray.origin());
+    const Vec3<double> d(ray.direction());
+
+    double a = glm::dot(d, d);
+    double b = glm::dot(o, d);
+    double c = glm::dot(o, o) - top_radius_ * top_radius_;
+    double discriminant = b * b - a * c;
+    if (!(discriminant > 0.0) || !(a > 0.0)) {
+        return {0.f, 0.f};
+    }
+
+    double q = -(b + std::copysign(std::sqrt(discriminant), b));
+    double t0 = q / a;
+    double t1 = c / q;
+    if (t0 > t1) {
+        std::swap(t0, t1);
+    }
+    return {static_cast<float>(t0), static_cast<float>(t1)};
+}
+
+/**
+ * @brief Bound the extinction over a segment by the envelope at its lowest point.
+ * @param ray The ray, in the field's frame
+ * @param t_min Start of the segment
+ * @param t_max End of the segment
+ * @return float The largest extinction of any channel on the segment
+ */
+template <IsSpectral TSpectral>
+float SphericalDensityField<TSpectral>::majorant(const Ray<TSpectral>& ray,
+                                                 float t_min,
+                                                 float t_max) const
+{
+    if (!(t_min <= t_max)) {
+        return 0.f;
+    }
+
+    const Vec3<double> o(ray.origin());
+    const Vec3<double> d(ray.direction());
+    double dd = glm::dot(d, d);
+    double closest = dd > 0.0 ? -glm::dot(o, d) / dd : static_cast<double>(t_min);
+    double t = std::clamp(closest, static_cast<double>(t_min), static_cast<double>(t_max));
+
+    double radius = glm::length(o + t * d);
+    return max_extinction_ * envelope_at_(radius - radius_);
+}
+
+/**
+ * @brief The optical depth of a segment from the precomputed column densities.
+ *
+ * The segment is split at the ray's closest approach to the centre. Along the part moving away
+ * from the centre, the column up to the top of the atmosphere at the start less the column at the
+ * end is the column of the part itself. The part moving towards the centre is handled the same
+ * way with the direction reversed.
+ *
+ * @param ray The ray, in the field's frame
+ * @param t_min Start of the segment
+ * @param t_max End of the segment
+ * @return std::optional<TSpectral> The optical depth
+ */
+template <IsSpectral TSpectral>
+std::optional<TSpectral> SphericalDensityField<TSpectral>::optical_depth(const Ray<TSpectral>& ray,
+                                                                         float t_min,
+                                                                         float t_max) const
+{
+    auto [enter, leave] = support(ray);
+    double a = std::max(t_min, enter);
+    double b = std::min(t_max, leave);
+    if (!(a < b)) {
+        return TSpectral{0.f};
+    }
+
+    const Vec3<double> o(ray.origin());
+    const Vec3<double> d(ray.direction());
+    double dd = glm::dot(d, d);
+    double inv_length = 1.0 / std::sqrt(dd);
+    double closest = -glm::dot(o, d) / dd;
+
+    auto column = [&](double t, double sign) {
+        Vec3<double> p = o + t * d;
+        double radius = glm::length(p);
+        double mu = radius > 0.0 ? sign * glm::dot(p, d) * inv_length / radius : 1.0;
+        return column_at_(radius, mu);
+    };
+
+    double total = 0.0;
+    if (a < closest) {
+        double end = std::min(b, closest);
+        total += column(end, -1.0) - column(a, -1.0);
+    }
+    if (b > closest) {
+        double start = std::max(a, closest);
+        total += column(start, 1.0) - column(b, 1.0);
+    }
+    return (absorption_ + scattering_) * static_cast<float>(std::max(total, 0.0));
+}
+
+/**
+ * @brief The relative density at an altitude, interpolated from the sampled profile.
+ * @param altitude Altitude above the planet surface, in metres
+ * @return float The relative density, zero above the top of the atmosphere
+ */
+template <IsSpectral TSpectral>
+float SphericalDensityField<TSpectral>::density(float altitude) const
+{
+    if (!(altitude < top_altitude_)) {
+        return 0.f;
+    }
+
+    float x = std::max(altitude, 0.f) / top_altitude_ * static_cast<float>(PROFILE_SAMPLES - 1);
+    auto i = std::min(static_cast<std::size_t>(x), PROFILE_SAMPLES - 2);
+    float f = x - static_cast<float>(i);
+    return profile_[i] * (1.f - f) + profile_[i + 1] * f;
+}
+
+/**
+ * @brief The column density from a point up to the top of the atmosphere.
+ * @param radius Distance of the point from the planet centre, in metres
+ * @param mu Cosine of the angle between the direction and the local vertical, in [0, 1]
+ * @return float The integrated relative density along the path, in metres
+ */
+template <IsSpectral TSpectral>
+float SphericalDensityField<TSpectral>::column_density(float radius, float mu) const
+{
+    return static_cast<float>(column_at_(radius, mu));
+}
+
+template <IsSpectral TSpectral>
+float SphericalDensityField<TSpectral>::envelope_at_(double altitude) const
+{
+    if (!(altitude < top_altitude_)) {
+        return 0.f;
+    }
+    double x = std::max(altitude, 0.0) / top_altitude_ * static_cast<double>(PROFILE_SAMPLES - 1);
+    return envelope_[std::min(static_cast<std::size_t>(x), PROFILE_SAMPLES - 1)];
+}
+
+template <IsSpectral TSpectral>
+double SphericalDensityField<TSpectral>::column_at_(double radius, double mu) const
+{
+    double altitude = std::clamp(radius - radius_, 0.0, static_cast<double>(top_altitude_));
+    double x = std::sqrt(altitude / top_altitude_) * static_cast<double>(COLUMN_RADIUS_SAMPLES - 1);
+    double y = std::sqrt(std::clamp(mu, 0.0, 1.0)) * static_cast<double>(COLUMN_ANGLE_SAMPLES - 1);
+
+    auto i = std::min(static_cast<std::size_t>(x), COLUMN_RADIUS_SAMPLES - 2);
+    auto j = std::min(static_cast<std::size_t>(y), COLUMN_ANGLE_SAMPLES - 2);
+    double fx = x - static_cast<double>(i);
+    double fy = y - static_cast<double>(j);
+
+    const float* row0 = &columns_[i * COLUMN_ANGLE_SAMPLES];
+    const float* row1 = row0 + COLUMN_ANGLE_SAMPLES;
+    return (row0[j] * (1.0 - fy) + row0[j + 1] * fy) * (1.0 - fx) +
+           (row1[j] * (1.0 - fy) + row1[j + 1] * fy) * fx;
+}
+
+/**
+ * @brief Integrate the profile from a point to the top of the atmosphere with Simpson's rule.
+ *
+ * The path length is parametrised as s = s_top * x^2 so that steps are finest near the start,
+ * where an upward path is densest.
+ */
+template <IsSpectral TSpectral>
+double SphericalDensityField<TSpectral>::integrate_column_(double radius, double mu) const
+{
+    double s_top =
+        -radius * mu +
+        std::sqrt(std::max(0.0, top_radius_ * top_radius_ - radius * radius * (1.0 - mu * mu)));
+    if (!(s_top > 0.0)) {
+        return 0.0;
+    }
+
+    auto integrand = [&](double x) {
+        double s = s_top * x * x;
+        double r = std::sqrt(radius * radius + s * s + 2.0 * radius * mu * s);
+        return static_cast<double>(density(static_cast<float>(r - radius_))) * 2.0 * s_top * x;
+    };
+
+    const double h = 1.0 / static_cast<double>(COLUMN_STEPS);
+    double sum = integrand(0.0) + integrand(1.0);
+    for (std::size_t k = 1; k < COLUMN_STEPS; ++k) {
+        sum += integrand(static_cast<double>(k) * h) * ((k % 2 == 1) ? 4.0 : 2.0);
+    }
+    return sum * h / 3.0;
+}
+} // namespace huira
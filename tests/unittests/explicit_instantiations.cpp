@@ -45,6 +45,7 @@
 #include "huira/render/interaction.hpp"
 #include "huira/render/renderer.hpp"
 #include "huira/render/sampler.hpp"
+#include "huira/render/surface_cache.hpp"
 
 // scene/
 #include "huira/scene/frame_node.hpp"
@@ -90,6 +91,9 @@ template class Image<TestSpectral>;
 
 template class SphereLight<TestSpectral>;
 
+template class SurfaceCache<TestSpectral>;
+template class IrradianceCache<TestSpectral>;
+template class ShadowCache<TestSpectral>;
 template class Renderer<TestSpectral>;
 
 template class Node<TestSpectral>;
@@ -0,0 +1,96 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/scene/scene.hpp"
+
+using namespace huira;
+namespace fs = std::filesystem;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+
+// A tetrahedron named "cube", shaded with a red material, scaled by the given factor so that
+// models of different sizes hold the same names but different vertices:
+fs::path write_model(const std::string& stem, double scale)
+{
+    const fs::path dir = fs::temp_directory_path();
+    {
+        std::ofstream mtl(dir / "huira_test_shared.mtl");
+        mtl << "newmtl red\nKd 0.8 0.2 0.2\n";
+    }
+
+    const fs::path path = dir / (stem + ".obj");
+    std::ofstream obj(path);
+    obj << "mtllib huira_test_shared.mtl\no cube\n";
+    obj << "v 0 0 0\nv " << scale << " 0 0\nv 0 " << scale << " 0\nv 0 0 " << scale << "\n";
+    obj << "usemtl red\nf 1 3 2\nf 1 2 4\nf 1 4 3\nf 2 3 4\n";
+    return path;
+}
+
+void remove_models()
+{
+    const fs::path dir = fs::temp_directory_path();
+    fs::remove(dir / "huira_test_shared.mtl");
+    fs::remove(dir / "huira_test_shared.obj");
+    fs::remove(dir / "huira_test_scaled.obj");
+}
+} // namespace
+
+TEST_CASE("ModelLoader - Shared assets", "[assets][model_loader]")
+{
+    const fs::path path = write_model("huira_test_shared", 1.0);
+    const fs::path scaled = write_model("huira_test_scaled", 2.0);
+
+    Scene<Spectral> scene;
+    scene.load_model(path, "first");
+    scene.load_model(path, "second");
+
+    // The second load reuses the first one's mesh, material and primitive:
+    auto primitive = scene.get_primitive("cube").get();
+    REQUIRE_THROWS(scene.get_primitive("cube_1"));
+
+    // A model with the same names and material but other vertices shares only the material:
+    scene.load_model(scaled, "scaled");
+    auto other = scene.get_primitive("cube_1").get();
+    REQUIRE(other->geometry != primitive->geometry);
+    REQUIRE(other->material == primitive->material);
+
+    remove_models();
+}
+
+TEST_CASE("ModelLoader - Edited assets are not shared", "[assets][model_loader]")
+{
+    const fs::path path = write_model("huira_test_shared", 1.0);
+
+    SECTION("Material")
+    {
+        Scene<Spectral> scene;
+        scene.load_model(path, "first");
+        auto primitive = scene.get_primitive("cube").get();
+        MaterialHandle<Spectral>{primitive->material}.set_albedo_factor(Spectral{0.5f});
+
+        scene.load_model(path, "second");
+        auto reloaded = scene.get_primitive("cube_1").get();
+        REQUIRE(reloaded->material != primitive->material);
+        REQUIRE(reloaded->geometry == primitive->geometry);
+    }
+
+    SECTION("Mesh")
+    {
+        Scene<Spectral> scene;
+        scene.load_model(path, "first");
+        auto primitive = scene.get_primitive("cube").get();
+        MeshHandle<Spectral>{primitive->geometry}.set_lod_pixel_error(4.0f);
+
+        scene.load_model(path, "second");
+        auto reloaded = scene.get_primitive("cube_1").get();
+        REQUIRE(reloaded->geometry != primitive->geometry);
+        REQUIRE(reloaded->material == primitive->material);
+    }
+
+    remove_models();
+}
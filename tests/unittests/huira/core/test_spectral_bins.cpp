@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "catch2/catch_template_test_macros.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+
+using namespace huira;
+
+// Sizes chosen to exercise every SIMD width plus a scalar tail
+using Spectral1 = UniformSpectralBins<1, 380, 750>;
+using Spectral13 = UniformSpectralBins<13, 380, 750>;
+using Spectral37 = UniformSpectralBins<37, 380, 750>;
+
+template <typename TSpectral>
+TSpectral make_ramp(float offset, float scale)
+{
+    TSpectral s;
+    for (std::size_t i = 0; i < TSpectral::size(); ++i) {
+        s[i] = offset + scale * static_cast<float>(i);
+    }
+    return s;
+}
+
+TEMPLATE_TEST_CASE("SpectralBins - Arithmetic matches per-bin evaluation",
+                   "[spectral_bins][simd]",
+                   Spectral1,
+                   RGB,
+                   Visible8,
+                   Spectral13,
+                   Spectral37)
+{
+    const TestType a = make_ramp<TestType>(1.5f, 1.f);
+    const TestType b = make_ramp<TestType>(2.f, 0.5f);
+    const TestType c = make_ramp<TestType>(-3.f, 0.25f);
+
+    SECTION("Array-array operators")
+    {
+        TestType sum = a + b;
+        TestType diff = a - b;
+        TestType prod = a * b;
+        TestType quot = a / b;
+        for (std::size_t i = 0; i < TestType::size(); ++i) {
+            REQUIRE_THAT(sum[i], Catch::Matchers::WithinRel(a[i] + b[i], 1e-6f));
+            REQUIRE_THAT(diff[i], Catch::Matchers::WithinAbs(a[i] - b[i], 1e-6));
+            REQUIRE_THAT(prod[i], Catch::Matchers::WithinRel(a[i] * b[i], 1e-6f));
+            REQUIRE_THAT(quot[i], Catch::Matchers::WithinRel(a[i] / b[i], 1e-6f));
+        }
+    }
+
+    SECTION("Array-scalar operators")
+    {
+        TestType scaled = a * 3.0;
+        TestType shifted = a - 2;
+        for (std::size_t i = 0; i < TestType::size(); ++i) {
+            REQUIRE_THAT(scaled[i], Catch::Matchers::WithinRel(a[i] * 3.f, 1e-6f));
+            REQUIRE_THAT(shifted[i], Catch::Matchers::WithinAbs(a[i] - 2.f, 1e-6));
+        }
+    }
+
+    SECTION("Fused multiply-add")
+    {
+        TestType f = fma(a, b, c);
+        TestType fs = fma(a, 0.5f, c);
+        for (std::size_t i = 0; i < TestType::size(); ++i) {
+            REQUIRE_THAT(f[i], Catch::Matchers::WithinAbs(a[i] * b[i] + c[i], 1e-4));
+            REQUIRE_THAT(fs[i], Catch::Matchers::WithinAbs(a[i] * 0.5f + c[i], 1e-4));
+        }
+    }
+
+    SECTION("Reductions")
+    {
+        float total = 0.f;
+        float sum_sq = 0.f;
+        float max_val = c[0];
+        float min_val = c[0];
+        for (std::size_t i = 0; i < TestType::size(); ++i) {
+            total += c[i];
+            sum_sq += c[i] * c[i];
+            max_val = std::max(max_val, c[i]);
+            min_val = std::min(min_val, c[i]);
+        }
+        REQUIRE_THAT(c.total(), Catch::Matchers::WithinAbs(total, 1e-4));
+        REQUIRE_THAT(c.magnitude(), Catch::Matchers::WithinRel(std::sqrt(sum_sq), 1e-5f));
+        REQUIRE(c.max() == max_val);
+        REQUIRE(c.min() == min_val);
+    }
+
+    SECTION("Exponential")
+    {
+        TestType e = (c * -0.5f).exp();
+        for (std::size_t i = 0; i < TestType::size(); ++i) {
+            REQUIRE_THAT(e[i], Catch::Matchers::WithinRel(std::exp(-0.5f * c[i]), 1e-6f));
+        }
+    }
+
+    SECTION("Constant evaluation")
+    {
+        constexpr TestType k = TestType(1.f) + TestType(2.f) * 2.f;
+        STATIC_REQUIRE(k[0] == 5.f);
+    }
+}
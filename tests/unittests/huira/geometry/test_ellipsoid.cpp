@@ -0,0 +1,131 @@
+#include <cmath>
+#include <limits>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/geometry/ellipsoid.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+using Body = Ellipsoid<Spectral>;
+
+constexpr float NO_LIMIT = std::numeric_limits<float>::infinity();
+
+Vec3<float> unit_normal(const HitRecord& hit)
+{
+    return glm::normalize(hit.Ng);
+}
+} // namespace
+
+TEST_CASE("Ellipsoid - Far rays", "[geometry][ellipsoid]")
+{
+    // A moon-sized body seen from 1e8 m, where single precision would leave metres of error:
+    const Vec3<double> radii{2.5e5, 2.4e5, 2.3e5};
+    const Vec3<double> origin{1e8, 3e4, -2e4};
+    const Vec3<double> direction{-1.0, 0.0, 0.0};
+
+    HitRecord hit;
+    hit.inst_id = 7;
+    REQUIRE(Body::intersect_local(radii, origin, direction, 0.f, NO_LIMIT, hit));
+
+    const double surface_x =
+        radii.x * std::sqrt(1.0 - (origin.y / radii.y) * (origin.y / radii.y) -
+                            (origin.z / radii.z) * (origin.z / radii.z));
+    REQUIRE_THAT(hit.t, WithinRel(origin.x - surface_x, 1e-7));
+    REQUIRE(hit.inst_id == 7);
+
+    // The normal is the gradient of the surface at the hit:
+    const Vec3<double> p = origin + static_cast<double>(hit.t) * direction;
+    const Vec3<float> expected{glm::normalize(p / (radii * radii))};
+    const Vec3<float> normal = unit_normal(hit);
+    REQUIRE_THAT(normal.x, WithinAbs(expected.x, 1e-5));
+    REQUIRE_THAT(normal.y, WithinAbs(expected.y, 1e-5));
+    REQUIRE_THAT(normal.z, WithinAbs(expected.z, 1e-5));
+
+    // Directions need not be unit length:
+    HitRecord scaled;
+    REQUIRE(Body::intersect_local(radii, origin, 1e-3 * direction, 0.f, NO_LIMIT, scaled));
+    REQUIRE_THAT(scaled.t, WithinRel(1e3 * (origin.x - surface_x), 1e-7));
+
+    // A ray passing just outside the body misses:
+    HitRecord miss;
+    const Vec3<double> beside{1e8, 2.4e5 * 1.001, 0.0};
+    REQUIRE_FALSE(Body::intersect_local(radii, beside, direction, 0.f, NO_LIMIT, miss));
+    REQUIRE_FALSE(miss.hit());
+}
+
+TEST_CASE("Ellipsoid - Grazing rays", "[geometry][ellipsoid]")
+{
+    // Powers of two keep the tangent ray exactly tangent:
+    const Vec3<double> radii{1024.0, 1024.0, 1024.0};
+    const Vec3<double> direction{1.0, 0.0, 0.0};
+
+    HitRecord tangent;
+    REQUIRE(Body::intersect_local(
+        radii, Vec3<double>{-1048576.0, 1024.0, 0.0}, direction, 0.f, NO_LIMIT, tangent));
+    REQUIRE_THAT(tangent.t, WithinRel(1048576.0, 1e-7));
+    REQUIRE_THAT(unit_normal(tangent).y, WithinAbs(1.0, 1e-6));
+
+    // A millimetre inside the limb, the ray enters the body about 1.4 m before reaching it:
+    HitRecord inside;
+    REQUIRE(Body::intersect_local(
+        radii, Vec3<double>{-1048576.0, 1023.999, 0.0}, direction, 0.f, NO_LIMIT, inside));
+    const double half_chord = std::sqrt(1024.0 * 1024.0 - 1023.999 * 1023.999);
+    REQUIRE_THAT(inside.t, WithinAbs(1048576.0 - half_chord, 0.2));
+    REQUIRE(inside.t < 1048576.f);
+
+    // A millimetre outside, it misses:
+    HitRecord outside;
+    REQUIRE_FALSE(Body::intersect_local(
+        radii, Vec3<double>{-1048576.0, 1024.001, 0.0}, direction, 0.f, NO_LIMIT, outside));
+}
+
+TEST_CASE("Ellipsoid - Origin inside", "[geometry][ellipsoid]")
+{
+    const Vec3<double> radii{3.0, 2.0, 1.0};
+    const Vec3<double> origin{0.5, 0.2, 0.1};
+
+    // Only the crossing ahead of the ray counts, where the normal points out of the body:
+    HitRecord hit;
+    REQUIRE(Body::intersect_local(radii, origin, Vec3<double>{0.0, 0.0, 1.0}, 0.f, NO_LIMIT, hit));
+    const double surface_z = std::sqrt(1.0 - (0.5 / 3.0) * (0.5 / 3.0) - 0.1 * 0.1);
+    REQUIRE_THAT(hit.t, WithinAbs(surface_z - 0.1, 1e-6));
+    REQUIRE(unit_normal(hit).z > 0.f);
+
+    HitRecord back;
+    REQUIRE(
+        Body::intersect_local(radii, origin, Vec3<double>{0.0, 0.0, -1.0}, 0.f, NO_LIMIT, back));
+    REQUIRE_THAT(back.t, WithinAbs(surface_z + 0.1, 1e-6));
+    REQUIRE(unit_normal(back).z < 0.f);
+}
+
+TEST_CASE("Ellipsoid - Ray extent", "[geometry][ellipsoid]")
+{
+    // A unit sphere crossed at t = 4 and t = 6:
+    const Vec3<double> radii{1.0, 1.0, 1.0};
+    const Vec3<double> origin{0.0, 0.0, -5.0};
+    const Vec3<double> direction{0.0, 0.0, 1.0};
+
+    HitRecord hit;
+    REQUIRE_FALSE(Body::intersect_local(radii, origin, direction, 0.f, 3.f, hit));
+
+    REQUIRE(Body::intersect_local(radii, origin, direction, 0.f, 5.f, hit));
+    REQUIRE_THAT(hit.t, WithinAbs(4.0, 1e-6));
+    REQUIRE_THAT(unit_normal(hit).z, WithinAbs(-1.0, 1e-6));
+
+    // Starting past the front face, the back face is hit:
+    REQUIRE(Body::intersect_local(radii, origin, direction, 4.5f, NO_LIMIT, hit));
+    REQUIRE_THAT(hit.t, WithinAbs(6.0, 1e-6));
+    REQUIRE_THAT(unit_normal(hit).z, WithinAbs(1.0, 1e-6));
+
+    HitRecord between;
+    REQUIRE_FALSE(Body::intersect_local(radii, origin, direction, 4.5f, 5.5f, between));
+
+    // Behind the ray, nothing is hit:
+    REQUIRE_FALSE(Body::intersect_local(radii, origin, -direction, 0.f, NO_LIMIT, between));
+}
@@ -0,0 +1,125 @@
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/geometry/heightfield.hpp"
+
+using namespace huira;
+using namespace huira::units::literals;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+using Field = Heightfield<Spectral>;
+
+constexpr std::size_t WIDTH = 300;
+constexpr std::size_t HEIGHT = 200;
+
+// A tilted plane, 2 m between samples, rising along the columns and falling along the rows:
+Field make_plane()
+{
+    std::vector<float> elevations(WIDTH * HEIGHT);
+    for (std::size_t row = 0; row < HEIGHT; ++row) {
+        for (std::size_t col = 0; col < WIDTH; ++col) {
+            elevations[row * WIDTH + col] =
+                0.5f * static_cast<float>(col) - 0.25f * static_cast<float>(row) + 10.f;
+        }
+    }
+    return Field(WIDTH, HEIGHT, std::move(elevations), HeightfieldMapping::planar(2.0_m));
+}
+} // namespace
+
+TEST_CASE("Heightfield - Tiles", "[geometry][heightfield]")
+{
+    Field field = make_plane();
+    REQUIRE(field.width() == WIDTH);
+    REQUIRE(field.height() == HEIGHT);
+    REQUIRE(field.elevation(4, 2) == 11.5f);
+
+    // 299 x 199 cells, split into tiles of at most 128 cells a side:
+    REQUIRE(field.tile_count() == 3 * 2);
+
+    // Samples are centred on the origin, with rows running along -y:
+    Vec3<float> corner = field.position(0.0, 0.0);
+    REQUIRE_THAT(corner.x, WithinAbs(-299.0, 1e-4));
+    REQUIRE_THAT(corner.y, WithinAbs(199.0, 1e-4));
+    REQUIRE_THAT(corner.z, WithinAbs(10.0, 1e-4));
+
+    REQUIRE_THROWS(Field(1, 4, std::vector<float>(4), HeightfieldMapping::planar(1.0_m)));
+    REQUIRE_THROWS(Field(4, 4, std::vector<float>(15), HeightfieldMapping::planar(1.0_m)));
+    REQUIRE_THROWS(Field(4, 4, std::vector<float>(16), HeightfieldMapping::planar(0.0_m)));
+}
+
+TEST_CASE("Heightfield - Level selection", "[geometry][heightfield]")
+{
+    Field field = make_plane();
+
+    // Without a camera every tile stays at full resolution:
+    REQUIRE(field.select_tile_levels({}, 1e-3f) == std::vector<std::uint8_t>(6, 0));
+
+    // Seen from far away, each tile drops to its coarsest level, a single cell across its longer
+    // side. The last tile is 43 x 71 cells:
+    const std::vector<Vec3<float>> far{{0.f, 0.f, 1e6f}};
+    std::vector<std::uint8_t> levels = field.select_tile_levels(far, 1e-3f);
+    REQUIRE(levels == std::vector<std::uint8_t>{7, 7, 7, 7, 7, 6});
+
+    // Seen from just above the first tile, it keeps full resolution, while the far corner of the
+    // raster may be coarser:
+    const std::vector<Vec3<float>> near{field.position(0.0, 0.0) + Vec3<float>{0.f, 0.f, 10.f}};
+    levels = field.select_tile_levels(near, 0.05f);
+    REQUIRE(levels[0] == 0);
+    REQUIRE(levels[5] > 0);
+
+    // The nearest of several eyes decides:
+    levels = field.select_tile_levels({far[0], near[0]}, 0.05f);
+    REQUIRE(levels[0] == 0);
+
+    const auto revision = field.revision();
+    field.set_lod_pixels(0.f);
+    REQUIRE(field.revision() > revision);
+    REQUIRE(field.select_tile_levels(far, 1e-3f) == std::vector<std::uint8_t>(6, 0));
+
+    REQUIRE_THROWS(field.set_lod_pixels(-1.f));
+    REQUIRE_THROWS(field.set_lod_pixels(std::numeric_limits<float>::infinity()));
+    REQUIRE_THROWS(field.set_lod_pixels(std::numeric_limits<float>::quiet_NaN()));
+    REQUIRE(field.lod_pixels() == 0.f);
+}
+
+TEST_CASE("Heightfield - Surface interaction", "[geometry][heightfield]")
+{
+    Field field = make_plane();
+
+    // Grid coordinates of column 10.5, row 20.25 in the first tile, whose 129 samples a side are
+    // ringed by a skirt:
+    HitRecord hit;
+    hit.prim_id = 0;
+    hit.u = 11.5f / 130.f;
+    hit.v = 21.25f / 130.f;
+    Interaction<Spectral> isect;
+    field.compute_surface_interaction(hit, isect);
+
+    REQUIRE_THAT(isect.position.x, WithinAbs((10.5 - 149.5) * 2.0, 1e-3));
+    REQUIRE_THAT(isect.position.y, WithinAbs((99.5 - 20.25) * 2.0, 1e-3));
+    REQUIRE_THAT(isect.position.z, WithinAbs(0.5 * 10.5 - 0.25 * 20.25 + 10.0, 1e-3));
+
+    const Vec3<float> expected = field.position(10.5, 20.25);
+    REQUIRE_THAT(isect.position.z, WithinAbs(expected.z, 1e-3));
+
+    REQUIRE_THAT(isect.uv.x, WithinAbs(10.5 / 299.0, 1e-5));
+    REQUIRE_THAT(isect.uv.y, WithinAbs(20.25 / 199.0, 1e-5));
+    const Vec2<float> uv = field.compute_uv(hit);
+    REQUIRE_THAT(uv.x, WithinAbs(isect.uv.x, 1e-6));
+    REQUIRE_THAT(uv.y, WithinAbs(isect.uv.y, 1e-6));
+
+    // The plane z = x / 4 + y / 8 + c, with the normal pointing up:
+    const Vec3<float> normal = glm::normalize(Vec3<float>{-0.25f, -0.125f, 1.f});
+    REQUIRE_THAT(isect.normal_s.x, WithinAbs(normal.x, 1e-4));
+    REQUIRE_THAT(isect.normal_s.y, WithinAbs(normal.y, 1e-4));
+    REQUIRE_THAT(isect.normal_s.z, WithinAbs(normal.z, 1e-4));
+    REQUIRE_THAT(glm::dot(isect.tangent, isect.normal_s), WithinAbs(0.0, 1e-5));
+}
@@ -0,0 +1,127 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/geometry/io/mesh_cache.hpp"
+
+using namespace huira;
+namespace fs = std::filesystem;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+using Spectral4 = UniformSpectralBins<4, 380, 750>;
+
+// A closed unit sphere of latitude/longitude quads, with tangents and a bright northern half:
+std::shared_ptr<Mesh<Spectral>> make_sphere(std::uint32_t rings, std::uint32_t segments)
+{
+    const float pi = 3.14159265358979f;
+    VertexBuffer<Spectral> vertices;
+    TangentBuffer tangents;
+    for (std::uint32_t i = 0; i <= rings; ++i) {
+        float theta = pi * static_cast<float>(i) / static_cast<float>(rings);
+        for (std::uint32_t j = 0; j < segments; ++j) {
+            float phi = 2.f * pi * static_cast<float>(j) / static_cast<float>(segments);
+            Vertex<Spectral> vertex;
+            vertex.position = Vec3<float>{
+                std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)};
+            vertex.normal = vertex.position;
+            vertex.uv = Vec2<float>{phi / (2.f * pi), theta / pi};
+            vertex.albedo = Spectral{i < rings / 2 ? 0.5f : 0.1f};
+            vertices.push_back(vertex);
+            tangents.push_back(Tangent{Vec3<float>{-std::sin(phi), std::cos(phi), 0.f},
+                                       Vec3<float>{0.f, 0.f, 1.f}});
+        }
+    }
+
+    IndexBuffer indices;
+    for (std::uint32_t i = 0; i < rings; ++i) {
+        for (std::uint32_t j = 0; j < segments; ++j) {
+            std::uint32_t a = i * segments + j;
+            std::uint32_t b = (i + 1) * segments + j;
+            std::uint32_t c = (i + 1) * segments + (j + 1) % segments;
+            std::uint32_t d = i * segments + (j + 1) % segments;
+            indices.insert(indices.end(), {a, b, c, a, c, d});
+        }
+    }
+    return std::make_shared<Mesh<Spectral>>(std::move(indices), vertices, std::move(tangents));
+}
+
+template <typename T>
+bool same_bytes(std::span<const T> a, std::span<const T> b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+}
+} // namespace
+
+TEST_CASE("Mesh cache - Round trip", "[geometry][mesh_cache]")
+{
+    auto mesh = make_sphere(64, 128);
+    mesh->generate_lods(3);
+    REQUIRE(mesh->lod_count() > 1);
+
+    const fs::path path = fs::temp_directory_path() / "huira_test_mesh_cache.hmesh";
+    write_mesh_cache(path, *mesh, 1234);
+
+    REQUIRE(mesh_cache_matches<Spectral>(path, 1234));
+    REQUIRE_FALSE(mesh_cache_matches<Spectral>(path, 4321));
+    REQUIRE_FALSE(mesh_cache_matches<Spectral4>(path, 1234));
+    REQUIRE_FALSE(mesh_cache_matches<Spectral>(path.string() + ".missing", 1234));
+
+    auto cached = read_mesh_cache<Spectral>(path);
+    REQUIRE(cached->lod_count() == mesh->lod_count());
+    for (std::size_t level = 0; level < mesh->lod_count(); ++level) {
+        const auto& expected = mesh->lod_vertex_streams(level);
+        const auto& actual = cached->lod_vertex_streams(level);
+        REQUIRE(same_bytes(actual.positions(), expected.positions()));
+        REQUIRE(same_bytes(actual.encoded_normals(), expected.encoded_normals()));
+        REQUIRE(same_bytes(actual.encoded_uvs(), expected.encoded_uvs()));
+        REQUIRE(same_bytes(actual.vertex_albedos(), expected.vertex_albedos()));
+        REQUIRE(actual.uv(7) == expected.uv(7));
+        REQUIRE(same_bytes(cached->lod_index_buffer(level), mesh->lod_index_buffer(level)));
+        REQUIRE(same_bytes(cached->lod_tangent_buffer(level), mesh->lod_tangent_buffer(level)));
+        REQUIRE(cached->lod_error(level) == mesh->lod_error(level));
+    }
+
+    cached.reset();
+    fs::remove(path);
+}
+
+TEST_CASE("Mesh cache - Uniform albedo and damaged files", "[geometry][mesh_cache]")
+{
+    VertexBuffer<Spectral> vertices(3);
+    vertices[1].position = Vec3<float>{1.f, 0.f, 0.f};
+    vertices[2].position = Vec3<float>{0.f, 1.f, 0.f};
+    for (auto& vertex : vertices) {
+        vertex.albedo = Spectral{0.3f};
+    }
+    Mesh<Spectral> triangle(IndexBuffer{0, 1, 2}, vertices);
+
+    const fs::path path = fs::temp_directory_path() / "huira_test_mesh_cache_small.hmesh";
+    write_mesh_cache(path, triangle);
+    auto cached = read_mesh_cache<Spectral>(path);
+    REQUIRE_FALSE(cached->vertex_streams().has_vertex_albedo());
+    REQUIRE(cached->vertex_streams().albedo(2) == Spectral{0.3f});
+    REQUIRE_FALSE(cached->has_tangents());
+    cached.reset();
+
+    // Cut off in the middle of the buffers:
+    fs::resize_file(path, fs::file_size(path) - 100);
+    REQUIRE_THROWS(read_mesh_cache<Spectral>(path));
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a mesh cache";
+    }
+    REQUIRE_FALSE(mesh_cache_matches<Spectral>(path, 0));
+    REQUIRE_THROWS(read_mesh_cache<Spectral>(path));
+    fs::remove(path);
+}
@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/geometry/mesh.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+
+VertexBuffer<Spectral> square_vertices()
+{
+    VertexBuffer<Spectral> vertices(4);
+    const Vec3<float> corners[4]{
+        {-1.f, -1.f, 0.f}, {1.f, -1.f, 0.f}, {1.f, 1.f, 0.f}, {-1.f, 1.f, 0.f}};
+    for (std::size_t i = 0; i < 4; ++i) {
+        vertices[i].position = corners[i];
+        vertices[i].normal = Vec3<float>{0.f, 0.f, 1.f};
+    }
+    return vertices;
+}
+
+// A square of two triangles, with a level that keeps both and a coarser one keeping only the
+// first:
+Mesh<Spectral> make_square()
+{
+    Mesh<Spectral> mesh(IndexBuffer{0, 1, 2, 0, 2, 3}, square_vertices());
+    mesh.add_lod(IndexBuffer{0, 1, 2, 0, 2, 3}, square_vertices(), TangentBuffer{}, 0.01f);
+    mesh.add_lod(IndexBuffer{0, 1, 2}, square_vertices(), TangentBuffer{}, 0.1f);
+    return mesh;
+}
+
+std::vector<Vec3<float>> eye_at(float distance)
+{
+    return {Vec3<float>{0.f, 0.f, distance}};
+}
+} // namespace
+
+TEST_CASE("Mesh - Level selection", "[geometry][mesh_lod]")
+{
+    Mesh<Spectral> mesh = make_square();
+    REQUIRE(mesh.lod_count() == 3);
+
+    // Without a camera the current level is kept:
+    REQUIRE(mesh.select_lod_level({}, 1e-3f) == 0);
+    REQUIRE(mesh.select_lod_level({}, 1e-3f, 2) == 2);
+
+    // A level is used once its error projects to at most a pixel, with the default 25% margin:
+    REQUIRE(mesh.select_lod_level(eye_at(5.f), 1e-3f) == 0);
+    REQUIRE(mesh.select_lod_level(eye_at(20.f), 1e-3f) == 1);
+    REQUIRE(mesh.select_lod_level(eye_at(1000.f), 1e-3f) == 2);
+
+    // Within the margin, the level traced so far is kept:
+    REQUIRE(mesh.select_lod_level(eye_at(14.5f), 1e-3f, 0) == 0);
+    REQUIRE(mesh.select_lod_level(eye_at(14.5f), 1e-3f, 1) == 1);
+    REQUIRE(mesh.select_lod_level(eye_at(5.f), 1e-3f, 2) == 0);
+
+    // The nearest instance decides:
+    std::vector<Vec3<float>> eyes = eye_at(1000.f);
+    eyes.push_back(Vec3<float>{0.f, 0.f, 5.f});
+    REQUIRE(mesh.select_lod_level(eyes, 1e-3f) == 0);
+
+    // Choosing a level leaves the mesh as it was:
+    REQUIRE(mesh.lod_level() == 0);
+
+    mesh.set_lod_pixel_error(0.f);
+    REQUIRE(mesh.select_lod_level(eye_at(1000.f), 1e-3f) == 0);
+
+    mesh.clear_lods();
+    REQUIRE(mesh.select_lod_level(eye_at(1000.f), 1e-3f, 2) == 0);
+}
+
+TEST_CASE("Mesh - Hits on the mesh itself are at full resolution", "[geometry][mesh_lod]")
+{
+    Mesh<Spectral> mesh = make_square();
+
+    // The second triangle exists only at full resolution and in level 1:
+    HitRecord hit;
+    hit.prim_id = 1;
+    hit.u = 0.5f;
+    hit.v = 0.5f;
+    Interaction<Spectral> isect;
+    mesh.compute_surface_interaction(hit, isect);
+    REQUIRE_THAT(isect.position.x, WithinAbs(0.0, 1e-6));
+    REQUIRE_THAT(isect.position.y, WithinAbs(1.0, 1e-6));
+    REQUIRE_THAT(isect.normal_s.z, WithinAbs(1.0, 1e-3));
+}
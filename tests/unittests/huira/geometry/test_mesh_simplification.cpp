@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/geometry/mesh_simplification.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+struct TestMesh {
+    IndexBuffer indices;
+    std::vector<Vec3<float>> positions;
+};
+
+// A closed unit sphere of latitude/longitude quads, with single vertices at the poles:
+TestMesh make_sphere(std::uint32_t rings, std::uint32_t segments)
+{
+    TestMesh mesh;
+    const float pi = 3.14159265358979f;
+    mesh.positions.push_back(Vec3<float>{0.f, 0.f, 1.f});
+    for (std::uint32_t i = 1; i < rings; ++i) {
+        float theta = pi * static_cast<float>(i) / static_cast<float>(rings);
+        for (std::uint32_t j = 0; j < segments; ++j) {
+            float phi = 2.f * pi * static_cast<float>(j) / static_cast<float>(segments);
+            mesh.positions.push_back(Vec3<float>{std::sin(theta) * std::cos(phi),
+                                                 std::sin(theta) * std::sin(phi),
+                                                 std::cos(theta)});
+        }
+    }
+    const auto south = static_cast<std::uint32_t>(mesh.positions.size());
+    mesh.positions.push_back(Vec3<float>{0.f, 0.f, -1.f});
+
+    auto ring_vertex = [&](std::uint32_t i, std::uint32_t j) {
+        return 1 + (i - 1) * segments + j % segments;
+    };
+    for (std::uint32_t j = 0; j < segments; ++j) {
+        mesh.indices.insert(mesh.indices.end(), {0, ring_vertex(1, j), ring_vertex(1, j + 1)});
+        mesh.indices.insert(mesh.indices.end(),
+                            {south, ring_vertex(rings - 1, j + 1), ring_vertex(rings - 1, j)});
+    }
+    for (std::uint32_t i = 1; i + 1 < rings; ++i) {
+        for (std::uint32_t j = 0; j < segments; ++j) {
+            std::uint32_t a = ring_vertex(i, j);
+            std::uint32_t b = ring_vertex(i + 1, j);
+            std::uint32_t c = ring_vertex(i + 1, j + 1);
+            std::uint32_t d = ring_vertex(i, j + 1);
+            mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d});
+        }
+    }
+    return mesh;
+}
+
+// A flat n by n grid of quads on the xy plane:
+TestMesh make_grid(std::uint32_t n)
+{
+    TestMesh mesh;
+    for (std::uint32_t y = 0; y <= n; ++y) {
+        for (std::uint32_t x = 0; x <= n; ++x) {
+            mesh.positions.push_back(
+                Vec3<float>{static_cast<float>(x), static_cast<float>(y), 0.f});
+        }
+    }
+    for (std::uint32_t y = 0; y < n; ++y) {
+        for (std::uint32_t x = 0; x < n; ++x) {
+            std::uint32_t a = y * (n + 1) + x;
+            mesh.indices.insert(mesh.indices.end(), {a, a + 1, a + n + 2, a, a + n + 2, a + n + 1});
+        }
+    }
+    return mesh;
+}
+
+// Number of triangles on each undirected edge:
+std::map<std::pair<std::uint32_t, std::uint32_t>, int> edge_use(const IndexBuffer& indices)
+{
+    std::map<std::pair<std::uint32_t, std::uint32_t>, int> edges;
+    for (std::size_t t = 0; t < indices.size(); t += 3) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            std::uint32_t a = indices[t + k];
+            std::uint32_t b = indices[t + (k + 1) % 3];
+            ++edges[{std::min(a, b), std::max(a, b)}];
+        }
+    }
+    return edges;
+}
+} // namespace
+
+TEST_CASE("simplify_mesh - Closed surfaces", "[geometry][simplification]")
+{
+    auto sphere = make_sphere(32, 64);
+    const std::size_t triangles = sphere.indices.size() / 3;
+    auto simplified = simplify_mesh(sphere.indices, sphere.positions, triangles / 8);
+
+    REQUIRE(simplified.index_buffer.size() / 3 <= triangles / 8);
+    REQUIRE(simplified.index_buffer.size() / 3 > triangles / 16);
+    REQUIRE(simplified.vertices.size() < sphere.positions.size());
+    REQUIRE(std::ranges::is_sorted(simplified.vertices));
+
+    // The result stays closed and manifold:
+    for (const auto& [edge, count] : edge_use(simplified.index_buffer)) {
+        REQUIRE(count == 2);
+    }
+
+    // The error estimate is positive and bounded by the sagitta of the coarse triangles:
+    REQUIRE(simplified.error > 0.f);
+    REQUIRE(simplified.error < 0.2f);
+
+    // Going further costs more:
+    std::vector<Vec3<float>> kept;
+    for (std::uint32_t v : simplified.vertices) {
+        kept.push_back(sphere.positions[v]);
+    }
+    auto coarser = simplify_mesh(simplified.index_buffer, kept, 64);
+    REQUIRE(coarser.index_buffer.size() / 3 <= 64);
+    REQUIRE(coarser.error > simplified.error);
+}
+
+TEST_CASE("simplify_mesh - Open surfaces", "[geometry][simplification]")
+{
+    auto grid = make_grid(16);
+    auto simplified = simplify_mesh(grid.indices, grid.positions, 0);
+
+    // Only the interior collapses; the 64 border vertices stay:
+    REQUIRE(simplified.vertices.size() == 64);
+    for (std::uint32_t v : simplified.vertices) {
+        const Vec3<float>& p = grid.positions[v];
+        REQUIRE((p.x == 0.f || p.x == 16.f || p.y == 0.f || p.y == 16.f));
+    }
+    REQUIRE_THAT(simplified.error, WithinAbs(0.f, 1e-6f));
+
+    // The area is unchanged:
+    float area = 0.f;
+    for (std::size_t t = 0; t < simplified.index_buffer.size(); t += 3) {
+        const Vec3<float>& a = grid.positions[simplified.vertices[simplified.index_buffer[t]]];
+        const Vec3<float>& b = grid.positions[simplified.vertices[simplified.index_buffer[t + 1]]];
+        const Vec3<float>& c = grid.positions[simplified.vertices[simplified.index_buffer[t + 2]]];
+        area += 0.5f * glm::cross(b - a, c - a).z;
+    }
+    REQUIRE_THAT(area, WithinAbs(256.f, 1e-3f));
+
+    REQUIRE_THROWS(simplify_mesh(IndexBuffer{0, 1, 1000}, grid.positions, 0));
+}
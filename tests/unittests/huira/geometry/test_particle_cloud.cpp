@@ -0,0 +1,154 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/geometry/particle_cloud.hpp"
+#include "huira/scene/scene.hpp"
+#include "huira/scene/scene_view.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+namespace fs = std::filesystem;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+using Cloud = ParticleCloud<Spectral>;
+} // namespace
+
+TEST_CASE("ParticleCloud - Construction", "[geometry][particle_cloud]")
+{
+    std::vector<Vec3<float>> positions{{0.f, 0.f, 0.f}, {1.f, 2.f, 3.f}, {-4.f, 5.f, 6.f}};
+
+    Cloud shared_radius(positions, std::vector<float>{0.5f});
+    REQUIRE(shared_radius.size() == 3);
+    REQUIRE(shared_radius.radius(2) == 0.5f);
+    REQUIRE(shared_radius.position(1) == positions[1]);
+    REQUIRE_FALSE(shared_radius.has_particle_albedo());
+    REQUIRE(shared_radius.albedo(1) == Spectral{1});
+
+    Cloud per_particle(positions,
+                       std::vector<float>{0.1f, 0.2f, 0.3f},
+                       std::vector<Spectral>{Spectral{0.1f}, Spectral{0.2f}, Spectral{0.3f}},
+                       ParticleShape::Disc);
+    REQUIRE(per_particle.shape() == ParticleShape::Disc);
+    REQUIRE(per_particle.radius(1) == 0.2f);
+    REQUIRE(per_particle.has_particle_albedo());
+    REQUIRE(per_particle.albedo(2) == Spectral{0.3f});
+
+    REQUIRE_THROWS(Cloud(positions, std::vector<float>{0.1f, 0.2f}));
+    REQUIRE_THROWS(Cloud(positions, std::vector<float>{-1.f}));
+    REQUIRE_THROWS(Cloud(positions,
+                         std::vector<float>{1.f},
+                         std::vector<Spectral>{Spectral{0.1f}, Spectral{0.2f}}));
+    REQUIRE_THROWS(Cloud(std::vector<Vec3<float>>{}, std::vector<float>{1.f}));
+}
+
+TEST_CASE("ParticleCloud - Motion", "[geometry][particle_cloud]")
+{
+    std::vector<Vec3<float>> positions{{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}};
+    Cloud cloud(positions, std::vector<float>{0.25f, 0.5f});
+    REQUIRE(cloud.time_step_count() == 1);
+    const auto revision = cloud.revision();
+
+    cloud.add_time_step(std::vector<Vec3<float>>{{0.f, 1.f, 0.f}, {1.f, 1.f, 0.f}});
+    REQUIRE(cloud.time_step_count() == 2);
+    REQUIRE(cloud.revision() > revision);
+    REQUIRE(cloud.position(1, 1) == Vec3<float>{1.f, 1.f, 0.f});
+    REQUIRE(cloud.radius(1) == 0.5f);
+
+    REQUIRE_THROWS(cloud.add_time_step(std::vector<Vec3<float>>{{0.f, 0.f, 0.f}}));
+
+    const auto moving = cloud.revision();
+    cloud.clear_motion();
+    REQUIRE(cloud.time_step_count() == 1);
+    REQUIRE(cloud.position(1) == positions[1]);
+    REQUIRE(cloud.revision() > moving);
+}
+
+TEST_CASE("ParticleCloud - Surface interaction", "[geometry][particle_cloud]")
+{
+    Cloud cloud(std::vector<Vec3<float>>{{10.f, 0.f, 0.f}},
+                std::vector<float>{2.f},
+                std::vector<Spectral>{Spectral{0.4f}});
+
+    HitRecord hit;
+    hit.prim_id = 0;
+    hit.Ng = Vec3<float>{0.f, 0.f, 3.f};
+    Interaction<Spectral> isect;
+    cloud.compute_surface_interaction(hit, isect);
+
+    REQUIRE_THAT(isect.position.x, WithinAbs(10.0, 1e-6));
+    REQUIRE_THAT(isect.position.z, WithinAbs(2.0, 1e-6));
+    REQUIRE_THAT(isect.normal_s.z, WithinAbs(1.0, 1e-6));
+    REQUIRE_THAT(glm::dot(isect.tangent, isect.normal_s), WithinAbs(0.0, 1e-6));
+    REQUIRE(isect.vertex_albedo == Spectral{0.4f});
+
+    // A moving particle is hit where it was at the ray's time:
+    cloud.add_time_step(std::vector<Vec3<float>>{{10.f, 4.f, 0.f}});
+    cloud.add_time_step(std::vector<Vec3<float>>{{10.f, 4.f, 8.f}});
+    REQUIRE(cloud.position_at(0, 0.25f) == Vec3<float>{10.f, 2.f, 0.f});
+    REQUIRE(cloud.position_at(0, 1.f) == Vec3<float>{10.f, 4.f, 8.f});
+
+    hit.time = 0.75f;
+    cloud.compute_surface_interaction(hit, isect);
+    REQUIRE_THAT(isect.position.y, WithinAbs(4.0, 1e-6));
+    REQUIRE_THAT(isect.position.z, WithinAbs(6.0, 1e-6));
+}
+
+TEST_CASE("ParticleCloud - Views keep the motion they trace", "[geometry][particle_cloud]")
+{
+    Scene<Spectral> scene;
+    auto cloud = scene.add_particles(std::vector<Vec3<float>>{{0.f, 0.f, 10.f}},
+                                     std::vector<float>{1.f});
+    scene.root.new_instance(scene.add_primitive(cloud));
+    auto camera = scene.root.new_instance(scene.new_camera_model());
+    const Interval exposure{Time::from_et(0.0), Time::from_et(1.0)};
+
+    // A ray from the camera straight at the particle:
+    const Ray<Spectral> ray(Vec3<float>{0.f}, Vec3<float>{0.f, 0.f, 1.f});
+    SceneView<Spectral> before(scene, exposure, camera, ObservationMode::TRUE_STATE);
+    const HitRecord hit = before.intersect(ray);
+    REQUIRE(hit.hit());
+    REQUIRE_THAT(hit.t, WithinAbs(9.0, 1e-4));
+    REQUIRE_THAT(before.resolve_hit(ray, hit).position.z, WithinAbs(9.0, 1e-4));
+
+    // Moving the particle leaves the earlier view's hits where that view traced them:
+    cloud.add_time_step(std::vector<Vec3<float>>{{0.f, 0.f, 20.f}});
+    REQUIRE_THAT(before.resolve_hit(ray, hit).position.z, WithinAbs(9.0, 1e-4));
+    REQUIRE_THAT(before.intersect(ray).t, WithinAbs(9.0, 1e-4));
+
+    // While a later view sees the particle halfway through its move:
+    SceneView<Spectral> after(scene, exposure, camera, ObservationMode::TRUE_STATE);
+    const HitRecord moved = after.intersect(ray);
+    REQUIRE(moved.hit());
+    REQUIRE_THAT(moved.t, WithinAbs(14.0, 1e-3));
+    REQUIRE_THAT(after.resolve_hit(ray, moved).position.z, WithinAbs(14.0, 1e-3));
+
+    cloud.clear_motion();
+    REQUIRE_THAT(after.resolve_hit(ray, moved).position.z, WithinAbs(14.0, 1e-3));
+}
+
+TEST_CASE("ParticleCloud - Raw particle files", "[geometry][particle_cloud]")
+{
+    const fs::path path = fs::temp_directory_path() / "huira_test_particles.bin";
+    const std::vector<float> records{0.f, 1.f, 2.f, 0.5f, 3.f, 4.f, 5.f, 0.25f};
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(records.data()),
+                  static_cast<std::streamsize>(records.size() * sizeof(float)));
+    }
+
+    auto points = Cloud::read_raw(path);
+    REQUIRE(points.size() == 2);
+    Cloud cloud(std::move(points));
+    REQUIRE(cloud.position(1) == Vec3<float>{3.f, 4.f, 5.f});
+    REQUIRE(cloud.radius(1) == 0.25f);
+
+    fs::resize_file(path, 3 * sizeof(float));
+    REQUIRE_THROWS(Cloud::read_raw(path));
+    fs::remove(path);
+}
@@ -0,0 +1,279 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "cspice/SpiceUsr.h"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/core/spice.hpp"
+#include "huira/geometry/io/shape_models.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+namespace fs = std::filesystem;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+
+// An ICQ model of a cube with 2 km sides centred on (10, 20, 30) km, with each face given in
+// a different orientation:
+void write_cube_icq(const fs::path& path, int q)
+{
+    std::ofstream out(path);
+    out << q << "\n";
+    for (int f = 0; f < 6; ++f) {
+        const int axis = f / 2;
+        const double sign = (f % 2 == 0) ? 1.0 : -1.0;
+        for (int j = 0; j <= q; ++j) {
+            for (int i = 0; i <= q; ++i) {
+                double xyz[3];
+                xyz[axis] = sign;
+                xyz[(axis + 1) % 3] = 2.0 * i / q - 1.0;
+                xyz[(axis + 2) % 3] = 2.0 * j / q - 1.0;
+                char line[96];
+                std::snprintf(line,
+                              sizeof(line),
+                              "%.17g %.17g %.17g\n",
+                              xyz[0] + 10.0,
+                              xyz[1] + 20.0,
+                              xyz[2] + 30.0);
+                out << line;
+            }
+        }
+    }
+}
+
+// The eight corners of a cube with 2 km sides centred on (10, 20, 30) km, and its twelve plates
+// wound outwards, numbering the corners from one as DSK files do:
+const std::array<std::array<SpiceDouble, 3>, 8> CUBE_VERTICES{{{9.0, 19.0, 29.0},
+                                                              {11.0, 19.0, 29.0},
+                                                              {11.0, 21.0, 29.0},
+                                                              {9.0, 21.0, 29.0},
+                                                              {9.0, 19.0, 31.0},
+                                                              {11.0, 19.0, 31.0},
+                                                              {11.0, 21.0, 31.0},
+                                                              {9.0, 21.0, 31.0}}};
+const std::array<std::array<SpiceInt, 3>, 12> CUBE_PLATES{{{1, 3, 2},
+                                                          {1, 4, 3},
+                                                          {5, 6, 7},
+                                                          {5, 7, 8},
+                                                          {1, 2, 6},
+                                                          {1, 6, 5},
+                                                          {2, 3, 7},
+                                                          {2, 7, 6},
+                                                          {3, 4, 8},
+                                                          {3, 8, 7},
+                                                          {4, 1, 5},
+                                                          {4, 5, 8}}};
+
+// Writes a type 2 DSK file holding the cube's plates split across the given number of segments,
+// each segment carrying its own copy of the eight corners:
+void write_cube_dsk(const fs::path& path, int segments)
+{
+    fs::remove(path);
+    SpiceInt handle = 0;
+    spice::call_spice(dskopn_c, path.string().c_str(), "huira test cube", 0, &handle);
+
+    constexpr SpiceInt WORKSZ = 10000;
+    constexpr SpiceInt VOXPSZ = 10000;
+    constexpr SpiceInt VOXLSZ = 10000;
+    constexpr SpiceInt SPXISZ = 100000;
+    std::vector<std::array<SpiceInt, 2>> work(WORKSZ);
+    std::vector<SpiceDouble> spaixd(SPICE_DSK02_SPADSZ);
+    std::vector<SpiceInt> spaixi(SPXISZ);
+
+    const auto* vertices = reinterpret_cast<const SpiceDouble(*)[3]>(CUBE_VERTICES.data());
+    const SpiceInt plates_per_segment = 12 / segments;
+    for (int segment = 0; segment < segments; ++segment) {
+        const auto* plates = reinterpret_cast<const SpiceInt(*)[3]>(
+            CUBE_PLATES.data() + segment * plates_per_segment);
+        spice::call_spice(dskmi2_c,
+                          8,
+                          vertices,
+                          plates_per_segment,
+                          plates,
+                          5.0,
+                          4,
+                          WORKSZ,
+                          VOXPSZ,
+                          VOXLSZ,
+                          SPICETRUE,
+                          SPXISZ,
+                          reinterpret_cast<SpiceInt(*)[2]>(work.data()),
+                          spaixd.data(),
+                          spaixi.data());
+
+        SpiceDouble corpar[SPICE_DSK_NSYPAR] = {};
+        SpiceDouble min_radius = 0.0;
+        SpiceDouble max_radius = 0.0;
+        spice::call_spice(dskrb2_c,
+                          8,
+                          vertices,
+                          plates_per_segment,
+                          plates,
+                          SPICE_DSK_LATSYS,
+                          corpar,
+                          &min_radius,
+                          &max_radius);
+        spice::call_spice(dskw02_c,
+                          handle,
+                          499,
+                          1,
+                          2,
+                          "IAU_MARS",
+                          SPICE_DSK_LATSYS,
+                          corpar,
+                          -pi_c(),
+                          pi_c(),
+                          -halfpi_c(),
+                          halfpi_c(),
+                          min_radius,
+                          max_radius,
+                          -1.0e10,
+                          1.0e10,
+                          8,
+                          vertices,
+                          plates_per_segment,
+                          plates,
+                          spaixd.data(),
+                          spaixi.data());
+    }
+    spice::call_spice(dskcls_c, handle, SPICETRUE);
+}
+} // namespace
+
+TEST_CASE("Shape models - ICQ cube", "[geometry][shape_models]")
+{
+    const fs::path path = fs::temp_directory_path() / "huira_test_cube.icq";
+    write_cube_icq(path, 4);
+
+    ShapeModelBuffers buffers = read_icq_plates(path);
+
+    // The seams are merged, leaving the 6 * 5^2 - 12 * 3 - 8 * 2 distinct grid points:
+    REQUIRE(buffers.positions.size() == 98);
+    REQUIRE(buffers.indices.size() == 6 * 4 * 4 * 2 * 3);
+
+    // Every face is wound outwards, so the enclosed volume is that of the cube:
+    double volume = 0.0;
+    for (std::size_t t = 0; t < buffers.indices.size(); t += 3) {
+        const Vec3<double>& a = buffers.positions[buffers.indices[t]];
+        const Vec3<double>& b = buffers.positions[buffers.indices[t + 1]];
+        const Vec3<double>& c = buffers.positions[buffers.indices[t + 2]];
+        volume += glm::dot(a, glm::cross(b, c)) / 6.0;
+    }
+    REQUIRE_THAT(volume, WithinAbs(8.0, 1e-9));
+
+    Vec3<double> center{0.0};
+    auto mesh = read_icq<Spectral>(path, center);
+    REQUIRE_THAT(center.x, WithinAbs(10000.0, 1e-9));
+    REQUIRE_THAT(center.y, WithinAbs(20000.0, 1e-9));
+    REQUIRE_THAT(center.z, WithinAbs(30000.0, 1e-9));
+
+    // Vertices are in metres about the centre, with normals pointing away from it:
+    const auto& vertices = mesh->vertex_streams();
+    REQUIRE(vertices.size() == 98);
+    for (std::size_t v = 0; v < vertices.size(); ++v) {
+        const Vec3<float> position = vertices.position(v);
+        REQUIRE(glm::length(position) >= 999.f);
+        REQUIRE(glm::length(position) <= 1733.f);
+        REQUIRE(glm::dot(vertices.normal(v), position) > 0.f);
+    }
+
+    fs::remove(path);
+}
+
+TEST_CASE("Shape models - Malformed ICQ", "[geometry][shape_models]")
+{
+    const fs::path path = fs::temp_directory_path() / "huira_test_truncated.icq";
+    {
+        std::ofstream out(path);
+        out << "2\n1.0 2.0 3.0\n4.0 5.0\n";
+    }
+    REQUIRE_THROWS(read_icq_plates(path));
+
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "not an icq file\n";
+    }
+    REQUIRE_THROWS(read_icq_plates(path));
+    fs::remove(path);
+
+    REQUIRE_THROWS(read_icq_plates(path));
+}
+
+TEST_CASE("Shape models - DSK cube", "[geometry][shape_models]")
+{
+    const fs::path path = fs::temp_directory_path() / "huira_test_cube.bds";
+    write_cube_dsk(path, 2);
+
+    // Both segments are read, each with its own copy of the corners:
+    ShapeModelBuffers buffers = read_dsk_plates(path);
+    REQUIRE(buffers.positions.size() == 16);
+    REQUIRE(buffers.indices.size() == 12 * 3);
+    for (std::size_t v = 0; v < 16; ++v) {
+        const auto& expected = CUBE_VERTICES[v % 8];
+        REQUIRE(buffers.positions[v] == Vec3<double>{expected[0], expected[1], expected[2]});
+    }
+
+    // Plate corners are renumbered from zero, and those of the second segment follow the first
+    // segment's vertices:
+    for (std::size_t p = 0; p < 12; ++p) {
+        const std::uint32_t offset = p < 6 ? 0 : 8;
+        for (std::size_t k = 0; k < 3; ++k) {
+            REQUIRE(buffers.indices[3 * p + k] ==
+                    static_cast<std::uint32_t>(CUBE_PLATES[p][k] - 1) + offset);
+        }
+    }
+
+    double volume = 0.0;
+    for (std::size_t t = 0; t < buffers.indices.size(); t += 3) {
+        const Vec3<double>& a = buffers.positions[buffers.indices[t]];
+        const Vec3<double>& b = buffers.positions[buffers.indices[t + 1]];
+        const Vec3<double>& c = buffers.positions[buffers.indices[t + 2]];
+        volume += glm::dot(a, glm::cross(b, c)) / 6.0;
+    }
+    REQUIRE_THAT(volume, WithinAbs(8.0, 1e-9));
+
+    Vec3<double> center{0.0};
+    auto mesh = read_dsk<Spectral>(path, center);
+    REQUIRE_THAT(center.x, WithinAbs(10000.0, 1e-9));
+    REQUIRE_THAT(center.y, WithinAbs(20000.0, 1e-9));
+    REQUIRE_THAT(center.z, WithinAbs(30000.0, 1e-9));
+    REQUIRE(mesh->vertex_streams().size() == 16);
+    REQUIRE_THAT(glm::length(mesh->vertex_streams().position(0)), WithinAbs(1732.05, 1e-2));
+
+    fs::remove(path);
+}
+
+TEST_CASE("Shape models - Unreadable DSK", "[geometry][shape_models]")
+{
+    const fs::path path = fs::temp_directory_path() / "huira_test_empty.bds";
+    REQUIRE_THROWS(read_dsk_plates(path));
+
+    // A file that is not a DAS file fails to open:
+    {
+        std::ofstream out(path);
+        out << "not a dsk file\n";
+    }
+    REQUIRE_THROWS(read_dsk_plates(path));
+
+    // A DSK file with no segments fails after it is opened, and must still be closed so that a
+    // new file written in its place is read afresh:
+    fs::remove(path);
+    SpiceInt handle = 0;
+    spice::call_spice(dskopn_c, path.string().c_str(), "huira empty dsk", 0, &handle);
+    spice::call_spice(dskcls_c, handle, SPICETRUE);
+    REQUIRE_THROWS(read_dsk_plates(path));
+
+    write_cube_dsk(path, 1);
+    ShapeModelBuffers buffers = read_dsk_plates(path);
+    REQUIRE(buffers.positions.size() == 8);
+    REQUIRE(buffers.indices.size() == 12 * 3);
+    fs::remove(path);
+}
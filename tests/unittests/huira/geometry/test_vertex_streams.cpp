@@ -0,0 +1,103 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/geometry/vertex_streams.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+
+VertexBuffer<Spectral> make_vertices(std::size_t count)
+{
+    VertexBuffer<Spectral> vertices(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        float t = static_cast<float>(i);
+        vertices[i].position = Vec3<float>{t, 2.f * t, -t};
+        vertices[i].normal =
+            glm::normalize(Vec3<float>{std::cos(t), std::sin(t), std::cos(3.f * t)});
+        vertices[i].uv = Vec2<float>{-2.f + 0.37f * t, 0.05f * t};
+    }
+    return vertices;
+}
+} // namespace
+
+TEST_CASE("encode_oct_normal - Round trip", "[geometry][vertex_streams]")
+{
+    for (int i = 0; i < 1000; ++i) {
+        float t = static_cast<float>(i);
+        Vec3<float> n =
+            glm::normalize(Vec3<float>{std::sin(1.3f * t), std::cos(0.7f * t), std::sin(2.9f * t)});
+        Vec3<float> decoded = decode_oct_normal(encode_oct_normal(n));
+        REQUIRE(glm::length(decoded - n) < 1e-4f);
+    }
+
+    // The poles and the fold of the octahedron survive too:
+    for (Vec3<float> n : {Vec3<float>{0.f, 0.f, 1.f},
+                          Vec3<float>{0.f, 0.f, -1.f},
+                          Vec3<float>{1.f, 0.f, 0.f},
+                          Vec3<float>{0.f, -1.f, 0.f}}) {
+        REQUIRE(glm::length(decode_oct_normal(encode_oct_normal(n)) - n) < 1e-4f);
+    }
+}
+
+TEST_CASE("VertexStreams - Packing", "[geometry][vertex_streams]")
+{
+    auto vertices = make_vertices(100);
+    VertexStreams<Spectral> streams(vertices);
+
+    REQUIRE(streams.size() == 100);
+    REQUIRE(streams.positions().size() == 100);
+    REQUIRE_FALSE(streams.has_vertex_albedo());
+
+    // Positions are exact, uvs within one step of their bounding box:
+    const float du = 0.37f * 99.f / 65535.f;
+    const float dv = 0.05f * 99.f / 65535.f;
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        REQUIRE(streams.position(i) == vertices[i].position);
+        REQUIRE(glm::length(streams.normal(i) - vertices[i].normal) < 1e-4f);
+        REQUIRE_THAT(streams.uv(i).x, WithinAbs(vertices[i].uv.x, du));
+        REQUIRE_THAT(streams.uv(i).y, WithinAbs(vertices[i].uv.y, dv));
+        REQUIRE(streams.albedo(i) == Spectral{1.f});
+    }
+
+    // Much smaller than the vertices they came from:
+    REQUIRE(streams.memory_bytes() < vertices.size() * sizeof(Vertex<Spectral>) / 2);
+}
+
+TEST_CASE("VertexStreams - Per-vertex albedo", "[geometry][vertex_streams]")
+{
+    auto vertices = make_vertices(10);
+    vertices[3].albedo = Spectral{0.25f};
+    VertexStreams<Spectral> streams(vertices);
+
+    REQUIRE(streams.has_vertex_albedo());
+    REQUIRE(streams.albedo(3) == Spectral{0.25f});
+    REQUIRE(streams.albedo(4) == Spectral{1.f});
+
+    auto unpacked = streams.unpack();
+    REQUIRE(unpacked.size() == vertices.size());
+    REQUIRE(unpacked[3].albedo == Spectral{0.25f});
+}
+
+TEST_CASE("VertexStreams - Subset", "[geometry][vertex_streams]")
+{
+    auto vertices = make_vertices(20);
+    VertexStreams<Spectral> streams(vertices);
+    std::vector<std::uint32_t> kept{2, 7, 19};
+    auto subset = streams.subset(kept);
+
+    REQUIRE(subset.size() == 3);
+    for (std::size_t i = 0; i < kept.size(); ++i) {
+        REQUIRE(subset.position(i) == streams.position(kept[i]));
+        REQUIRE(subset.normal(i) == streams.normal(kept[i]));
+        REQUIRE(subset.uv(i) == streams.uv(kept[i]));
+    }
+    REQUIRE(VertexStreams<Spectral>{}.empty());
+}
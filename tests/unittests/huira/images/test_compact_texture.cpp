@@ -0,0 +1,126 @@
+#include <cmath>
+#include <cstddef>
+#include <memory>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/images/compact_texture.hpp"
+#include "huira/images/mip_pyramid.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+std::shared_ptr<Image<RGB>> make_gradient(int width, int height, float scale)
+{
+    auto image = std::make_shared<Image<RGB>>(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float u = static_cast<float>(x) / static_cast<float>(width - 1);
+            float v = static_cast<float>(y) / static_cast<float>(height - 1);
+            (*image)(x, y) = RGB{u * scale, v * scale, 0.5f * (u + v) * scale};
+        }
+    }
+    return image;
+}
+} // namespace
+
+TEST_CASE("CompactTexture - Half floats", "[images][compact_texture]")
+{
+    for (float value : {0.f, 1.f, -2.5f, 0.333f, 65504.f, 6.1035e-5f, 1e-7f}) {
+        float round_trip = detail::half_to_float(detail::float_to_half(value));
+        REQUIRE_THAT(round_trip, WithinAbs(value, std::abs(value) * 1e-3 + 1e-7));
+    }
+    REQUIRE(detail::float_to_half(1e6f) == 0x7c00);
+    REQUIRE(detail::float_to_half(1.f) == 0x3c00);
+}
+
+TEST_CASE("CompactTexture - Spectral basis", "[images][compact_texture]")
+{
+    RGBSpectralBasis<Visible8> basis;
+    REQUIRE(basis.linear());
+
+    const RGB rgb{0.1f, 0.6f, 0.3f};
+    Visible8 expected = convert_rgb_to_spectral<Visible8>(rgb);
+    Visible8 actual = basis(rgb);
+    for (std::size_t i = 0; i < Visible8::size(); ++i) {
+        REQUIRE_THAT(actual[i], WithinAbs(expected[i], 1e-5));
+    }
+
+    RGBSpectralBasis<Visible8> squared(
+        [](RGB c) { return convert_rgb_to_spectral<Visible8>(c * c); });
+    REQUIRE_FALSE(squared.linear());
+}
+
+TEST_CASE("CompactTexture - Matches a float pyramid", "[images][compact_texture]")
+{
+    struct Case {
+        CompactTexelFormat format;
+        float scale;
+        float tolerance;
+    };
+    for (Case c : {Case{CompactTexelFormat::RGB8, 1.f, 0.01f},
+                   Case{CompactTexelFormat::RGB16, 1.f, 1e-4f},
+                   Case{CompactTexelFormat::Half, 40.f, 0.05f}}) {
+        auto image = make_gradient(33, 17, c.scale);
+        CompactTexture<Visible8> compact(*image, c.format);
+        MipPyramid<RGB> mips(image);
+        RGBSpectralBasis<Visible8> basis;
+
+        REQUIRE(compact.levels() == mips.levels());
+        for (float duv : {0.f, 0.02f, 0.2f}) {
+            for (float u : {0.f, 0.35f, 0.8f}) {
+                Vec2<float> uv{u, 0.6f};
+                Vec2<float> dx{duv, 0.f};
+                Vec2<float> dy{0.f, duv};
+                Visible8 expected = basis(mips.sample(uv, dx, dy));
+                Visible8 actual = compact.sample(uv, dx, dy);
+                for (std::size_t i = 0; i < Visible8::size(); ++i) {
+                    REQUIRE_THAT(actual[i], WithinAbs(expected[i], c.tolerance));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("CompactTexture - Storage size", "[images][compact_texture]")
+{
+    auto image = make_gradient(64, 64, 1.f);
+    CompactTexture<Visible8> rgb8(*image, CompactTexelFormat::RGB8);
+    CompactTexture<Visible8> rgb16(*image, CompactTexelFormat::RGB16);
+
+    std::size_t texels = 0;
+    for (std::size_t l = 0; l < rgb8.levels(); ++l) {
+        Resolution res = rgb8.level_resolution(l);
+        texels += static_cast<std::size_t>(res.width) * static_cast<std::size_t>(res.height);
+    }
+    REQUIRE(rgb8.bytes() == texels * 3);
+    REQUIRE(rgb16.bytes() == texels * 6);
+    REQUIRE(rgb8.bytes() * 8 < texels * sizeof(Visible8));
+}
+
+TEST_CASE("CompactTexture - Format selection", "[images][compact_texture]")
+{
+    REQUIRE(compact_texel_format(*make_gradient(4, 4, 1.f), 8) == CompactTexelFormat::RGB8);
+    REQUIRE(compact_texel_format(*make_gradient(4, 4, 1.f), 16) == CompactTexelFormat::RGB16);
+    REQUIRE(compact_texel_format(*make_gradient(4, 4, 2.f), 8) == CompactTexelFormat::Half);
+}
+
+TEST_CASE("CompactTexture - Holds its source", "[images][compact_texture]")
+{
+    auto image = make_gradient(20, 12, 1.f);
+    CompactTexture<Visible8> compact(*image, CompactTexelFormat::RGB16);
+    RGBSpectralBasis<Visible8> basis;
+    REQUIRE(compact.holds(*image, CompactTexelFormat::RGB16, basis));
+
+    REQUIRE_FALSE(compact.holds(*image, CompactTexelFormat::RGB8, basis));
+    REQUIRE_FALSE(compact.holds(*make_gradient(12, 20, 1.f), CompactTexelFormat::RGB16, basis));
+    RGBSpectralBasis<Visible8> doubled(
+        [](RGB c) { return convert_rgb_to_spectral<Visible8>(c * 2.f); });
+    REQUIRE_FALSE(compact.holds(*image, CompactTexelFormat::RGB16, doubled));
+
+    // A single texel off by more than the format resolves is told apart:
+    Image<RGB> edited = *image;
+    edited(7, 5) = RGB{0.f, 0.f, 0.f};
+    REQUIRE_FALSE(compact.holds(edited, CompactTexelFormat::RGB16, basis));
+}
@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "huira/images/image.hpp"
+
+using namespace huira;
+
+namespace {
+Image<float> make_ramp(int width, int height)
+{
+    Image<float> image(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            image(x, y) = static_cast<float>(y * width + x);
+        }
+    }
+    return image;
+}
+} // namespace
+
+TEST_CASE("ImageLayout - Tiled indices cover storage exactly once", "[images][image_layout]")
+{
+    for (auto [w, h] : {std::pair{8, 8}, std::pair{13, 5}, std::pair{1, 17}, std::pair{30, 21}}) {
+        std::vector<int> hits(static_cast<std::size_t>(w * h), 0);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                std::size_t index = detail::tiled_pixel_index(x, y, w, h);
+                REQUIRE(index < hits.size());
+                ++hits[index];
+            }
+        }
+        for (int count : hits) {
+            REQUIRE(count == 1);
+        }
+    }
+}
+
+TEST_CASE("ImageLayout - Relayout preserves pixels", "[images][image_layout]")
+{
+    Image<float> row_major = make_ramp(19, 11);
+    Image<float> tiled = row_major;
+    tiled.set_layout(ImageLayout::Tiled);
+
+    REQUIRE(tiled.layout() == ImageLayout::Tiled);
+    REQUIRE(tiled.size() == row_major.size());
+    REQUIRE(tiled(9, 0) == row_major(9, 0));
+    REQUIRE(tiled[9] != row_major[9]);
+
+    for (int y = 0; y < 11; ++y) {
+        for (int x = 0; x < 19; ++x) {
+            REQUIRE(tiled(x, y) == row_major(x, y));
+        }
+    }
+    for (float u : {0.f, 0.13f, 0.5f, 0.91f}) {
+        REQUIRE(tiled.sample_bilinear(u, 0.37f) == row_major.sample_bilinear(u, 0.37f));
+    }
+
+    tiled.set_layout(ImageLayout::RowMajor);
+    for (std::size_t i = 0; i < tiled.size(); ++i) {
+        REQUIRE(tiled[i] == row_major[i]);
+    }
+}
+
+TEST_CASE("ImageLayout - Derived images keep the layout", "[images][image_layout]")
+{
+    Image<float> row_major = make_ramp(12, 9);
+    Image<float> tiled = row_major;
+    tiled.set_layout(ImageLayout::Tiled);
+
+    Image<float> sum = tiled + row_major;
+    REQUIRE(sum.layout() == ImageLayout::Tiled);
+    REQUIRE(sum(10, 8) == 2.f * row_major(10, 8));
+
+    Image<float> channel = tiled.get_channel(0);
+    REQUIRE(channel.layout() == ImageLayout::Tiled);
+    REQUIRE(channel(10, 8) == row_major(10, 8));
+}
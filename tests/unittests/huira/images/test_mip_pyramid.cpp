@@ -0,0 +1,111 @@
+#include <cstddef>
+#include <memory>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/images/mip_pyramid.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+std::shared_ptr<Image<float>> make_checkerboard(int width, int height)
+{
+    auto image = std::make_shared<Image<float>>(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            (*image)(x, y) = ((x + y) % 2 == 0) ? 1.f : 0.f;
+        }
+    }
+    return image;
+}
+} // namespace
+
+TEST_CASE("MipPyramid - Level chain", "[images][mip_pyramid]")
+{
+    SECTION("Power of two halves down to 1x1")
+    {
+        MipPyramid<float> mips(make_checkerboard(16, 8));
+        REQUIRE(mips.levels() == 5);
+        REQUIRE(mips.level(1).width() == 8);
+        REQUIRE(mips.level(1).height() == 4);
+        REQUIRE(mips.level(4).width() == 1);
+        REQUIRE(mips.level(4).height() == 1);
+    }
+
+    SECTION("Odd sizes round down")
+    {
+        MipPyramid<float> mips(make_checkerboard(5, 3));
+        REQUIRE(mips.level(1).width() == 2);
+        REQUIRE(mips.level(1).height() == 1);
+        REQUIRE(mips.level(mips.levels() - 1).width() == 1);
+    }
+
+    SECTION("Level 0 is the base image")
+    {
+        auto base = make_checkerboard(4, 4);
+        MipPyramid<float> mips(base);
+        REQUIRE(&mips.level(0) == base.get());
+        REQUIRE_THROWS(mips.level(mips.levels()));
+    }
+
+    SECTION("Empty images are rejected")
+    {
+        REQUIRE_THROWS(MipPyramid<float>(std::make_shared<Image<float>>()));
+    }
+}
+
+TEST_CASE("MipPyramid - Box filtering preserves the mean", "[images][mip_pyramid]")
+{
+    for (auto [w, h] : {std::pair{64, 64}, std::pair{7, 5}, std::pair{33, 2}}) {
+        auto base = make_checkerboard(w, h);
+        float mean = 0.f;
+        for (std::size_t i = 0; i < base->size(); ++i) {
+            mean += (*base)[i];
+        }
+        mean /= static_cast<float>(base->size());
+
+        MipPyramid<float> mips(base);
+        const auto& top = mips.level(mips.levels() - 1);
+        // Odd sizes weight texels unevenly, so only power of two sizes are exact:
+        float tolerance = (w % 2 == 0 && h % 2 == 0) ? 1e-6f : 0.1f;
+        CHECK_THAT(top(0, 0), WithinAbs(mean, tolerance));
+    }
+}
+
+TEST_CASE("MipPyramid - Footprint selects the level", "[images][mip_pyramid]")
+{
+    MipPyramid<float> mips(make_checkerboard(256, 256));
+    const Vec2<float> uv{0.3f, 0.6f};
+    const float texel = 1.f / 255.f;
+
+    SECTION("Zero footprint samples the base level")
+    {
+        float value = mips.sample(uv, Vec2<float>{0.f}, Vec2<float>{0.f});
+        CHECK(value == mips.level(0).sample_bilinear(uv.x, uv.y));
+    }
+
+    SECTION("Large footprint converges to the image mean")
+    {
+        float value =
+            mips.sample(uv, Vec2<float>{64.f * texel, 0.f}, Vec2<float>{0.f, 64.f * texel});
+        CHECK_THAT(value, WithinAbs(0.5f, 1e-5f));
+    }
+
+    SECTION("Trilinear blends adjacent levels")
+    {
+        float a = mips.level(2).sample_bilinear(uv.x, uv.y);
+        float b = mips.level(3).sample_bilinear(uv.x, uv.y);
+        CHECK_THAT(mips.sample_trilinear(uv.x, uv.y, 2.25f),
+                   WithinAbs(0.75f * a + 0.25f * b, 1e-6f));
+    }
+
+    SECTION("Anisotropic footprint is filtered along its major axis")
+    {
+        // One texel wide, 8 texels long: stays at a fine level instead of blurring to level 3
+        float value = mips.sample(uv, Vec2<float>{8.f * texel, 0.f}, Vec2<float>{0.f, texel});
+        CHECK_THAT(value, WithinAbs(0.5f, 0.05f));
+        CHECK(mips.sample(uv, Vec2<float>{8.f * texel, 0.f}, Vec2<float>{0.f, texel}) ==
+              mips.sample(uv, Vec2<float>{0.f, texel}, Vec2<float>{8.f * texel, 0.f}));
+    }
+}
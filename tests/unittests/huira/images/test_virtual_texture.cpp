@@ -0,0 +1,189 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/images/mip_pyramid.hpp"
+#include "huira/images/virtual_texture.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+namespace {
+std::shared_ptr<Image<float>> make_gradient(int width, int height)
+{
+    auto image = std::make_shared<Image<float>>(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            (*image)(x, y) = static_cast<float>(x) + 0.01f * static_cast<float>(y);
+        }
+    }
+    return image;
+}
+
+// Removes the file when the test finishes, pass or fail:
+struct TempFile {
+    fs::path path;
+    explicit TempFile(const std::string& name) : path{fs::temp_directory_path() / name} {}
+    ~TempFile() { fs::remove(path); }
+};
+} // namespace
+
+TEST_CASE("VirtualTexture - Layout", "[images][virtual_texture]")
+{
+    VirtualTextureLayout layout(Resolution{100, 40}, 1, 32);
+    REQUIRE(layout.levels() == 7);
+    REQUIRE(layout.tiles_x(0) == 4);
+    REQUIRE(layout.tiles_y(0) == 2);
+    REQUIRE(layout.tiles_x(6) == 1);
+    REQUIRE(layout.level_first_tile[1] == 8);
+    REQUIRE(layout.tile_bytes() == 32 * 32 * sizeof(float));
+    REQUIRE(layout.tile_offset(1, 0, 0) == sizeof(VirtualTextureHeader) + 8 * layout.tile_bytes());
+}
+
+TEST_CASE("VirtualTexture - Round trip", "[images][virtual_texture]")
+{
+    TempFile file("huira_test_round_trip.hvt");
+    auto image = make_gradient(37, 21);
+    write_virtual_texture(file.path, *image, 8);
+
+    auto cache = std::make_shared<TileCache>();
+    VirtualTexture<float> texture(file.path, cache);
+    MipPyramid<float> mips(image);
+
+    SECTION("Every level matches the in-memory pyramid")
+    {
+        REQUIRE(texture.levels() == mips.levels());
+        for (std::size_t level = 0; level < mips.levels(); ++level) {
+            Image<float> read = texture.read_level(level);
+            const Image<float>& expected = mips.level(level);
+            REQUIRE(read.width() == expected.width());
+            REQUIRE(read.height() == expected.height());
+            for (std::size_t i = 0; i < read.size(); ++i) {
+                REQUIRE(read[i] == expected[i]);
+            }
+        }
+    }
+
+    SECTION("Filtered lookups match the in-memory pyramid")
+    {
+        for (float duv : {0.f, 0.01f, 0.1f, 0.5f}) {
+            for (float u : {0.f, 0.3f, 0.77f}) {
+                Vec2<float> uv{u, 0.4f};
+                Vec2<float> dx{duv, 0.f};
+                Vec2<float> dy{0.f, duv * 0.5f};
+                REQUIRE_THAT(texture.sample(uv, dx, dy), WithinAbs(mips.sample(uv, dx, dy), 1e-4));
+            }
+        }
+    }
+
+    SECTION("Repeated lookups hit the cache")
+    {
+        (void)texture.sample_bilinear(0, 0.5f, 0.5f);
+        std::size_t misses = cache->misses();
+        (void)texture.sample_bilinear(0, 0.5f, 0.5f);
+        REQUIRE(cache->misses() == misses);
+        REQUIRE(cache->hits() > 0);
+    }
+
+    SECTION("Mismatched pixel types are rejected")
+    {
+        REQUIRE_THROWS(VirtualTexture<Vec3<float>>(file.path, cache));
+    }
+}
+
+TEST_CASE("VirtualTexture - Cache budget", "[images][virtual_texture]")
+{
+    TempFile file("huira_test_budget.hvt");
+    write_virtual_texture(file.path, *make_gradient(256, 256), 16);
+
+    // Room for 16 tiles, far less than the 256 tiles in level 0:
+    const std::size_t tile_bytes = 16 * 16 * sizeof(float);
+    auto cache = std::make_shared<TileCache>(16 * tile_bytes);
+    {
+        VirtualTexture<float> texture(file.path, cache);
+        for (int y = 0; y < 256; y += 8) {
+            for (int x = 0; x < 256; x += 8) {
+                (void)texture.sample_bilinear(0, static_cast<float>(x) / 255.f,
+                                              static_cast<float>(y) / 255.f);
+            }
+        }
+        REQUIRE(cache->resident_bytes() <= cache->budget());
+        REQUIRE(cache->resident_bytes() > 0);
+    }
+
+    // Closing the texture releases its tiles:
+    REQUIRE(cache->resident_bytes() == 0);
+}
+
+TEST_CASE("VirtualTexture - Invalid files", "[images][virtual_texture]")
+{
+    TempFile file("huira_test_invalid.hvt");
+    write_virtual_texture(file.path, *make_gradient(16, 16), 8);
+    fs::resize_file(file.path, fs::file_size(file.path) - 4);
+    REQUIRE_THROWS(read_virtual_texture_layout(file.path));
+    REQUIRE_THROWS(read_virtual_texture_layout(fs::temp_directory_path() / "huira_missing.hvt"));
+}
+
+TEST_CASE("VirtualTexture - Streamed rows", "[images][virtual_texture]")
+{
+    TempFile file("huira_test_streamed.hvt");
+    auto image = make_gradient(45, 19);
+
+    // Rows are asked for once each, top to bottom:
+    int next_row = 0;
+    write_virtual_texture<float>(
+        file.path,
+        image->resolution(),
+        [&](int y, std::span<float> row) {
+            REQUIRE(y == next_row++);
+            REQUIRE(row.size() == 45);
+            for (int x = 0; x < 45; ++x) {
+                row[static_cast<std::size_t>(x)] = (*image)(x, y);
+            }
+        },
+        8);
+    REQUIRE(next_row == 19);
+
+    auto cache = std::make_shared<TileCache>();
+    VirtualTexture<float> texture(file.path, cache);
+    MipPyramid<float> mips(image);
+    REQUIRE(texture.levels() == mips.levels());
+    for (std::size_t level = 0; level < mips.levels(); ++level) {
+        Image<float> read = texture.read_level(level);
+        const Image<float>& expected = mips.level(level);
+        REQUIRE(read.resolution() == expected.resolution());
+        for (std::size_t i = 0; i < read.size(); ++i) {
+            REQUIRE(read[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("VirtualTexture - Converted texels", "[images][virtual_texture]")
+{
+    TempFile file("huira_test_converted.hvt");
+    auto image = make_gradient(20, 12);
+    write_virtual_texture<Vec3<float>>(
+        file.path,
+        *image,
+        [](const float& texel) { return Vec3<float>{texel, 2.f * texel, 0.f}; },
+        8);
+
+    auto cache = std::make_shared<TileCache>();
+    VirtualTexture<Vec3<float>> texture(file.path, cache);
+    MipPyramid<float> mips(image);
+    for (std::size_t level = 0; level < mips.levels(); ++level) {
+        Image<Vec3<float>> read = texture.read_level(level);
+        const Image<float>& expected = mips.level(level);
+        for (std::size_t i = 0; i < read.size(); ++i) {
+            REQUIRE_THAT(read[i].x, WithinAbs(expected[i], 1e-4));
+            REQUIRE_THAT(read[i].y, WithinAbs(2.f * expected[i], 1e-4));
+            REQUIRE(read[i].z == 0.f);
+        }
+    }
+}
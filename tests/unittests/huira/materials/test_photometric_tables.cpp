@@ -0,0 +1,123 @@
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/materials/bsdfs/hapke_bsdf.hpp"
+#include "huira/materials/bsdfs/mcewen_bsdf.hpp"
+#include "huira/materials/bsdfs/phase_angle_table.hpp"
+#include "huira/render/interaction.hpp"
+
+using namespace huira;
+
+namespace {
+struct PhotometricFixture {
+    Interaction<RGB> isect;
+    ShadingParams<RGB> params;
+    std::vector<Vec3<float>> directions;
+
+    PhotometricFixture()
+    {
+        isect.normal_g = Vec3<float>{0.f, 0.f, 1.f};
+        isect.normal_s = isect.normal_g;
+        build_default_tangent_frame(isect.normal_s, isect.tangent, isect.bitangent);
+        params.albedo = RGB{0.12f, 0.1f, 0.08f};
+
+        // Upper-hemisphere directions from grazing to normal, all around the azimuth:
+        for (int i = 1; i <= 16; ++i) {
+            float theta = 1.55f * static_cast<float>(i) / 16.f;
+            for (int j = 0; j < 32; ++j) {
+                float phi = 6.2831853f * static_cast<float>(j) / 32.f;
+                directions.emplace_back(std::sin(theta) * std::cos(phi),
+                                        std::sin(theta) * std::sin(phi),
+                                        std::cos(theta));
+            }
+        }
+    }
+};
+
+template <typename TBSDF>
+float max_relative_difference(const TBSDF& exact,
+                              const TBSDF& tabulated,
+                              const PhotometricFixture& fx)
+{
+    float worst = 0.f;
+    for (const auto& wo : fx.directions) {
+        for (const auto& wi : fx.directions) {
+            RGB a = exact.eval(wo, wi, fx.isect, fx.params);
+            RGB b = tabulated.eval(wo, wi, fx.isect, fx.params);
+            for (std::size_t c = 0; c < RGB::size(); ++c) {
+                float diff = std::abs(a[c] - b[c]) / std::max(std::abs(a[c]), 1e-6f);
+                worst = std::max(worst, diff);
+            }
+        }
+    }
+    return worst;
+}
+} // namespace
+
+TEST_CASE("PhaseAngleTable - Interpolation", "[materials][photometric]")
+{
+    SECTION("Reproduces a linear function of cos(alpha) at any angle")
+    {
+        PhaseAngleTable table([](float cos_alpha) { return 2.f + cos_alpha; }, 64);
+        for (float cos_alpha : {-1.f, -0.7f, -0.01f, 0.f, 0.3f, 0.99f, 1.f}) {
+            REQUIRE_THAT(table(cos_alpha), Catch::Matchers::WithinRel(2.f + cos_alpha, 1e-3f));
+        }
+    }
+
+    SECTION("Rejects degenerate resolutions")
+    {
+        REQUIRE_THROWS(PhaseAngleTable([](float) { return 1.f; }, 2));
+    }
+}
+
+TEST_CASE("Photometric BSDFs - Tabulated evaluation matches exact", "[materials][photometric]")
+{
+    PhotometricFixture fx;
+
+    SECTION("Hapke")
+    {
+        HapkeBSDF<RGB> exact(0.06f, 1.0f, 0.2f, 0.5f, PhotometricEvaluation::Exact);
+        HapkeBSDF<RGB> tabulated(0.06f, 1.0f, 0.2f, 0.5f, PhotometricEvaluation::Tabulated);
+        REQUIRE(exact.table_error() == 0.f);
+        REQUIRE(tabulated.table_error() < 1e-4f);
+        REQUIRE(max_relative_difference(exact, tabulated, fx) < 1e-3f);
+    }
+
+    SECTION("McEwen")
+    {
+        McEwenBSDF<RGB> exact(PhotometricEvaluation::Exact);
+        McEwenBSDF<RGB> tabulated(PhotometricEvaluation::Tabulated);
+        REQUIRE(tabulated.table_error() < 1e-5f);
+        REQUIRE(max_relative_difference(exact, tabulated, fx) < 1e-4f);
+    }
+}
+
+// Not run by default; use `test_photometric_tables "[benchmark]"` to compare the two paths.
+TEST_CASE("Photometric BSDFs - Evaluation throughput", "[.][benchmark]")
+{
+    PhotometricFixture fx;
+    HapkeBSDF<RGB> hapke_exact(0.06f, 1.0f, 0.2f, 0.5f, PhotometricEvaluation::Exact);
+    HapkeBSDF<RGB> hapke_tabulated(0.06f, 1.0f, 0.2f, 0.5f, PhotometricEvaluation::Tabulated);
+    McEwenBSDF<RGB> mcewen_exact(PhotometricEvaluation::Exact);
+    McEwenBSDF<RGB> mcewen_tabulated(PhotometricEvaluation::Tabulated);
+
+    auto sweep = [&fx](const BSDF<RGB>& bsdf) {
+        RGB sum{0.f};
+        for (const auto& wo : fx.directions) {
+            for (const auto& wi : fx.directions) {
+                sum += bsdf.eval(wo, wi, fx.isect, fx.params);
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("Hapke exact") { return sweep(hapke_exact); };
+    BENCHMARK("Hapke tabulated") { return sweep(hapke_tabulated); };
+    BENCHMARK("McEwen exact") { return sweep(mcewen_exact); };
+    BENCHMARK("McEwen tabulated") { return sweep(mcewen_tabulated); };
+}
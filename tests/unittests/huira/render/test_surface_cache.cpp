@@ -0,0 +1,208 @@
+#include <cmath>
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/render/surface_cache.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+using Cache = SurfaceCache<float>;
+
+const SurfaceCacheBody BODY{42, 0};
+const Vec3<float> SUN{1.f, 0.f, 0.f};
+
+// The sun turned by an angle about the z axis of a body:
+Vec3<float> sun_turned_by(float angle)
+{
+    return Vec3<float>{std::cos(angle), std::sin(angle), 0.f};
+}
+
+void insert_values(Cache& cache, const SurfaceCacheCell& cell, const std::vector<float>& values)
+{
+    std::vector<Cache::Record> records;
+    for (float value : values) {
+        records.push_back({BODY, cell, value});
+    }
+    cache.insert(records);
+}
+} // namespace
+
+TEST_CASE("SurfaceCache - Cells", "[render][surface_cache]")
+{
+    // Positions are floored onto the grid, in the body's frame:
+    const Vec3<float> up{0.f, 0.f, 1.f};
+    SurfaceCacheCell cell = make_surface_cache_cell(Vec3<float>{2.5f, -0.5f, 7.9f}, up, 0.5f);
+    REQUIRE(cell.x == 1);
+    REQUIRE(cell.y == -1);
+    REQUIRE(cell.z == 3);
+    REQUIRE(cell == make_surface_cache_cell(Vec3<float>{3.9f, -1.9f, 6.1f}, up, 0.5f));
+    REQUIRE_FALSE(cell == make_surface_cache_cell(Vec3<float>{4.f, -0.5f, 7.9f}, up, 0.5f));
+
+    // Normals are binned by their dominant axis and its sign, so that opposite faces sharing a
+    // cell are kept apart:
+    const Vec3<float> origin{0.f};
+    const Vec3<float> normals[6]{
+        {0.9f, 0.1f, 0.3f},
+        {-0.9f, 0.1f, 0.3f},
+        {0.2f, 0.8f, -0.1f},
+        {0.2f, -0.8f, -0.1f},
+        {0.3f, 0.1f, 0.6f},
+        {0.3f, 0.1f, -0.6f},
+    };
+    std::unordered_set<SurfaceCacheCell, SurfaceCacheCellHash> cells;
+    for (std::size_t bin = 0; bin < 6; ++bin) {
+        SurfaceCacheCell binned = make_surface_cache_cell(origin, normals[bin], 1.f);
+        REQUIRE(binned.normal_bin == bin);
+        cells.insert(binned);
+    }
+    REQUIRE(cells.size() == 6);
+
+    // Equal cells hash alike:
+    SurfaceCacheCellHash hash;
+    REQUIRE(hash(cell) == hash(make_surface_cache_cell(Vec3<float>{3.9f, -1.9f, 6.1f}, up, 0.5f)));
+}
+
+TEST_CASE("SurfaceCache - Lookups", "[render][surface_cache]")
+{
+    Cache cache(units::Meter(1.0), units::Radian(0.01), 4);
+    const SurfaceCacheCell cell{1, 2, 3, 4};
+    const SurfaceCacheCell other{1, 2, 3, 5};
+
+    // Records for bodies without a sun direction are dropped:
+    insert_values(cache, cell, {1.f, 1.f, 1.f, 1.f});
+    REQUIRE(cache.size() == 0);
+    REQUIRE_FALSE(cache.lookup(BODY, cell));
+
+    REQUIRE_FALSE(cache.update_sun_direction(BODY, SUN));
+
+    // Below min_samples a cell is not returned:
+    insert_values(cache, cell, {1.f, 2.f, 3.f});
+    REQUIRE(cache.size() == 1);
+    REQUIRE_FALSE(cache.lookup(BODY, cell));
+
+    // From min_samples on, its mean is:
+    insert_values(cache, cell, {6.f});
+    auto value = cache.lookup(BODY, cell);
+    REQUIRE(value);
+    REQUIRE_THAT(*value, WithinAbs(3.0, 1e-6));
+
+    insert_values(cache, cell, {8.f});
+    REQUIRE_THAT(*cache.lookup(BODY, cell), WithinAbs(4.0, 1e-6));
+
+    // Cells and bodies are kept apart:
+    REQUIRE_FALSE(cache.lookup(BODY, other));
+    REQUIRE_FALSE(cache.lookup(SurfaceCacheBody{42, 1}, cell));
+
+    cache.set_min_samples(6);
+    REQUIRE_FALSE(cache.lookup(BODY, cell));
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE_THROWS(cache.set_min_samples(0));
+    REQUIRE_THROWS(cache.set_cell_size(units::Meter(0.0)));
+}
+
+TEST_CASE("SurfaceCache - Forgetting", "[render][surface_cache]")
+{
+    Cache cache(units::Meter(1.0), units::Radian(0.01), 1);
+    cache.set_max_samples(4);
+    REQUIRE_THROWS(cache.set_max_samples(0));
+    cache.update_sun_direction(BODY, SUN);
+    const SurfaceCacheCell cell{};
+
+    // Once a cell holds the maximum of four observations, its sum and count are halved before the
+    // next one is added, so newer values take over:
+    insert_values(cache, cell, {0.f, 0.f, 0.f, 0.f});
+    REQUIRE_THAT(*cache.lookup(BODY, cell), WithinAbs(0.0, 1e-6));
+    insert_values(cache, cell, {3.f});
+    REQUIRE_THAT(*cache.lookup(BODY, cell), WithinAbs(1.0, 1e-6));
+    insert_values(cache, cell, {3.f, 3.f, 3.f, 3.f, 3.f, 3.f, 3.f, 3.f});
+    REQUIRE_THAT(*cache.lookup(BODY, cell), WithinAbs(3.0, 0.2));
+}
+
+TEST_CASE("SurfaceCache - Sun direction", "[render][surface_cache]")
+{
+    Cache cache(units::Meter(1.0), units::Radian(0.01), 1);
+    const SurfaceCacheCell cell{};
+    const SurfaceCacheBody other{7, 0};
+    cache.update_sun_direction(BODY, SUN);
+    cache.update_sun_direction(other, SUN);
+    insert_values(cache, cell, {2.f});
+    cache.insert({{other, cell, 5.f}});
+    REQUIRE(cache.size() == 2);
+
+    // Within the tolerance, entries are kept:
+    REQUIRE(cache.same_sun_direction(SUN, sun_turned_by(0.005f)));
+    REQUIRE_FALSE(cache.update_sun_direction(BODY, sun_turned_by(0.005f)));
+    REQUIRE_THAT(*cache.lookup(BODY, cell), WithinAbs(2.0, 1e-6));
+
+    // Past it, the body's entries are dropped, and the body is lit from the new direction:
+    REQUIRE_FALSE(cache.same_sun_direction(SUN, sun_turned_by(0.02f)));
+    REQUIRE(cache.update_sun_direction(BODY, sun_turned_by(0.02f)));
+    REQUIRE_FALSE(cache.lookup(BODY, cell));
+    REQUIRE_FALSE(cache.update_sun_direction(BODY, sun_turned_by(0.025f)));
+
+    // Other bodies are left alone:
+    REQUIRE(cache.size() == 1);
+    REQUIRE_THAT(*cache.lookup(other, cell), WithinAbs(5.0, 1e-6));
+}
+
+TEST_CASE("IrradianceCache - Path records", "[render][surface_cache]")
+{
+    using Radiance = IrradianceCache<Spectral>;
+    const SurfaceCacheCell cell{};
+
+    // Radiance leaving each vertex is what the path gathered after it, per unit throughput and
+    // albedo:
+    std::vector<Radiance::PathVertex> vertices{
+        {BODY, cell, Spectral{1.f}, Spectral{0.f}, Spectral{0.5f}},
+        {BODY, cell, Spectral{0.25f}, Spectral{2.f}, Spectral{0.5f}},
+    };
+    std::vector<Radiance::Record> records;
+    Radiance::append_records(vertices, Spectral{3.f}, records);
+    REQUIRE(records.size() == 2);
+    REQUIRE_THAT(records[0].value[0], WithinAbs(6.0, 1e-5));
+    REQUIRE_THAT(records[1].value[0], WithinAbs(8.0, 1e-5));
+
+    // Black surfaces record nothing rather than dividing by zero:
+    vertices[0].albedo = Spectral{0.f};
+    records.clear();
+    Radiance::append_records(vertices, Spectral{3.f}, records);
+    REQUIRE(records[0].value == Spectral{0.f});
+}
+
+TEST_CASE("ShadowCache - Visibility", "[render][surface_cache]")
+{
+    using Shadows = ShadowCache<Spectral>;
+    Shadows cache;
+    const SurfaceCacheCell cell{};
+    cache.update_sun_direction(BODY, SUN);
+
+    // The penumbra is the mean of the shadow rays sampled in a cell, once it has eight of them:
+    std::vector<Shadows::Record> records;
+    for (int i = 0; i < 7; ++i) {
+        records.push_back({BODY, cell, Spectral{i % 2 == 0 ? 1.f : 0.f}});
+    }
+    cache.insert(records);
+    REQUIRE_FALSE(cache.lookup(BODY, cell));
+
+    cache.insert({{BODY, cell, Spectral{0.f}}});
+    auto visibility = cache.lookup(BODY, cell);
+    REQUIRE(visibility);
+    REQUIRE_THAT((*visibility)[0], WithinAbs(0.5, 1e-6));
+
+    // Shadows are kept while the sun moves less than a milliradian relative to the body:
+    REQUIRE_FALSE(cache.update_sun_direction(BODY, sun_turned_by(0.0005f)));
+    REQUIRE(cache.lookup(BODY, cell));
+
+    REQUIRE(cache.update_sun_direction(BODY, sun_turned_by(0.002f)));
+    REQUIRE_FALSE(cache.lookup(BODY, cell));
+    REQUIRE(cache.size() == 0);
+}
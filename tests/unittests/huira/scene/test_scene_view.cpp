@@ -0,0 +1,281 @@
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/render/sampler.hpp"
+#include "huira/scene/scene.hpp"
+#include "huira/scene/scene_view.hpp"
+#include "huira/volumes/medium_stack.hpp"
+
+using namespace huira;
+using namespace huira::units::literals;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+using Spectral = UniformSpectralBins<8, 380, 750>;
+
+constexpr unsigned int MASK_GEOMETRY = 0x01;
+constexpr unsigned int MASK_LIGHT = 0x02;
+
+const Interval EXPOSURE{Time::from_et(0.0), Time::from_et(1.0)};
+
+Ray<Spectral> ray_towards(const Vec3<float>& target)
+{
+    return Ray<Spectral>(Vec3<float>{0.f}, glm::normalize(target));
+}
+
+float transmittance(const SceneView<Spectral>& view, const Ray<Spectral>& ray, float t_far)
+{
+    RandomSampler<float> sampler(1);
+    return view.evaluate_transmittance(ray, t_far, MediumStack<Spectral>{}, sampler)[0];
+}
+
+// Seen from the camera at the origin, looking down +z: a tilted, stretched ellipsoid 20 m
+// ahead, a veil letting half the light through each of its two faces 10 m ahead, and a sphere
+// light off to the side:
+struct BodiesScene {
+    Scene<Spectral> scene;
+    InstanceHandle<Spectral> camera = scene.root.new_instance(scene.new_camera_model());
+
+    BodiesScene()
+    {
+        auto body = scene.root.new_instance(
+            scene.add_primitive(scene.add_ellipsoid(2_m, 3_m, 4_m)));
+        body.set_position(0_m, 0_m, 20_m);
+        body.set_rotation_local_to_parent(Vec3<double>{0.0, 1.0, 0.0}, 30_deg);
+        body.set_scale(1.0, 1.5, 1.0);
+
+        auto veil_material = scene.new_material(scene.new_bsdf_null());
+        veil_material.set_transmission_factor(Spectral{0.5f});
+        auto veil = scene.root.new_instance(
+            scene.add_primitive(scene.add_ellipsoid(0.5_m, 0.5_m, 0.5_m), veil_material));
+        veil.set_position(0_m, 0_m, 10_m);
+        veil.set_scale(2.0);
+
+        auto light = scene.root.new_instance(scene.new_sphere_light(1_m, 100_W));
+        light.set_position(6_m, 0_m, 20_m);
+    }
+};
+
+// Seen from the camera at the origin, looking down +z: a square 5 m ahead, shaded with a material
+// the tests set up, in front of a larger, opaque one 10 m ahead:
+struct QuadsScene {
+    Scene<Spectral> scene;
+    InstanceHandle<Spectral> camera = scene.root.new_instance(scene.new_camera_model());
+    MaterialHandle<Spectral> front_material = scene.new_material(scene.new_bsdf_lambertian());
+
+    QuadsScene()
+    {
+        VertexBuffer<Spectral> vertices(4);
+        const Vec3<float> corners[4]{
+            {-1.f, -1.f, 0.f}, {1.f, -1.f, 0.f}, {1.f, 1.f, 0.f}, {-1.f, 1.f, 0.f}};
+        for (std::size_t i = 0; i < 4; ++i) {
+            vertices[i].position = corners[i];
+            vertices[i].normal = Vec3<float>{0.f, 0.f, -1.f};
+        }
+        auto square = scene.add_mesh(IndexBuffer{0, 1, 2, 0, 2, 3}, vertices);
+
+        auto front = scene.root.new_instance(scene.add_primitive(square, front_material));
+        front.set_position(0_m, 0_m, 5_m);
+        auto back = scene.root.new_instance(scene.add_primitive(square));
+        back.set_position(0_m, 0_m, 10_m);
+        back.set_scale(4.0);
+    }
+
+    void set_front_alpha(float alpha)
+    {
+        front_material.set_alpha_image(scene.add_texture(Image<float>(2, 2, alpha)));
+    }
+};
+
+// A ray through both squares, away from the diagonal their triangles share:
+const Ray<Spectral> THROUGH_QUADS = ray_towards(Vec3<float>{0.02f, -0.04f, 1.f});
+
+float distance_to(float z)
+{
+    return z / THROUGH_QUADS.direction().z;
+}
+
+void require_same_hit(const HitRecord& analytic, const HitRecord& embree)
+{
+    REQUIRE(analytic.hit() == embree.hit());
+    if (!analytic.hit()) {
+        return;
+    }
+    REQUIRE(analytic.inst_id == embree.inst_id);
+    REQUIRE_THAT(analytic.t, WithinRel(embree.t, 1e-5f));
+    const Vec3<float> a = glm::normalize(analytic.Ng);
+    const Vec3<float> b = glm::normalize(embree.Ng);
+    REQUIRE_THAT(a.x, WithinAbs(b.x, 1e-5));
+    REQUIRE_THAT(a.y, WithinAbs(b.y, 1e-5));
+    REQUIRE_THAT(a.z, WithinAbs(b.z, 1e-5));
+}
+} // namespace
+
+TEST_CASE("SceneView - Analytic bodies trace as Embree does", "[scene][scene_view]")
+{
+    BodiesScene bodies;
+
+    // A single temporal sample lets the view trace its ellipsoids and sphere light directly,
+    // while motion blur sends the same scene through Embree:
+    SceneView<Spectral> analytic(
+        bodies.scene, EXPOSURE, bodies.camera, ObservationMode::TRUE_STATE);
+    SceneView<Spectral> embree(
+        bodies.scene, EXPOSURE, bodies.camera, ObservationMode::TRUE_STATE, 2);
+    REQUIRE(analytic.traces_analytic_bodies());
+    REQUIRE_FALSE(embree.traces_analytic_bodies());
+
+    SECTION("Closest hits")
+    {
+        // A fan of rays across the ellipsoid, the veil and the light, including some that miss:
+        std::size_t hits = 0;
+        for (int i = -10; i <= 10; ++i) {
+            for (int j = -10; j <= 10; ++j) {
+                const Ray<Spectral> ray = ray_towards(
+                    Vec3<float>{0.8f * static_cast<float>(i), 0.8f * static_cast<float>(j), 20.f});
+                const HitRecord hit = analytic.intersect(ray);
+                require_same_hit(hit, embree.intersect(ray));
+                hits += hit.hit() ? 1 : 0;
+            }
+        }
+        REQUIRE(hits > 0);
+        REQUIRE(hits < 21 * 21);
+
+        // Straight ahead, the veil is hit before the ellipsoid behind it:
+        const HitRecord ahead = analytic.intersect(ray_towards(Vec3<float>{0.f, 0.f, 1.f}));
+        REQUIRE(ahead.hit());
+        REQUIRE_THAT(ahead.t, WithinAbs(9.0, 1e-4));
+    }
+
+    SECTION("Masks")
+    {
+        const Ray<Spectral> at_light = ray_towards(Vec3<float>{6.f, 0.f, 20.f});
+        const Ray<Spectral> at_body = ray_towards(Vec3<float>{0.f, 3.f, 20.f});
+
+        for (unsigned int mask : {MASK_GEOMETRY, MASK_LIGHT, MASK_GEOMETRY | MASK_LIGHT}) {
+            require_same_hit(analytic.intersect(at_light, 0.5f, mask),
+                             embree.intersect(at_light, 0.5f, mask));
+            require_same_hit(analytic.intersect(at_body, 0.5f, mask),
+                             embree.intersect(at_body, 0.5f, mask));
+        }
+        REQUIRE(analytic.intersect(at_light, 0.5f, MASK_LIGHT).hit());
+        REQUIRE_FALSE(analytic.intersect(at_light, 0.5f, MASK_GEOMETRY).hit());
+        REQUIRE(analytic.intersect(at_body, 0.5f, MASK_GEOMETRY).hit());
+        REQUIRE_FALSE(analytic.intersect(at_body, 0.5f, MASK_LIGHT).hit());
+    }
+
+    SECTION("Occlusion")
+    {
+        // Lights never block shadow rays, and the ellipsoid only does within range:
+        const Ray<Spectral> at_light = ray_towards(Vec3<float>{6.f, 0.f, 20.f});
+        const Ray<Spectral> at_body = ray_towards(Vec3<float>{0.f, 3.f, 20.f});
+        for (const auto& [ray, t_far, expected] : {std::tuple{at_light, 100.f, 1.f},
+                                                   std::tuple{at_body, 100.f, 0.f},
+                                                   std::tuple{at_body, 5.f, 1.f}}) {
+            REQUIRE_THAT(transmittance(analytic, ray, t_far), WithinAbs(expected, 1e-6));
+            REQUIRE_THAT(transmittance(embree, ray, t_far), WithinAbs(expected, 1e-6));
+        }
+    }
+
+    SECTION("Crossing transmissive surfaces")
+    {
+        // Straight ahead, a shadow ray passes both faces of the veil before reaching the
+        // ellipsoid:
+        const Ray<Spectral> ahead = ray_towards(Vec3<float>{0.f, 0.f, 1.f});
+        for (const auto& [t_far, expected] :
+             {std::pair{5.f, 1.f}, std::pair{10.f, 0.5f}, std::pair{12.f, 0.25f},
+              std::pair{100.f, 0.f}}) {
+            REQUIRE_THAT(transmittance(analytic, ahead, t_far), WithinAbs(expected, 1e-5));
+            REQUIRE_THAT(transmittance(embree, ahead, t_far), WithinAbs(expected, 1e-5));
+        }
+    }
+}
+
+TEST_CASE("SceneView - Alpha-tested surfaces", "[scene][scene_view]")
+{
+    QuadsScene quads;
+
+    SECTION("Transparent")
+    {
+        quads.set_front_alpha(0.f);
+        SceneView<Spectral> view(quads.scene, EXPOSURE, quads.camera, ObservationMode::TRUE_STATE);
+        const HitRecord hit = view.intersect(THROUGH_QUADS);
+        REQUIRE(hit.hit());
+        REQUIRE_THAT(hit.t, WithinRel(distance_to(10.f), 1e-5f));
+
+        // Shadow rays pass it too, up to the square behind:
+        REQUIRE(transmittance(view, THROUGH_QUADS, distance_to(7.f)) == 1.f);
+        REQUIRE(transmittance(view, THROUGH_QUADS, distance_to(20.f)) == 0.f);
+    }
+
+    SECTION("Opaque")
+    {
+        quads.set_front_alpha(1.f);
+        SceneView<Spectral> view(quads.scene, EXPOSURE, quads.camera, ObservationMode::TRUE_STATE);
+        const HitRecord hit = view.intersect(THROUGH_QUADS);
+        REQUIRE(hit.hit());
+        REQUIRE_THAT(hit.t, WithinRel(distance_to(5.f), 1e-5f));
+
+        REQUIRE(transmittance(view, THROUGH_QUADS, distance_to(4.f)) == 1.f);
+        REQUIRE(transmittance(view, THROUGH_QUADS, distance_to(7.f)) == 0.f);
+    }
+
+    SECTION("Partly transparent")
+    {
+        // Each ray passes with a chance of one minus the opacity:
+        quads.front_material.set_alpha_factor(0.5f);
+        SceneView<Spectral> view(quads.scene, EXPOSURE, quads.camera, ObservationMode::TRUE_STATE);
+        std::size_t front = 0;
+        std::size_t total = 0;
+        for (int i = -10; i < 10; ++i) {
+            for (int j = -10; j < 10; ++j) {
+                const HitRecord hit = view.intersect(ray_towards(
+                    Vec3<float>{0.019f * static_cast<float>(i) + 0.005f,
+                                0.019f * static_cast<float>(j) + 0.003f,
+                                1.f}));
+                REQUIRE(hit.hit());
+                front += hit.t < 7.f ? 1 : 0;
+                ++total;
+            }
+        }
+        REQUIRE(front > total * 35 / 100);
+        REQUIRE(front < total * 65 / 100);
+    }
+}
+
+TEST_CASE("SceneView - Shadow rays through transmissive surfaces", "[scene][scene_view]")
+{
+    QuadsScene quads;
+    quads.front_material.set_transmission_factor(Spectral{0.5f});
+
+    SECTION("Transmissive")
+    {
+        SceneView<Spectral> view(quads.scene, EXPOSURE, quads.camera, ObservationMode::TRUE_STATE);
+
+        // Primary rays still stop at the surface:
+        REQUIRE_THAT(view.intersect(THROUGH_QUADS).t, WithinRel(distance_to(5.f), 1e-5f));
+
+        // While shadow rays are let through, attenuated, until the opaque square:
+        REQUIRE(transmittance(view, THROUGH_QUADS, distance_to(4.f)) == 1.f);
+        REQUIRE_THAT(transmittance(view, THROUGH_QUADS, distance_to(7.f)), WithinAbs(0.5, 1e-6));
+        REQUIRE(transmittance(view, THROUGH_QUADS, distance_to(20.f)) == 0.f);
+    }
+
+    SECTION("Transmissive and alpha-tested")
+    {
+        // Where the alpha test keeps the surface, it attenuates as before:
+        quads.set_front_alpha(1.f);
+        SceneView<Spectral> kept(quads.scene, EXPOSURE, quads.camera, ObservationMode::TRUE_STATE);
+        REQUIRE_THAT(transmittance(kept, THROUGH_QUADS, distance_to(7.f)), WithinAbs(0.5, 1e-6));
+
+        // Where it cuts the surface out, nothing is left to attenuate:
+        quads.set_front_alpha(0.f);
+        SceneView<Spectral> cut(quads.scene, EXPOSURE, quads.camera, ObservationMode::TRUE_STATE);
+        REQUIRE(transmittance(cut, THROUGH_QUADS, distance_to(7.f)) == 1.f);
+        REQUIRE(transmittance(cut, THROUGH_QUADS, distance_to(20.f)) == 0.f);
+    }
+}
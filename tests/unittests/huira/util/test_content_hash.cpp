@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "huira/util/content_hash.hpp"
+
+using namespace huira;
+
+namespace {
+std::uint64_t hash_floats(const std::vector<float>& values)
+{
+    return ContentHasher{}.values(values.data(), values.size()).digest();
+}
+} // namespace
+
+TEST_CASE("ContentHasher - Equal content gives equal digests", "[util][content_hash]")
+{
+    std::vector<float> a{1.f, 2.f, 3.f, 4.f, 5.f};
+    std::vector<float> b = a;
+    REQUIRE(hash_floats(a) == hash_floats(b));
+
+    // Feeding the same bytes in pieces does not change the digest:
+    ContentHasher pieces;
+    pieces.values(a.data(), 2).values(a.data() + 2, 3);
+    REQUIRE(pieces.digest() == hash_floats(a));
+}
+
+TEST_CASE("ContentHasher - Different content gives different digests", "[util][content_hash]")
+{
+    std::vector<float> a{1.f, 2.f, 3.f, 4.f, 5.f};
+
+    SECTION("Changed value")
+    {
+        std::vector<float> b = a;
+        b[4] = 6.f;
+        REQUIRE(hash_floats(a) != hash_floats(b));
+    }
+
+    SECTION("Changed order")
+    {
+        std::vector<float> b{2.f, 1.f, 3.f, 4.f, 5.f};
+        REQUIRE(hash_floats(a) != hash_floats(b));
+    }
+
+    SECTION("Trailing zeros")
+    {
+        std::vector<float> b = a;
+        b.push_back(0.f);
+        REQUIRE(hash_floats(a) != hash_floats(b));
+    }
+
+    SECTION("String boundaries")
+    {
+        REQUIRE(ContentHasher{}.string("ab").string("c").digest() !=
+                ContentHasher{}.string("a").string("bc").digest());
+    }
+}
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/constants.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/volumes/atmosphere.hpp"
+#include "huira/volumes/density/exponential_density_field.hpp"
+#include "huira/volumes/scattering/isotropic_scatter.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinRel;
+
+namespace {
+constexpr float EARTH_RADIUS = 6.371e6f;
+
+Atmosphere<Visible8> make_atmosphere(float scattering)
+{
+    auto air = std::make_shared<ExponentialDensityField<Visible8>>(
+        EARTH_RADIUS, 8000.f, Visible8{0.f}, Visible8{scattering});
+    auto phase = std::make_shared<IsotropicPhaseFunction<Visible8>>();
+    return Atmosphere<Visible8>({AtmosphereLayer<Visible8>{air, phase}});
+}
+} // namespace
+
+TEST_CASE("Atmosphere - Transmittance table", "[volumes][atmosphere]")
+{
+    auto atmosphere = make_atmosphere(1e-5f);
+    ExponentialDensityField<Visible8> air(EARTH_RADIUS, 8000.f, Visible8{0.f}, Visible8{1e-5f});
+
+    for (float mu : {1.f, 0.3f, 0.05f, 0.f, -0.02f}) {
+        float radius = EARTH_RADIUS + 3000.f;
+        Ray<Visible8> ray(Vec3<float>{0.f, 0.f, radius},
+                          Vec3<float>{std::sqrt(1.f - mu * mu), 0.f, mu});
+        float depth = (*air.optical_depth(ray, 0.f, std::numeric_limits<float>::infinity()))[0];
+        REQUIRE_THAT(atmosphere.transmittance_to_top(radius, mu)[0],
+                     WithinRel(std::exp(-depth), 0.01f));
+    }
+
+    // Looking below the horizon from the ground the planet is in the way:
+    REQUIRE(atmosphere.transmittance_to_top(EARTH_RADIUS, -0.1f)[0] == 0.f);
+}
+
+TEST_CASE("Atmosphere - Segments", "[volumes][atmosphere]")
+{
+    auto atmosphere = make_atmosphere(1e-5f);
+    Ray<Visible8> ray(Vec3<float>{-2e6f, 0.f, EARTH_RADIUS + 20000.f}, Vec3<float>{1.f, 0.f, 0.f});
+
+    SECTION("Without light only transmittance remains")
+    {
+        auto segment = atmosphere.integrate(ray, std::numeric_limits<float>::infinity(), {});
+        REQUIRE(segment.radiance.max() == 0.f);
+        REQUIRE_THAT(segment.transmittance[0],
+                     WithinRel(atmosphere.transmittance(ray, 1e9f)[0], 1e-4f));
+        REQUIRE(segment.transmittance[0] < 1.f);
+    }
+
+    SECTION("Rays missing the atmosphere are unaffected")
+    {
+        Ray<Visible8> miss(Vec3<float>{0.f, 0.f, 2.f * EARTH_RADIUS}, Vec3<float>{1.f, 0.f, 0.f});
+        AtmosphereLight<Visible8> sun{Vec3<float>{0.f, 0.f, 1.f}, Visible8{1000.f}};
+        auto segment = atmosphere.integrate(miss, std::numeric_limits<float>::infinity(), {sun});
+        REQUIRE(segment.radiance.max() == 0.f);
+        REQUIRE(segment.transmittance.min() == 1.f);
+    }
+}
+
+TEST_CASE("Atmosphere - Optically thin single scattering", "[volumes][atmosphere]")
+{
+    // With almost no extinction, looking straight down with the sun overhead sees the vertical
+    // column scattered isotropically:
+    const float scattering = 1e-9f;
+    auto atmosphere = make_atmosphere(scattering);
+    AtmosphereLight<Visible8> sun{Vec3<float>{0.f, 0.f, 1.f}, Visible8{1000.f}};
+    Ray<Visible8> ray(Vec3<float>{0.f, 0.f, EARTH_RADIUS + 500000.f}, Vec3<float>{0.f, 0.f, -1.f});
+
+    auto segment = atmosphere.integrate(ray, std::numeric_limits<float>::infinity(), {sun});
+    float top = ExponentialDensityField<Visible8>::DEFAULT_TOP_SCALE_HEIGHTS;
+    float column = scattering * 8000.f * (1.f - std::exp(-top));
+    float expected = 1000.f * column / (4.f * PI<float>());
+    REQUIRE_THAT(segment.radiance[0], WithinRel(expected, 0.02f));
+}
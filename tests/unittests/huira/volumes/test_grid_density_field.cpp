@@ -0,0 +1,157 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/volumes/density/grid_density_field.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinAbs;
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::size_t N = 40;
+
+// A ball of unit density in one corner of a [0, 40]^3 box, one unit per voxel:
+std::vector<float> make_ball()
+{
+    std::vector<float> densities(N * N * N, 0.f);
+    for (std::size_t k = 0; k < N; ++k) {
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t i = 0; i < N; ++i) {
+                float x = static_cast<float>(i) + 0.5f - 8.f;
+                float y = static_cast<float>(j) + 0.5f - 8.f;
+                float z = static_cast<float>(k) + 0.5f - 8.f;
+                if (x * x + y * y + z * z < 25.f) {
+                    densities[i + N * (j + N * k)] = 1.f;
+                }
+            }
+        }
+    }
+    return densities;
+}
+
+GridDensityField<Visible8> make_field()
+{
+    return GridDensityField<Visible8>({N, N, N},
+                                      make_ball(),
+                                      Vec3<float>{0.f, 0.f, 0.f},
+                                      Vec3<float>{40.f, 40.f, 40.f},
+                                      Visible8{0.1f},
+                                      Visible8{0.4f});
+}
+
+// Removes the file when the test finishes, pass or fail:
+struct TempFile {
+    fs::path path;
+    explicit TempFile(const std::string& name) : path{fs::temp_directory_path() / name} {}
+    ~TempFile() { fs::remove(path); }
+};
+} // namespace
+
+TEST_CASE("GridDensityField - Lookup", "[volumes][density]")
+{
+    auto field = make_field();
+
+    // Only the bricks around the ball are stored:
+    REQUIRE(field.brick_count() == 125);
+    REQUIRE(field.occupied_brick_count() == 8);
+
+    REQUIRE_THAT(field.density(Vec3<float>{8.f, 8.f, 8.f}), WithinAbs(1.f, 1e-6f));
+    REQUIRE(field.density(Vec3<float>{30.f, 30.f, 30.f}) == 0.f);
+    REQUIRE(field.density(Vec3<float>{-1.f, 8.f, 8.f}) == 0.f);
+
+    // Halfway between two voxel centres the density is their average:
+    REQUIRE_THAT(field.density(Vec3<float>{13.f, 8.5f, 8.5f}), WithinAbs(0.5f, 1e-6f));
+
+    auto props = field.evaluate(Vec3<float>{8.f, 8.f, 8.f});
+    REQUIRE_THAT(props.extinction()[0], WithinAbs(0.5f, 1e-6f));
+
+    REQUIRE_THROWS(GridDensityField<Visible8>({N, N, N},
+                                              std::vector<float>(10, 1.f),
+                                              Vec3<float>{0.f},
+                                              Vec3<float>{1.f},
+                                              Visible8{0.f},
+                                              Visible8{1.f}));
+}
+
+TEST_CASE("GridDensityField - Majorant traversal", "[volumes][density]")
+{
+    auto field = make_field();
+
+    SECTION("Segments are ordered, bounded and skip empty space")
+    {
+        Ray<Visible8> ray(Vec3<float>{-10.f, 7.f, 9.f}, Vec3<float>{1.f, 0.05f, 0.02f});
+        auto [t_begin, t_end] = field.support(ray);
+        REQUIRE_THAT(t_begin, WithinAbs(10.f, 1e-4f));
+
+        float previous_end = t_begin;
+        std::size_t visited = 0;
+        field.for_each_majorant_segment(ray, 0.f, 1e6f, [&](float a, float b, float majorant) {
+            REQUIRE(a >= previous_end - 1e-4f);
+            REQUIRE(b > a);
+            for (int i = 0; i <= 50; ++i) {
+                float t = a + (b - a) * static_cast<float>(i) / 50.f;
+                REQUIRE(field.evaluate(ray.at(t)).extinction().max() <= majorant * 1.0001f);
+            }
+            previous_end = b;
+            ++visited;
+            return true;
+        });
+
+        // The ray crosses five bricks but only those next to the ball have any density:
+        REQUIRE(visited == 3);
+        REQUIRE(previous_end < 40.f);
+    }
+
+    SECTION("Rays through empty bricks visit nothing")
+    {
+        Ray<Visible8> ray(Vec3<float>{-10.f, 35.f, 35.f}, Vec3<float>{1.f, 0.f, 0.f});
+        bool called = false;
+        field.for_each_majorant_segment(ray, 0.f, 1e6f, [&](float, float, float) {
+            called = true;
+            return true;
+        });
+        REQUIRE_FALSE(called);
+        REQUIRE(field.majorant(ray, 0.f, 1e6f) == 0.f);
+    }
+
+    SECTION("Rays missing the box have no support")
+    {
+        Ray<Visible8> ray(Vec3<float>{-10.f, 50.f, 8.f}, Vec3<float>{1.f, 0.f, 0.f});
+        auto [t_begin, t_end] = field.support(ray);
+        REQUIRE_FALSE(t_begin < t_end);
+    }
+
+    SECTION("Traversal stops when asked")
+    {
+        Ray<Visible8> ray(Vec3<float>{-10.f, 7.f, 9.f}, Vec3<float>{1.f, 0.f, 0.f});
+        std::size_t visited = 0;
+        field.for_each_majorant_segment(ray, 0.f, 1e6f, [&](float, float, float) {
+            ++visited;
+            return false;
+        });
+        REQUIRE(visited == 1);
+    }
+}
+
+TEST_CASE("GridDensityField - Raw files", "[volumes][density]")
+{
+    TempFile file("huira_grid_density_field.raw");
+    auto densities = make_ball();
+    {
+        std::ofstream out(file.path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(densities.data()),
+                  static_cast<std::streamsize>(densities.size() * sizeof(float)));
+    }
+
+    REQUIRE(GridDensityField<Visible8>::read_raw(file.path, {N, N, N}) == densities);
+    REQUIRE_THROWS(GridDensityField<Visible8>::read_raw(file.path, {N, N, N + 1}));
+}
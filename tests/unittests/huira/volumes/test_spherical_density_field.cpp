@@ -0,0 +1,108 @@
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "huira/core/spectral_bins.hpp"
+#include "huira/volumes/density/exponential_density_field.hpp"
+#include "huira/volumes/density/tabulated_density_field.hpp"
+
+using namespace huira;
+using Catch::Matchers::WithinRel;
+
+namespace {
+constexpr float EARTH_RADIUS = 6.371e6f;
+
+ExponentialDensityField<Visible8> make_atmosphere()
+{
+    return ExponentialDensityField<Visible8>(
+        EARTH_RADIUS, 8000.f, Visible8{2e-6f}, Visible8{1e-5f});
+}
+
+// Midpoint rule over the extinction returned by evaluate():
+float integrate_extinction(const DensityField<Visible8>& field,
+                           const Ray<Visible8>& ray,
+                           float t_min,
+                           float t_max)
+{
+    constexpr int steps = 200000;
+    const double dt = (static_cast<double>(t_max) - t_min) / steps;
+    double sum = 0.0;
+    for (int i = 0; i < steps; ++i) {
+        auto t = static_cast<float>(t_min + (i + 0.5) * dt);
+        sum += field.evaluate(ray.at(t)).extinction()[0];
+    }
+    return static_cast<float>(sum * dt * glm::length(ray.direction()));
+}
+} // namespace
+
+TEST_CASE("SphericalDensityField - Optical depth", "[volumes][density]")
+{
+    auto field = make_atmosphere();
+
+    SECTION("Vertical ray from the ground")
+    {
+        Ray<Visible8> ray(Vec3<float>{0.f, 0.f, EARTH_RADIUS + 1.f}, Vec3<float>{0.f, 0.f, 1.f});
+        float expected = integrate_extinction(field, ray, 0.f, 50000.f);
+        REQUIRE_THAT((*field.optical_depth(ray, 0.f, 50000.f))[0], WithinRel(expected, 0.01f));
+    }
+
+    SECTION("Horizontal ray through its closest approach")
+    {
+        Ray<Visible8> ray(Vec3<float>{-300000.f, 0.f, EARTH_RADIUS + 2000.f},
+                          Vec3<float>{1.f, 0.f, 0.f});
+        float expected = integrate_extinction(field, ray, 0.f, 600000.f);
+        REQUIRE_THAT((*field.optical_depth(ray, 0.f, 600000.f))[0], WithinRel(expected, 0.01f));
+    }
+
+    SECTION("Descending ray with a scaled direction")
+    {
+        Ray<Visible8> ray(Vec3<float>{0.f, 0.f, EARTH_RADIUS + 90000.f},
+                          Vec3<float>{2.f, 0.f, -0.1f});
+        float expected = integrate_extinction(field, ray, 10000.f, 200000.f);
+        REQUIRE_THAT((*field.optical_depth(ray, 10000.f, 200000.f))[0],
+                     WithinRel(expected, 0.01f));
+    }
+
+    SECTION("Rays missing the atmosphere see nothing")
+    {
+        Ray<Visible8> ray(Vec3<float>{0.f, 0.f, 2.f * EARTH_RADIUS}, Vec3<float>{1.f, 0.f, 0.f});
+        auto [enter, leave] = field.support(ray);
+        REQUIRE_FALSE(enter < leave);
+        REQUIRE((*field.optical_depth(ray, 0.f, 1e7f))[0] == 0.f);
+    }
+}
+
+TEST_CASE("SphericalDensityField - Majorant bounds the extinction", "[volumes][density]")
+{
+    auto field = make_atmosphere();
+    Ray<Visible8> ray(Vec3<float>{-400000.f, 0.f, EARTH_RADIUS + 30000.f},
+                      Vec3<float>{1.f, 0.f, -0.04f});
+    for (float t0 = 0.f; t0 < 800000.f; t0 += 50000.f) {
+        float t1 = t0 + 50000.f;
+        float majorant = field.majorant(ray, t0, t1);
+        for (int i = 0; i <= 100; ++i) {
+            float t = t0 + (t1 - t0) * static_cast<float>(i) / 100.f;
+            REQUIRE(field.evaluate(ray.at(t)).extinction().max() <= majorant * 1.0001f);
+        }
+    }
+}
+
+TEST_CASE("TabulatedDensityField - Profile", "[volumes][density]")
+{
+    TabulatedDensityField<Visible8> field(
+        EARTH_RADIUS, {0.f, 5000.f, 10000.f}, {1.f, 0.5f, 0.f}, Visible8{0.f}, Visible8{1e-4f});
+
+    REQUIRE_THAT(field.density(2500.f), WithinRel(0.75f, 1e-3f));
+    REQUIRE(field.density(20000.f) == 0.f);
+
+    // The column straight up is the area under the profile:
+    Ray<Visible8> ray(Vec3<float>{0.f, EARTH_RADIUS, 0.f}, Vec3<float>{0.f, 1.f, 0.f});
+    REQUIRE_THAT((*field.optical_depth(ray, 0.f, 1e6f))[0], WithinRel(1e-4f * 5000.f, 0.01f));
+
+    REQUIRE_THROWS(TabulatedDensityField<Visible8>(
+        EARTH_RADIUS, {0.f, 5000.f, 5000.f}, {1.f, 0.5f, 0.f}, Visible8{0.f}, Visible8{1e-4f}));
+    REQUIRE_THROWS(TabulatedDensityField<Visible8>(
+        EARTH_RADIUS, {0.f, 5000.f}, {1.f}, Visible8{0.f}, Visible8{1e-4f}));
+}